@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <functional>
 #include "imodule.h"
 #include <list>
 
@@ -8,6 +9,9 @@
 #include "math/Vector3.h"
 #include "math/AABB.h"
 
+class Ray;
+class VolumeTest;
+
 namespace map
 {
 
@@ -76,6 +80,25 @@ public:
 
     virtual std::size_t     getNumAreas() const = 0;
     virtual const Area&     getArea(int areaNum) const = 0;
+
+    /**
+     * Returns the number of the area containing the given point, or -1 if
+     * the point is outside of all areas. If the bounds of several areas
+     * contain the point, the smallest of these areas is returned.
+     */
+    virtual int findAreaByPoint(const Vector3& point) const = 0;
+
+    /**
+     * Returns the number of the area whose bounds are hit first by the given
+     * ray, or -1 if the ray doesn't hit any area.
+     */
+    virtual int pickArea(const Ray& ray) const = 0;
+
+    /**
+     * Invokes the given functor with the number of each area whose bounds
+     * are (at least partially) inside the given volume, e.g. the view frustum.
+     */
+    virtual void forEachAreaInVolume(const VolumeTest& volume, const std::function<void(int)>& functor) const = 0;
 };
 typedef std::shared_ptr<IAasFile> IAasFilePtr;
 
@@ -109,6 +132,19 @@ public:
      * Load the AAS file contents from the given stream. 
      */
     virtual IAasFilePtr loadFromStream(std::istream& stream) = 0;
+
+    /**
+     * Writes the given AAS file (which must have been loaded by this loader)
+     * to the given binary stream, to be read back by loadFromBinaryCache().
+     * Returns false if this loader doesn't support binary caches.
+     */
+    virtual bool writeBinaryCache(const IAasFile& aasFile, std::ostream& stream) = 0;
+
+    /**
+     * Loads an AAS file from the given binary stream written by writeBinaryCache().
+     * Returns an empty pointer if the data is not usable.
+     */
+    virtual IAasFilePtr loadFromBinaryCache(std::istream& stream) = 0;
 };
 typedef std::shared_ptr<IAasFileLoader> IAasFileLoaderPtr;
 
@@ -144,6 +180,11 @@ public:
 
     // Returns a list of AAS files for the given map (absolute) map path
     virtual std::list<AasFileInfo> getAasFilesForMap(const std::string& mapPath) = 0;
+
+    // Loads the given AAS file using a matching loader, returns an empty
+    // pointer on failure. Unless disabled in the preferences, a binary cache
+    // is stored next to the AAS file and used as long as the file is unchanged.
+    virtual IAasFilePtr loadAasFile(const AasFileInfo& info) = 0;
 };
 
 } // namespace
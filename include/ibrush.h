@@ -35,6 +35,14 @@ public:
 	virtual scene::INodePtr createBrush() = 0;
 
 	virtual IBrushSettings& getSettings() = 0;
+
+	/**
+	 * Builds the windings of all brushes in the scene whose planes have
+	 * changed since their last evaluation, spreading the work over all cores.
+	 * Called before the scene is rendered or tested for selection, such that
+	 * the brushes don't need to be evaluated one by one during traversal.
+	 */
+	virtual void evaluateChangedBrushes() = 0;
 };
 
 enum class PrefabType : int
@@ -60,13 +68,13 @@ const std::size_t SPHERE_MAX_SIDES = 7;
 
 }
 
-// The structure defining a single corner point of an IWinding
+// The structure defining a single corner point of an IWinding.
+// The tangent and bitangent vectors are the same for all vertices of a face,
+// they are stored once per winding (see Winding::getTangent()).
 struct WindingVertex
 {
 	Vector3 vertex;			// The 3D coordinates of the point
 	Vector2 texcoord;		// The UV coordinates
-	Vector3 tangent;		// The tangent
-	Vector3 bitangent;		// The bitangent
 	Vector3 normal;			// The normals
 	std::size_t adjacent;	// The index of the adjacent WindingVertex
 
@@ -75,7 +83,6 @@ struct WindingVertex
 	bool operator==(const WindingVertex& other) const
 	{
 		return (vertex == other.vertex && texcoord == other.texcoord &&
-			    tangent == other.tangent && bitangent == other.bitangent &&
 				normal == other.normal && adjacent == other.adjacent);
 	}
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <functional>
 #include "imodule.h"
 
 namespace radiant
@@ -26,6 +27,18 @@ public:
     /// Copy the given string to the system clipboard
     virtual void setString(const std::string& str) = 0;
 
+    /**
+     * Copy a string to the system clipboard which is generated by the given
+     * function only when the contents are actually requested, by getString()
+     * or by another application. Meant for large contents which are usually
+     * pasted within this application without being converted to text at all.
+     */
+    virtual void setStringProvider(const std::function<std::string()>& provider) = 0;
+
+    /// Returns true as long as the system clipboard holds the contents of the
+    /// last setStringProvider() call, i.e. nothing else has been copied since.
+    virtual bool isProvidingString() = 0;
+
     // A signal that is emitted when the contents of the system clipboard changes
     virtual sigc::signal<void>& signal_clipboardContentChanged() = 0;
 };
@@ -33,6 +33,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "math/Vector3.h"
 
 #include <vector>
+#include <string_view>
 #include <list>
 #include <map>
 #include <memory>
@@ -209,6 +210,16 @@ public:
     getAttribute(const std::string& name,
                  bool includeInherited = true) const = 0;
 
+    /**
+     * Return the value of the named attribute, including inherited ones.
+     * Unlike getAttribute() this doesn't need to construct a std::string for
+     * the name, the lookup doesn't allocate.
+     *
+     * \return
+     * The attribute value, or an empty string if the attribute is not found.
+     */
+    virtual const std::string& getAttributeValue(std::string_view name) const = 0;
+
     /**
      * Function that will be invoked by forEachAttribute.
      *
@@ -8,6 +8,7 @@
 #include "iscenegraph.h"
 #include "itransformnode.h"
 #include <functional>
+#include <string_view>
 
 #include "string/predicate.h"
 
@@ -164,6 +165,16 @@ public:
      */
     virtual std::string getKeyValue(const std::string& key) const = 0;
 
+    /**
+     * Allocation-free variant of getKeyValue(), for frequently queried keys.
+     *
+     * @returns
+     * A view of the current value for this key (which might be inherited
+     * from the entity class), or an empty view if it does not exist. The
+     * view is invalidated as soon as the key is changed or removed.
+     */
+    virtual std::string_view getKeyValueView(std::string_view key) const = 0;
+
     /**
      * greebo: Checks whether the given key is inherited or not.
      *
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class ArbitraryMeshVertex;
+
+namespace render
+{
+
+/**
+ * The primitive type of a block of indexed geometry
+ * held in the render system's geometry store.
+ */
+enum class GeometryType
+{
+    Triangles,
+    Lines,
+    Points,
+};
+
+/**
+ * \brief
+ * Storage container for indexed vertex geometry, owned by the RenderSystem.
+ *
+ * Renderables allocate a slot of a certain size and upload their (world space)
+ * vertices and indices to it whenever their geometry changes. The data is kept
+ * in a few large buffer objects, such that the backend can draw all slots
+ * sharing the same shader pass and primitive type with a single multi-draw call.
+ *
+ * Slots are not bound to a specific shader, they are submitted to a Shader
+ * each frame through RenderableCollector::addGeometry().
+ *
+ * Geometry in the store doesn't take part in light interactions, so it is meant
+ * for unlit, world-space geometry like wireframes and entity decorations. Lit
+ * surfaces (brush faces, patch meshes) as well as the view-dependent brush
+ * wireframes are still submitted as OpenGLRenderables.
+ */
+class IGeometryStore
+{
+public:
+    virtual ~IGeometryStore() {}
+
+    // Handle referring to a single allocation in this store
+    using Slot = std::uint64_t;
+
+    // Slot value that is never handed out by allocateSlot()
+    static constexpr Slot InvalidSlot = std::numeric_limits<Slot>::max();
+
+    /**
+     * Allocate a new slot, reserving room for the given number of vertices
+     * and indices. The returned handle is valid until deallocateSlot() is called.
+     */
+    virtual Slot allocateSlot(std::size_t numVertices, std::size_t numIndices) = 0;
+
+    /**
+     * Replace the data of the given slot. The indices refer to the given
+     * vertex array (starting at 0), the store takes care of rebasing them.
+     * The amount of vertices and indices must not exceed the sizes the slot
+     * has been allocated with, otherwise a std::logic_error is thrown.
+     */
+    virtual void updateData(Slot slot, const std::vector<ArbitraryMeshVertex>& vertices,
+        const std::vector<unsigned int>& indices) = 0;
+
+    /**
+     * Release the memory occupied by this slot.
+     * The slot handle must not be used after this call.
+     */
+    virtual void deallocateSlot(Slot slot) = 0;
+
+    // The information needed to draw the contents of a slot
+    struct RenderParameters
+    {
+        // Offset of the first index of this slot (in elements, not bytes)
+        std::size_t firstIndex;
+
+        // The number of indices currently used by this slot
+        std::size_t indexCount;
+    };
+
+    /**
+     * Returns the index range the backend needs to draw the given slot.
+     */
+    virtual RenderParameters getRenderParameters(Slot slot) const = 0;
+};
+
+}
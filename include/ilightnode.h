@@ -4,6 +4,12 @@
 #include "inode.h"
 #include "math/AABB.h"
 
+/**
+ * The extents of the light "diamond" (see ILightNode::getSelectAABB()). The diamond
+ * is centered at the light origin, which is always inside the light's world AABB.
+ */
+const double LIGHT_DIAMOND_EXTENTS = 8.0;
+
 /**
  * LightNodes derive from this class.
  * It's mainly used to determine the selectable part
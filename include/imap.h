@@ -6,6 +6,7 @@
 #include "imapformat.h"
 #include "imapmerge.h"
 #include "ikeyvaluestore.h"
+#include "imaterialusageindex.h"
 #include <sigc++/signal.h>
 
 #include <os/fs.h>
@@ -85,11 +86,55 @@ public:
 	 * Provides methods to create and assign layers in this map.
 	 */
 	virtual ILayerManager& getLayerManager() = 0;
+
+	/**
+	 * Keeps track of the materials used by the faces and patches in this map.
+	 */
+	virtual IMaterialUsageIndex& getMaterialUsageIndex() = 0;
+
+    /**
+     * Emitted whenever the change revision of a node in this map is incremented,
+     * i.e. right before the node is changed as part of an undoable operation.
+     * Adding or removing a child node counts as a change of the parent.
+     * Spawnarg changes are reported too, even if they are not undoable.
+     */
+    virtual sigc::signal<void, const INodePtr&>& signal_nodeChanged() = 0;
 };
 typedef std::shared_ptr<IMapRootNode> IMapRootNodePtr;
 
 } // namespace scene
 
+namespace map
+{
+
+/**
+ * Handle to a map copy which is written to disk on a background thread,
+ * as returned by IMap::saveCopyInBackground().
+ */
+class IBackgroundMapSave
+{
+public:
+    using Ptr = std::shared_ptr<IBackgroundMapSave>;
+
+    virtual ~IBackgroundMapSave() {}
+
+    // The time in milliseconds the calling thread has been blocked
+    // while taking the snapshot of the scene
+    virtual std::size_t getPauseTime() const = 0;
+
+    // The number of scene nodes which had to be copied for the snapshot,
+    // the nodes unchanged since the previous background save are re-used
+    virtual std::size_t getNumCopiedNodes() const = 0;
+
+    // Returns true once the file has been written (or writing failed)
+    virtual bool isFinished() const = 0;
+
+    // Blocks until the file has been written
+    virtual void wait() = 0;
+};
+
+}
+
 /**
  * greebo: This is the global interface to the currently
  * active map file.
@@ -182,6 +227,17 @@ public:
 	virtual map::IMapExporter::Ptr createMapExporter(map::IMapWriter& writer,
 		const scene::IMapRootNodePtr& root, std::ostream& mapStream) = 0;
 
+    /**
+     * Saves a copy of the current map to the given path, the format is
+     * determined from the file extension. The scene is captured in a snapshot,
+     * which is then serialised and written on a background thread. Formats
+     * that cannot be written from a snapshot are saved synchronously.
+     *
+     * Returns an empty reference if a previous background save is still in
+     * progress, in which case nothing is saved.
+     */
+    virtual map::IBackgroundMapSave::Ptr saveCopyInBackground(const std::string& absolutePath) = 0;
+
     // Exports the current selection to the given output stream, using the map's format
     virtual void exportSelected(std::ostream& out) = 0;
 
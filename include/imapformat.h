@@ -121,6 +121,21 @@ public:
 	// Patch export methods
 	virtual void beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream) = 0;
 	virtual void endWritePatch(const IPatchNodePtr& patch, std::ostream& stream) = 0;
+	/**
+	 * Creates a new writer of the same kind, used to export a single entity
+	 * (including its primitives) into a separate stream on a worker thread.
+	 * The returned writer numbers its entity as entityNum, such that the
+	 * concatenated output of all entity writers is the same as if this
+	 * writer had been used for the whole map. The writers must not share
+	 * any mutable state with each other.
+	 *
+	 * Returns an empty pointer if the writer doesn't support this, in which
+	 * case the map is exported sequentially.
+	 */
+	virtual std::shared_ptr<IMapWriter> createEntityWriter(std::size_t entityNum) const
+	{
+		return std::shared_ptr<IMapWriter>();
+	}
 };
 typedef std::shared_ptr<IMapWriter> IMapWriterPtr;
 
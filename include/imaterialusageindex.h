@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <memory>
+
+class IFace;
+
+namespace scene
+{
+
+class INode;
+
+/**
+ * A single surface using a material: either a brush face or a patch.
+ */
+struct MaterialUsage
+{
+    // The brush or patch node owning the surface
+    INode* node = nullptr;
+
+    // The face, or nullptr if the surface is a patch
+    IFace* face = nullptr;
+
+    bool isFace() const
+    {
+        return face != nullptr;
+    }
+};
+
+/**
+ * Index of the materials used by the faces and patches in a map,
+ * maintained incrementally while surfaces are inserted into or removed
+ * from the scene, or change their material.
+ *
+ * Material names are compared case-insensitively.
+ */
+class IMaterialUsageIndex
+{
+public:
+    using Ptr = std::shared_ptr<IMaterialUsageIndex>;
+
+    virtual ~IMaterialUsageIndex() {}
+
+    // Called by the surfaces themselves, don't use these in client code
+    virtual void addUsage(const std::string& material, const MaterialUsage& usage) = 0;
+    virtual void removeUsage(const std::string& material, const MaterialUsage& usage) = 0;
+
+    // Number of faces using the given material
+    virtual std::size_t getFaceCount(const std::string& material) const = 0;
+
+    // Number of patches using the given material
+    virtual std::size_t getPatchCount(const std::string& material) const = 0;
+
+    using MaterialVisitor = std::function<void(const std::string& material, std::size_t faceCount, std::size_t patchCount)>;
+
+    // Visits every material in use, along with the number of faces and patches using it
+    virtual void foreachMaterial(const MaterialVisitor& visitor) const = 0;
+
+    /**
+     * Visits every face and patch using the given material, until the functor
+     * returns false. The functor is invoked on a copy of the usage list, it's
+     * safe to change the material of the visited surfaces.
+     * Returns false if the functor stopped the traversal.
+     */
+    virtual bool foreachUsage(const std::string& material, const std::function<bool(const MaterialUsage&)>& functor) const = 0;
+};
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "inode.h"
+
+namespace scene
+{
+
+/**
+ * A scene node which is able to estimate the amount of memory it occupies,
+ * used to compile the memory report of a map.
+ */
+class IMemoryAccountable :
+    public virtual INode
+{
+public:
+    virtual ~IMemoryAccountable() {}
+
+    // Returns the approximate number of bytes used by this node, including
+    // the memory allocated by the node's members (but excluding child nodes)
+    virtual std::size_t getMemoryUsage() const = 0;
+};
+
+}
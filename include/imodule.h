@@ -329,6 +329,23 @@ public:
 	// Returns the instance ID of this registry. This is a numeric type used by
 	// InstanceReference classes to check if their references are still valid.
 	virtual InstanceId getInstanceId() const = 0;
+
+    // Timing of a single initialiseModule() call, relative to the
+    // start of the module initialisation phase
+    struct InitialisationRecord
+    {
+        std::string name;
+        std::size_t beginUsec;
+        std::size_t durationUsec;
+    };
+    typedef std::vector<InitialisationRecord> InitialisationTimeline;
+
+    /**
+     * Returns the startup timeline, one record per initialised module in the
+     * order the initialiseModule() calls have been finished. The timeline is
+     * written to the log after all modules have been initialised, too.
+     */
+    virtual const InitialisationTimeline& getInitialisationTimeline() const = 0;
 };
 
 namespace module
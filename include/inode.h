@@ -259,6 +259,14 @@ public:
 
     // Called during recursive transform changed, but only by INodes themselves
     virtual void transformChangedLocal() = 0;
+
+    /**
+     * Returns a number which is incremented whenever the undoable state of this
+     * node is about to change as part of an undoable operation (e.g. when a
+     * brush face or a spawnarg is modified, or a child node is added).
+     * Changes done by undo and redo themselves are not counted.
+     */
+    virtual std::size_t getChangeRevision() const = 0;
 };
 
 } // namespace scene
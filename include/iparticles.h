@@ -8,8 +8,12 @@
 
 class RenderSystem;
 class Matrix4;
+template<typename Element> class BasicVector2;
+typedef BasicVector2<double> Vector2;
 template<typename Element> class BasicVector3;
 typedef BasicVector3<double> Vector3;
+template<typename Element> class BasicVector4;
+typedef BasicVector4<double> Vector4;
 class AABB;
 
 namespace scene
@@ -152,6 +156,21 @@ public:
 	 * calculate and return the bounds at the time passed to update().
 	 */
 	virtual const AABB& getBounds() = 0;
+
+	/**
+	 * Re-seeds the random number generator providing the starting values
+	 * of the particle bunches and sets up the stages again. The geometry
+	 * generated by update() depends on the seed and the time only.
+	 */
+	virtual void setRandomSeed(unsigned int seed) = 0;
+
+	using VertexVisitor = std::function<void(const Vector3& vertex, const Vector2& texcoord, const Vector4& colour)>;
+
+	/**
+	 * Visits the vertices of the quads generated by the last update(),
+	 * four vertices per quad, stage by stage.
+	 */
+	virtual void foreachVertex(const VertexVisitor& visitor) const = 0;
 };
 typedef std::shared_ptr<IRenderableParticle> IRenderableParticlePtr;
 
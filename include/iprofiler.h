@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include "imodule.h"
+
+namespace profiling
+{
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Lightweight instrumentation of the application: named zones (time spans),
+ * counter values and frame markers are recorded into per-thread ring buffers
+ * while the profiler is running. Recording is off by default, it is toggled
+ * by the ProfilerStart and ProfilerStop commands.
+ *
+ * The recorded events can be written in the Chrome trace event format,
+ * which can be inspected using chrome://tracing or ui.perfetto.dev.
+ *
+ * Only the name pointers are recorded, names need to be string literals
+ * (or otherwise live as long as the profiler).
+ */
+class IProfiler :
+    public RegisterableModule
+{
+public:
+    virtual ~IProfiler() {}
+
+    // Returns true while events are recorded, this is cheap to call
+    virtual bool isRunning() const = 0;
+
+    // Starts recording, discarding all previously recorded events
+    virtual void start() = 0;
+
+    // Stops recording, the recorded events are kept until the next start()
+    virtual void stop() = 0;
+
+    // Records a zone on the calling thread (use the ScopedZone helper below)
+    virtual void addZone(const char* name, Clock::time_point begin, Clock::time_point end) = 0;
+
+    // Records the value of the named counter at the current time
+    virtual void setCounter(const char* name, double value) = 0;
+
+    // Records the begin of a frame of the given name (e.g. a redraw of a view)
+    virtual void markFrame(const char* name) = 0;
+
+    // Writes the recorded events as Chrome trace JSON to the given stream
+    virtual void writeTrace(std::ostream& stream) = 0;
+};
+
+}
+
+const char* const MODULE_PROFILER("Profiler");
+
+inline profiling::IProfiler& GlobalProfiler()
+{
+    static module::InstanceReference<profiling::IProfiler> _reference(MODULE_PROFILER);
+    return _reference;
+}
+
+namespace profiling
+{
+
+/**
+ * Records a zone spanning the lifetime of this object, if the profiler
+ * is running at construction time. The profiler module needs to be
+ * initialised at that point, so modules using zones should list
+ * MODULE_PROFILER in their dependencies.
+ */
+class ScopedZone
+{
+private:
+    const char* _name;
+    Clock::time_point _begin;
+
+public:
+    ScopedZone(const char* name) :
+        _name(GlobalProfiler().isRunning() ? name : nullptr)
+    {
+        if (_name != nullptr)
+        {
+            _begin = Clock::now();
+        }
+    }
+
+    ~ScopedZone()
+    {
+        if (_name != nullptr)
+        {
+            GlobalProfiler().addZone(_name, _begin, Clock::now());
+        }
+    }
+
+    ScopedZone(const ScopedZone& other) = delete;
+    ScopedZone& operator=(const ScopedZone& other) = delete;
+};
+
+}
@@ -7,6 +7,7 @@
 #include "math/AABB.h"
 
 #include "ishaderlayer.h"
+#include "igeometrystore.h"
 #include <sigc++/signal.h>
 
 /**
@@ -232,6 +233,15 @@ public:
 
     /// Test if the given light intersects the LitObject
     virtual bool intersectsLight(const RendererLight& light) const = 0;
+
+    /**
+     * \brief Return the world-space bounds of the LitObject.
+     *
+     * The result of intersectsLight() must not change as long as these bounds
+     * and the lightAABB() of the light stay the same, which allows the
+     * renderer to cache the light interactions between frames.
+     */
+    virtual const AABB& litObjectAABB() const = 0;
 };
 typedef std::shared_ptr<LitObject> LitObjectPtr;
 
@@ -423,6 +433,20 @@ public:
 							   const LightSources* lights = nullptr,
                                const IRenderEntity* entity = nullptr) = 0;
 
+    /**
+     * \brief
+     * Submit a slot of the render system's geometry store to this Shader,
+     * to be drawn during the next render pass. The geometry is expected to be
+     * in world coordinates, no transform is applied.
+     *
+     * \param slot
+     * The slot as returned by IGeometryStore::allocateSlot().
+     *
+     * \param type
+     * The primitive type the indices of this slot are describing.
+     */
+    virtual void addGeometry(render::IGeometryStore::Slot slot, render::GeometryType type) = 0;
+
     /**
      * \brief
      * Control the visibility of this shader.
@@ -467,6 +491,49 @@ typedef std::shared_ptr<Shader> ShaderPtr;
 
 const char* const MODULE_RENDERSYSTEM("ShaderCache");
 
+namespace render
+{
+
+/**
+ * Counters collected by the backend during the most recent call to
+ * RenderSystem::render(). Used for the camera statistics overlay.
+ */
+struct FrameStatistics
+{
+    // Number of (shader pass, entity) buckets in the sorted render queue
+    std::size_t queueEntries = 0;
+
+    // Number of renderables drawn plus the number of multi-draw calls
+    // issued for geometry store slots
+    std::size_t drawCalls = 0;
+
+    // Number of times a shader pass state has been applied
+    std::size_t stateChanges = 0;
+
+    // Number of state applications that have been skipped because
+    // the previous queue entry already left GL in the required state
+    std::size_t skippedStateChanges = 0;
+
+    // Time spent collecting and sorting the render queue (microseconds)
+    std::size_t queueBuildTimeUsec = 0;
+};
+
+/**
+ * A client of the render system which postponed capturing its shader, see
+ * RenderSystem::deferCapture().
+ */
+class IDeferredShaderCapture
+{
+public:
+    virtual ~IDeferredShaderCapture() {}
+
+    // Capture the shader now, invoked by RenderSystem::captureDeferredShaders()
+    // after the client has been removed from the list of deferred captures.
+    virtual void captureShaderNow() = 0;
+};
+
+}
+
 /**
  * \brief
  * The main interface for the backend renderer.
@@ -492,6 +559,29 @@ public:
 
 	virtual ShaderPtr capture(const std::string& name) = 0;
 
+    /**
+     * \brief
+     * Register a client which postponed capturing its shader.
+     *
+     * Huge maps consist of hundreds of thousands of surfaces, most of which
+     * are not visible after loading. Surfaces capture their shader when they
+     * are rendered or queried for the first time and cancel their request.
+     * The remaining ones are captured in batches by captureDeferredShaders().
+     */
+    virtual void deferCapture(render::IDeferredShaderCapture& client) = 0;
+
+    /// Remove the client from the list of deferred captures, if it is listed
+    virtual void cancelDeferredCapture(render::IDeferredShaderCapture& client) = 0;
+
+    /**
+     * \brief
+     * Let at most maxCount of the deferred clients capture their shaders.
+     *
+     * \return
+     * The number of clients still waiting for their capture.
+     */
+    virtual std::size_t captureDeferredShaders(std::size_t maxCount) = 0;
+
     /**
      * \brief
      * Main render method.
@@ -550,6 +640,20 @@ public:
     /// Set the shader program to use.
     virtual void setShaderProgram(ShaderProgram prog) = 0;
 
+    /**
+     * \brief
+     * Returns the geometry store owned by this render system. Renderables can
+     * allocate slots in this store and submit them to Shaders by using
+     * RenderableCollector::addGeometry().
+     */
+    virtual render::IGeometryStore& getGeometryStore() = 0;
+
+    /**
+     * \brief
+     * Returns the statistics gathered during the last render() call.
+     */
+    virtual const render::FrameStatistics& getFrameStatistics() const = 0;
+
     virtual void attachRenderable(const Renderable& renderable) = 0;
     virtual void detachRenderable(const Renderable& renderable) = 0;
     virtual void forEachRenderable(const RenderableCallback& callback) const = 0;
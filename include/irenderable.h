@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include "igeometrystore.h"
 
 class Shader;
 typedef std::shared_ptr<Shader> ShaderPtr;
@@ -71,6 +72,27 @@ public:
                                const LitObject* litObject = nullptr,
                                const IRenderEntity* entity = nullptr) = 0;
 
+    /**
+     * \brief Submit a slot of the render system's geometry store.
+     *
+     * The geometry of the slot is drawn with the given shader, the vertices
+     * are already in world space. This is cheaper than submitting an
+     * OpenGLRenderable since the backend can batch all the slots of a shader
+     * pass into a few draw calls. Geometry submitted this way is not
+     * considered for lighting.
+     *
+     * \param shader
+     * The Shader object this geometry will be attached to.
+     *
+     * \param slot
+     * The slot as allocated in the RenderSystem's IGeometryStore.
+     *
+     * \param type
+     * The primitive type of the slot's geometry.
+     */
+    virtual void addGeometry(Shader& shader, render::IGeometryStore::Slot slot,
+                             render::GeometryType type) = 0;
+
     /**
      * \brief Submit a light source for the render operation.
      *
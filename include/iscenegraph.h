@@ -25,6 +25,7 @@ namespace scene
 
 class ISpacePartitionSystem;
 typedef std::shared_ptr<ISpacePartitionSystem> ISpacePartitionSystemPtr;
+struct BoundsQuery;
 
 /**
 * A scene-graph - a Directed Acyclic Graph (DAG).
@@ -112,6 +113,10 @@ public:
 	// Same as above, but culls any hidden nodes
 	virtual void foreachVisibleNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) = 0;
 
+	// Call the functor on each scene node whose bounds match the given query, even hidden ones.
+	// The spacepartition is used to skip the parts of the scene out of reach of the query.
+	virtual void foreachNodeInBounds(const BoundsQuery& query, const INode::VisitorFunc& functor) = 0;
+
 	// Returns the associated spacepartition
 	virtual ISpacePartitionSystemPtr getSpacePartition() = 0;
 };
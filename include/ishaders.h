@@ -10,6 +10,7 @@
 
 #include <ostream>
 #include <vector>
+#include <functional>
 
 #include "Texture.h"
 #include "ishaderlayer.h"
@@ -190,6 +191,23 @@ public:
     /// Return true if the editor image is no tex for this shader.
     virtual bool isEditorImageNoTex() = 0;
 
+    /// Return true if the editor image texture has been created, in which case
+    /// getEditorImage() returns right away without loading anything.
+    virtual bool isEditorImageRealised() = 0;
+
+    /**
+     * Returns a function loading the image data of the editor image, without
+     * creating the GL texture. The function doesn't refer to this material and
+     * may be invoked in a worker thread, its result can be passed to
+     * realiseEditorImage() on the main thread.
+     */
+    using EditorImageLoader = std::function<ImagePtr()>;
+    virtual EditorImageLoader getEditorImageLoader() = 0;
+
+    /// Creates the editor image texture from the image data returned by the
+    /// getEditorImageLoader() function. Does nothing if the texture exists already.
+    virtual void realiseEditorImage(const ImagePtr& image) = 0;
+
     // Returns the expression defining the editor image of this material, as passed to qer_editorimage statement,
     // or an empty string if this keyword was not used at all in this declaration.
     virtual shaders::IMapExpression::Ptr getEditorImageExpression() = 0;
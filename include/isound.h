@@ -3,6 +3,7 @@
 #include "imodule.h"
 #include "ModResource.h"
 
+#include <map>
 #include <vector>
 #include <functional>
 #include <sigc++/signal.h>
@@ -87,6 +88,15 @@ typedef std::shared_ptr<ISoundShader> ISoundShaderPtr;
 
 const char* const MODULE_SOUNDMANAGER("SoundManager");
 
+// Properties of a single sound file, as determined from its header
+struct SoundFileInfo
+{
+    float duration = 0;             // in seconds
+    unsigned int channels = 0;
+    unsigned int sampleRate = 0;    // in Hz
+    std::size_t size = 0;           // file size in bytes
+};
+
 /// Sound manager interface.
 class ISoundManager :
     public RegisterableModule
@@ -125,6 +135,12 @@ public:
     // Will throw a std::out_of_range exception if the path cannot be resolved
     virtual float getSoundFileDuration(const std::string& vfsPath) = 0;
 
+    // Returns the properties of all the given sound files (VFS paths as used in
+    // the sound shaders), in one go. Files known to the metadata index are not
+    // read again, the others are read in parallel. Paths that cannot be resolved
+    // are missing in the returned map.
+    virtual std::map<std::string, SoundFileInfo> getSoundFileInfo(const std::vector<std::string>& vfsPaths) = 0;
+
     // Reloads all sound shader definitions from the VFS
     virtual void reloadSounds() = 0;
 
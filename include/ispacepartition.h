@@ -3,10 +3,10 @@
 
 #include <list>
 #include <vector>
+#include <functional>
+#include <cmath>
 #include "imodule.h"
-
-// Forward declaration
-class AABB;
+#include "math/AABB.h"
 
 namespace scene
 {
@@ -63,6 +63,118 @@ public:
 };
 typedef std::shared_ptr<ISPNode> ISPNodePtr;
 
+/**
+ * Specifies how the world bounds of a scene node are tested
+ * against the bounds of a BoundsQuery.
+ */
+enum class BoundsQueryType
+{
+	// The node bounds intersect or touch the query bounds
+	Intersects,
+
+	// The node bounds are completely inside the query bounds (touching the border is allowed)
+	Contained,
+
+	// Like Intersects, but the query bounds are extending infinitely along the column axis
+	ColumnIntersects,
+};
+
+/**
+ * A spatial query against the SpacePartition, matching all nodes
+ * whose world bounds pass the test against any of the query bounds.
+ * Nodes with invalid bounds never match a query.
+ */
+struct BoundsQuery
+{
+	std::vector<AABB> bounds;
+
+	BoundsQueryType type = BoundsQueryType::Intersects;
+
+	// The axis (0 = x, 1 = y, 2 = z) the query bounds are extended along (ColumnIntersects only)
+	std::size_t columnAxis = 2;
+
+	// This value is added to the extents of all query bounds. Can be used to find nodes
+	// whose selectable area is exceeding their world bounds by a known amount.
+	double tolerance = 0;
+
+	BoundsQuery()
+	{}
+
+	BoundsQuery(const std::vector<AABB>& bounds_, BoundsQueryType type_ = BoundsQueryType::Intersects) :
+		bounds(bounds_),
+		type(type_)
+	{}
+
+	// Returns true if the given node bounds are matching this query
+	bool matches(const AABB& nodeBounds) const
+	{
+		if (!nodeBounds.isValid()) return false;
+
+		for (const auto& queryBounds : bounds)
+		{
+			if (matches(queryBounds, nodeBounds))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Returns true if nodes inside the given region can possibly match this query
+	bool touches(const AABB& region) const
+	{
+		for (const auto& queryBounds : bounds)
+		{
+			if (intersects(queryBounds, region))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+private:
+	bool ignoresAxis(std::size_t axis) const
+	{
+		return type == BoundsQueryType::ColumnIntersects && axis == columnAxis;
+	}
+
+	bool intersects(const AABB& queryBounds, const AABB& other) const
+	{
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			if (!ignoresAxis(i) && std::abs(queryBounds.origin[i] - other.origin[i]) >
+				queryBounds.extents[i] + tolerance + other.extents[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool matches(const AABB& queryBounds, const AABB& nodeBounds) const
+	{
+		if (type != BoundsQueryType::Contained)
+		{
+			return intersects(queryBounds, nodeBounds);
+		}
+
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			if (std::abs(queryBounds.origin[i] - nodeBounds.origin[i]) >
+				queryBounds.extents[i] + tolerance - nodeBounds.extents[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+};
+
 /**
  * greebo: The SpacePartitionSystem interface is a simple one. All it needs
  * to do is to provide link/unlink methods for linking scene::INodes
@@ -90,6 +202,11 @@ public:
 
 	// Returns the root node of this SP tree (the largest one, encompassing everything)
 	virtual ISPNodePtr getRoot() const = 0;
+
+	// Invokes the functor for each linked node matching the given query. Subtrees of the
+	// partition not touching any of the query bounds are skipped. The traversal is stopped
+	// as soon as the functor returns false. The functor must not link or unlink any nodes.
+	virtual void foreachNodeInBounds(const BoundsQuery& query, const std::function<bool(const INodePtr&)>& functor) const = 0;
 };
 typedef std::shared_ptr<ISpacePartitionSystem> ISpacePartitionSystemPtr;
 
@@ -0,0 +1,25 @@
+# Bulk data access test, requires NumPy
+
+import numpy
+
+# Shift the textures of all selected faces by 8 units in one undoable step
+texdefs = GlobalBulkData.getFaceTexdefs(1)
+print('Number of selected faces: ' + str(len(texdefs)))
+
+texdefs[:, 0, 2] += 8.0 / 128
+GlobalBulkData.setFaceTexdefs(1, texdefs)
+
+# Print the bounds of all brush vertices in the map
+vertices = GlobalBulkData.getBrushVertices(0)
+
+if len(vertices) > 0:
+	print('Brush vertex bounds: ' + str(vertices.min(axis=0)) + ' to ' + str(vertices.max(axis=0)))
+
+# Raise all selected entities by 16 units
+origins = GlobalBulkData.getEntityOrigins(1)
+origins[:, 2] += 16
+GlobalBulkData.setEntityOrigins(1, origins)
+
+# List the names of all entities in the map
+for name in GlobalBulkData.getEntityKeyValues(0, 'name'):
+	print(name)
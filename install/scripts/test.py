@@ -117,6 +117,19 @@ print("Point files found: " + str(len(GlobalMap.getPointFileList())))
 for path in GlobalMap.getPointFileList:
 	print("Pointfile: " + path)
 
+# Query the materials used by the map's faces and patches
+for material in GlobalMap.getMaterialsInUse():
+	print(material + ": " + str(GlobalMap.getMaterialFaceCount(material)) + " faces, " + \
+		str(GlobalMap.getMaterialPatchCount(material)) + " patches")
+
+# Visit the brushes and patches using a certain material
+class MaterialUserVisitor(dr.SceneNodeVisitor) :
+	def pre(self, node):
+		print(node.getNodeType() + " is using textures/common/caulk")
+		return 1
+
+GlobalMap.foreachNodeUsingMaterial("textures/common/caulk", MaterialUserVisitor())
+
 # Try to find the map's worldspawn
 worldspawn = GlobalMap.getWorldSpawn()
 
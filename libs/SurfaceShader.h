@@ -5,31 +5,48 @@
 #include "debugging/debugging.h"
 #include "util/Noncopyable.h"
 #include "irender.h"
+#include "ifilter.h"
+#include "imaterialusageindex.h"
 #include "shaderlib.h"
+#include "string/StringPool.h"
 
 /**
  * Encapsulates a GL ShaderPtr and keeps track whether this
  * shader is actually in use in the map or not. The shader
  * is captured and released based on whether there is a
  * shadersystem reference available.
+ *
+ * The capture is deferred until the shader is first needed
+ * for rendering or queried for its dimensions. Surfaces which
+ * are not visible after loading a map are captured in batches
+ * through RenderSystem::captureDeferredShaders().
  */
 class SurfaceShader :
     public util::Noncopyable,
-	public Shader::Observer
+	public Shader::Observer,
+    public render::IDeferredShaderCapture
 {
 private:
-    // greebo: The name of the material
-    std::string _materialName;
+    // greebo: The name of the material, pointing into the pool of material names.
+    // Large maps use a few hundred materials on many thousands of surfaces.
+    const std::string* _materialName;
 
     RenderSystemPtr _renderSystem;
 
     ShaderPtr _glShader;
 
+    // True while this surface is waiting in the render system's deferred captures
+    bool _captureDeferred;
+
     // In-use flag
     bool _inUse;
 
     bool _realised;
 
+    // The usage index this surface is registered in (while in the scene)
+    scene::IMaterialUsageIndex* _usageIndex;
+    scene::MaterialUsage _usage;
+
 	// Client signals
 	sigc::signal<void> _signalRealised;
 	sigc::signal<void> _signalUnrealised;
@@ -38,10 +55,12 @@ public:
     // Constructor. The renderSystem reference will be kept internally as reference
     // The SurfaceShader will try to de-reference it when capturing shaders.
     SurfaceShader(const std::string& materialName, const RenderSystemPtr& renderSystem = RenderSystemPtr()) :
-        _materialName(materialName),
+        _materialName(&MaterialNames().intern(materialName)),
         _renderSystem(renderSystem),
+        _captureDeferred(false),
         _inUse(false),
-        _realised(false)
+        _realised(false),
+        _usageIndex(nullptr)
     {
         captureShader();
     }
@@ -49,9 +68,31 @@ public:
     // Destructor
     virtual ~SurfaceShader()
     {
+        setUsageIndex(nullptr, scene::MaterialUsage());
         releaseShader();
     }
 
+    /**
+     * Registers this surface in the given usage index, which is kept up to date
+     * when the material is changed. Pass nullptr to remove the surface from the
+     * index it's currently registered in.
+     */
+    void setUsageIndex(scene::IMaterialUsageIndex* index, const scene::MaterialUsage& usage)
+    {
+        if (_usageIndex)
+        {
+            _usageIndex->removeUsage(*_materialName, _usage);
+        }
+
+        _usageIndex = index;
+        _usage = usage;
+
+        if (_usageIndex)
+        {
+            _usageIndex->addUsage(*_materialName, _usage);
+        }
+    }
+
     /**
     * Indicates whether this Shader is actually in use in the scene or not.
     * The shader is not in use if the owning Patch resides on the UndoStack, forex.
@@ -79,7 +120,7 @@ public:
     */
     const std::string& getMaterialName() const
     {
-        return _materialName;
+        return *_materialName;
     }
 
     /**
@@ -89,11 +130,17 @@ public:
     void setMaterialName(const std::string& name)
     {
         // return, if the shader is the same as the currently used
-        if (shader_equal(_materialName, name)) return;
+        if (shader_equal(*_materialName, name)) return;
 
         releaseShader();
 
-        _materialName = name;
+        if (_usageIndex)
+        {
+            _usageIndex->removeUsage(*_materialName, _usage);
+            _usageIndex->addUsage(name, _usage);
+        }
+
+        _materialName = &MaterialNames().intern(name);
 
         captureShader();
     }
@@ -104,12 +151,32 @@ public:
     */
     const ShaderPtr& getGLShader() const
     {
+        ensureShaderCaptured();
+
         return _glShader;
     }
 
+    /**
+    * \brief
+    * Returns true if the material is not hidden by the active filters.
+    * This doesn't capture the shader. Surfaces without a render system
+    * are considered invisible.
+    */
+    bool isMaterialVisible() const
+    {
+        if (_glShader && _glShader->getMaterial())
+        {
+            return _glShader->getMaterial()->isVisible();
+        }
+
+        return _renderSystem && GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, *_materialName);
+    }
+
     // Return the dimensions of the editorimage of the contained material
     std::size_t getWidth() const
     {
+        ensureShaderCaptured();
+
         if (_realised)
         {
             return _glShader->getMaterial()->getEditorImage()->getWidth();
@@ -120,6 +187,8 @@ public:
 
     std::size_t getHeight() const
     {
+        ensureShaderCaptured();
+
         if (_realised)
         {
             return _glShader->getMaterial()->getEditorImage()->getHeight();
@@ -130,6 +199,9 @@ public:
 
     void setRenderSystem(const RenderSystemPtr& renderSystem)
     {
+        // Release the shader (or cancel its capture) at the previous render system
+        releaseShader();
+
         _renderSystem = renderSystem;
 
         captureShader();
@@ -171,6 +243,13 @@ public:
 		return _realised;
 	}
 
+    // The pool the material names of all surfaces are stored in
+    static string::StringPool& MaterialNames()
+    {
+        static string::StringPool _pool;
+        return _pool;
+    }
+
 private:
     // Shader capture and release
     void captureShader()
@@ -178,23 +257,49 @@ private:
 		// Release previous resources in any case
 		releaseShader();
 
-        // Check if we have a rendersystem - can we capture already?
+        // Check if we have a rendersystem - the actual capture happens on first use
         if (_renderSystem)
         {
-            _glShader = _renderSystem->capture(_materialName);
-            assert(_glShader);
+            _renderSystem->deferCapture(*this);
+            _captureDeferred = true;
+        }
+    }
 
-			_glShader->attachObserver(*this);
+    void ensureShaderCaptured() const
+    {
+        if (!_captureDeferred) return;
 
-            if (_inUse)
-            {
-                _glShader->incrementUsed();
-            }
+        auto& self = const_cast<SurfaceShader&>(*this);
+
+        _renderSystem->cancelDeferredCapture(self);
+        self.captureShaderNow();
+    }
+
+    // Inherited via IDeferredShaderCapture
+    void captureShaderNow() override
+    {
+        _captureDeferred = false;
+
+        _glShader = _renderSystem->capture(*_materialName);
+        assert(_glShader);
+
+        // Invokes onShaderRealised() right away if the shader is realised
+        _glShader->attachObserver(*this);
+
+        if (_inUse)
+        {
+            _glShader->incrementUsed();
         }
     }
 
     void releaseShader()
     {
+        if (_captureDeferred)
+        {
+            _renderSystem->cancelDeferredCapture(*this);
+            _captureDeferred = false;
+        }
+
         if (_glShader)
         {
 			_glShader->detachObserver(*this);
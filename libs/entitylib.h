@@ -12,6 +12,7 @@
 #include "generic/callback.h"
 #include "math/AABB.h"
 #include "scenelib.h"
+#include "string/convert.h"
 
 #include <list>
 #include <set>
@@ -492,4 +493,43 @@ inline void foreachSelectedEntity(const std::function<void(Entity&)>& functor)
     });
 }
 
+// Returns the origin of the given entity, which is 0,0,0 if the "origin" spawnarg is not set
+inline Vector3 getEntityOrigin(const Entity& entity)
+{
+    return string::convert<Vector3>(entity.getKeyValue("origin"));
+}
+
+/**
+ * Sets the "origin" spawnarg of the given entity. The worldspawn and entities
+ * whose getEntityOrigin() already matches the given value are left untouched,
+ * such that writing back unchanged origins doesn't add any spawnargs.
+ * Returns true if the spawnarg has been set.
+ */
+inline bool setEntityOrigin(Entity& entity, const Vector3& origin)
+{
+    if (entity.isWorldspawn() || getEntityOrigin(entity) == origin)
+    {
+        return false;
+    }
+
+    entity.setKeyValue("origin", string::to_string(origin));
+    return true;
+}
+
+/**
+ * Sets the given spawnarg, unless getKeyValue() already returns the given value.
+ * Writing back an unchanged (possibly inherited) value doesn't turn it into
+ * a spawnarg of the entity. Returns true if the spawnarg has been set.
+ */
+inline bool setEntityKeyValue(Entity& entity, const std::string& key, const std::string& value)
+{
+    if (entity.getKeyValue(key) == value)
+    {
+        return false;
+    }
+
+    entity.setKeyValue(key, value);
+    return true;
+}
+
 }
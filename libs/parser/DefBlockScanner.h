@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace parser
+{
+
+/**
+ * Finds the "name { ... }" blocks on the top level of the given text and
+ * returns their names along with the offset of the name's first character.
+ *
+ * This is a lightweight character-level scan, used to index large numbers of
+ * definition files without building any tokens. Comments and quoted strings
+ * are skipped the same way the DefTokeniser does, such that a DefTokeniser
+ * started at one of the returned offsets yields the block name, followed by
+ * the opening brace.
+ */
+inline std::vector<std::pair<std::string, std::size_t>> findDefBlocks(const std::string& text)
+{
+    std::vector<std::pair<std::string, std::size_t>> blocks;
+
+    std::size_t depth = 0;
+    std::size_t tokenStart = std::string::npos;
+    std::size_t tokenEnd = 0;
+
+    for (std::size_t i = 0; i < text.size(); ++i)
+    {
+        char c = text[i];
+
+        if (c == '/' && i + 1 < text.size() && text[i + 1] == '/')
+        {
+            auto eol = text.find('\n', i);
+            i = eol != std::string::npos ? eol : text.size();
+            continue;
+        }
+
+        if (c == '/' && i + 1 < text.size() && text[i + 1] == '*')
+        {
+            auto end = text.find("*/", i + 2);
+            i = end != std::string::npos ? end + 1 : text.size();
+            continue;
+        }
+
+        if (c == '"')
+        {
+            // Skip to the closing quote, a backslash escapes the next character
+            for (++i; i < text.size() && text[i] != '"'; ++i)
+            {
+                if (text[i] == '\\') ++i;
+            }
+
+            tokenStart = std::string::npos;
+            continue;
+        }
+
+        if (c == '{')
+        {
+            if (depth == 0 && tokenStart != std::string::npos)
+            {
+                blocks.emplace_back(text.substr(tokenStart, tokenEnd - tokenStart), tokenStart);
+            }
+
+            tokenStart = std::string::npos;
+            ++depth;
+            continue;
+        }
+
+        if (c == '}')
+        {
+            tokenStart = std::string::npos;
+
+            if (depth > 0) --depth;
+            continue;
+        }
+
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '(' || c == ')')
+        {
+            continue;
+        }
+
+        // Part of a regular token, remember where the last one started on the top level
+        if (depth == 0)
+        {
+            if (i == 0 || tokenEnd != i)
+            {
+                tokenStart = i;
+            }
+
+            tokenEnd = i + 1;
+        }
+    }
+
+    return blocks;
+}
+
+}
@@ -262,6 +262,10 @@ public:
 		return _vector.size();
 	}
 
+	std::size_t capacity() const {
+		return _vector.capacity();
+	}
+
 	bool empty() const {
 		return _vector.empty();
 	}
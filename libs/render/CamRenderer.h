@@ -4,7 +4,7 @@
 #include "imap.h"
 #include "ivolumetest.h"
 
-#include "VectorLightList.h"
+#include "LightInteractionCache.h"
 
 #include <map>
 
@@ -41,8 +41,10 @@ private:
 
     const HighlightShaders& _shaders;
 
-    // All lights we have received from the scene
-    std::list<const RendererLight*> _sceneLights;
+    // Light interactions of the previous frames, if the view keeps them,
+    // otherwise they are evaluated from scratch using a local cache
+    LightInteractionCache _localInteractionCache;
+    LightInteractionCache& _interactionCache;
 
     // Lit renderable provided via addRenderable(), for which we construct the
     // light list with lights received via addLight().
@@ -54,8 +56,8 @@ private:
         Matrix4 local2World;
         const IRenderEntity* entity = nullptr;
 
-        // Calculated list of intersecting lights (initially empty)
-        render::lib::VectorLightList lights;
+        // Intersecting lights, as calculated by the interaction cache
+        const LightSources* lights = nullptr;
     };
     using LitRenderables = std::vector<LitRenderable>;
 
@@ -64,34 +66,47 @@ private:
     // are submitted too.
     std::map<Shader*, LitRenderables> _litRenderables;
 
-    // Intersect all received renderables wiith lights
+    // Assign the lights intersecting each received renderable. The cache only
+    // tests the objects and lights that changed since the previous frame, and
+    // each LitObject once, no matter how many renderables it submitted.
     void calculateLightIntersections()
     {
+        _interactionCache.beginUpdate();
+
         // For each shader
         for (auto i = _litRenderables.begin(); i != _litRenderables.end(); ++i)
         {
             // For each renderable associated with this shader
             for (auto j = i->second.begin(); j != i->second.end(); ++j)
             {
-                // Test intersection between the LitObject and each light in
-                // the scene
-                for (const RendererLight* l: _sceneLights)
+                if (j->litObject)
                 {
-                    if (j->litObject && j->litObject->intersectsLight(*l))
-                        j->lights.addLight(*l);
+                    j->lights = &_interactionCache.getLights(*j->litObject);
                 }
             }
         }
+
+        _interactionCache.endUpdate();
     }
 
 public:
 
     /// Initialise CamRenderer with optional highlight shaders
     CamRenderer(const VolumeTest& view, const HighlightShaders& shaders)
+    : CamRenderer(view, shaders, nullptr)
+    {}
+
+    /// Initialise CamRenderer re-using the light interactions of the given cache,
+    /// which needs to stay alive until the frame has been rendered
+    CamRenderer(const VolumeTest& view, const HighlightShaders& shaders,
+                LightInteractionCache* interactionCache)
     : _view(view),
       _editMode(GlobalMapModule().getEditMode()),
-      _shaders(shaders)
-    {}
+      _shaders(shaders),
+      _interactionCache(interactionCache ? *interactionCache : _localInteractionCache)
+    {
+        _interactionCache.beginFrame();
+    }
 
     /**
      * \brief
@@ -121,7 +136,7 @@ public:
             {
                 const LitRenderable& lr = *j;
                 shader->addRenderable(lr.renderable, lr.local2World,
-                                      useLights ? &lr.lights : nullptr,
+                                      useLights ? lr.lights : nullptr,
                                       lr.entity);
             }
         }
@@ -133,6 +148,12 @@ public:
     /// Obtain the total light count
     int getTotalLights() const { return _totalLights; }
 
+    /// Obtain the light interaction counters of this frame
+    const LightInteractionCache::Statistics& getInteractionStatistics() const
+    {
+        return _interactionCache.getStatistics();
+    }
+
     // RenderableCollector implementation
 
     bool supportsFullMaterials() const override { return true; }
@@ -152,11 +173,12 @@ public:
     void addLight(const RendererLight& light) override
     {
         // Determine if this light is visible within the view frustum
-        VolumeIntersectionValue viv = _view.TestAABB(light.lightAABB());
+        AABB lightAABB = light.lightAABB();
+        VolumeIntersectionValue viv = _view.TestAABB(lightAABB);
         if (viv != VOLUME_OUTSIDE)
         {
             // Store the light in our list of scene lights
-            _sceneLights.push_back(&light);
+            _interactionCache.addLight(light, lightAABB);
 
             // Count the light for the stats display
             ++_visibleLights;
@@ -172,27 +194,10 @@ public:
                        const LitObject* litObject = nullptr,
                        const IRenderEntity* entity = nullptr) override
     {
-        if (_editMode == IMap::EditMode::Merge && (_flags & Highlight::Flags::MergeAction) != 0)
+        forEachHighlightShader([&](Shader& highlightShader)
         {
-            const auto& mergeShader = (_flags & Highlight::Flags::MergeActionAdd) != 0 ? _shaders.mergeActionShaderAdd :
-                (_flags & Highlight::Flags::MergeActionRemove) != 0 ? _shaders.mergeActionShaderRemove : 
-                (_flags & Highlight::Flags::MergeActionConflict) != 0 ? _shaders.mergeActionShaderConflict : _shaders.mergeActionShaderChange;
-            
-            if (mergeShader)
-            {
-                mergeShader->addRenderable(renderable, localToWorld, nullptr, entity);
-            }
-        }
-
-        if ((_flags & Highlight::Flags::Primitives) != 0 && _shaders.primitiveHighlightShader)
-        {
-            _shaders.primitiveHighlightShader->addRenderable(renderable, localToWorld, nullptr, entity);
-        }
-
-        if ((_flags & Highlight::Flags::Faces) != 0 && _shaders.faceHighlightShader)
-        {
-            _shaders.faceHighlightShader->addRenderable(renderable, localToWorld, nullptr, entity);
-        }
+            highlightShader.addRenderable(renderable, localToWorld, nullptr, entity);
+        });
 
         // Construct an entry for this shader in the map if it is the first
         // time we've seen it
@@ -217,6 +222,45 @@ public:
         LitRenderable lr { renderable, litObject, localToWorld, entity };
         iter->second.push_back(std::move(lr));
     }
+
+    void addGeometry(Shader& shader, IGeometryStore::Slot slot, GeometryType type) override
+    {
+        forEachHighlightShader([&](Shader& highlightShader)
+        {
+            highlightShader.addGeometry(slot, type);
+        });
+
+        // Geometry store slots are not lit, pass them to the shader right away
+        shader.addGeometry(slot, type);
+    }
+
+private:
+    // Invokes the functor for each highlight shader applicable to the current flags
+    template<typename Functor>
+    void forEachHighlightShader(const Functor& functor)
+    {
+        if (_editMode == IMap::EditMode::Merge && (_flags & Highlight::Flags::MergeAction) != 0)
+        {
+            const auto& mergeShader = (_flags & Highlight::Flags::MergeActionAdd) != 0 ? _shaders.mergeActionShaderAdd :
+                (_flags & Highlight::Flags::MergeActionRemove) != 0 ? _shaders.mergeActionShaderRemove : 
+                (_flags & Highlight::Flags::MergeActionConflict) != 0 ? _shaders.mergeActionShaderConflict : _shaders.mergeActionShaderChange;
+            
+            if (mergeShader)
+            {
+                functor(*mergeShader);
+            }
+        }
+
+        if ((_flags & Highlight::Flags::Primitives) != 0 && _shaders.primitiveHighlightShader)
+        {
+            functor(*_shaders.primitiveHighlightShader);
+        }
+
+        if ((_flags & Highlight::Flags::Faces) != 0 && _shaders.faceHighlightShader)
+        {
+            functor(*_shaders.faceHighlightShader);
+        }
+    }
 };
 
 
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "irender.h"
+#include "VectorLightList.h"
+
+#include <chrono>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace render
+{
+
+/**
+ * \brief
+ * Keeps the lists of lights intersecting the lit objects between frames.
+ *
+ * The lights and objects are remembered along with their bounds at the time
+ * of the last update. An object's light list is only re-evaluated when its
+ * bounds have changed, or when lights have been added, removed or changed
+ * their bounds, in which case only these lights are tested.
+ *
+ * The cache is owned by a view (e.g. the camera) and passed to the CamRenderer
+ * constructed for each frame. Objects and lights not submitted in a frame are
+ * forgotten, the cache never dereferences pointers submitted in earlier frames.
+ */
+class LightInteractionCache
+{
+public:
+    struct Statistics
+    {
+        // Number of object-light pairs in the current frame
+        std::size_t interactions = 0;
+
+        // Number of objects whose light list had to be (partially) re-evaluated
+        std::size_t rebuiltObjects = 0;
+
+        // Number of added, changed or removed lights since the previous frame
+        std::size_t changedLights = 0;
+
+        // Time spent updating the light lists
+        std::size_t updateTimeUsec = 0;
+    };
+
+private:
+    struct ObjectEntry
+    {
+        AABB bounds;
+        std::size_t frame = 0;
+        lib::VectorLightList lights;
+    };
+
+    std::unordered_map<const LitObject*, ObjectEntry> _objects;
+
+    // The lights (and their bounds) of the previous and the current frame
+    std::unordered_map<const RendererLight*, AABB> _lights;
+    std::vector<std::pair<const RendererLight*, AABB>> _frameLights;
+
+    // Lights that need to be tested against unchanged objects in this frame,
+    // and lights that need to be removed from their lists
+    std::vector<const RendererLight*> _addedLights;
+    std::unordered_set<const RendererLight*> _removedLights;
+
+    std::size_t _frame = 0;
+    bool _updating = false;
+
+    Statistics _statistics;
+    std::chrono::steady_clock::time_point _updateStart;
+
+public:
+    /// Start collecting the lights of a new frame
+    void beginFrame()
+    {
+        _frameLights.clear();
+        _updating = false;
+    }
+
+    /// Submit a light of the current frame along with its (already calculated) bounds
+    void addLight(const RendererLight& light, const AABB& lightAABB)
+    {
+        _frameLights.emplace_back(&light, lightAABB);
+    }
+
+    /**
+     * \brief
+     * Compare the submitted lights against the ones of the previous update.
+     * Must be called after all lights of the frame have been added, and
+     * before getLights() is called for the objects of the frame.
+     */
+    void beginUpdate()
+    {
+        _updateStart = std::chrono::steady_clock::now();
+        _statistics = Statistics();
+        _updating = true;
+        ++_frame;
+
+        _addedLights.clear();
+        _removedLights.clear();
+
+        std::unordered_map<const RendererLight*, AABB> lights;
+        lights.reserve(_frameLights.size());
+
+        for (const auto& pair : _frameLights)
+        {
+            if (!lights.emplace(pair.first, pair.second).second)
+            {
+                continue; // submitted twice
+            }
+
+            auto existing = _lights.find(pair.first);
+
+            if (existing == _lights.end())
+            {
+                _addedLights.push_back(pair.first);
+            }
+            else if (existing->second != pair.second)
+            {
+                // A changed light is removed from all lists and tested again
+                _removedLights.insert(pair.first);
+                _addedLights.push_back(pair.first);
+            }
+        }
+
+        for (const auto& pair : _lights)
+        {
+            if (lights.count(pair.first) == 0)
+            {
+                _removedLights.insert(pair.first);
+            }
+        }
+
+        _lights.swap(lights);
+
+        _statistics.changedLights = _addedLights.size() + _removedLights.size();
+    }
+
+    /// Return the lights intersecting the given object, which is updated if necessary
+    const LightSources& getLights(const LitObject& object)
+    {
+        auto& entry = _objects[&object];
+
+        if (entry.frame == _frame)
+        {
+            return entry.lights; // already handled in this frame
+        }
+
+        const auto& bounds = object.litObjectAABB();
+
+        if (entry.frame == 0 || entry.frame != _frame - 1 || entry.bounds != bounds)
+        {
+            // New or changed object (or not seen in the previous frame), test all lights
+            entry.bounds = bounds;
+            entry.lights.clear();
+
+            for (const auto& pair : _lights)
+            {
+                if (object.intersectsLight(*pair.first))
+                {
+                    entry.lights.addLight(*pair.first);
+                }
+            }
+
+            ++_statistics.rebuiltObjects;
+        }
+        else if (!_addedLights.empty() || !_removedLights.empty())
+        {
+            if (!_removedLights.empty())
+            {
+                entry.lights.removeLights([&](const RendererLight* light)
+                {
+                    return _removedLights.count(light) > 0;
+                });
+            }
+
+            for (auto light : _addedLights)
+            {
+                if (object.intersectsLight(*light))
+                {
+                    entry.lights.addLight(*light);
+                }
+            }
+
+            ++_statistics.rebuiltObjects;
+        }
+
+        entry.frame = _frame;
+        _statistics.interactions += entry.lights.size();
+
+        return entry.lights;
+    }
+
+    /// Forget all objects that haven't been submitted in this frame
+    void endUpdate()
+    {
+        if (!_updating) return;
+
+        for (auto i = _objects.begin(); i != _objects.end();)
+        {
+            if (i->second.frame != _frame)
+            {
+                i = _objects.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        _updating = false;
+        _statistics.updateTimeUsec = static_cast<std::size_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - _updateStart).count());
+    }
+
+    /// Return the statistics of the last update
+    const Statistics& getStatistics() const
+    {
+        return _statistics;
+    }
+};
+
+}
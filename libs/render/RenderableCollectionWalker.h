@@ -5,6 +5,7 @@
 #include "ientity.h"
 #include "ieclass.h"
 #include "iscenegraph.h"
+#include "ibrush.h"
 #include <functional>
 
 namespace render
@@ -157,6 +158,9 @@ public:
      */
     static void CollectRenderablesInScene(RenderableCollector& collector, const VolumeTest& volume)
     {
+        // Build the windings of all changed brushes at once, before the walker does it one by one
+        GlobalBrushCreator().evaluateChangedBrushes();
+
         // Instantiate a new walker class
         RenderableCollectionWalker renderHighlightWalker(collector, volume);
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "irender.h"
+#include <vector>
+#include <algorithm>
 
 namespace render
 {
@@ -35,6 +37,18 @@ public:
         _lights.clear();
     }
 
+    /// Remove all lights for which the given predicate returns true
+    template<typename Predicate>
+    void removeLights(const Predicate& predicate)
+    {
+        _lights.erase(std::remove_if(_lights.begin(), _lights.end(), predicate), _lights.end());
+    }
+
+    std::size_t size() const
+    {
+        return _lights.size();
+    }
+
     // LightSources implementation
     void forEachLight(const RendererLightCallback& callback) const override
     {
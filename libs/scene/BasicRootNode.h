@@ -7,6 +7,7 @@
 #include "iselectiongroup.h"
 #include "iselectionset.h"
 #include "Node.h"
+#include "MaterialUsageIndex.h"
 #include "inamespace.h"
 #include "UndoFileChangeTracker.h"
 #include "KeyValueStore.h"
@@ -29,6 +30,8 @@ private:
     selection::ISelectionGroupManager::Ptr _selectionGroupManager;
     selection::ISelectionSetManager::Ptr _selectionSetManager;
     ILayerManager::Ptr _layerManager;
+    MaterialUsageIndex _materialUsageIndex;
+    sigc::signal<void, const INodePtr&> _sigNodeChanged;
     AABB _emptyAABB;
 
 public:
@@ -79,6 +82,16 @@ public:
         return *_layerManager;
     }
 
+    IMaterialUsageIndex& getMaterialUsageIndex() override
+    {
+        return _materialUsageIndex;
+    }
+
+    sigc::signal<void, const INodePtr&>& signal_nodeChanged() override
+    {
+        return _sigNodeChanged;
+    }
+
     const AABB& localAABB() const override
     {
         return _emptyAABB;
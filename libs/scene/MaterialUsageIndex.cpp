@@ -0,0 +1,94 @@
+#include "MaterialUsageIndex.h"
+
+#include <vector>
+
+namespace scene
+{
+
+void MaterialUsageIndex::addUsage(const std::string& material, const MaterialUsage& usage)
+{
+    auto& usages = _materials[material];
+
+    if (usage.isFace())
+    {
+        usages.faces.emplace(usage.face, usage.node);
+    }
+    else
+    {
+        usages.patches.insert(usage.node);
+    }
+}
+
+void MaterialUsageIndex::removeUsage(const std::string& material, const MaterialUsage& usage)
+{
+    auto found = _materials.find(material);
+
+    if (found == _materials.end()) return;
+
+    if (usage.isFace())
+    {
+        found->second.faces.erase(usage.face);
+    }
+    else
+    {
+        found->second.patches.erase(usage.node);
+    }
+
+    if (found->second.faces.empty() && found->second.patches.empty())
+    {
+        _materials.erase(found);
+    }
+}
+
+std::size_t MaterialUsageIndex::getFaceCount(const std::string& material) const
+{
+    auto found = _materials.find(material);
+    return found != _materials.end() ? found->second.faces.size() : 0;
+}
+
+std::size_t MaterialUsageIndex::getPatchCount(const std::string& material) const
+{
+    auto found = _materials.find(material);
+    return found != _materials.end() ? found->second.patches.size() : 0;
+}
+
+void MaterialUsageIndex::foreachMaterial(const MaterialVisitor& visitor) const
+{
+    for (const auto& [material, usages] : _materials)
+    {
+        visitor(material, usages.faces.size(), usages.patches.size());
+    }
+}
+
+bool MaterialUsageIndex::foreachUsage(const std::string& material, const std::function<bool(const MaterialUsage&)>& functor) const
+{
+    auto found = _materials.find(material);
+
+    if (found == _materials.end()) return true;
+
+    // Copy the usages, the functor might change the materials
+    std::vector<MaterialUsage> usages;
+    usages.reserve(found->second.faces.size() + found->second.patches.size());
+
+    for (const auto& [face, node] : found->second.faces)
+    {
+        usages.push_back(MaterialUsage{ node, face });
+    }
+
+    for (auto node : found->second.patches)
+    {
+        usages.push_back(MaterialUsage{ node, nullptr });
+    }
+
+    for (const auto& usage : usages)
+    {
+        if (!functor(usage))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include "imaterialusageindex.h"
+#include "string/string.h"
+
+namespace scene
+{
+
+/**
+ * Default implementation of the material usage index, as owned by the
+ * map root nodes.
+ */
+class MaterialUsageIndex :
+    public IMaterialUsageIndex
+{
+private:
+    struct Usages
+    {
+        // Faces mapped to their brush node
+        std::unordered_map<IFace*, INode*> faces;
+        std::unordered_set<INode*> patches;
+    };
+
+    // The key is the material name as it has been used first
+    std::map<std::string, Usages, string::ILess> _materials;
+
+public:
+    void addUsage(const std::string& material, const MaterialUsage& usage) override;
+    void removeUsage(const std::string& material, const MaterialUsage& usage) override;
+
+    std::size_t getFaceCount(const std::string& material) const override;
+    std::size_t getPatchCount(const std::string& material) const override;
+
+    void foreachMaterial(const MaterialVisitor& visitor) const override;
+    bool foreachUsage(const std::string& material, const std::function<bool(const MaterialUsage&)>& functor) const override;
+};
+
+}
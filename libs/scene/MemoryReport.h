@@ -0,0 +1,137 @@
+#pragma once
+
+#include <map>
+#include <sstream>
+#include <iomanip>
+#include "inode.h"
+#include "ibrush.h"
+#include "imemoryaccountable.h"
+#include "debugging/ScenegraphUtils.h"
+
+namespace scene
+{
+
+/**
+ * Traverses the given subgraph on construction, summing up the memory
+ * used by the nodes of each type (entities, brushes, patches, ...).
+ * The numbers are approximations based on the object sizes and the
+ * capacity of their containers, they are meant to compare the memory
+ * requirements of the primitive types and their changes over time.
+ */
+class MemoryReport :
+	public NodeVisitor
+{
+public:
+	struct Usage
+	{
+		std::size_t count = 0;
+		std::size_t bytes = 0;
+	};
+
+	typedef std::map<INode::Type, Usage> Map;
+
+private:
+	Map _map;
+
+	// Brush details, their memory is part of the brush usage
+	std::size_t _numFaces;
+	std::size_t _numWindingVertices;
+
+public:
+	MemoryReport(const INodePtr& root) :
+		_numFaces(0),
+		_numWindingVertices(0)
+	{
+		if (root)
+		{
+			root->traverseChildren(*this);
+		}
+	}
+
+	bool pre(const INodePtr& node) override
+	{
+		auto& usage = _map[node->getNodeType()];
+
+		usage.count++;
+
+		auto accountable = std::dynamic_pointer_cast<IMemoryAccountable>(node);
+
+		if (accountable)
+		{
+			usage.bytes += accountable->getMemoryUsage();
+		}
+
+		if (Node_isBrush(node))
+		{
+			const auto& brush = *Node_getIBrush(node);
+
+			_numFaces += brush.getNumFaces();
+
+			for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+			{
+				_numWindingVertices += brush.getFace(i).getWinding().size();
+			}
+		}
+
+		return true;
+	}
+
+	const Map& getMap() const
+	{
+		return _map;
+	}
+
+	// Returns the usage of the given node type (zero if there are no such nodes)
+	Usage getUsage(INode::Type type) const
+	{
+		auto found = _map.find(type);
+		return found != _map.end() ? found->second : Usage();
+	}
+
+	std::size_t getTotalBytes() const
+	{
+		std::size_t total = 0;
+
+		for (const auto& pair : _map)
+		{
+			total += pair.second.bytes;
+		}
+
+		return total;
+	}
+
+	std::size_t getNumFaces() const
+	{
+		return _numFaces;
+	}
+
+	std::size_t getNumWindingVertices() const
+	{
+		return _numWindingVertices;
+	}
+
+	// Returns the report as human-readable table
+	std::string toString() const
+	{
+		std::ostringstream stream;
+
+		stream << std::left << std::setw(20) << "Type" << std::right
+			<< std::setw(12) << "Count" << std::setw(16) << "Bytes" << std::setw(12) << "Bytes/Node" << std::endl;
+
+		for (const auto& pair : _map)
+		{
+			stream << std::left << std::setw(20) << getNameForNodeType(pair.first) << std::right
+				<< std::setw(12) << pair.second.count << std::setw(16) << pair.second.bytes
+				<< std::setw(12) << (pair.second.count > 0 ? pair.second.bytes / pair.second.count : 0) << std::endl;
+		}
+
+		stream << std::left << std::setw(20) << "Total" << std::right
+			<< std::setw(12) << "" << std::setw(16) << getTotalBytes() << std::endl;
+
+		stream << "Brush faces: " << _numFaces << ", winding vertices: " << _numWindingVertices << std::endl;
+
+		return stream.str();
+	}
+};
+
+}
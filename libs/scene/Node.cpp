@@ -2,6 +2,7 @@
 
 #include "itransformnode.h"
 #include "iscenegraph.h"
+#include "imap.h"
 #include "debugging/debugging.h"
 #include "InstanceWalkers.h"
 #include "AABBAccumulateWalker.h"
@@ -23,6 +24,7 @@ Node::Node() :
 	_local2world(Matrix4::getIdentity()),
 	_instantiated(false),
 	_forceVisible(false),
+	_changeTracker(*this),
     _renderEntity(nullptr)
 {
 	// Each node is part of layer 0 by default
@@ -43,6 +45,7 @@ Node::Node(const Node& other) :
 	_instantiated(false),
 	_forceVisible(false),
 	_layers(other._layers),
+	_changeTracker(*this),
     _renderEntity(other._renderEntity)
 {}
 
@@ -293,6 +296,25 @@ void Node::disconnectUndoSystem(IMapFileChangeTracker& changeTracker)
     _children.disconnectUndoSystem(changeTracker);
 }
 
+IMapFileChangeTracker& Node::getChangeTracker(IMapRootNode& root)
+{
+    _changeTracker.setMapTracker(root.getUndoChangeTracker(), root.signal_nodeChanged());
+    return _changeTracker;
+}
+
+void Node::reportChange()
+{
+    if (inScene())
+    {
+        _changeTracker.reportChange();
+    }
+}
+
+std::size_t Node::getChangeRevision() const
+{
+    return _changeTracker.getRevision();
+}
+
 TraversableNodeSet& Node::getTraversable() {
 	return _children;
 }
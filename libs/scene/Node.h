@@ -3,7 +3,9 @@
 #include "inode.h"
 #include "ipath.h"
 #include "irender.h"
+#include "mapfile.h"
 #include <list>
+#include <sigc++/signal.h>
 #include "TraversableNodeSet.h"
 #include "math/AABB.h"
 #include "math/Matrix4.h"
@@ -63,6 +65,70 @@ private:
 	// The list of layers this object is associated to
 	LayerList _layers;
 
+	// Change tracker handed to this node's undoables, forwarding
+	// to the map's tracker while counting the changes of this node
+	class ChangeTracker :
+		public IMapFileChangeTracker
+	{
+	private:
+		Node& _owner;
+		IMapFileChangeTracker* _mapTracker = nullptr;
+		sigc::signal<void, const INodePtr&>* _nodeChangedSignal = nullptr;
+		std::size_t _revision = 0;
+
+	public:
+		ChangeTracker(Node& owner) :
+			_owner(owner)
+		{}
+
+		void setMapTracker(IMapFileChangeTracker& mapTracker, sigc::signal<void, const INodePtr&>& nodeChangedSignal)
+		{
+			_mapTracker = &mapTracker;
+			_nodeChangedSignal = &nodeChangedSignal;
+		}
+
+		std::size_t getRevision() const
+		{
+			return _revision;
+		}
+
+		void save() override
+		{
+			if (_mapTracker) _mapTracker->save();
+		}
+
+		bool saved() const override
+		{
+			return _mapTracker ? _mapTracker->saved() : true;
+		}
+
+		void changed() override
+		{
+			++_revision;
+			if (_mapTracker) _mapTracker->changed();
+			if (_nodeChangedSignal) _nodeChangedSignal->emit(_owner.getSelf());
+		}
+
+		// Emits the node changed signal without counting the change,
+		// for changes not recorded by the undo system
+		void reportChange()
+		{
+			if (_nodeChangedSignal) _nodeChangedSignal->emit(_owner.getSelf());
+		}
+
+		void setChangedCallback(const std::function<void()>& changed) override
+		{
+			if (_mapTracker) _mapTracker->setChangedCallback(changed);
+		}
+
+		std::size_t changes() const override
+		{
+			return _mapTracker ? _mapTracker->changes() : 0;
+		}
+	};
+
+	ChangeTracker _changeTracker;
+
 protected:
 	// If this node is attached to a parent entity, this is the reference to it
     IRenderEntity* _renderEntity;
@@ -188,6 +254,8 @@ public:
 		_renderEntity = entity;
 	}
 
+	std::size_t getChangeRevision() const override;
+
 	// Base renderable implementation
 	virtual RenderSystemPtr getRenderSystem() const;
 	virtual void setRenderSystem(const RenderSystemPtr& renderSystem) override;
@@ -207,6 +275,16 @@ protected:
     virtual void connectUndoSystem(IMapFileChangeTracker& changeTracker);
     virtual void disconnectUndoSystem(IMapFileChangeTracker& changeTracker);
 
+	// Returns the change tracker subclasses should pass to the undoables of this node,
+	// such that changes are counted in this node's change revision and reported
+	// through the root's node changed signal.
+	IMapFileChangeTracker& getChangeTracker(IMapRootNode& root);
+
+	// Reports a change of this node through the root's node changed signal. Subclasses
+	// call this for changes which might happen outside an undoable operation, these
+	// don't reach the change tracker. Has no effect while the node is not in the scene.
+	void reportChange();
+
 	// Clears the TraversableNodeSet
 	virtual void removeAllChildNodes();
 
@@ -28,7 +28,7 @@ SelectableNode::~SelectableNode()
 
 void SelectableNode::onInsertIntoScene(IMapRootNode& root)
 {
-	connectUndoSystem(root.getUndoChangeTracker());
+	connectUndoSystem(getChangeTracker(root));
 
 	Node::onInsertIntoScene(root);
 
@@ -51,7 +51,7 @@ void SelectableNode::onRemoveFromScene(IMapRootNode& root)
 {
 	setSelected(false);
 
-	disconnectUndoSystem(root.getUndoChangeTracker());
+	disconnectUndoSystem(getChangeTracker(root));
 
 	// When a node is removed from the scene with a non-empty group assignment
 	// we do notify the SelectionGroup to remove ourselves, but we keep the ID list
@@ -2,19 +2,18 @@
 
 #include <map>
 #include <string>
-#include "ipatch.h"
-#include "ibrush.h"
+#include "imap.h"
 #include "iscenegraph.h"
 
 namespace scene
 {
 
 /**
- * greebo: This object traverses the scenegraph on construction
- * counting all occurrences of each shader.
+ * greebo: This object collects the number of faces and patches using each
+ * shader on construction. The counts are taken from the material usage
+ * index of the current map, no scene traversal is necessary.
  */
-class ShaderBreakdown :
-	public scene::NodeVisitor
+class ShaderBreakdown
 {
 public:
 	struct ShaderCount
@@ -37,31 +36,18 @@ public:
 	ShaderBreakdown()
 	{
 		_map.clear();
-		GlobalSceneGraph().root()->traverseChildren(*this);
-	}
-
-	bool pre(const scene::INodePtr& node) override
-	{
-		// Check if this node is a patch
-		if (Node_isPatch(node))
-		{
-			increaseShaderCount(Node_getIPatch(node)->getShader(), false);
-			return false;
-		}
 
-		if (Node_isBrush(node))
-        {
-			auto brush = Node_getIBrush(node);
-			
-			for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
-            {
-                increaseShaderCount(brush->getFace(i).getShader(), true);
-            }
+		const auto& root = GlobalSceneGraph().root();
 
-			return false;
-		}
+		if (!root) return;
 
-		return true;
+		root->getMaterialUsageIndex().foreachMaterial(
+			[&](const std::string& material, std::size_t faceCount, std::size_t patchCount)
+		{
+			auto& count = _map[material];
+			count.faceCount = faceCount;
+			count.patchCount = patchCount;
+		});
 	}
 
 	// Accessor method to retrieve the shader breakdown map
@@ -79,33 +65,6 @@ public:
 	{
 		return _map.end();
 	}
-
-private:
-	// Local helper to increase the shader occurrence count
-	void increaseShaderCount(const std::string& shaderName, bool isFace)
-	{
-		// Try to look up the shader in the map
-		auto found = _map.find(shaderName);
-
-		if (found == _map.end())
-		{
-			// Shader not yet registered, create new entry
-			auto result = _map.emplace(shaderName, ShaderCount());
-
-			found = result.first;
-		}
-
-		// Iterator is valid at this point, increase the counter
-		if (isFace)
-		{
-			found->second.faceCount++;
-		}
-		else
-		{
-			found->second.patchCount++;
-		}
-	}
-
 }; // class ShaderBreakdown
 
 } // namespace
@@ -7,6 +7,8 @@
 #include "iundo.h"
 #include "ipatch.h"
 #include "iselection.h"
+#include "imap.h"
+#include "iscenegraph.h"
 #include "scene/Traverse.h"
 #include "gamelib.h"
 
@@ -110,10 +112,27 @@ inline int findAndReplaceShader(const std::string& find, const std::string& repl
 			GlobalSelectionSystem().foreachPatch(std::ref(replacer));
 		}
 	}
-	else
+	else if (GlobalSceneGraph().root())
 	{
-		scene::foreachVisibleFace(std::ref(replacer));
-		scene::foreachVisiblePatch(std::ref(replacer));
+		// Only the visible surfaces using the material need to be visited
+		GlobalSceneGraph().root()->getMaterialUsageIndex().foreachUsage(find, [&](const MaterialUsage& usage)
+		{
+			if (!usage.node->visible()) return true;
+
+			if (usage.isFace())
+			{
+				if (usage.face->isVisible())
+				{
+					replacer(*usage.face);
+				}
+			}
+			else if (auto patchNode = dynamic_cast<IPatchNode*>(usage.node); patchNode)
+			{
+				replacer(patchNode->getPatch());
+			}
+
+			return true;
+		});
 	}
 
 	return replacer.getReplacedCount();
@@ -5,7 +5,9 @@
 
 #include "idatastream.h"
 #include <ostream>
+#include <istream>
 #include <algorithm>
+#include <charconv>
 
 namespace stream
 {
@@ -59,6 +61,23 @@ inline ValueType readLittleEndian(InputStream& stream)
 	return value;
 }
 
+/**
+ * Read a number type stored in little endian format from the given
+ * std::istream. Check the stream state to detect read failures.
+ */
+template<typename ValueType>
+inline ValueType readLittleEndian(std::istream& stream)
+{
+	ValueType value = ValueType();
+	stream.read(reinterpret_cast<char*>(&value), sizeof(ValueType));
+
+#ifdef __BIG_ENDIAN__
+	std::reverse(reinterpret_cast<char*>(&value), reinterpret_cast<char*>(&value) + sizeof(ValueType));
+#endif
+
+	return value;
+}
+
 inline void readByte(InputStream& stream, InputStream::byte_type& value)
 {
 	stream.read(&value, 1);
@@ -72,4 +91,38 @@ inline InputStream::byte_type readByte(InputStream& stream)
 	return value;
 }
 
+/**
+ * Writes the given floating point value to the stream, producing the same
+ * characters as "stream << value", respecting the stream's precision.
+ *
+ * Where available, the text is produced by std::to_chars, which is
+ * considerably faster than the locale-aware number formatting of the
+ * iostreams. Streams with non-default float formatting flags are
+ * passed on to operator<<.
+ */
+inline void writeDouble(std::ostream& stream, double value)
+{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+	constexpr auto nonDefaultFlags = std::ios_base::floatfield | std::ios_base::showpoint |
+		std::ios_base::showpos | std::ios_base::uppercase;
+
+	if ((stream.flags() & nonDefaultFlags) == 0 && stream.width() == 0)
+	{
+		char buffer[64];
+
+		// The default floatfield corresponds to printf's %.*g
+		auto result = std::to_chars(buffer, buffer + sizeof(buffer), value,
+			std::chars_format::general, static_cast<int>(stream.precision()));
+
+		if (result.ec == std::errc())
+		{
+			stream.write(buffer, result.ptr - buffer);
+			return;
+		}
+	}
+#endif
+
+	stream << value;
+}
+
 }
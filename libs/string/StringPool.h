@@ -0,0 +1,76 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace string
+{
+
+// Returns the number of bytes the given string allocated on the heap,
+// short strings are stored inline without any allocation
+inline std::size_t getHeapMemoryUsage(const std::string& str)
+{
+    auto object = reinterpret_cast<const char*>(&str);
+
+    if (str.data() >= object && str.data() < object + sizeof(std::string))
+    {
+        return 0;
+    }
+
+    return str.capacity() + 1;
+}
+
+/**
+ * A set of interned strings. Equal strings passed to intern() are
+ * resolved to the same pooled instance, which stays valid for the
+ * lifetime of the pool. Strings are never removed again, which makes
+ * this suitable for string sets of limited size which are referenced
+ * by a large number of objects, like the material names of the brush
+ * faces in a map.
+ *
+ * Comparison is case-sensitive, such that the original spelling is kept.
+ * The pool is safe to use from multiple threads.
+ */
+class StringPool
+{
+private:
+    // Node-based container, references to the elements stay valid
+    std::unordered_set<std::string> _strings;
+
+    mutable std::mutex _lock;
+
+public:
+    // Returns the pooled instance of the given string, adding it if necessary
+    const std::string& intern(const std::string& str)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        return *_strings.insert(str).first;
+    }
+
+    // The number of distinct strings in this pool
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _strings.size();
+    }
+
+    // Approximate number of bytes allocated by this pool
+    std::size_t getMemoryUsage() const
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        // Each element lives in its own hash node (next pointer plus cached hash)
+        auto bytes = sizeof(*this) + _strings.bucket_count() * sizeof(void*);
+
+        for (const auto& str : _strings)
+        {
+            bytes += sizeof(void*) + sizeof(std::size_t) + sizeof(std::string);
+            bytes += getHeapMemoryUsage(str);
+        }
+
+        return bytes;
+    }
+};
+
+}
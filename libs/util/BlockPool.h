@@ -0,0 +1,214 @@
+#pragma once
+
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+
+namespace util
+{
+
+/// Allocation counters summed over all block pools of a module
+struct BlockPoolStatistics
+{
+    // Number of blocks handed out so far
+    std::size_t allocations = 0;
+
+    // Number of blocks currently in use
+    std::size_t liveBlocks = 0;
+
+    // Number of chunks and their total size
+    std::size_t chunks = 0;
+    std::size_t reservedBytes = 0;
+};
+
+namespace detail
+{
+
+struct BlockPoolCounters
+{
+    std::atomic<std::size_t> allocations{ 0 };
+    std::atomic<std::size_t> liveBlocks{ 0 };
+    std::atomic<std::size_t> chunks{ 0 };
+    std::atomic<std::size_t> reservedBytes{ 0 };
+
+    static BlockPoolCounters& Instance()
+    {
+        static BlockPoolCounters _instance;
+        return _instance;
+    }
+};
+
+}
+
+/// Returns the current counters of the block pools in this module
+inline BlockPoolStatistics getBlockPoolStatistics()
+{
+    auto& counters = detail::BlockPoolCounters::Instance();
+
+    BlockPoolStatistics statistics;
+    statistics.allocations = counters.allocations;
+    statistics.liveBlocks = counters.liveBlocks;
+    statistics.chunks = counters.chunks;
+    statistics.reservedBytes = counters.reservedBytes;
+
+    return statistics;
+}
+
+/**
+ * \brief
+ * Hands out memory blocks of a fixed size, carved from larger chunks.
+ *
+ * Objects of the same size end up next to each other, instead of being
+ * scattered across the heap by millions of small allocations. Released blocks
+ * are put on a free list and handed out again by the next allocations, e.g.
+ * when the next map is loaded. The chunks are kept for the lifetime of the
+ * process, the pool instances are never destroyed, since blocks might still be
+ * released during static destruction.
+ *
+ * There is one pool per block size and alignment, shared by all types of
+ * that size. Allocations are guarded by a mutex, since nodes are created in
+ * worker threads as well.
+ */
+template<std::size_t BlockSize, std::size_t Alignment>
+class BlockPool
+{
+private:
+    static_assert(Alignment <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // Blocks are large enough to hold the free list pointer and keep their alignment
+    static constexpr std::size_t Stride =
+        (std::max(BlockSize, sizeof(FreeBlock)) + Alignment - 1) / Alignment * Alignment;
+
+    // Aim for 64k chunks, small ones for very large blocks
+    static constexpr std::size_t BlocksPerChunk = std::max<std::size_t>(65536 / Stride, 16);
+
+    std::mutex _lock;
+    FreeBlock* _freeList;
+
+    BlockPool() :
+        _freeList(nullptr)
+    {}
+
+public:
+    static BlockPool& Instance()
+    {
+        static auto* _instance = new BlockPool;
+        return *_instance;
+    }
+
+    void* allocate()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (!_freeList)
+        {
+            addChunk();
+        }
+
+        auto block = _freeList;
+        _freeList = block->next;
+
+        auto& counters = detail::BlockPoolCounters::Instance();
+        ++counters.allocations;
+        ++counters.liveBlocks;
+
+        return block;
+    }
+
+    void deallocate(void* pointer) noexcept
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _freeList = new (pointer) FreeBlock{ _freeList };
+
+        --detail::BlockPoolCounters::Instance().liveBlocks;
+    }
+
+private:
+    void addChunk()
+    {
+        auto chunk = static_cast<unsigned char*>(::operator new(Stride * BlocksPerChunk));
+
+        // Link the blocks such that they are handed out in address order
+        for (auto i = BlocksPerChunk; i-- > 0;)
+        {
+            _freeList = new (chunk + i * Stride) FreeBlock{ _freeList };
+        }
+
+        auto& counters = detail::BlockPoolCounters::Instance();
+        ++counters.chunks;
+        counters.reservedBytes += Stride * BlocksPerChunk;
+    }
+};
+
+/**
+ * \brief
+ * Allocator taking single objects from the BlockPool of their size, to be
+ * used with std::allocate_shared. The shared_ptr control block is allocated
+ * along with the object, the allocator is rebound to the combined type.
+ * Array allocations are passed on to std::allocator.
+ */
+template<typename T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+
+    PoolAllocator() noexcept
+    {}
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        if (n != 1)
+        {
+            return std::allocator<T>().allocate(n);
+        }
+
+        return static_cast<T*>(BlockPool<sizeof(T), alignof(T)>::Instance().allocate());
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept
+    {
+        if (n != 1)
+        {
+            std::allocator<T>().deallocate(pointer, n);
+            return;
+        }
+
+        BlockPool<sizeof(T), alignof(T)>::Instance().deallocate(pointer);
+    }
+};
+
+template<typename T, typename U>
+inline bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&)
+{
+    return true;
+}
+
+template<typename T, typename U>
+inline bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&)
+{
+    return false;
+}
+
+/// Creates a shared object whose memory (including the control block) is taken from a BlockPool
+template<typename T, typename... Args>
+inline std::shared_ptr<T> makePooledShared(Args&&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+}
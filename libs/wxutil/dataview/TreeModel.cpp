@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <unordered_set>
 
 namespace wxutil
 {
@@ -225,6 +226,32 @@ int TreeModel::RemoveItems(const std::function<bool (const TreeModel::Row&)>& pr
 	return RemoveItemsRecursively(GetRoot(), predicate);
 }
 
+int TreeModel::RemoveItems(const wxDataViewItem& parent, const wxDataViewItemArray& items)
+{
+	if (items.IsEmpty()) return 0;
+
+	Node* parentNode = !parent.IsOk() ? _rootNode.get() : static_cast<Node*>(parent.GetID());
+
+	std::unordered_set<void*> itemsToDelete;
+
+	for (const wxDataViewItem& item : items)
+	{
+		itemsToDelete.insert(item.GetID());
+	}
+
+	// Notify the control before the nodes are actually deleted, see RemoveItemsRecursively
+	ItemsDeleted(parent, items);
+
+	auto numChildren = parentNode->children.size();
+
+	// Single pass through the children instead of searching each item
+	parentNode->children.erase(std::remove_if(parentNode->children.begin(), parentNode->children.end(),
+		[&](const NodePtr& child) { return itemsToDelete.count(child->item.GetID()) > 0; }),
+		parentNode->children.end());
+
+	return static_cast<int>(numChildren - parentNode->children.size());
+}
+
 int TreeModel::RemoveItemsRecursively(const wxDataViewItem& parent, const std::function<bool (const TreeModel::Row&)>& predicate)
 {
 	Node* parentNode = !parent.IsOk() ? _rootNode.get() : static_cast<Node*>(parent.GetID());
@@ -416,6 +416,10 @@ public:
 	// Remove all items matching the predicate, returns the number of deleted items
 	virtual int RemoveItems(const std::function<bool (const Row&)>& predicate);
 
+	// Removes the given children of the given parent item in one go, sending a single
+	// notification. Returns the number of deleted items.
+	virtual int RemoveItems(const wxDataViewItem& parent, const wxDataViewItemArray& items);
+
 	// Returns a Row reference to the topmost element
 	virtual Row GetRootItem();
 
@@ -0,0 +1,217 @@
+#include "XDataIndex.h"
+
+#include <iterator>
+#include "iarchive.h"
+#include "os/path.h"
+#include "parser/DefBlockScanner.h"
+
+namespace XData
+{
+
+XDataIndex::XDataIndex() :
+	_scanner([this]()
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		refresh();
+	})
+{}
+
+XDataIndex& XDataIndex::Instance()
+{
+	static XDataIndex _instance;
+	return _instance;
+}
+
+void XDataIndex::startScan()
+{
+	_scanner.start();
+}
+
+void XDataIndex::clear()
+{
+	_scanner.reset();
+
+	std::lock_guard<std::mutex> lock(_lock);
+
+	_files.clear();
+	_definitions.clear();
+	_fileSet.clear();
+	_duplicatedDefs.clear();
+}
+
+void XDataIndex::getInfo(StringVectorMap& definitions, StringSet& fileSet, StringVectorMap& duplicatedDefs)
+{
+	// Wait for the initial scan (or run it right now if it hasn't been started)
+	_scanner.ensureFinished();
+
+	std::lock_guard<std::mutex> lock(_lock);
+
+	refresh();
+
+	definitions = _definitions;
+	fileSet = _fileSet;
+	duplicatedDefs = _duplicatedDefs;
+}
+
+std::size_t XDataIndex::getOffset(const std::string& definitionName, const std::string& filename)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	auto found = _files.find(filename);
+
+	if (found == _files.end())
+	{
+		return 0;
+	}
+
+	// The file might have been written since the last refresh
+	auto stamp = getStamp(GlobalFileSystem().getFileInfo(filename));
+
+	if (!(stamp == found->second.stamp))
+	{
+		found->second.stamp = stamp;
+		scanFile(filename, found->second);
+		rebuildMaps();
+	}
+
+	for (const auto& pair : found->second.definitions)
+	{
+		if (pair.first == definitionName)
+		{
+			return pair.second;
+		}
+	}
+
+	return 0;
+}
+
+void XDataIndex::refresh()
+{
+	std::map<std::string, FileEntry> files;
+	bool changed = false;
+
+	GlobalFileSystem().forEachFile(
+		XDATA_DIR, XDATA_EXT,
+		[&](const vfs::FileInfo& fileInfo)
+		{
+			auto filename = XDATA_DIR + fileInfo.name;
+			auto stamp = getStamp(fileInfo);
+
+			auto existing = _files.find(filename);
+
+			// Re-use the information of unchanged files
+			if (existing != _files.end() && existing->second.stamp == stamp)
+			{
+				files.emplace(filename, std::move(existing->second));
+				return;
+			}
+
+			auto& entry = files[filename];
+			entry.stamp = stamp;
+			scanFile(filename, entry);
+
+			changed = true;
+		},
+		99
+	);
+
+	// Any remaining file that hasn't been moved over has been removed
+	if (files.size() != _files.size())
+	{
+		changed = true;
+	}
+
+	_files.swap(files);
+
+	if (changed)
+	{
+		rebuildMaps();
+	}
+}
+
+void XDataIndex::rebuildMaps()
+{
+	_definitions.clear();
+	_fileSet.clear();
+	_duplicatedDefs.clear();
+
+	for (const auto& file : _files)
+	{
+		if (!file.second.modPath.empty())
+		{
+			_fileSet.insert(file.second.modPath);
+		}
+
+		for (const auto& definition : file.second.definitions)
+		{
+			auto result = _definitions.emplace(definition.first, StringList(1, file.first));
+
+			if (result.second) continue;
+
+			// Definition already exists
+			result.first->second.push_back(file.first);
+
+			auto& duplicates = _duplicatedDefs[definition.first];
+
+			if (duplicates.empty())
+			{
+				duplicates.push_back(result.first->second.front());
+			}
+
+			duplicates.push_back(file.first);
+		}
+	}
+
+	for (const auto& pair : _duplicatedDefs)
+	{
+		rWarning() << "[XDataIndex] The definition " << pair.first << " is defined in "
+			<< pair.second.size() << " files, first in " << pair.second.front() << std::endl;
+	}
+}
+
+XDataIndex::FileStamp XDataIndex::getStamp(const vfs::FileInfo& fileInfo)
+{
+	FileStamp stamp;
+
+	stamp.archivePath = fileInfo.getArchivePath();
+	stamp.size = fileInfo.getSize();
+
+	// Physical files carry their own time, files in PK4s use the archive's
+	auto path = fileInfo.getIsPhysicalFile() ?
+		os::standardPathWithSlash(stamp.archivePath) + fileInfo.fullPath() : stamp.archivePath;
+
+	try
+	{
+		stamp.modificationTime = fs::last_write_time(path);
+	}
+	catch (const fs::filesystem_error&)
+	{
+		// Leave the time at its default, the size is still compared
+	}
+
+	return stamp;
+}
+
+void XDataIndex::scanFile(const std::string& filename, FileEntry& entry)
+{
+	entry.modPath.clear();
+	entry.definitions.clear();
+
+	auto file = GlobalFileSystem().openTextFile(filename);
+
+	if (!file)
+	{
+		rError() << "[XDataIndex] Unable to open " << filename << std::endl;
+		return;
+	}
+
+	entry.modPath = file->getModName() + "/" + file->getName();
+
+	std::istream stream(&(file->getInputStream()));
+	std::string text((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	// Lightweight scan for the "name {" patterns on the top level
+	entry.definitions = parser::findDefBlocks(text);
+}
+
+} // namespace XData
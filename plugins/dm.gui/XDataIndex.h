@@ -0,0 +1,92 @@
+#pragma once
+
+#include <mutex>
+#include "os/fs.h"
+#include "ThreadedDefLoader.h"
+#include "XDataLoader.h"
+
+namespace XData
+{
+
+/**
+ * Keeps track of the names and locations of all XData definitions in the VFS,
+ * such that the XDataLoader doesn't need to tokenise every .xd file to find
+ * a single definition.
+ *
+ * The index is built once in a worker thread (started by the GUI module) and
+ * kept up to date by comparing the size and modification time of the .xd files
+ * (or their containing PK4) each time the information is requested. Only
+ * changed files are scanned again.
+ */
+class XDataIndex
+{
+private:
+	struct FileStamp
+	{
+		std::string archivePath;
+		std::size_t size = 0;
+		fs::file_time_type modificationTime;
+
+		bool operator==(const FileStamp& other) const
+		{
+			return size == other.size && modificationTime == other.modificationTime &&
+				archivePath == other.archivePath;
+		}
+	};
+
+	struct FileEntry
+	{
+		FileStamp stamp;
+
+		// The name of the file including the mod path
+		std::string modPath;
+
+		// Definition names and the offsets of their first character in the file
+		std::vector<std::pair<std::string, std::size_t>> definitions;
+	};
+
+	// All .xd files, keyed by their VFS path (including the xdata/ folder)
+	std::map<std::string, FileEntry> _files;
+
+	// Information derived from the _files map
+	StringVectorMap _definitions;
+	StringSet _fileSet;
+	StringVectorMap _duplicatedDefs;
+
+	std::mutex _lock;
+
+	util::ThreadedDefLoader<void> _scanner;
+
+public:
+	XDataIndex();
+
+	static XDataIndex& Instance();
+
+	// Starts building the index in a worker thread
+	void startScan();
+
+	// Waits for the worker thread and discards all information
+	void clear();
+
+	// Brings the index up to date and copies the name => files map, the mod paths of
+	// all .xd files and the map of duplicated definitions to the given containers
+	void getInfo(StringVectorMap& definitions, StringSet& fileSet, StringVectorMap& duplicatedDefs);
+
+	// Returns the offset of the given definition in the given file (VFS path)
+	// or 0 if the definition is not indexed. Rescans the file if it has changed.
+	std::size_t getOffset(const std::string& definitionName, const std::string& filename);
+
+private:
+	// Rescans all changed files, must be called with the lock held
+	void refresh();
+
+	// Rebuilds _definitions, _fileSet and _duplicatedDefs
+	void rebuildMaps();
+
+	static FileStamp getStamp(const vfs::FileInfo& fileInfo);
+
+	// Finds the definition names and offsets in the given file
+	static void scanFile(const std::string& filename, FileEntry& entry);
+};
+
+} // namespace XData
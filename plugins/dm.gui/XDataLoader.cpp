@@ -1,4 +1,5 @@
 #include "XDataLoader.h"
+#include "XDataIndex.h"
 
 #include "string/convert.h"
 #include "iarchive.h"
@@ -43,6 +44,10 @@ const bool XDataLoader::importDef( const std::string& definitionName, XDataMap&
 		if (file == NULL)
 			return reportError("[XDataLoader::importDef] Error: Failed to open file " + files[n] + "\n");
 		std::istream is(&(file->getInputStream()));
+
+		// Skip everything in front of the definition without tokenising it
+		is.ignore(XDataIndex::Instance().getOffset(definitionName, files[n]));
+
 		parser::BasicDefTokeniser<std::istream> tok(is);
 
 		// Parse the desired definition:
@@ -498,8 +503,10 @@ const bool XDataLoader::recursiveImport( const std::string& sourceDef, const Str
 				+ ". Found an import-statement, but failed to open the corresponding file: " + it->second[k] + ".\n"
 				);
 
-		//Find the Source-Definition in the File:
+		//Find the Source-Definition in the File, jump right in front of it if it's indexed:
 		std::istream is(&(file->getInputStream()));
+		is.ignore(XDataIndex::Instance().getOffset(sourceDef, it->second[k]));
+
 		parser::BasicDefTokeniser<std::istream> ImpTok(is);
 		while (true)
 		{
@@ -725,58 +732,7 @@ void XDataLoader::jumpOutOfBrackets(parser::DefTokeniser& tok, std::size_t curre
 
 void XDataLoader::retrieveXdInfo()
 {
-	_defMap.clear();
-	_fileSet.clear();
-	_duplicatedDefs.clear();
-	//ScopedDebugTimer timer("XData definitions parsed: ");
-	GlobalFileSystem().forEachFile(
-        XDATA_DIR, XDATA_EXT,
-        [&](const vfs::FileInfo& fileInfo) { loadFromFile(fileInfo.name); },
-        99
-    );
-}
-
-void XDataLoader::loadFromFile(const std::string& filename)
-{
-	// Attempt to open the file in text mode
-	ArchiveTextFilePtr file =
-		GlobalFileSystem().openTextFile(XDATA_DIR + filename);
-
-	if (file != NULL) {
-		// File is open, so add the file to the _fileSet-set and parse the tokens
-		_fileSet.insert(file->getModName() + "/" + file->getName());
-		try
-		{
-			std::istream is(&(file->getInputStream()));
-			parser::BasicDefTokeniser<std::istream> tok(is);
-			//grab all names from stream:
-			while (tok.hasMoreTokens())
-			{
-				std::string tempstring = tok.nextToken();
-				tok.assertNextToken("{");
-				std::pair<StringVectorMap::iterator,bool> ret = _defMap.insert( StringVectorMap::value_type(tempstring, StringList(1, XDATA_DIR + filename) ) );
-				if (!ret.second)	//Definition already exists.
-				{
-					ret.first->second.push_back(XDATA_DIR + filename);
-                    rError() << "[XDataLoader] The definition " << tempstring << " of the file " << filename << " already exists. It was defined at least once. First in " << ret.first->second[0] << ".\n";
-					//Create an entry in the _duplicatedDefs map with the original file. If entry already exists, insert will fail.
-					std::pair<StringVectorMap::iterator,bool> duplRet = _duplicatedDefs.insert( StringVectorMap::value_type(tempstring, StringList(1,ret.first->second[0]) ) );
-					//The new file is appended to the vector.
-					duplRet.first->second.push_back(XDATA_DIR + filename);
-				}
-				jumpOutOfBrackets(tok);
-			}
-		}
-		catch (parser::ParseException& e)
-		{
-			rError() << "[XDataLoader] Failed to parse " << filename
-				<< ": " << e.what() << std::endl;
-		}
-	}
-	else
-	{
-        rError() << "[XDataLoader] Unable to open " << filename << std::endl;
-	}
+	XDataIndex::Instance().getInfo(_defMap, _fileSet, _duplicatedDefs);
 }
 
 } // namespace XData
@@ -91,12 +91,10 @@ public:
 		return _defMap;
 	}
 
-	// Retrieves all XData-related information found in the VFS.
+	// Retrieves all XData-related information found in the VFS. The information is
+	// taken from the XDataIndex, which only rescans the files changed since the last call.
 	void retrieveXdInfo();
 
-	// Functor operator: Adds all definitions found in the target file to the _defMap.
-	void loadFromFile(const std::string& filename);
-
 private:
 	// Issues the ErrorMessage to the cerr console and appends it to the _errorList. Returns always false, so that it can be used after a return statement.
 	const bool reportError(const std::string& ErrorMessage)
@@ -1,6 +1,7 @@
 // Project related
 #include "ReadableEditorDialog.h"
 #include "ReadableReloader.h"
+#include "XDataIndex.h"
 #include "gui/GuiManager.h"
 
 // General
@@ -71,6 +72,15 @@ public:
 
 		// Create the Readable Editor Preferences
 		constructPreferences();
+
+		// Index the XData definitions in the background, the readable editor needs them
+		XData::XDataIndex::Instance().startScan();
+	}
+
+	void shutdownModule() override
+	{
+		// Wait for the index worker thread before the plugin gets unloaded
+		XData::XDataIndex::Instance().clear();
 	}
 
 private:
@@ -35,6 +35,7 @@
 #include "interfaces/SelectionGroupInterface.h"
 #include "interfaces/CameraInterface.h"
 #include "interfaces/LayerInterface.h"
+#include "interfaces/BulkDataInterface.h"
 
 #include "PythonModule.h"
 
@@ -329,6 +330,7 @@ void ScriptingSystem::initialiseModule(const IApplicationContext& ctx)
 	addInterface("SelectionGroupInterface", std::make_shared<SelectionGroupInterface>());
 	addInterface("CameraInterface", std::make_shared<CameraInterface>());
 	addInterface("LayerInterface", std::make_shared<LayerInterface>());
+	addInterface("BulkDataInterface", std::make_shared<BulkDataInterface>());
 
 	GlobalCommandSystem().addCommand(
 		"RunScript",
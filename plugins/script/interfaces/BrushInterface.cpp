@@ -210,8 +210,6 @@ void BrushInterface::registerInterface(py::module& scope, py::dict& globals)
 	vertex.def(py::init<>());
 	vertex.def_readonly("vertex", &WindingVertex::vertex);
 	vertex.def_readonly("texcoord", &WindingVertex::texcoord);
-	vertex.def_readonly("tangent", &WindingVertex::tangent);
-	vertex.def_readonly("bitangent", &WindingVertex::bitangent);
 	vertex.def_readonly("normal", &WindingVertex::normal);
 	vertex.def_readonly("adjacent", &WindingVertex::adjacent);
 	
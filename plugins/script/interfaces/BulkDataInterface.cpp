@@ -0,0 +1,550 @@
+#include "BulkDataInterface.h"
+
+#include <vector>
+#include "ibrush.h"
+#include "ipatch.h"
+#include "ientity.h"
+#include "iselection.h"
+#include "iscenegraph.h"
+#include "iundo.h"
+#include "entitylib.h"
+#include "string/convert.h"
+
+#include "SceneGraphInterface.h"
+
+namespace script
+{
+
+namespace
+{
+
+// Collects the selected nodes or all nodes of the map which pass the given test
+std::vector<scene::INodePtr> collectNodes(int selectedOnly, const std::function<bool(const scene::INodePtr&)>& predicate)
+{
+	std::vector<scene::INodePtr> nodes;
+
+	if (selectedOnly)
+	{
+		GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node)
+		{
+			if (predicate(node))
+			{
+				nodes.push_back(node);
+			}
+		});
+	}
+	else if (GlobalSceneGraph().root())
+	{
+		GlobalSceneGraph().root()->foreachNode([&](const scene::INodePtr& node)
+		{
+			if (predicate(node))
+			{
+				nodes.push_back(node);
+			}
+
+			return true;
+		});
+	}
+
+	return nodes;
+}
+
+std::vector<IBrushNodePtr> collectBrushes(int selectedOnly)
+{
+	std::vector<IBrushNodePtr> brushes;
+
+	for (const auto& node : collectNodes(selectedOnly, Node_isBrush))
+	{
+		brushes.emplace_back(std::dynamic_pointer_cast<IBrushNode>(node));
+	}
+
+	return brushes;
+}
+
+std::vector<IPatchNodePtr> collectPatches(int selectedOnly)
+{
+	std::vector<IPatchNodePtr> patches;
+
+	for (const auto& node : collectNodes(selectedOnly, Node_isPatch))
+	{
+		patches.emplace_back(std::dynamic_pointer_cast<IPatchNode>(node));
+	}
+
+	return patches;
+}
+
+std::vector<IEntityNodePtr> collectEntities(int selectedOnly)
+{
+	std::vector<IEntityNodePtr> entities;
+
+	for (const auto& node : collectNodes(selectedOnly, Node_isEntity))
+	{
+		entities.emplace_back(std::dynamic_pointer_cast<IEntityNode>(node));
+	}
+
+	return entities;
+}
+
+py::list toNodeList(const std::vector<scene::INodePtr>& nodes)
+{
+	py::list list;
+
+	for (const auto& node : nodes)
+	{
+		list.append(ScriptSceneNode(node));
+	}
+
+	return list;
+}
+
+std::size_t countFaces(const std::vector<IBrushNodePtr>& brushes)
+{
+	std::size_t count = 0;
+
+	for (const auto& brush : brushes)
+	{
+		count += brush->getIBrush().getNumFaces();
+	}
+
+	return count;
+}
+
+template<typename Func>
+void foreachFace(const std::vector<IBrushNodePtr>& brushes, Func func)
+{
+	for (const auto& brush : brushes)
+	{
+		auto& ibrush = brush->getIBrush();
+
+		for (std::size_t i = 0; i < ibrush.getNumFaces(); ++i)
+		{
+			func(ibrush.getFace(i));
+		}
+	}
+}
+
+// Makes sure the windings are up to date before they're accessed
+void evaluateWindings(const std::vector<IBrushNodePtr>& brushes)
+{
+	for (const auto& brush : brushes)
+	{
+		brush->getIBrush().evaluateBRep();
+	}
+}
+
+std::size_t countControlPoints(const std::vector<IPatchNodePtr>& patches)
+{
+	std::size_t count = 0;
+
+	for (const auto& patch : patches)
+	{
+		count += patch->getPatch().getWidth() * patch->getPatch().getHeight();
+	}
+
+	return count;
+}
+
+// Throws a ValueError if the array doesn't have the expected shape
+void checkShape(const py::array_t<double>& array, const std::vector<std::size_t>& shape)
+{
+	bool matches = static_cast<std::size_t>(array.ndim()) == shape.size();
+
+	for (std::size_t i = 0; matches && i < shape.size(); ++i)
+	{
+		matches = static_cast<std::size_t>(array.shape(i)) == shape[i];
+	}
+
+	if (!matches)
+	{
+		std::string expected;
+
+		for (auto dim : shape)
+		{
+			expected += (expected.empty() ? "" : ", ") + string::to_string(dim);
+		}
+
+		throw py::value_error("Array shape doesn't match, expected (" + expected + ")");
+	}
+}
+
+void checkLength(const py::list& list, std::size_t length)
+{
+	if (list.size() != length)
+	{
+		throw py::value_error("List length doesn't match, expected " + string::to_string(length));
+	}
+}
+
+}
+
+py::list BulkDataInterface::getBrushes(int selectedOnly)
+{
+	return toNodeList(collectNodes(selectedOnly, Node_isBrush));
+}
+
+py::list BulkDataInterface::getPatches(int selectedOnly)
+{
+	return toNodeList(collectNodes(selectedOnly, Node_isPatch));
+}
+
+py::list BulkDataInterface::getEntities(int selectedOnly)
+{
+	return toNodeList(collectNodes(selectedOnly, Node_isEntity));
+}
+
+py::array_t<int> BulkDataInterface::getFaceCounts(int selectedOnly)
+{
+	auto brushes = collectBrushes(selectedOnly);
+
+	py::array_t<int> result(brushes.size());
+	auto data = result.mutable_unchecked<1>();
+
+	for (std::size_t i = 0; i < brushes.size(); ++i)
+	{
+		data(i) = static_cast<int>(brushes[i]->getIBrush().getNumFaces());
+	}
+
+	return result;
+}
+
+py::array_t<double> BulkDataInterface::getFacePlanes(int selectedOnly)
+{
+	auto brushes = collectBrushes(selectedOnly);
+
+	py::array_t<double> result({ countFaces(brushes), std::size_t(4) });
+	auto data = result.mutable_unchecked<2>();
+	py::ssize_t row = 0;
+
+	foreachFace(brushes, [&](IFace& face)
+	{
+		const auto& plane = face.getPlane3();
+
+		data(row, 0) = plane.normal().x();
+		data(row, 1) = plane.normal().y();
+		data(row, 2) = plane.normal().z();
+		data(row, 3) = plane.dist();
+		++row;
+	});
+
+	return result;
+}
+
+py::array_t<double> BulkDataInterface::getFaceTexdefs(int selectedOnly)
+{
+	auto brushes = collectBrushes(selectedOnly);
+
+	py::array_t<double> result({ countFaces(brushes), std::size_t(2), std::size_t(3) });
+	auto data = result.mutable_unchecked<3>();
+	py::ssize_t row = 0;
+
+	foreachFace(brushes, [&](IFace& face)
+	{
+		auto texdef = face.getTexDefMatrix();
+
+		data(row, 0, 0) = texdef.xx();
+		data(row, 0, 1) = texdef.yx();
+		data(row, 0, 2) = texdef.tx();
+		data(row, 1, 0) = texdef.xy();
+		data(row, 1, 1) = texdef.yy();
+		data(row, 1, 2) = texdef.ty();
+		++row;
+	});
+
+	return result;
+}
+
+void BulkDataInterface::setFaceTexdefs(int selectedOnly, const py::array_t<double>& texdefs)
+{
+	auto brushes = collectBrushes(selectedOnly);
+	checkShape(texdefs, { countFaces(brushes), 2, 3 });
+
+	UndoableCommand cmd("bulkSetFaceTexdefs");
+
+	auto data = texdefs.unchecked<3>();
+	py::ssize_t row = 0;
+
+	for (const auto& brush : brushes)
+	{
+		brush->getIBrush().undoSave();
+	}
+
+	foreachFace(brushes, [&](IFace& face)
+	{
+		auto texdef = Matrix4::getIdentity();
+
+		texdef.xx() = data(row, 0, 0);
+		texdef.yx() = data(row, 0, 1);
+		texdef.tx() = data(row, 0, 2);
+		texdef.xy() = data(row, 1, 0);
+		texdef.yy() = data(row, 1, 1);
+		texdef.ty() = data(row, 1, 2);
+		++row;
+
+		face.setProjectionMatrix(texdef);
+	});
+}
+
+py::list BulkDataInterface::getFaceShaders(int selectedOnly)
+{
+	py::list result;
+
+	foreachFace(collectBrushes(selectedOnly), [&](IFace& face)
+	{
+		result.append(face.getShader());
+	});
+
+	return result;
+}
+
+void BulkDataInterface::setFaceShaders(int selectedOnly, const py::list& shaders)
+{
+	auto brushes = collectBrushes(selectedOnly);
+	checkLength(shaders, countFaces(brushes));
+
+	// Convert all names first, a type error shouldn't leave a half-changed map
+	std::vector<std::string> names;
+	names.reserve(shaders.size());
+
+	for (const auto& shader : shaders)
+	{
+		names.emplace_back(shader.cast<std::string>());
+	}
+
+	UndoableCommand cmd("bulkSetFaceShaders");
+
+	for (const auto& brush : brushes)
+	{
+		brush->getIBrush().undoSave();
+	}
+
+	std::size_t index = 0;
+
+	foreachFace(brushes, [&](IFace& face)
+	{
+		face.setShader(names[index++]);
+	});
+}
+
+py::array_t<int> BulkDataInterface::getWindingSizes(int selectedOnly)
+{
+	auto brushes = collectBrushes(selectedOnly);
+	evaluateWindings(brushes);
+
+	py::array_t<int> result(countFaces(brushes));
+	auto data = result.mutable_unchecked<1>();
+	py::ssize_t row = 0;
+
+	foreachFace(brushes, [&](IFace& face)
+	{
+		data(row++) = static_cast<int>(face.getWinding().size());
+	});
+
+	return result;
+}
+
+py::array_t<double> BulkDataInterface::getBrushVertices(int selectedOnly)
+{
+	auto brushes = collectBrushes(selectedOnly);
+	evaluateWindings(brushes);
+
+	std::size_t numVertices = 0;
+
+	foreachFace(brushes, [&](IFace& face)
+	{
+		numVertices += face.getWinding().size();
+	});
+
+	py::array_t<double> result({ numVertices, std::size_t(3) });
+	auto data = result.mutable_unchecked<2>();
+	py::ssize_t row = 0;
+
+	foreachFace(brushes, [&](IFace& face)
+	{
+		for (const auto& vertex : face.getWinding())
+		{
+			data(row, 0) = vertex.vertex.x();
+			data(row, 1) = vertex.vertex.y();
+			data(row, 2) = vertex.vertex.z();
+			++row;
+		}
+	});
+
+	return result;
+}
+
+py::array_t<int> BulkDataInterface::getPatchDims(int selectedOnly)
+{
+	auto patches = collectPatches(selectedOnly);
+
+	py::array_t<int> result({ patches.size(), std::size_t(2) });
+	auto data = result.mutable_unchecked<2>();
+
+	for (std::size_t i = 0; i < patches.size(); ++i)
+	{
+		data(i, 0) = static_cast<int>(patches[i]->getPatch().getWidth());
+		data(i, 1) = static_cast<int>(patches[i]->getPatch().getHeight());
+	}
+
+	return result;
+}
+
+py::array_t<double> BulkDataInterface::getPatchControls(int selectedOnly)
+{
+	auto patches = collectPatches(selectedOnly);
+
+	py::array_t<double> result({ countControlPoints(patches), std::size_t(5) });
+	auto data = result.mutable_unchecked<2>();
+	py::ssize_t row = 0;
+
+	for (const auto& node : patches)
+	{
+		const auto& patch = node->getPatch();
+
+		for (std::size_t r = 0; r < patch.getHeight(); ++r)
+		{
+			for (std::size_t c = 0; c < patch.getWidth(); ++c)
+			{
+				const auto& ctrl = patch.ctrlAt(r, c);
+
+				data(row, 0) = ctrl.vertex.x();
+				data(row, 1) = ctrl.vertex.y();
+				data(row, 2) = ctrl.vertex.z();
+				data(row, 3) = ctrl.texcoord.x();
+				data(row, 4) = ctrl.texcoord.y();
+				++row;
+			}
+		}
+	}
+
+	return result;
+}
+
+void BulkDataInterface::setPatchControls(int selectedOnly, const py::array_t<double>& controls)
+{
+	auto patches = collectPatches(selectedOnly);
+	checkShape(controls, { countControlPoints(patches), 5 });
+
+	UndoableCommand cmd("bulkSetPatchControls");
+
+	auto data = controls.unchecked<2>();
+	py::ssize_t row = 0;
+
+	for (const auto& node : patches)
+	{
+		auto& patch = node->getPatch();
+		patch.undoSave();
+
+		for (std::size_t r = 0; r < patch.getHeight(); ++r)
+		{
+			for (std::size_t c = 0; c < patch.getWidth(); ++c)
+			{
+				auto& ctrl = patch.ctrlAt(r, c);
+
+				ctrl.vertex = Vector3(data(row, 0), data(row, 1), data(row, 2));
+				ctrl.texcoord = Vector2(data(row, 3), data(row, 4));
+				++row;
+			}
+		}
+
+		patch.controlPointsChanged();
+	}
+}
+
+py::array_t<double> BulkDataInterface::getEntityOrigins(int selectedOnly)
+{
+	auto entities = collectEntities(selectedOnly);
+
+	py::array_t<double> result({ entities.size(), std::size_t(3) });
+	auto data = result.mutable_unchecked<2>();
+
+	for (std::size_t i = 0; i < entities.size(); ++i)
+	{
+		auto origin = scene::getEntityOrigin(entities[i]->getEntity());
+
+		data(i, 0) = origin.x();
+		data(i, 1) = origin.y();
+		data(i, 2) = origin.z();
+	}
+
+	return result;
+}
+
+void BulkDataInterface::setEntityOrigins(int selectedOnly, const py::array_t<double>& origins)
+{
+	auto entities = collectEntities(selectedOnly);
+	checkShape(origins, { entities.size(), 3 });
+
+	UndoableCommand cmd("bulkSetEntityOrigins");
+
+	auto data = origins.unchecked<2>();
+
+	for (std::size_t i = 0; i < entities.size(); ++i)
+	{
+		// Unchanged rows and the worldspawn are skipped
+		scene::setEntityOrigin(entities[i]->getEntity(), Vector3(data(i, 0), data(i, 1), data(i, 2)));
+	}
+}
+
+py::list BulkDataInterface::getEntityKeyValues(int selectedOnly, const std::string& key)
+{
+	py::list result;
+
+	for (const auto& entity : collectEntities(selectedOnly))
+	{
+		result.append(entity->getEntity().getKeyValue(key));
+	}
+
+	return result;
+}
+
+void BulkDataInterface::setEntityKeyValues(int selectedOnly, const std::string& key, const py::list& values)
+{
+	auto entities = collectEntities(selectedOnly);
+	checkLength(values, entities.size());
+
+	std::vector<std::string> strings;
+	strings.reserve(values.size());
+
+	for (const auto& value : values)
+	{
+		strings.emplace_back(value.cast<std::string>());
+	}
+
+	UndoableCommand cmd("bulkSetEntityKeyValues");
+
+	for (std::size_t i = 0; i < entities.size(); ++i)
+	{
+		// Don't turn unchanged (inherited) values into spawnargs
+		scene::setEntityKeyValue(entities[i]->getEntity(), key, strings[i]);
+	}
+}
+
+// IScriptInterface implementation
+void BulkDataInterface::registerInterface(py::module& scope, py::dict& globals)
+{
+	py::class_<BulkDataInterface> bulkData(scope, "BulkData");
+
+	bulkData.def("getBrushes", &BulkDataInterface::getBrushes);
+	bulkData.def("getPatches", &BulkDataInterface::getPatches);
+	bulkData.def("getEntities", &BulkDataInterface::getEntities);
+	bulkData.def("getFaceCounts", &BulkDataInterface::getFaceCounts);
+	bulkData.def("getFacePlanes", &BulkDataInterface::getFacePlanes);
+	bulkData.def("getFaceTexdefs", &BulkDataInterface::getFaceTexdefs);
+	bulkData.def("setFaceTexdefs", &BulkDataInterface::setFaceTexdefs);
+	bulkData.def("getFaceShaders", &BulkDataInterface::getFaceShaders);
+	bulkData.def("setFaceShaders", &BulkDataInterface::setFaceShaders);
+	bulkData.def("getWindingSizes", &BulkDataInterface::getWindingSizes);
+	bulkData.def("getBrushVertices", &BulkDataInterface::getBrushVertices);
+	bulkData.def("getPatchDims", &BulkDataInterface::getPatchDims);
+	bulkData.def("getPatchControls", &BulkDataInterface::getPatchControls);
+	bulkData.def("setPatchControls", &BulkDataInterface::setPatchControls);
+	bulkData.def("getEntityOrigins", &BulkDataInterface::getEntityOrigins);
+	bulkData.def("setEntityOrigins", &BulkDataInterface::setEntityOrigins);
+	bulkData.def("getEntityKeyValues", &BulkDataInterface::getEntityKeyValues);
+	bulkData.def("setEntityKeyValues", &BulkDataInterface::setEntityKeyValues);
+
+	// Now point the Python variable "GlobalBulkData" to this instance
+	globals["GlobalBulkData"] = this;
+}
+
+} // namespace script
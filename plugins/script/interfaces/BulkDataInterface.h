@@ -0,0 +1,83 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include "iscript.h"
+#include "iscriptinterface.h"
+
+namespace script
+{
+
+/**
+ * Exposes the faces, patches and entities of the selection or the whole
+ * map as NumPy arrays, such that scripts processing a large number of
+ * objects don't need to cross the Python/C++ boundary for every single
+ * face or control point.
+ *
+ * All methods take a selectedOnly flag: if it is non-zero, only the
+ * selected nodes are considered (in selection order), otherwise all nodes
+ * of the map (in scene traversal order). As long as the selection or the
+ * map are not changed, the rows of all arrays refer to the same nodes as
+ * the lists returned by getBrushes(), getPatches() and getEntities().
+ *
+ * Each setter applies all changes in a single undoable operation.
+ */
+class BulkDataInterface :
+	public IScriptInterface
+{
+public:
+	// The nodes the rows of the arrays below refer to
+	py::list getBrushes(int selectedOnly);
+	py::list getPatches(int selectedOnly);
+	py::list getEntities(int selectedOnly);
+
+	// Brush faces, one row per face, brush by brush
+
+	// Number of faces of each brush, shape (numBrushes)
+	py::array_t<int> getFaceCounts(int selectedOnly);
+
+	// Face planes as (normal.x, normal.y, normal.z, dist), shape (numFaces, 4)
+	py::array_t<double> getFacePlanes(int selectedOnly);
+
+	// Texture matrices as ((xx, yx, tx), (xy, yy, ty)), shape (numFaces, 2, 3)
+	py::array_t<double> getFaceTexdefs(int selectedOnly);
+	void setFaceTexdefs(int selectedOnly, const py::array_t<double>& texdefs);
+
+	// Material names, a list with numFaces entries
+	py::list getFaceShaders(int selectedOnly);
+	void setFaceShaders(int selectedOnly, const py::list& shaders);
+
+	// Number of winding vertices of each face, shape (numFaces)
+	py::array_t<int> getWindingSizes(int selectedOnly);
+
+	// Winding vertices of all faces, face by face, shape (numWindingVertices, 3)
+	py::array_t<double> getBrushVertices(int selectedOnly);
+
+	// Patches
+
+	// Control grid dimensions as (width, height), shape (numPatches, 2)
+	py::array_t<int> getPatchDims(int selectedOnly);
+
+	// Control points as (x, y, z, s, t), patch by patch in row-major order,
+	// shape (numControlPoints, 5)
+	py::array_t<double> getPatchControls(int selectedOnly);
+	void setPatchControls(int selectedOnly, const py::array_t<double>& controls);
+
+	// Entities
+
+	// Origins, shape (numEntities, 3), entities without origin spawnarg report 0,0,0.
+	// The setter leaves the worldspawn and the entities of unchanged rows untouched.
+	py::array_t<double> getEntityOrigins(int selectedOnly);
+	void setEntityOrigins(int selectedOnly, const py::array_t<double>& origins);
+
+	// The (inherited) value of the given spawnarg, a list with numEntities entries.
+	// The setter leaves the entities of unchanged entries untouched.
+	py::list getEntityKeyValues(int selectedOnly, const std::string& key);
+	void setEntityKeyValues(int selectedOnly, const std::string& key, const py::list& values);
+
+	// IScriptInterface implementation
+	void registerInterface(py::module& scope, py::dict& globals) override;
+};
+
+} // namespace script
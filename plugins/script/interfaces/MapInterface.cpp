@@ -3,6 +3,7 @@
 #include <pybind11/pybind11.h>
 
 #include "imap.h"
+#include <set>
 
 namespace script 
 {
@@ -62,6 +63,52 @@ std::vector<std::string> MapInterface::getPointFileList()
     return files;
 }
 
+std::vector<std::string> MapInterface::getMaterialsInUse()
+{
+    std::vector<std::string> materials;
+
+    if (!GlobalMapModule().getRoot()) return materials;
+
+    GlobalMapModule().getRoot()->getMaterialUsageIndex().foreachMaterial(
+        [&](const std::string& material, std::size_t, std::size_t)
+    {
+        materials.push_back(material);
+    });
+
+    return materials;
+}
+
+std::size_t MapInterface::getMaterialFaceCount(const std::string& material)
+{
+    auto root = GlobalMapModule().getRoot();
+    return root ? root->getMaterialUsageIndex().getFaceCount(material) : 0;
+}
+
+std::size_t MapInterface::getMaterialPatchCount(const std::string& material)
+{
+    auto root = GlobalMapModule().getRoot();
+    return root ? root->getMaterialUsageIndex().getPatchCount(material) : 0;
+}
+
+void MapInterface::foreachNodeUsingMaterial(const std::string& material, scene::NodeVisitor& visitor)
+{
+    if (!GlobalMapModule().getRoot()) return;
+
+    std::set<scene::INode*> visited;
+
+    GlobalMapModule().getRoot()->getMaterialUsageIndex().foreachUsage(material, [&](const scene::MaterialUsage& usage)
+    {
+        // A brush is listed once, no matter how many of its faces use the material
+        if (!visited.insert(usage.node).second)
+        {
+            return true;
+        }
+
+        // Stop the traversal if the visitor returns false
+        return visitor.pre(usage.node->getSelf());
+    });
+}
+
 // IScriptInterface implementation
 void MapInterface::registerInterface(py::module& scope, py::dict& globals)
 {
@@ -86,6 +133,11 @@ void MapInterface::registerInterface(py::module& scope, py::dict& globals)
     map.def("isPointTraceVisible", &MapInterface::isPointTraceVisible);
     map.def("getPointFileList", &MapInterface::getPointFileList);
 
+    map.def("getMaterialsInUse", &MapInterface::getMaterialsInUse);
+    map.def("getMaterialFaceCount", &MapInterface::getMaterialFaceCount);
+    map.def("getMaterialPatchCount", &MapInterface::getMaterialPatchCount);
+    map.def("foreachNodeUsingMaterial", &MapInterface::foreachNodeUsingMaterial);
+
 	// Now point the Python variable "GlobalMap" to this instance
 	globals["GlobalMap"] = this;
 }
@@ -26,6 +26,13 @@ public:
     bool isPointTraceVisible();
     std::vector<std::string> getPointFileList();
 
+    // Material usage queries, answered by the map's material usage index
+    std::vector<std::string> getMaterialsInUse();
+    std::size_t getMaterialFaceCount(const std::string& material);
+    std::size_t getMaterialPatchCount(const std::string& material);
+    // Passes each brush and patch to the visitor's pre(), until it returns false
+    void foreachNodeUsingMaterial(const std::string& material, scene::NodeVisitor& visitor);
+
 	// IScriptInterface implementation
 	void registerInterface(py::module& scope, py::dict& globals) override;
 };
@@ -12,6 +12,7 @@
 #include <fmt/format.h>
 
 #include "iarchive.h"
+#include "isound.h"
 #include "stream/ScopedArchiveBuffer.h"
 #include "OggFileStream.h"
 
@@ -75,6 +76,29 @@ public:
         return static_cast<float>(ov_time_total(file.getHandle(), -1));
     }
 
+    /**
+     * Determines the length, number of channels and sample rate of the OGG file.
+     * The size member of the returned structure is left at 0.
+     * @throws: std::runtime_error if an error occurs.
+     */
+    static SoundFileInfo GetInfo(ArchiveFile& vfsFile)
+    {
+        FileWrapper file(vfsFile);
+
+        SoundFileInfo result;
+        result.duration = static_cast<float>(ov_time_total(file.getHandle(), -1));
+
+        vorbis_info* vorbisInfo = ov_info(file.getHandle(), -1);
+
+        if (vorbisInfo != nullptr)
+        {
+            result.channels = static_cast<unsigned int>(vorbisInfo->channels);
+            result.sampleRate = static_cast<unsigned int>(vorbisInfo->rate);
+        }
+
+        return result;
+    }
+
     /**
      * greebo: Loads an OGG file from the given stream into OpenAL,
      * returns the openAL buffer handle.
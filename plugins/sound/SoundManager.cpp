@@ -5,15 +5,11 @@
 #include "icommandsystem.h"
 
 #include "debugging/ScopedDebugTimer.h"
-#include "os/path.h"
-#include "string/case_conv.h"
 
+#include <set>
 #include <algorithm>
 #include "itextstream.h"
 
-#include "WavFileLoader.h"
-#include "OggFileLoader.h"
-
 namespace sound
 {
 
@@ -145,11 +141,25 @@ void SoundManager::loadShadersFromFilesystem()
         99						// max depth
     );
 
+    // Collect the referenced sound files while the shaders are still private to this thread
+    std::set<std::string> soundFiles;
+
+    for (const auto& pair : *foundShaders)
+    {
+        for (const auto& soundFile : pair.second->getSoundFileList())
+        {
+            soundFiles.insert(soundFile);
+        }
+    }
+
     _shaders.swap(*foundShaders);
 
     rMessage() << _shaders.size() << " sound shaders found." << std::endl;
 
     _sigSoundShadersReloaded.emit();
+
+    // Bring the metadata of all these files up to date in the background
+    _metadataIndex.fillAsync(std::vector<std::string>(soundFiles.begin(), soundFiles.end()));
 }
 
 void SoundManager::ensureShadersLoaded()
@@ -176,37 +186,37 @@ void SoundManager::initialiseModule(const IApplicationContext& ctx)
         rMessage() << "SoundManager: sound output disabled" << std::endl;
     }
 
+    _metadataIndexPath = ctx.getSettingsPath() + "soundmetadata.cache";
+    _metadataIndex.loadFromFile(_metadataIndexPath);
+
     _defLoader.start();
 }
 
+void SoundManager::shutdownModule()
+{
+    // The shader loader might be about to start filling the index
+    _defLoader.reset();
+
+    _metadataIndex.stop();
+    _metadataIndex.saveToFile(_metadataIndexPath);
+}
+
 float SoundManager::getSoundFileDuration(const std::string& vfsPath)
 {
-    auto file = openSoundFile(vfsPath);
+    auto info = getSoundFileInfo({ vfsPath });
+    auto found = info.find(vfsPath);
 
-    if (!file)
+    if (found == info.end())
     {
         throw std::out_of_range("Could not resolve sound file " + vfsPath);
     }
 
-    auto extension = string::to_lower_copy(os::getExtension(file->getName()));
-
-    try
-    {
-        if (extension == "wav")
-        {
-            return WavFileLoader::GetDuration(file->getInputStream());
-        }
-        else if (extension == "ogg")
-        {
-            return OggFileLoader::GetDuration(*file);
-        }
-    }
-    catch (const std::runtime_error& ex)
-    {
-        rError() << "Error determining sound file duration " << ex.what() << std::endl;
-    }
+    return found->second.duration;
+}
 
-    return 0.0f;
+std::map<std::string, SoundFileInfo> SoundManager::getSoundFileInfo(const std::vector<std::string>& vfsPaths)
+{
+    return _metadataIndex.getInfo(vfsPaths);
 }
 
 void SoundManager::reloadSounds()
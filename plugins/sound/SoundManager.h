@@ -2,6 +2,7 @@
 
 #include "SoundShader.h"
 #include "SoundPlayer.h"
+#include "SoundMetadataIndex.h"
 
 #include "isound.h"
 #include "icommandsystem.h"
@@ -30,6 +31,10 @@ private: /* FIELDS */
 
 	SoundShader::Ptr _emptyShader;
 
+    // Durations and other properties of the sound files, persisted between sessions
+    SoundMetadataIndex _metadataIndex;
+    std::string _metadataIndexPath;
+
 	// The helper class for playing the sounds
 	std::unique_ptr<SoundPlayer> _soundPlayer;
 
@@ -51,12 +56,14 @@ public:
 	void stopSound() override;
     void reloadSounds() override;
     float getSoundFileDuration(const std::string& vfsPath) override;
+    std::map<std::string, SoundFileInfo> getSoundFileInfo(const std::vector<std::string>& vfsPaths) override;
     sigc::signal<void>& signal_soundShadersReloaded() override;
 
 	// RegisterableModule implementation
 	const std::string& getName() const override;
 	const StringSet& getDependencies() const override;
 	void initialiseModule(const IApplicationContext& ctx) override;
+	void shutdownModule() override;
 };
 
 }
@@ -0,0 +1,302 @@
+#include "SoundMetadataIndex.h"
+
+#include <thread>
+#include <future>
+#include <fstream>
+#include <limits>
+#include <algorithm>
+#include "iarchive.h"
+#include "itextstream.h"
+#include "os/fs.h"
+#include "os/path.h"
+#include "string/case_conv.h"
+#include "string/convert.h"
+#include "string/split.h"
+
+#include "WavFileLoader.h"
+#include "OggFileLoader.h"
+
+namespace sound
+{
+
+namespace
+{
+
+const char* const INDEX_FILE_HEADER = "DarkRadiant sound metadata 1";
+
+std::int64_t getModificationTime(const std::string& path)
+{
+    try
+    {
+        auto time = fs::last_write_time(path);
+#ifdef DR_USE_BOOST_FILESYSTEM
+        return static_cast<std::int64_t>(time);
+#else
+        return static_cast<std::int64_t>(time.time_since_epoch().count());
+#endif
+    }
+    catch (const fs::filesystem_error&)
+    {
+        // Leave the time at 0, the size is still compared
+        return 0;
+    }
+}
+
+}
+
+SoundMetadataIndex::SoundMetadataIndex() :
+    _changed(false),
+    _filler([this]()
+    {
+        auto numFiles = getInfo(_pendingPaths).size();
+        rMessage() << "SoundMetadataIndex: " << numFiles << " sound files indexed." << std::endl;
+    }),
+    _cancelled(false)
+{}
+
+std::map<std::string, SoundFileInfo> SoundMetadataIndex::getInfo(const std::vector<std::string>& vfsPaths)
+{
+    std::map<std::string, SoundFileInfo> result;
+    std::vector<Lookup> lookups;
+
+    // Most files are packed in a few PK4s, stat each of them once per query
+    std::map<std::string, std::int64_t> archiveTimes;
+
+    for (const auto& vfsPath : vfsPaths)
+    {
+        auto fileInfo = resolveSoundFile(vfsPath);
+
+        if (fileInfo.isEmpty()) continue;
+
+        Lookup lookup;
+        lookup.vfsPath = vfsPath;
+        lookup.resolvedPath = fileInfo.fullPath();
+        lookup.stamp.archivePath = fileInfo.getArchivePath();
+        lookup.stamp.size = fileInfo.getSize();
+
+        if (fileInfo.getIsPhysicalFile())
+        {
+            // Physical files carry their own time
+            lookup.stamp.modificationTime = getModificationTime(
+                os::standardPathWithSlash(lookup.stamp.archivePath) + lookup.resolvedPath);
+        }
+        else
+        {
+            auto time = archiveTimes.emplace(lookup.stamp.archivePath, 0);
+
+            if (time.second)
+            {
+                time.first->second = getModificationTime(lookup.stamp.archivePath);
+            }
+
+            lookup.stamp.modificationTime = time.first->second;
+        }
+
+        lookups.emplace_back(std::move(lookup));
+    }
+
+    std::vector<Lookup> outdated;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        for (auto& lookup : lookups)
+        {
+            auto found = _entries.find(lookup.vfsPath);
+
+            if (found != _entries.end() && found->second.stamp == lookup.stamp)
+            {
+                result[lookup.vfsPath] = found->second.info;
+            }
+            else
+            {
+                outdated.emplace_back(std::move(lookup));
+            }
+        }
+    }
+
+    if (outdated.empty())
+    {
+        return result;
+    }
+
+    readFiles(outdated);
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    for (const auto& lookup : outdated)
+    {
+        if (!lookup.read) continue;
+
+        auto& entry = _entries[lookup.vfsPath];
+        entry.stamp = lookup.stamp;
+        entry.info = lookup.info;
+
+        result[lookup.vfsPath] = lookup.info;
+        _changed = true;
+    }
+
+    return result;
+}
+
+void SoundMetadataIndex::fillAsync(std::vector<std::string> vfsPaths)
+{
+    // The worker is idle after this call, it's safe to replace the paths
+    stop();
+
+    _pendingPaths = std::move(vfsPaths);
+    _filler.start();
+}
+
+void SoundMetadataIndex::stop()
+{
+    _cancelled = true;
+    _filler.reset();
+    _cancelled = false;
+}
+
+void SoundMetadataIndex::readFiles(std::vector<Lookup>& lookups)
+{
+    auto numWorkers = std::min<std::size_t>(
+        std::max(std::thread::hardware_concurrency(), 1u), lookups.size());
+
+    std::atomic<std::size_t> next(0);
+    std::vector<std::future<void>> workers;
+
+    for (std::size_t i = 0; i < numWorkers; ++i)
+    {
+        workers.emplace_back(std::async(std::launch::async, [&]()
+        {
+            for (auto index = next++; index < lookups.size() && !_cancelled; index = next++)
+            {
+                readFile(lookups[index]);
+            }
+        }));
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+}
+
+void SoundMetadataIndex::readFile(Lookup& lookup)
+{
+    auto file = GlobalFileSystem().openFile(lookup.resolvedPath);
+
+    if (!file) return;
+
+    lookup.info = SoundFileInfo();
+    lookup.info.size = file->size();
+
+    auto extension = string::to_lower_copy(os::getExtension(file->getName()));
+
+    try
+    {
+        if (extension == "wav")
+        {
+            lookup.info = WavFileLoader::GetInfo(file->getInputStream());
+        }
+        else if (extension == "ogg")
+        {
+            lookup.info = OggFileLoader::GetInfo(*file);
+        }
+
+        lookup.info.size = file->size();
+    }
+    catch (const std::runtime_error& ex)
+    {
+        // Remember the broken file too, it won't be read again until it changes
+        rError() << "Error determining sound file properties of " << lookup.resolvedPath
+            << ": " << ex.what() << std::endl;
+    }
+
+    lookup.read = true;
+}
+
+vfs::FileInfo SoundMetadataIndex::resolveSoundFile(const std::string& vfsPath)
+{
+    auto fileInfo = GlobalFileSystem().getFileInfo(vfsPath);
+
+    if (!fileInfo.isEmpty())
+    {
+        return fileInfo;
+    }
+
+    auto root = vfsPath.substr(0, vfsPath.rfind('.'));
+
+    fileInfo = GlobalFileSystem().getFileInfo(root + ".ogg");
+
+    return !fileInfo.isEmpty() ? fileInfo : GlobalFileSystem().getFileInfo(root + ".wav");
+}
+
+void SoundMetadataIndex::loadFromFile(const std::string& path)
+{
+    std::ifstream stream(path);
+
+    if (!stream) return;
+
+    std::string line;
+
+    if (!std::getline(stream, line) || line != INDEX_FILE_HEADER)
+    {
+        rMessage() << "SoundMetadataIndex: ignoring outdated index file " << path << std::endl;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    while (std::getline(stream, line))
+    {
+        std::vector<std::string> parts;
+        string::split(parts, line, "\t", false);
+
+        if (parts.size() != 8) continue;
+
+        auto& entry = _entries[parts[0]];
+
+        entry.stamp.archivePath = parts[1];
+        entry.stamp.size = string::convert<std::size_t>(parts[2]);
+        entry.stamp.modificationTime = string::convert<long long>(parts[3]);
+        entry.info.duration = string::convert<float>(parts[4]);
+        entry.info.channels = string::convert<unsigned int>(parts[5]);
+        entry.info.sampleRate = string::convert<unsigned int>(parts[6]);
+        entry.info.size = string::convert<std::size_t>(parts[7]);
+    }
+
+    _changed = false;
+
+    rMessage() << "SoundMetadataIndex: loaded " << _entries.size() << " entries from " << path << std::endl;
+}
+
+void SoundMetadataIndex::saveToFile(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    if (!_changed) return;
+
+    std::ofstream stream(path);
+
+    if (!stream)
+    {
+        rWarning() << "SoundMetadataIndex: cannot write to " << path << std::endl;
+        return;
+    }
+
+    stream.precision(std::numeric_limits<float>::max_digits10);
+    stream << INDEX_FILE_HEADER << "\n";
+
+    for (const auto& pair : _entries)
+    {
+        const auto& stamp = pair.second.stamp;
+        const auto& info = pair.second.info;
+
+        stream << pair.first << "\t" << stamp.archivePath << "\t" << stamp.size << "\t"
+            << stamp.modificationTime << "\t" << info.duration << "\t" << info.channels << "\t"
+            << info.sampleRate << "\t" << info.size << "\n";
+    }
+
+    _changed = false;
+}
+
+} // namespace sound
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include "isound.h"
+#include "ifilesystem.h"
+#include "ThreadedDefLoader.h"
+
+namespace sound
+{
+
+/**
+ * Keeps track of the duration, number of channels, sample rate and size
+ * of the sound files referenced by the sound shaders, such that these
+ * don't need to be determined by decoding the file headers each time.
+ *
+ * Every entry remembers the stamp (containing archive, size and modification
+ * time) of the file it has been read from. Entries with a matching stamp are
+ * served right away, the remaining files are read in parallel.
+ *
+ * The index is filled in a worker thread after the sound shaders have been
+ * parsed, and written to the settings path on shutdown, such that the next
+ * session only needs to read the files that have been changed.
+ */
+class SoundMetadataIndex
+{
+private:
+    struct FileStamp
+    {
+        std::string archivePath;
+        std::size_t size = 0;
+        std::int64_t modificationTime = 0;
+
+        bool operator==(const FileStamp& other) const
+        {
+            return size == other.size && modificationTime == other.modificationTime &&
+                archivePath == other.archivePath;
+        }
+    };
+
+    struct Entry
+    {
+        FileStamp stamp;
+        SoundFileInfo info;
+    };
+
+    // A file that needs to be read during a query
+    struct Lookup
+    {
+        std::string vfsPath;        // the path as used in the shader
+        std::string resolvedPath;   // the path of the existing .ogg or .wav file
+        FileStamp stamp;
+        SoundFileInfo info;
+        bool read = false;
+    };
+
+    // All known files, keyed by the VFS path as used in the sound shaders
+    std::map<std::string, Entry> _entries;
+    bool _changed;
+
+    std::mutex _lock;
+
+    // The worker filling the index in the background
+    std::vector<std::string> _pendingPaths;
+    util::ThreadedDefLoader<void> _filler;
+
+    std::atomic<bool> _cancelled;
+
+public:
+    SoundMetadataIndex();
+
+    // Returns the properties of the given files, reading the unknown or changed
+    // ones in parallel. Paths that cannot be resolved are missing in the result.
+    std::map<std::string, SoundFileInfo> getInfo(const std::vector<std::string>& vfsPaths);
+
+    // Starts reading the given files in a worker thread,
+    // cancelling a previous run first
+    void fillAsync(std::vector<std::string> vfsPaths);
+
+    // Cancels and waits for the worker thread
+    void stop();
+
+    // Reads the index from the given file, a missing or outdated file is ignored
+    void loadFromFile(const std::string& path);
+
+    // Writes the index to the given file, if it has been changed since loading it
+    void saveToFile(const std::string& path);
+
+private:
+    // Reads the files of the given lookups in parallel
+    void readFiles(std::vector<Lookup>& lookups);
+
+    static void readFile(Lookup& lookup);
+
+    // Returns the info of the file the given sound path resolves to,
+    // trying the OGG and WAV extensions the same way as the SoundManager
+    static vfs::FileInfo resolveSoundFile(const std::string& vfsPath);
+};
+
+} // namespace sound
@@ -2,6 +2,7 @@
 
 #include <stdexcept>
 #include "idatastream.h"
+#include "isound.h"
 
 #ifdef __APPLE__
 #include <OpenAL/al.h>
@@ -60,6 +61,16 @@ public:
      * @throws: std::runtime_error if an error occurs.
      */
     static float GetDuration(InputStream& stream)
+    {
+        return GetInfo(stream).duration;
+    }
+
+    /**
+     * Determines the length, number of channels and sample rate of the WAV file.
+     * The size member of the returned structure is left at 0.
+     * @throws: std::runtime_error if an error occurs.
+     */
+    static SoundFileInfo GetInfo(InputStream& stream)
     {
         FileInfo info;
         ParseFileInfo(stream, info);
@@ -70,11 +81,22 @@ public:
         unsigned int remainingSize = 0;
         stream.read(reinterpret_cast<byte*>(&remainingSize), sizeof(remainingSize));
 
+        if (info.channels == 0 || info.freq == 0 || info.bps < 8)
+        {
+            throw std::runtime_error("Invalid 'fmt ' chunk.");
+        }
+
         // Calculate how many samples we have in the payload, then calculate the duration
         auto numSamples = remainingSize / (info.bps >> 3);
         auto numSamplesPerChannel = numSamples / info.channels;
 
-        return static_cast<float>(numSamplesPerChannel) / info.freq;
+        SoundFileInfo result;
+
+        result.duration = static_cast<float>(numSamplesPerChannel) / info.freq;
+        result.channels = info.channels;
+        result.sampleRate = info.freq;
+
+        return result;
     }
 
 	/**
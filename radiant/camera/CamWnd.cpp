@@ -15,6 +15,7 @@
 
 #include "util/ScopedBoolLock.h"
 #include "iselectiontest.h"
+#include "iprofiler.h"
 #include "selectionlib.h"
 #include "gamelib.h"
 #include "CameraSettings.h"
@@ -641,6 +642,8 @@ void CamWnd::drawGrid()
 
 void CamWnd::Cam_Draw()
 {
+    profiling::ScopedZone zone("Camera view draw");
+
     wxSize glSize = _wxGLWidget->GetSize();
 
     if (_camera->getDeviceWidth() != glSize.GetWidth() || _camera->getDeviceHeight() != glSize.GetHeight())
@@ -777,7 +780,7 @@ void CamWnd::Cam_Draw()
     // Main scene render
     {
         // Front end (renderable collection from scene)
-        render::CamRenderer renderer(_view, _shaders);
+        render::CamRenderer renderer(_view, _shaders, &_lightInteractions);
         render::RenderableCollectionWalker::CollectRenderablesInScene(renderer, _view);
 
         // Accumulate render statistics
@@ -792,11 +795,26 @@ void CamWnd::Cam_Draw()
         }
 
         // Back end (submit to shaders and do the actual render)
-        renderer.submitToShaders(
-            getCameraSettings()->getRenderMode() == RENDER_MODE_LIGHTING
-        );
+        bool lightingMode = getCameraSettings()->getRenderMode() == RENDER_MODE_LIGHTING;
+        renderer.submitToShaders(lightingMode);
+
+        if (lightingMode)
+        {
+            const auto& interactions = renderer.getInteractionStatistics();
+
+            _renderStats.setInteractionStatistics(interactions.interactions,
+                interactions.rebuiltObjects, interactions.updateTimeUsec);
+
+            if (GlobalProfiler().isRunning())
+            {
+                GlobalProfiler().setCounter("Light interactions", static_cast<double>(interactions.interactions));
+                GlobalProfiler().setCounter("Rebuilt light lists", static_cast<double>(interactions.rebuiltObjects));
+            }
+        }
         GlobalRenderSystem().render(allowedRenderFlags, _camera->getModelView(),
                                     _camera->getProjection(), _view.getViewer());
+
+        _renderStats.setBackEndStatistics(GlobalRenderSystem().getFrameStatistics());
     }
 
     // greebo: Draw the clipper's points (skipping the depth-test)
@@ -896,6 +914,11 @@ bool CamWnd::onRender()
 
     if (GlobalMainFrame().screenUpdatesEnabled())
     {
+        if (GlobalProfiler().isRunning())
+        {
+            GlobalProfiler().markFrame("Camera view");
+        }
+
         debug::assertNoGlErrors();
 
         Cam_Draw();
@@ -91,6 +91,9 @@ class CamWnd :
     // Render statistics for display in the window (frame render time etc)
     render::RenderStatistics _renderStats;
 
+    // Light interactions of the previous frame, re-used in lighting mode
+    render::LightInteractionCache _lightInteractions;
+
     // Remembering the free movement type while holding down a key
     bool _freeMoveEnabled;
     unsigned int _freeMoveFlags;
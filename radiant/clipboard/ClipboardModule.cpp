@@ -21,8 +21,51 @@ namespace
 
         return hash;
     }
+
+    // Private format marking the contents set through setStringProvider()
+    const char* const PROVIDED_STRING_FORMAT = "application/x-darkradiant-provided-string";
+
+    // Text data object which asks the provider for the text the first time it's needed
+    class LazyTextDataObject :
+        public wxTextDataObject
+    {
+    private:
+        mutable std::function<std::string()> _provider;
+
+    public:
+        LazyTextDataObject(const std::function<std::string()>& provider) :
+            _provider(provider)
+        {}
+
+        size_t GetTextLength() const override
+        {
+            ensureText();
+            return wxTextDataObject::GetTextLength();
+        }
+
+        wxString GetText() const override
+        {
+            ensureText();
+            return wxTextDataObject::GetText();
+        }
+
+    private:
+        void ensureText() const
+        {
+            if (!_provider) return;
+
+            auto provider = std::move(_provider);
+            _provider = nullptr;
+
+            const_cast<LazyTextDataObject*>(this)->SetText(provider());
+        }
+    };
 }
 
+ClipboardModule::ClipboardModule() :
+    _isProvidingString(false)
+{}
+
 std::string ClipboardModule::getString()
 {
 	std::string returnValue;
@@ -51,12 +94,47 @@ void ClipboardModule::setString(const std::string& str)
 		wxTheClipboard->Close();
 
         _contentHash = getContentHash(str);
+        _isProvidingString = false;
 
         // Contents changed signal
         _sigContentsChanged.emit();
 	}
 }
 
+void ClipboardModule::setStringProvider(const std::function<std::string()>& provider)
+{
+    if (wxTheClipboard->Open())
+    {
+        auto data = new wxDataObjectComposite;
+        data->Add(new LazyTextDataObject(provider), true);
+
+        // The marker tells us whether the clipboard still holds our contents
+        auto marker = new wxCustomDataObject(wxDataFormat(PROVIDED_STRING_FORMAT));
+        marker->SetData(1, "1");
+        data->Add(marker);
+
+        wxTheClipboard->SetData(data);
+        wxTheClipboard->Close();
+
+        // The text is not known, any string found later on is a change
+        _contentHash.clear();
+        _isProvidingString = true;
+
+        _sigContentsChanged.emit();
+    }
+}
+
+bool ClipboardModule::isProvidingString()
+{
+    if (_isProvidingString && wxTheClipboard->Open())
+    {
+        _isProvidingString = wxTheClipboard->IsSupported(wxDataFormat(PROVIDED_STRING_FORMAT));
+        wxTheClipboard->Close();
+    }
+
+    return _isProvidingString;
+}
+
 sigc::signal<void>& ClipboardModule::signal_clipboardContentChanged()
 {
     return _sigContentsChanged;
@@ -90,6 +168,14 @@ void ClipboardModule::onAppActivated(wxActivateEvent& ev)
 {
     if (ev.GetActive())
     {
+        // Don't ask for the text as long as we're still the clipboard owner,
+        // this would invoke the string provider for nothing
+        if (_isProvidingString && isProvidingString())
+        {
+            ev.Skip();
+            return;
+        }
+
         // Inspect the clipboard when the main window regains focus
         // and fire the event if the contents changed
         auto newHash = getContentHash(getString());
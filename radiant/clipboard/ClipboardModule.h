@@ -14,9 +14,16 @@ private:
     sigc::signal<void> _sigContentsChanged;
     std::string _contentHash;
 
+    // True if the clipboard contents have been set by setStringProvider()
+    bool _isProvidingString;
+
 public:
+    ClipboardModule();
+
 	std::string getString() override;
 	void setString(const std::string& str) override;
+    void setStringProvider(const std::function<std::string()>& provider) override;
+    bool isProvidingString() override;
     virtual sigc::signal<void>& signal_clipboardContentChanged() override;
 
 	const std::string& getName() const override;
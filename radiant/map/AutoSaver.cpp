@@ -37,6 +37,7 @@ namespace
 	const char* RKEY_AUTOSAVE_ENABLED = "user/ui/map/autoSaveEnabled";
 	const char* RKEY_AUTOSAVE_INTERVAL = "user/ui/map/autoSaveInterval";
 	const char* RKEY_AUTOSAVE_SNAPSHOTS_ENABLED = "user/ui/map/autoSaveSnapshots";
+	const char* RKEY_AUTOSAVE_IN_BACKGROUND = "user/ui/map/autoSaveInBackground";
 	const char* RKEY_AUTOSAVE_SNAPSHOTS_FOLDER = "user/ui/map/snapshotFolder";
 	const char* RKEY_AUTOSAVE_MAX_SNAPSHOT_FOLDER_SIZE = "user/ui/map/maxSnapshotFolderSize";
 	const char* RKEY_AUTOSAVE_SNAPSHOT_FOLDER_SIZE_HISTORY = "user/ui/map/snapshotFolderSizeHistory";
@@ -141,7 +142,7 @@ void AutoMapSaver::saveSnapshot()
 		rMessage() << "Autosaving snapshot to " << filename << std::endl;
 
 		// Dump to map to the next available filename
-        GlobalCommandSystem().executeCommand("SaveMapCopyAs", filename);
+		saveMapCopy(filename);
 
 		handleSnapshotSizeLimit(existingSnapshots, snapshotPath, mapName);
 	}
@@ -152,6 +153,23 @@ void AutoMapSaver::saveSnapshot()
 	}
 }
 
+void AutoMapSaver::saveMapCopy(const std::string& filename)
+{
+	if (!registry::getValue<bool>(RKEY_AUTOSAVE_IN_BACKGROUND))
+	{
+		GlobalCommandSystem().executeCommand("SaveMapCopyAs", filename);
+		return;
+	}
+
+	// The map is written on a worker thread, editing is only blocked while the snapshot is taken
+	_backgroundSave = GlobalMapModule().saveCopyInBackground(filename);
+
+	if (_backgroundSave)
+	{
+		rMessage() << "Autosave paused editing for " << _backgroundSave->getPauseTime() << " msec" << std::endl;
+	}
+}
+
 void AutoMapSaver::handleSnapshotSizeLimit(const std::map<int, std::string>& existingSnapshots, 
 	const fs::path& snapshotPath, const std::string& mapName)
 {
@@ -238,6 +256,13 @@ void AutoMapSaver::checkSave()
 		return;
 	}
 
+	// Don't pile up autosaves if writing the previous one takes longer than the interval
+	if (_backgroundSave && !_backgroundSave->isFinished())
+	{
+		rMessage() << "Auto save skipped: the previous save is still being written" << std::endl;
+		return;
+	}
+
 	AutomaticMapSaveRequest request;
 	GlobalRadiantCore().getMessageBus().sendMessage(request);
 
@@ -283,7 +308,7 @@ void AutoMapSaver::checkSave()
 				rMessage() << "Autosaving unnamed map to " << autoSaveFilename << std::endl;
 
 				// Invoke the save call
-                GlobalCommandSystem().executeCommand("SaveMapCopyAs", autoSaveFilename);
+				saveMapCopy(autoSaveFilename);
 			}
 			else
 			{
@@ -299,7 +324,7 @@ void AutoMapSaver::checkSave()
 				rMessage() << "Autosaving map to " << filename << std::endl;
 
 				// Invoke the save call
-                GlobalCommandSystem().executeCommand("SaveMapCopyAs", filename);
+				saveMapCopy(filename);
 			}
 		}
 	}
@@ -321,6 +346,8 @@ void AutoMapSaver::constructPreferences()
 	page.appendCheckBox(_("Enable Autosave"), RKEY_AUTOSAVE_ENABLED);
 	page.appendSlider(_("Autosave Interval (in minutes)"), RKEY_AUTOSAVE_INTERVAL, 1, 61, 1, 1);
 
+	page.appendCheckBox(_("Save in the background"), RKEY_AUTOSAVE_IN_BACKGROUND);
+
 	page.appendCheckBox(_("Save Snapshots"), RKEY_AUTOSAVE_SNAPSHOTS_ENABLED);
 	page.appendEntry(_("Snapshot folder (relative to map folder)"), RKEY_AUTOSAVE_SNAPSHOTS_FOLDER);
 	page.appendEntry(_("Max total Snapshot size per map (MB)"), RKEY_AUTOSAVE_MAX_SNAPSHOT_FOLDER_SIZE);
@@ -410,6 +437,13 @@ void AutoMapSaver::shutdownModule()
 	_enabled = false;
 	stopTimer();
 
+	// Let a running save finish
+	if (_backgroundSave)
+	{
+		_backgroundSave->wait();
+		_backgroundSave.reset();
+	}
+
 	// Destroy the timer
 	_timer.reset();
 }
@@ -39,6 +39,9 @@ class AutoMapSaver :
 
 	std::vector<sigc::connection> _signalConnections;
 
+	// The most recent save running in the background (if any)
+	IBackgroundMapSave::Ptr _backgroundSave;
+
 public:
 	// Constructor
 	AutoMapSaver();
@@ -73,6 +76,9 @@ private:
 	// Saves a snapshot of the currently active map (only named maps)
 	void saveSnapshot();
 
+	// Saves a copy of the map to the given path, in the background if enabled
+	void saveMapCopy(const std::string& filename);
+
 	// This gets called when the interval time is over
     void onIntervalReached(wxTimerEvent& ev);
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <wx/stopwatch.h>
+#include "irender.h"
 #include "string/string.h"
 
 namespace render
@@ -19,6 +20,15 @@ class RenderStatistics
     int _visibleLights = 0;
     int _totalLights = 0;
 
+    // Counters reported by the render backend
+    FrameStatistics _backEnd;
+
+    // Light interactions (lighting mode only)
+    bool _hasInteractions = false;
+    std::size_t _interactions = 0;
+    std::size_t _rebuiltInteractions = 0;
+    std::size_t _interactionTimeUsec = 0;
+
 public:
 
     /// Return the constructed string for display
@@ -33,6 +43,14 @@ public:
              + " | f/e: " + std::to_string(_feTime) + " ms"
              + " | b/e: " + std::to_string(beTime) + " ms"
              + " | tot: " + std::to_string(totTime) + " ms"
+             + " | draws: " + std::to_string(_backEnd.drawCalls)
+             + " | states: " + std::to_string(_backEnd.stateChanges)
+             + " (" + std::to_string(_backEnd.skippedStateChanges) + " skipped)"
+             + " | queue: " + std::to_string(_backEnd.queueEntries)
+             + " / " + std::to_string(_backEnd.queueBuildTimeUsec) + " us"
+             + (_hasInteractions ? " | interactions: " + std::to_string(_interactions)
+                  + " (" + std::to_string(_rebuiltInteractions) + " rebuilt, "
+                  + std::to_string(_interactionTimeUsec) + " us)" : "")
              + " | fps: " + (totTime > 0 ? std::to_string(1000 / totTime) : "-");
     }
 
@@ -42,6 +60,21 @@ public:
         _feTime = _timer.Time();
     }
 
+    /// Store the counters of the back-end render stage
+    void setBackEndStatistics(const FrameStatistics& stats)
+    {
+        _backEnd = stats;
+    }
+
+    /// Store the light interaction counters of the front-end
+    void setInteractionStatistics(std::size_t interactions, std::size_t rebuilt, std::size_t timeUsec)
+    {
+        _hasInteractions = true;
+        _interactions = interactions;
+        _rebuiltInteractions = rebuilt;
+        _interactionTimeUsec = timeUsec;
+    }
+
     /// Set the light count
     void setLightCount(int visible, int total)
     {
@@ -54,7 +87,11 @@ public:
     {
         _visibleLights = _totalLights = 0;
 
+        _hasInteractions = false;
+        _interactions = _rebuiltInteractions = _interactionTimeUsec = 0;
+
         _feTime = 0;
+        _backEnd = FrameStatistics();
         _timer.Start();
     }
 };
@@ -345,9 +345,8 @@ void UserInterfaceModule::refreshShadersCmd(const cmd::ArgumentList& args)
 	// Disable screen updates for the scope of this function
 	auto blocker = GlobalMainFrame().getScopedScreenUpdateBlocker(_("Processing..."), _("Loading Shaders"));
 
-	// Reload the Shadersystem, this will also trigger an
-	// OpenGLRenderSystem unrealise/realise sequence as the rendersystem
-	// is attached to this class as Observer
+	// Reload the changed material files, the affected materials notify
+	// their OpenGLShaders which are re-constructing their passes
 	// We can't do this refresh() operation in a thread it seems due to context binding
 	GlobalMaterialManager().refresh();
 
@@ -19,6 +19,8 @@ namespace ui
 
 namespace
 {
+    const char* const DURATION_PLACEHOLDER = "--:--";
+
     inline std::string getDurationString(float durationInSeconds)
     {
         return fmt::format("{0:0.2f}s", durationInSeconds);
@@ -160,14 +162,22 @@ void SoundShaderPreview::update()
 		{
 			// Retrieve the list of associated filenames (VFS paths)
 			auto list = shader->getSoundFileList();
+			std::vector<std::string> unknownDurations;
 
 			for (std::size_t i = 0; i < list.size(); ++i)
 			{
 				auto row = _listStore->AddItem();
                 const auto& soundFile = list[i];
 
+				auto duration = getDurationOrPlaceholder(soundFile);
+
+				if (duration == DURATION_PLACEHOLDER)
+				{
+					unknownDurations.push_back(soundFile);
+				}
+
 				row[_columns.soundFile] = soundFile;
-				row[_columns.duration] = getDurationOrPlaceholder(soundFile);
+				row[_columns.duration] = duration;
 
 				row.SendItemAdded();
 
@@ -178,6 +188,12 @@ void SoundShaderPreview::update()
 				}
 			}
 
+			// Query all missing durations in one go
+			if (!unknownDurations.empty())
+			{
+				loadFileDurationsAsync(unknownDurations);
+			}
+
 			_shaderNameLabel->SetLabel(shader->getName());
 			_shaderFileLabel->SetLabel(shader->getShaderFilePath());
 			_shaderDescriptionSizer->Layout();
@@ -270,77 +286,61 @@ void SoundShaderPreview::onStop(wxCommandEvent& ev)
 
 std::string SoundShaderPreview::getDurationOrPlaceholder(const std::string& soundFile)
 {
-    {
-        std::lock_guard<std::mutex> lock(_durationsLock);
-
-        auto found = _durations.find(soundFile);
+    std::lock_guard<std::mutex> lock(_durationsLock);
 
-        if (found != _durations.end())
-        {
-            return getDurationString(found->second);
-        }
-    }
+    auto found = _durations.find(soundFile);
 
-    // No duration known yet, queue a task
-    loadFileDurationAsync(soundFile);
-    return "--:--";
+    // Unknown durations are queried by update() in a single batch
+    return found != _durations.end() ? getDurationString(found->second) : DURATION_PLACEHOLDER;
 }
 
-void SoundShaderPreview::loadFileDurationAsync(const std::string& soundFile)
+void SoundShaderPreview::loadFileDurationsAsync(const std::vector<std::string>& soundFiles)
 {
-    _durationQueries.enqueue([this, soundFile] // copy strings into lambda
+    _durationQueries.enqueue([this, soundFiles] // copy strings into lambda
     {
-        try
-        {
-            // In case the duration has been calculated in the meantime
-            // check if there's still need for this task to run
-            float duration = -1.0f;
-            {
-                std::lock_guard<std::mutex> lock(_durationsLock);
+        // Ask the sound manager for all files at once, it will
+        // serve most of them from its metadata index
+        auto fileInfo = GlobalSoundManager().getSoundFileInfo(soundFiles);
 
-                auto existing = _durations.find(soundFile);
-                
-                if (existing != _durations.end())
-                {
-                    duration = existing->second;
-                }
-            }
+        {
+            std::lock_guard<std::mutex> lock(_durationsLock);
 
-            if (duration < 0)
+            for (const auto& pair : fileInfo)
             {
-                // Duration still unknown, run the query
-                duration = GlobalSoundManager().getSoundFileDuration(soundFile);
-
-                // Store the duration in the local cache
-                std::lock_guard<std::mutex> lock(_durationsLock);
-                _durations[soundFile] = duration;
+                _durations[pair.first] = pair.second.duration;
             }
+        }
 
-            if (_isShuttingDown)
+        for (const auto& soundFile : soundFiles)
+        {
+            if (fileInfo.count(soundFile) == 0)
             {
-                // Don't dispatch anything if we're shutting down
-                return;
+                rError() << "Cannot query sound file duration of " << soundFile << std::endl;
             }
+        }
 
-            // Dispatch to UI thread when we're done
-            GetUserInterfaceModule().dispatch([this, soundFile, duration]()
+        if (_isShuttingDown)
+        {
+            // Don't dispatch anything if we're shutting down
+            return;
+        }
+
+        // Dispatch to UI thread when we're done
+        GetUserInterfaceModule().dispatch([this, fileInfo]()
+        {
+            // Load into treeview
+            for (const auto& pair : fileInfo)
             {
-                // Load into treeview
-                auto item = _listStore->FindString(soundFile, _columns.soundFile);
+                auto item = _listStore->FindString(pair.first, _columns.soundFile);
 
                 if (item.IsOk())
                 {
                     wxutil::TreeModel::Row row(item, *_listStore);
-                    row[_columns.duration] = getDurationString(duration);
+                    row[_columns.duration] = getDurationString(pair.second.duration);
                     row.SendItemChanged();
                 }
-            });
-        }
-        catch (const std::out_of_range& ex)
-        {
-            rError() << "Cannot query sound file duration of " << soundFile 
-                << ": " << ex.what() << std::endl;
-        }
+            }
+        });
     });
 }
 
@@ -4,6 +4,7 @@
 #include <mutex>
 #include <map>
 #include <memory>
+#include <vector>
 #include "wxutil/dataview/TreeModel.h"
 #include "wxutil/dataview/TreeView.h"
 #include "SequentialTaskQueue.h"
@@ -108,7 +109,7 @@ private:
 	void playSelectedFile(bool loop);
 	void handleSelectionChange();
 
-    void loadFileDurationAsync(const std::string& soundFile);
+    void loadFileDurationsAsync(const std::vector<std::string>& soundFiles);
     std::string getDurationOrPlaceholder(const std::string& soundFile);
 };
 
@@ -139,6 +139,13 @@ void EntityList::selectionChanged(const scene::INodePtr& node, bool isComponent)
 		return;
 	}
 
+	if (_treeModel.hasPendingChanges())
+	{
+		// The node might not be in the tree yet, the selection
+		// is updated after the scene changes have been applied
+		return;
+	}
+
 	_callbackActive = true;
 
 	_treeModel.updateSelectionStatus(node, std::bind(&EntityList::onTreeViewSelection, this,
@@ -159,12 +166,28 @@ void EntityList::onFilterConfigChanged()
 	}
 }
 
+void EntityList::onTreeModelChangesApplied()
+{
+	// Removed rows might have been selected, and deselections have been
+	// skipped while the changes were pending - start over
+	_selection.clear();
+
+	_callbackActive = true;
+
+	_treeView->UnselectAll();
+
+	_callbackActive = false;
+
+	update();
+}
+
 // Pre-hide callback
 void EntityList::_preHide()
 {
 	TransientWindow::_preHide();
 
 	_treeModel.disconnectFromSceneGraph();
+	_treeModelChangedConn.disconnect();
 
 	// Disconnect from the filters-changed signal
 	_filtersConfigChangedConn.disconnect();
@@ -188,6 +211,10 @@ void EntityList::_preShow()
 	// Observe the scenegraph
 	_treeModel.connectToSceneGraph();
 
+	_treeModelChangedConn = _treeModel.signal_changesApplied().connect(
+		sigc::mem_fun(*this, &EntityList::onTreeModelChangesApplied)
+	);
+
 	// Register self to the SelSystem to get notified upon selection changes.
 	GlobalSelectionSystem().addObserver(this);
 
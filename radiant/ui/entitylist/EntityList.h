@@ -41,6 +41,7 @@ private:
 	wxCheckBox* _visibleOnly;
 
 	sigc::connection _filtersConfigChangedConn;
+	sigc::connection _treeModelChangedConn;
 
 	struct DataViewItemLess
 	{
@@ -78,6 +79,9 @@ private:
 
 	void onFilterConfigChanged();
 
+	// Called after the tree model applied the queued scene changes
+	void onTreeModelChangesApplied();
+
 	void onRowExpand(wxDataViewEvent& ev);
 
 	// Called when the user is updating the treeview selection
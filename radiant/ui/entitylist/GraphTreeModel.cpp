@@ -29,61 +29,225 @@ void GraphTreeModel::connectToSceneGraph()
 void GraphTreeModel::disconnectFromSceneGraph()
 {
 	GlobalSceneGraph().removeSceneObserver(this);
+
+	// The model is refreshed when connecting again
+	clearPendingChanges();
 }
 
 const GraphTreeNodePtr& GraphTreeModel::insert(const scene::INodePtr& node)
 {
+	const GraphTreeNodePtr& existing = find(node);
+
+	if (existing)
+	{
+		return existing;
+	}
+
+	const GraphTreeNodePtr& gtNode = addRow(node);
+
+	wxutil::TreeModel::Row row(gtNode->getIter(), *_model);
+	row.SendItemAdded();
+
+	return gtNode;
+}
+
+void GraphTreeModel::insert(const std::vector<scene::INodePtr>& nodes)
+{
+	// Collect the new items per parent, in order of first appearance,
+	// such that parents are announced to the view before their children
+	std::vector<std::pair<wxDataViewItem, wxDataViewItemArray>> addedItems;
+	std::unordered_map<void*, std::size_t> parentIndices;
+
+	for (const scene::INodePtr& node : nodes)
+	{
+		if (_nodemap.count(node.get()) > 0) continue; // already present
+
+		const GraphTreeNodePtr& gtNode = addRow(node);
+		wxDataViewItem parent = _model->GetParent(gtNode->getIter());
+
+		auto index = parentIndices.emplace(parent.GetID(), addedItems.size());
+
+		if (index.second)
+		{
+			addedItems.emplace_back(parent, wxDataViewItemArray());
+		}
+
+		addedItems[index.first->second].second.push_back(gtNode->getIter());
+	}
+
+	for (const auto& pair : addedItems)
+	{
+		_model->ItemsAdded(pair.first, pair.second);
+	}
+}
+
+const GraphTreeNodePtr& GraphTreeModel::addRow(const scene::INodePtr& node)
+{
+	auto& entry = _nodemap[node.get()];
+
+	if (entry)
+	{
+		return entry; // already present
+	}
+
 	// Create a new GraphTreeNode
-	GraphTreeNodePtr gtNode(new GraphTreeNode(node));
+	entry.reset(new GraphTreeNode(node));
 
 	// Insert this iterator below a possible parent iterator
 	wxDataViewItem parentIter = findParentIter(node);
 
 	wxutil::TreeModel::Row row = parentIter ? _model->AddItem(parentIter) : _model->AddItem();
-	gtNode->getIter() = row.getItem();
+	entry->getIter() = row.getItem();
 
 	// Fill in the values
 	row[_columns.node] = wxVariant(static_cast<void*>(node.get()));
 	row[_columns.name] = node->name();
 
-	row.SendItemAdded();
-
-	// Insert this iterator into the node map to facilitate lookups
-	std::pair<NodeMap::iterator, bool> result = _nodemap.insert(
-		NodeMap::value_type(scene::INodeWeakPtr(node), gtNode)
-	);
-
 	// Return the GraphTreeNode reference
-	return result.first->second;
+	return entry;
 }
 
 void GraphTreeModel::erase(const scene::INodePtr& node)
 {
-	NodeMap::iterator found = _nodemap.find(scene::INodeWeakPtr(node));
+	erase(std::unordered_set<const scene::INode*>{ node.get() });
+}
+
+void GraphTreeModel::erase(const std::unordered_set<const scene::INode*>& nodes)
+{
+	std::unordered_set<void*> removedItems;
+	std::vector<wxDataViewItem> itemsToCheck;
 
-	if (found != _nodemap.end())
+	for (const scene::INode* node : nodes)
 	{
-		// Remove this from the model...
-		_model->RemoveItem(found->second->getIter());
+		auto found = _nodemap.find(node);
+
+		if (found == _nodemap.end()) continue;
+
+		removedItems.insert(found->second->getIter().GetID());
+		itemsToCheck.push_back(found->second->getIter());
 
-		// ...and from our lookup table
 		_nodemap.erase(found);
 	}
+
+	// The rows of the removed nodes take their children with them,
+	// drop any child rows that haven't been removed explicitly
+	while (!itemsToCheck.empty())
+	{
+		wxDataViewItem item = itemsToCheck.back();
+		itemsToCheck.pop_back();
+
+		wxDataViewItemArray children;
+		_model->GetChildren(item, children);
+
+		for (const wxDataViewItem& child : children)
+		{
+			wxutil::TreeModel::Row row(child, *_model);
+			auto found = _nodemap.find(static_cast<scene::INode*>(row[_columns.node].getPointer()));
+
+			if (found != _nodemap.end() && found->second->getIter() == child)
+			{
+				_nodemap.erase(found);
+			}
+
+			removedItems.insert(child.GetID());
+			itemsToCheck.push_back(child);
+		}
+	}
+
+	// Remove the topmost rows only, grouped by their parent
+	std::unordered_map<void*, std::pair<wxDataViewItem, wxDataViewItemArray>> itemsByParent;
+
+	for (void* id : removedItems)
+	{
+		wxDataViewItem item(id);
+		wxDataViewItem parent = _model->GetParent(item);
+
+		if (removedItems.count(parent.GetID()) > 0) continue;
+
+		auto& entry = itemsByParent[parent.GetID()];
+		entry.first = parent;
+		entry.second.push_back(item);
+	}
+
+	for (const auto& pair : itemsByParent)
+	{
+		_model->RemoveItems(pair.second.first, pair.second.second);
+	}
 }
 
 const GraphTreeNodePtr& GraphTreeModel::find(const scene::INodePtr& node) const
 {
-	NodeMap::const_iterator found = _nodemap.find(scene::INodeWeakPtr(node));
+	NodeMap::const_iterator found = _nodemap.find(node.get());
 	return (found != _nodemap.end()) ? found->second : _nullTreeNode;
 }
 
 void GraphTreeModel::clear()
 {
 	// Remove everything, wx plus nodemap
+	clearPendingChanges();
 	_nodemap.clear();
 	_model->Clear();
 }
 
+bool GraphTreeModel::hasPendingChanges() const
+{
+	return !_pendingInsertSet.empty() || !_pendingErases.empty();
+}
+
+void GraphTreeModel::applyPendingChanges()
+{
+	if (!hasPendingChanges())
+	{
+		clearPendingChanges();
+		return;
+	}
+
+	// Removals first, a removed node might have been re-inserted in the meantime
+	std::unordered_set<const scene::INode*> erases;
+	erases.swap(_pendingErases);
+
+	erase(erases);
+
+	std::vector<scene::INodePtr> inserts;
+	inserts.reserve(_pendingInsertSet.size());
+
+	for (const scene::INodeWeakPtr& weak : _pendingInserts)
+	{
+		scene::INodePtr node = weak.lock();
+
+		// Skip nodes that have been removed again
+		if (node && _pendingInsertSet.erase(node.get()) > 0)
+		{
+			inserts.push_back(node);
+		}
+	}
+
+	clearPendingChanges();
+
+	insert(inserts);
+
+	_sigChangesApplied.emit();
+}
+
+sigc::signal<void>& GraphTreeModel::signal_changesApplied()
+{
+	return _sigChangesApplied;
+}
+
+void GraphTreeModel::clearPendingChanges()
+{
+	_pendingInserts.clear();
+	_pendingInsertSet.clear();
+	_pendingErases.clear();
+
+	cancelCallbacks();
+}
+
+void GraphTreeModel::onIdle()
+{
+	applyPendingChanges();
+}
+
 void GraphTreeModel::refresh()
 {
 #if defined(__linux__)
@@ -98,6 +262,8 @@ void GraphTreeModel::refresh()
 	GraphTreeModelPopulator populator(*this, _visibleNodesOnly);
 	GlobalSceneGraph().root()->traverse(populator);
 
+	insert(populator.getNodes());
+
     // Now sort the model once we have all nodes in the tree
     _model->SortModelByColumn(_columns.name);
 }
@@ -119,7 +285,7 @@ void GraphTreeModel::updateSelectionStatus(const NotifySelectionUpdateFunc& noti
 void GraphTreeModel::updateSelectionStatus(const scene::INodePtr& node,
 										   const NotifySelectionUpdateFunc& notifySelectionChanged)
 {
-	NodeMap::const_iterator found = _nodemap.find(scene::INodeWeakPtr(node));
+	NodeMap::const_iterator found = _nodemap.find(node.get());
 
 	GraphTreeNodePtr foundNode;
 
@@ -153,7 +319,7 @@ const GraphTreeNodePtr& GraphTreeModel::findParentNode(const scene::INodePtr& no
 	}
 
 	// Try to find the node
-	NodeMap::const_iterator found = _nodemap.find(scene::INodeWeakPtr(parent));
+	NodeMap::const_iterator found = _nodemap.find(parent.get());
 
 	// Return NULL (empty shared_ptr) if not found
 	return (found != _nodemap.end()) ? found->second : _nullTreeNode;
@@ -181,13 +347,27 @@ wxutil::TreeModel::Ptr GraphTreeModel::getModel()
 // Gets called when a new <instance> is inserted into the scenegraph
 void GraphTreeModel::onSceneNodeInsert(const scene::INodePtr& node)
 {
-	insert(node); // wrap to the actual insert() method
+	// Queue the change, it is applied in the next idle cycle
+	if (_pendingInsertSet.insert(node.get()).second)
+	{
+		_pendingInserts.push_back(node);
+	}
+
+	requestIdleCallback();
 }
 
 // Gets called when <instance> is removed from the scenegraph
 void GraphTreeModel::onSceneNodeErase(const scene::INodePtr& node)
 {
-	erase(node); // wrap to the actual erase() method
+	// A node that hasn't been applied yet is just dropped from the queue
+	_pendingInsertSet.erase(node.get());
+
+	if (_nodemap.count(node.get()) > 0)
+	{
+		_pendingErases.insert(node.get());
+	}
+
+	requestIdleCallback();
 }
 
 } // namespace ui
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <memory>
-#include <map>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <sigc++/signal.h>
 #include "iscenegraph.h"
 #include "GraphTreeNode.h"
 
 #include "wxutil/dataview/TreeModel.h"
+#include "wxutil/event/SingleIdleCallback.h"
 
 namespace ui
 {
@@ -16,9 +20,14 @@ namespace ui
  *
  * The class provides basic routines to insert/remove scene::INodePtrs
  * into the model (the lookup should be performed fast).
+ *
+ * Insertions and removals reported by the scenegraph are queued and applied
+ * in the next idle cycle, such that large changes (like deleting thousands
+ * of entities) result in a single notification per parent item.
  */
 class GraphTreeModel :
-	public scene::Graph::Observer
+	public scene::Graph::Observer,
+	public wxutil::SingleIdleCallback
 {
 public:
 	struct TreeColumns :
@@ -34,10 +43,21 @@ public:
 	};
 
 private:
-	// This maps scene::Nodes to TreeNode structures to allow fast lookups in the tree
-    typedef std::map<scene::INodeWeakPtr, GraphTreeNodePtr, std::owner_less<scene::INodeWeakPtr> > NodeMap;
+	// This maps scene::Nodes to TreeNode structures to allow fast lookups in the tree.
+	// Entries are removed as soon as the scenegraph reports the node's removal,
+	// stale pointers are never dereferenced.
+	typedef std::unordered_map<const scene::INode*, GraphTreeNodePtr> NodeMap;
 	NodeMap _nodemap;
 
+	// Scene changes waiting to be applied in the next idle cycle.
+	// Nodes removed before being applied are dropped from the insert set.
+	std::vector<scene::INodeWeakPtr> _pendingInserts;
+	std::unordered_set<const scene::INode*> _pendingInsertSet;
+	std::unordered_set<const scene::INode*> _pendingErases;
+
+	// Emitted after the queued changes have been applied
+	sigc::signal<void> _sigChangesApplied;
+
 	// The NULL treenode, must always be empty
 	const GraphTreeNodePtr _nullTreeNode;
 
@@ -57,6 +77,19 @@ public:
 	// Removes the given instance from the tree
 	void erase(const scene::INodePtr& node);
 
+	// Inserts the given nodes (parents before their children), notifying the
+	// view once per parent item
+	void insert(const std::vector<scene::INodePtr>& nodes);
+
+	// True if there are scene changes waiting to be applied
+	bool hasPendingChanges() const;
+
+	// Applies the queued scene changes right away
+	void applyPendingChanges();
+
+	// Emitted after queued scene changes have been applied to the model
+	sigc::signal<void>& signal_changesApplied();
+
 	// Tries to lookup the given node in the tree, can return the NULL node
 	const GraphTreeNodePtr& find(const scene::INodePtr& node) const;
 
@@ -95,6 +128,17 @@ public:
 	void onSceneNodeErase(const scene::INodePtr& node);
 
 private:
+	// Adds the row of the given node without notifying the view
+	const GraphTreeNodePtr& addRow(const scene::INodePtr& node);
+
+	// Removes the nodes with the given pointers, along with their rows' children
+	void erase(const std::unordered_set<const scene::INode*>& nodes);
+
+	void clearPendingChanges();
+
+	// SingleIdleCallback implementation
+	void onIdle() override;
+
 	// Looks up the parent of the given node, can return NULL (empty shared_ptr)
 	const GraphTreeNodePtr& findParentNode(const scene::INodePtr& node) const;
 
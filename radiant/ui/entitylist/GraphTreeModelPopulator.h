@@ -8,7 +8,7 @@ namespace ui {
 
 /**
  * greebo: The purpose of this class is to traverse the entire scenegraph and
- *         push all the found nodes into the given GraphTreeModel.
+ *         collect all the nodes to be inserted into the given GraphTreeModel.
  *
  * This is used by the GraphTreeModel itself to update its status on show.
  */
@@ -21,6 +21,9 @@ private:
 
 	bool _visibleNodesOnly;
 
+	// The nodes to insert, parents before their children
+	std::vector<scene::INodePtr> _nodes;
+
 public:
 	GraphTreeModelPopulator(GraphTreeModel& model, bool visibleNodesOnly) :
 		_model(model),
@@ -35,8 +38,8 @@ public:
 	{
 		if ((!_visibleNodesOnly || node->visible()) && node->getNodeType() != scene::INode::Type::EntityConnection)
 		{
-			// Insert this node into the GraphTreeModel
-			_model.insert(node);
+			// Remember this node, the model inserts all of them in one go
+			_nodes.push_back(node);
 		}
 
 		Entity* ent = Node_getEntity(node);
@@ -48,6 +51,11 @@ public:
 
 		return true; // traverse children
 	}
+
+	const std::vector<scene::INodePtr>& getNodes() const
+	{
+		return _nodes;
+	}
 };
 
 } // namespace ui
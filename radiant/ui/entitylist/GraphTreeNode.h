@@ -1,5 +1,6 @@
 #pragma once
 
+#include "inode.h"
 #include "wxutil/dataview/TreeModel.h"
 
 namespace ui
@@ -14,8 +15,8 @@ namespace ui
 class GraphTreeNode
 {
 private:
-	// A reference to the actual node
-	const scene::INodePtr& _node;
+	// The actual node
+	scene::INodeWeakPtr _node;
 
 	// The iterator pointing to the row in a wxutil::TreeModel
 	wxDataViewItem _iter;
@@ -30,9 +31,9 @@ public:
 		return _iter;
 	}
 
-	const scene::INodePtr& getNode() const
+	scene::INodePtr getNode() const
 	{
-		return _node;
+		return _node.lock();
 	}
 };
 typedef std::shared_ptr<GraphTreeNode> GraphTreeNodePtr;
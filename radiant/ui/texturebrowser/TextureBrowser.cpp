@@ -8,6 +8,7 @@
 #include "icolourscheme.h"
 #include "igroupdialog.h"
 #include "iradiant.h"
+#include "irender.h"
 #include "ifavourites.h"
 #include "ipreferencesystem.h"
 #include "imediabrowser.h"
@@ -24,7 +25,9 @@
 
 #include "string/predicate.h"
 #include <functional>
+#include <algorithm>
 
+#include <wx/app.h>
 #include <wx/panel.h>
 #include <wx/wxprec.h>
 #include <wx/toolbar.h>
@@ -35,6 +38,7 @@
 #include "string/case_conv.h"
 #include "debugging/gl.h"
 #include "TextureBrowserManager.h"
+#include "TextureTileLoader.h"
 
 namespace ui
 {
@@ -52,6 +56,12 @@ namespace
 
     const int VIEWPORT_BORDER = 12;
     const int TILE_BORDER = 2;
+
+    // The texture size assumed for tiles whose texture hasn't been loaded yet
+    const int PLACEHOLDER_TEXTURE_SIZE = 256;
+
+    // The number of surfaces capturing their deferred shaders per idle event
+    const std::size_t SHADER_CAPTURES_PER_IDLE = 20000;
 }
 
 class TextureBrowser::TextureTile
@@ -63,8 +73,12 @@ public:
     Vector2i position;
     MaterialPtr material;
 
+    // Whether the size has been taken from the texture, or is a placeholder
+    bool hasTexture;
+
     TextureTile(TextureBrowser& owner) :
-        _owner(owner)
+        _owner(owner),
+        hasTexture(false)
     {}
 
     bool isVisible()
@@ -79,15 +93,28 @@ public:
             return;
         }
 
-        TexturePtr texture = material->getEditorImage();
-        if (!texture) return;
-
         // Is this texture visible?
         if ((position.y() - size.y() - FONT_HEIGHT() < _owner.getOriginY()) &&
             (position.y() > _owner.getOriginY() - _owner.getViewportHeight()))
         {
             drawBorder();
-            drawTextureQuad(texture->getGLTexNum());
+
+            // Never load the texture here, tiles are waiting for the background loader
+            if (material->isEditorImageRealised())
+            {
+                if (!hasTexture)
+                {
+                    // The texture has been loaded elsewhere, the tile might need a different size
+                    _owner.queueUpdate();
+                }
+
+                drawTextureQuad(material->getEditorImage()->getGLTexNum());
+            }
+            else
+            {
+                drawPlaceholder();
+            }
+
             drawTextureName();
         }
     }
@@ -183,6 +210,21 @@ private:
         glEnd();
     }
 
+    void drawPlaceholder()
+    {
+        glDisable(GL_TEXTURE_2D);
+        glColor3f(0.3f, 0.3f, 0.3f);
+
+        glBegin(GL_QUADS);
+        glVertex2i(position.x(), position.y() - FONT_HEIGHT());
+        glVertex2i(position.x() + size.x(), position.y() - FONT_HEIGHT());
+        glVertex2i(position.x() + size.x(), position.y() - FONT_HEIGHT() - size.y());
+        glVertex2i(position.x(), position.y() - FONT_HEIGHT() - size.y());
+        glEnd();
+
+        glEnable(GL_TEXTURE_2D);
+    }
+
     void drawTextureName()
     {
         glDisable(GL_TEXTURE_2D);
@@ -231,7 +273,8 @@ TextureBrowser::TextureBrowser(wxWindow* parent) :
     _showOtherMaterials(registry::getValue<bool>(RKEY_TEXTURES_SHOW_OTHER_MATERIALS)),
     _uniformTextureSize(registry::getValue<int>(RKEY_TEXTURE_UNIFORM_SIZE)),
     _maxNameLength(registry::getValue<int>(RKEY_TEXTURE_MAX_NAME_LENGTH)),
-    _updateNeeded(true)
+    _updateNeeded(true),
+    _tileLoader(new TextureTileLoader([]() { wxWakeUpIdle(); }))
 {
     observeKey(RKEY_TEXTURES_HIDE_UNUSED);
     observeKey(RKEY_TEXTURES_SHOW_OTHER_MATERIALS);
@@ -479,6 +522,15 @@ int TextureBrowser::getTextureWidth(const Texture& tex) const
     }
 }
 
+TextureBrowser::Vector2i TextureBrowser::getPlaceholderSize() const
+{
+    // Until the texture is loaded the tile is assumed to be square
+    int size = _useUniformScale ? _uniformTextureSize :
+        static_cast<int>(PLACEHOLDER_TEXTURE_SIZE * (static_cast<float>(_textureScale) / 100));
+
+    return Vector2i(size, size);
+}
+
 int TextureBrowser::getTextureHeight(const Texture& tex) const
 {
     if (!_useUniformScale)
@@ -518,7 +570,7 @@ void TextureBrowser::setSelectedShader(const std::string& newShader)
 }
 
 // Data structure keeping track of the virtual position for the next texture to
-// be drawn in. Only the getPositionForTexture() method should access the values
+// be drawn in. Only the getPositionForTile() method should access the values
 // in this structure.
 class TextureBrowser::CurrentPosition
 {
@@ -532,11 +584,11 @@ public:
     int rowAdvance;
 };
 
-TextureBrowser::Vector2i TextureBrowser::getPositionForTexture(
-    CurrentPosition& currentPos, const Texture& tex) const
+TextureBrowser::Vector2i TextureBrowser::getPositionForTile(
+    CurrentPosition& currentPos, const Vector2i& size) const
 {
-    int nWidth = getTextureWidth(tex);
-    int nHeight = getTextureHeight(tex);
+    int nWidth = size.x();
+    int nHeight = size.y();
 
     // Wrap to the next row if there is not enough horizontal space for this
     // texture
@@ -651,6 +703,7 @@ void TextureBrowser::setOriginY(int newOriginY)
     _viewportOriginY = newOriginY;
     clampOriginY();
     updateScroll();
+    requestVisibleTextures();
     queueDraw();
 }
 
@@ -690,11 +743,23 @@ void TextureBrowser::performUpdate()
 
         tile.material = mat;
 
-        Texture& texture = *tile.material->getEditorImage();
+        // Only the textures loaded already are taken into account, the
+        // others are requested below and the layout is updated as they arrive
+        tile.hasTexture = mat->isEditorImageRealised();
+
+        if (tile.hasTexture)
+        {
+            Texture& texture = *tile.material->getEditorImage();
 
-        tile.position = getPositionForTexture(layout, texture);
-        tile.size.x() = getTextureWidth(texture);
-        tile.size.y() = getTextureHeight(texture);
+            tile.size.x() = getTextureWidth(texture);
+            tile.size.y() = getTextureHeight(texture);
+        }
+        else
+        {
+            tile.size = getPlaceholderSize();
+        }
+
+        tile.position = getPositionForTile(layout, tile.size);
 
         _entireSpaceHeight = std::max(
             _entireSpaceHeight,
@@ -703,10 +768,106 @@ void TextureBrowser::performUpdate()
     });
 
     updateScroll();
+    requestVisibleTextures();
+}
+
+void TextureBrowser::requestVisibleTextures()
+{
+    int viewportTop = getOriginY();
+    int viewportBottom = viewportTop - getViewportHeight();
+
+    // Prefetch the tiles up to one viewport height above and below the visible area
+    int rangeTop = viewportTop + getViewportHeight();
+    int rangeBottom = viewportBottom - getViewportHeight();
+
+    std::vector<std::pair<int, const TextureTile*>> candidates;
+
+    for (const TextureTile& tile : _tiles)
+    {
+        int tileTop = tile.position.y();
+        int tileBottom = tile.position.y() - tile.size.y() - FONT_HEIGHT();
+
+        if (tileBottom > rangeTop || tileTop < rangeBottom || tile.material->isEditorImageRealised())
+        {
+            continue;
+        }
+
+        // Visible tiles come first, then ordered by their distance to the viewport
+        int distance = tileBottom > viewportTop ? tileBottom - viewportTop :
+            tileTop < viewportBottom ? viewportBottom - tileTop : 0;
+
+        candidates.emplace_back(distance, &tile);
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+    {
+        return a.first < b.first;
+    });
+
+    std::vector<TextureTileLoader::Request> requests;
+    requests.reserve(candidates.size());
+
+    for (const auto& candidate : candidates)
+    {
+        const auto& material = candidate.second->material;
+        requests.emplace_back(TextureTileLoader::Request{ material->getName(), material->getEditorImageLoader() });
+    }
+
+    _tileLoader->setRequests(std::move(requests));
+}
+
+void TextureBrowser::collectLoadedTextures()
+{
+    auto results = _tileLoader->collectResults();
+
+    if (results.empty())
+    {
+        return;
+    }
+
+    std::map<std::string, ImagePtr> images;
+
+    for (auto& result : results)
+    {
+        images[result.materialName] = std::move(result.image);
+    }
+
+    bool layoutChanged = false;
+
+    for (TextureTile& tile : _tiles)
+    {
+        auto found = images.find(tile.material->getName());
+
+        if (found == images.end())
+        {
+            continue;
+        }
+
+        // Create the GL texture, this is the only part happening on the UI thread
+        tile.material->realiseEditorImage(found->second);
+        tile.hasTexture = true;
+
+        Texture& texture = *tile.material->getEditorImage();
+
+        if (tile.size != Vector2i(getTextureWidth(texture), getTextureHeight(texture)))
+        {
+            layoutChanged = true;
+        }
+    }
+
+    if (layoutChanged)
+    {
+        queueUpdate();
+    }
+
+    queueDraw();
 }
 
 void TextureBrowser::onActiveShadersChanged()
 {
+    // The images of the previous materials are outdated
+    _tileLoader->clear();
+
     queueUpdate();
 }
 
@@ -998,6 +1159,21 @@ void TextureBrowser::onGLMouseButtonRelease(wxMouseEvent& ev)
 
 void TextureBrowser::onIdle(wxIdleEvent& ev)
 {
+    collectLoadedTextures();
+
+    // Materials are flagged as in use when the surfaces capture their shaders.
+    // Surfaces that haven't been rendered yet are deferring the capture, let
+    // them catch up in batches as long as the unused materials are hidden.
+    if (_hideUnused && GlobalRenderSystem().captureDeferredShaders(0) > 0)
+    {
+        if (GlobalRenderSystem().captureDeferredShaders(SHADER_CAPTURES_PER_IDLE) > 0)
+        {
+            ev.RequestMore();
+        }
+
+        queueUpdate();
+    }
+
     if (_updateNeeded)
     {
         performUpdate();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <sigc++/connection.h>
 #include "iregistry.h"
 #include "icommandsystem.h"
@@ -24,6 +25,8 @@ class wxToolBar;
 namespace ui 
 {
 
+class TextureTileLoader;
+
 namespace
 {
     const char* const RKEY_TEXTURES_HIDE_UNUSED = "user/ui/textures/browser/hideUnused";
@@ -45,6 +48,10 @@ namespace
  *
  * Uses an OpenGL widget to render a rectangular view into a "virtual space"
  * containing all active texture tiles.
+ *
+ * The layout doesn't wait for the textures to be loaded: tiles without a
+ * texture are shown as placeholders, and the textures of the tiles in and
+ * around the viewport are loaded in the background, closest tiles first.
  */
 class TextureBrowser :
     public wxPanel,
@@ -127,6 +134,9 @@ class TextureBrowser :
 
     // renderable items will be updated next round
     bool _updateNeeded;
+
+    // Loads the images of the tiles around the viewport
+    std::unique_ptr<TextureTileLoader> _tileLoader;
     
 public:
     // Constructor
@@ -166,11 +176,20 @@ private:
     int getTextureWidth(const Texture& tex) const;
     int getTextureHeight(const Texture& tex) const;
 
-    // Get a new position for the given texture, and advance the CurrentPosition
-    // state object.
+    // Return the display size of a tile whose texture hasn't been loaded yet
+    Vector2i getPlaceholderSize() const;
+
+    // Get a new position for a tile of the given size, and advance the
+    // CurrentPosition state object.
     class CurrentPosition;
-    Vector2i getPositionForTexture(CurrentPosition& layout,
-                                   const Texture& texture) const;
+    Vector2i getPositionForTile(CurrentPosition& layout,
+                                const Vector2i& size) const;
+
+    // Submits the tiles without texture in and around the viewport to the loader
+    void requestVisibleTextures();
+
+    // Creates the textures of the images loaded in the background
+    void collectLoadedTextures();
 
     bool checkSeekInMediaBrowser(); // sensitivity check
     void onSeekInMediaBrowser();
@@ -0,0 +1,114 @@
+#include "TextureTileLoader.h"
+
+#include <algorithm>
+
+namespace ui
+{
+
+TextureTileLoader::TextureTileLoader(const std::function<void()>& resultsAvailable) :
+    _generation(0),
+    _shutdown(false),
+    _resultsAvailable(resultsAvailable)
+{
+    // Leave some cores to the rest of the application
+    auto numWorkers = std::max(std::thread::hardware_concurrency() / 2, 1u);
+
+    for (unsigned int i = 0; i < numWorkers; ++i)
+    {
+        _workers.emplace_back(std::bind(&TextureTileLoader::processRequests, this));
+    }
+}
+
+TextureTileLoader::~TextureTileLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _shutdown = true;
+        _requests.clear();
+    }
+
+    _requestsAvailable.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+void TextureTileLoader::setRequests(std::vector<Request>&& requests)
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        requests.erase(std::remove_if(requests.begin(), requests.end(), [&](const Request& request)
+        {
+            return _inProgress.count(request.materialName) > 0;
+        }), requests.end());
+
+        _requests = std::move(requests);
+    }
+
+    _requestsAvailable.notify_all();
+}
+
+std::vector<TextureTileLoader::Result> TextureTileLoader::collectResults()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    std::vector<Result> results;
+    results.swap(_results);
+
+    return results;
+}
+
+void TextureTileLoader::clear()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _requests.clear();
+    _results.clear();
+    ++_generation;
+}
+
+void TextureTileLoader::processRequests()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+
+    while (true)
+    {
+        _requestsAvailable.wait(lock, [this]() { return _shutdown || !_requests.empty(); });
+
+        if (_shutdown) return;
+
+        // Take the most important request
+        auto request = std::move(_requests.front());
+        _requests.erase(_requests.begin());
+
+        auto generation = _generation;
+        ++_inProgress[request.materialName];
+
+        lock.unlock();
+
+        auto image = request.loader();
+
+        lock.lock();
+
+        auto inProgress = _inProgress.find(request.materialName);
+
+        if (--inProgress->second == 0)
+        {
+            _inProgress.erase(inProgress);
+        }
+
+        if (generation != _generation) continue;
+
+        _results.emplace_back(Result{ std::move(request.materialName), std::move(image) });
+
+        if (_resultsAvailable)
+        {
+            _resultsAvailable();
+        }
+    }
+}
+
+}
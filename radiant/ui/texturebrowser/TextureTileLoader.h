@@ -0,0 +1,81 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+#include "ishaders.h"
+
+namespace ui
+{
+
+/**
+ * Loads the editor images of the texture browser tiles in worker threads.
+ *
+ * The browser submits the tiles around its viewport, ordered by their distance
+ * to it, each time the layout or the scroll position changes. Requests that
+ * are no longer submitted are dropped from the queue. Loads already running
+ * can't be interrupted, their images are delivered nonetheless.
+ *
+ * Only the image data is loaded in the workers, the browser collects the
+ * finished images on the main thread and creates the textures from them.
+ */
+class TextureTileLoader
+{
+public:
+    struct Request
+    {
+        std::string materialName;
+        Material::EditorImageLoader loader;
+    };
+
+    struct Result
+    {
+        std::string materialName;
+        ImagePtr image;
+    };
+
+private:
+    std::mutex _lock;
+    std::condition_variable _requestsAvailable;
+
+    // The pending requests, the most important one first
+    std::vector<Request> _requests;
+
+    // The names of the materials currently loaded by a worker
+    std::map<std::string, std::size_t> _inProgress;
+
+    std::vector<Result> _results;
+
+    // Incremented by clear(), results of earlier generations are discarded
+    std::size_t _generation;
+
+    bool _shutdown;
+
+    std::vector<std::thread> _workers;
+
+    // Invoked in a worker thread after a result has been added
+    std::function<void()> _resultsAvailable;
+
+public:
+    TextureTileLoader(const std::function<void()>& resultsAvailable);
+
+    ~TextureTileLoader();
+
+    // Replaces the queue by the given requests, ordered by priority.
+    // Materials already being loaded are skipped.
+    void setRequests(std::vector<Request>&& requests);
+
+    // Returns (and removes) the finished images
+    std::vector<Result> collectResults();
+
+    // Drops all pending requests and discards the results of the running loads
+    void clear();
+
+private:
+    void processRequests();
+};
+
+}
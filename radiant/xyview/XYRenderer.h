@@ -61,6 +61,32 @@ public:
                        const Matrix4& localToWorld,
                        const LitObject* /* litObject */,
                        const IRenderEntity* entity = nullptr) override
+    {
+        forEachTargetShader(shader, [&](Shader& targetShader)
+        {
+            targetShader.addRenderable(renderable, localToWorld, nullptr, entity);
+        });
+    }
+
+    void addGeometry(Shader& shader, render::IGeometryStore::Slot slot,
+                     render::GeometryType type) override
+    {
+        forEachTargetShader(shader, [&](Shader& targetShader)
+        {
+            targetShader.addGeometry(slot, type);
+        });
+    }
+
+    void render(const Matrix4& modelview, const Matrix4& projection)
+    {
+        GlobalRenderSystem().render(_globalstate, modelview, projection, Vector3(0,0,0));
+    }
+
+private:
+    // Invokes the functor for each shader an object submitted with the given
+    // shader should end up in, according to the current highlight flags
+    template<typename Functor>
+    void forEachTargetShader(Shader& shader, const Functor& functor)
     {
         if (_editMode == IMap::EditMode::Merge)
         {
@@ -73,19 +99,19 @@ public:
 
                 if (mergeShader)
                 {
-                    mergeShader->addRenderable(renderable, localToWorld, nullptr, entity);
+                    functor(*mergeShader);
                 }
             }
             else
             {
                 // Everything else is using the shader for non-merge-affected nodes
-                _shaders.nonMergeActionNodeShader->addRenderable(renderable, localToWorld, nullptr, entity);
+                functor(*_shaders.nonMergeActionNodeShader);
             }
 
             // Elements can still be selected in merge mode
             if ((_flags & Highlight::Flags::Primitives) != 0)
             {
-                _shaders.selectedShader->addRenderable(renderable, localToWorld, nullptr, entity);
+                functor(*_shaders.selectedShader);
             }
 
             return;
@@ -96,19 +122,14 @@ public:
         {
             if ((_flags & Highlight::Flags::GroupMember) != 0)
             {
-                _shaders.selectedShaderGroup->addRenderable(renderable, localToWorld, nullptr, entity);
+                functor(*_shaders.selectedShaderGroup);
             }
             else
             {
-                _shaders.selectedShader->addRenderable(renderable, localToWorld, nullptr, entity);
+                functor(*_shaders.selectedShader);
             }
         }
 
-        shader.addRenderable(renderable, localToWorld, nullptr, entity);
-    }
-
-    void render(const Matrix4& modelview, const Matrix4& projection)
-    {
-        GlobalRenderSystem().render(_globalstate, modelview, projection, Vector3(0,0,0));
+        functor(shader);
     }
 }; // class XYRenderer
@@ -17,6 +17,7 @@
 #include "selectionlib.h"
 
 #include "ibrush.h"
+#include "iprofiler.h"
 #include "camera/CameraSettings.h"
 #include "ui/ortho/OrthoContextMenu.h"
 #include "ui/overlay/Overlay.h"
@@ -1320,6 +1321,8 @@ void XYWnd::updateModelview() {
 
 void XYWnd::draw()
 {
+    profiling::ScopedZone zone("Ortho view draw");
+
     ensureFont();
 
     // clear
@@ -1607,6 +1610,11 @@ bool XYWnd::onRender()
 	{
         util::ScopedBoolLock drawLock(_drawing);
 
+        if (GlobalProfiler().isRunning())
+        {
+            GlobalProfiler().markFrame("Ortho view");
+        }
+
 		draw();
 
         return true;
@@ -7,9 +7,11 @@
 
 #include "BrushModule.h"
 #include "BrushNode.h"
+#include "ChangedBrushSet.h"
 #include "Face.h"
 #include "FixedWinding.h"
 #include "math/Ray.h"
+#include "util/BlockPool.h"
 
 #include <functional>
 
@@ -39,10 +41,14 @@ Brush::Brush(BrushNode& owner) :
     _owner(owner),
     _undoStateSaver(nullptr),
     _mapFileChangeTracker(nullptr),
+    _materialUsageIndex(nullptr),
     _faceCentroidPoints(GL_POINTS),
     _uniqueVertexPoints(GL_POINTS),
     _uniqueEdgePoints(GL_POINTS),
     m_planeChanged(false),
+    _windingsPrepared(false),
+    _windingsDegenerate(false),
+    _inScene(false),
     m_transformChanged(false),
 	_detailFlag(Structural)
 {
@@ -53,10 +59,14 @@ Brush::Brush(BrushNode& owner, const Brush& other) :
     _owner(owner),
     _undoStateSaver(nullptr),
     _mapFileChangeTracker(nullptr),
+    _materialUsageIndex(nullptr),
     _faceCentroidPoints(GL_POINTS),
     _uniqueVertexPoints(GL_POINTS),
     _uniqueEdgePoints(GL_POINTS),
     m_planeChanged(false),
+    _windingsPrepared(false),
+    _windingsDegenerate(false),
+    _inScene(false),
     m_transformChanged(false),
 	_detailFlag(Structural)
 {
@@ -66,6 +76,11 @@ Brush::Brush(BrushNode& owner, const Brush& other) :
 Brush::~Brush()
 {
     ASSERT_MESSAGE(m_observers.empty(), "Brush::~Brush: observers still attached");
+
+    if (_inScene)
+    {
+        brush::ChangedBrushSet::Instance().remove(*this);
+    }
 }
 
 BrushNode& Brush::getBrushNode()
@@ -89,7 +104,7 @@ IFace& Brush::addFace(const Plane3& plane)
 {
     // Allocate a new Face
     undoSave();
-    push_back(FacePtr(new Face(*this, plane)));
+    push_back(util::makePooledShared<Face>(*this, plane));
 
     return *m_faces.back();
 }
@@ -98,7 +113,7 @@ IFace& Brush::addFace(const Plane3& plane, const Matrix4& texDef, const std::str
 {
     // Allocate a new Face
     undoSave();
-    push_back(FacePtr(new Face(*this, plane, texDef, shader)));
+    push_back(util::makePooledShared<Face>(*this, plane, texDef, shader));
 
     return *m_faces.back();
 }
@@ -167,6 +182,16 @@ void Brush::disconnectUndoSystem(IMapFileChangeTracker& changeTracker)
     GlobalUndoSystem().releaseStateSaver(*this);
 }
 
+void Brush::setMaterialUsageIndex(scene::IMaterialUsageIndex* index)
+{
+    _materialUsageIndex = index;
+}
+
+scene::IMaterialUsageIndex* Brush::getMaterialUsageIndex()
+{
+    return _materialUsageIndex;
+}
+
 void Brush::setShader(const std::string& newShader) {
     undoSave();
 
@@ -192,7 +217,7 @@ bool Brush::hasVisibleMaterial() const
     // Traverse the faces
     for (Faces::const_iterator i = m_faces.begin(); i != m_faces.end(); ++i)
     {
-        if ((*i)->getFaceShader().getGLShader()->getMaterial()->isVisible())
+        if ((*i)->getFaceShader().isMaterialVisible())
         {
             return true; // return true on first visible material
         }
@@ -243,6 +268,32 @@ void Brush::evaluateBRep() const {
     }
 }
 
+void Brush::prepareWindings() {
+    // A pending transform needs to be evaluated on the main thread first,
+    // leave this brush to the lazy evaluation otherwise
+    if (m_transformChanged) return;
+
+    if (m_planeChanged && !_windingsPrepared) {
+        _windingsDegenerate = buildWindings();
+        _windingsPrepared = true;
+    }
+}
+
+bool Brush::hasPendingWindings() const {
+    return m_planeChanged && !_windingsPrepared;
+}
+
+void Brush::setInScene(bool inScene) {
+    _inScene = inScene;
+
+    if (_inScene && m_planeChanged && !_windingsPrepared) {
+        brush::ChangedBrushSet::Instance().add(*this);
+    }
+    else if (!_inScene) {
+        brush::ChangedBrushSet::Instance().remove(*this);
+    }
+}
+
 void Brush::transformChanged() {
     m_transformChanged = true;
     onFacePlaneChanged();
@@ -358,6 +409,11 @@ void Brush::importState(const IUndoMementoPtr& state)
 	_detailFlag = memento._detailFlag;
     appendFaces(memento._faces);
 
+    for (std::size_t i = 0; i < m_faces.size(); ++i)
+    {
+        m_faces[i]->importState(memento._faceStates[i]);
+    }
+
     onFacePlaneChanged();
 
     for(Observers::iterator i = m_observers.begin(); i != m_observers.end(); ++i) {
@@ -371,7 +427,7 @@ FacePtr Brush::addFace(const Face& face) {
         return FacePtr();
     }
     undoSave();
-    push_back(FacePtr(new Face(*this, face)));
+    push_back(util::makePooledShared<Face>(*this, face));
     onFacePlaneChanged();
     return m_faces.back();
 }
@@ -382,7 +438,7 @@ FacePtr Brush::addPlane(const Vector3& p0, const Vector3& p1, const Vector3& p2,
         return FacePtr();
     }
     undoSave();
-    push_back(FacePtr(new Face(*this, p0, p1, p2, shader, projection)));
+    push_back(util::makePooledShared<Face>(*this, p0, p1, p2, shader, projection));
     onFacePlaneChanged();
     return m_faces.back();
 }
@@ -473,7 +529,14 @@ void Brush::erase(std::size_t index)
 
 void Brush::onFacePlaneChanged()
 {
+    // Let the scene evaluate this brush in the next batch, unless it's already waiting for it
+    if (_inScene && (!m_planeChanged || _windingsPrepared))
+    {
+        brush::ChangedBrushSet::Instance().add(*this);
+    }
+
     m_planeChanged = true;
+    _windingsPrepared = false;
     aabbChanged();
 }
 
@@ -520,6 +583,25 @@ std::size_t Brush::getNumFaces() const
     return m_faces.size();
 }
 
+std::size_t Brush::getAllocatedMemory() const
+{
+    std::size_t bytes = m_faces.capacity() * sizeof(FacePtr);
+
+    for (const auto& face : m_faces)
+    {
+        // The face object plus the shared_ptr's control block
+        bytes += sizeof(Face) + 2 * sizeof(long) + sizeof(void*) + face->getAllocatedMemory();
+    }
+
+    bytes += (_faceCentroidPoints.capacity() + _uniqueVertexPoints.capacity() + _uniqueEdgePoints.capacity()) * sizeof(VertexCb);
+    bytes += m_select_vertices.capacity() * sizeof(SelectableVertex);
+    bytes += m_select_edges.capacity() * sizeof(SelectableEdge);
+    bytes += _edgeIndices.capacity() * sizeof(EdgeRenderIndices);
+    bytes += _edgeFaces.capacity() * sizeof(EdgeFaces);
+
+    return bytes;
+}
+
 bool Brush::empty() const {
     return m_faces.empty();
 }
@@ -553,6 +635,11 @@ void Brush::removeEmptyFaces() {
 
 /// \brief Constructs \p winding from the intersection of \p plane with the other planes of the brush.
 void Brush::windingForClipPlane(Winding& winding, const Plane3& plane) const {
+    windingForClipPlane(winding, plane, getClipPlanes());
+}
+
+/// \brief Constructs \p winding from the intersection of \p plane with the given clip planes of the brush.
+void Brush::windingForClipPlane(Winding& winding, const Plane3& plane, const ClipPlanes& clipPlanes) const {
     FixedWinding buffer[2];
     bool swap = false;
 
@@ -561,23 +648,14 @@ void Brush::windingForClipPlane(Winding& winding, const Plane3& plane) const {
 
     // chop the poly by all of the other faces
     {
-        for (std::size_t i = 0;  i < m_faces.size(); ++i) {
-            const Face& clip = *m_faces[i];
-
-            if (clip.plane3() == plane
-                || !clip.plane3().isValid() || !plane_unique(i)
-                || plane == -clip.plane3())
-            {
+        for (const auto& clip : clipPlanes) {
+            // The clip planes are already flipped, because we want to keep the back side
+            if (plane == clip.flipped || plane == -clip.flipped) {
                 continue;
             }
 
             buffer[!swap].clear();
-
-            {
-                // flip the plane, because we want to keep the back side
-                Plane3 clipPlane(-clip.plane3().normal(), -clip.plane3().dist());
-                buffer[swap].clip(plane, clipPlane, i, buffer[!swap]);
-            }
+            buffer[swap].clip(plane, clip.flipped, clip.index, buffer[!swap]);
 
             swap = !swap;
         }
@@ -970,6 +1048,21 @@ void Brush::vertex_clear() {
     }
 }
 
+Brush::ClipPlanes Brush::getClipPlanes() const {
+    ClipPlanes clipPlanes;
+    clipPlanes.reserve(m_faces.size());
+
+    for (std::size_t i = 0; i < m_faces.size(); ++i) {
+        const Plane3& plane = m_faces[i]->plane3();
+
+        if (plane.isValid() && plane_unique(i)) {
+            clipPlanes.push_back(ClipPlane{ i, Plane3(-plane.normal(), -plane.dist()) });
+        }
+    }
+
+    return clipPlanes;
+}
+
 /// \brief Returns true if the face identified by \p index is preceded by another plane that takes priority over it.
 bool Brush::plane_unique(std::size_t index) const {
     // duplicate plane
@@ -1114,14 +1207,20 @@ bool Brush::buildWindings() {
     {
         m_aabb_local = AABB();
 
+        // Determine the faces taking part in the construction once, instead of
+        // checking the plane uniqueness (which is O(faces) itself) for each pair of faces
+        auto clipPlanes = getClipPlanes();
+        auto clipPlane = clipPlanes.begin();
+
         for (std::size_t i = 0;  i < m_faces.size(); ++i) {
             Face& f = *m_faces[i];
 
-            if (!f.plane3().isValid() || !plane_unique(i)) {
+            if (clipPlane == clipPlanes.end() || clipPlane->index != i) {
                 f.getWinding().resize(0);
             }
             else {
-                windingForClipPlane(f.getWinding(), f.plane3());
+                ++clipPlane;
+                windingForClipPlane(f.getWinding(), f.plane3(), clipPlanes);
 
                 // update brush bounds
                 const Winding& winding = f.getWinding();
@@ -1199,7 +1298,9 @@ std::size_t ProximalVertexArray_index(const ProximalVertexArray& array, const Pr
 
 /// \brief Constructs the face windings and updates anything that depends on them.
 void Brush::buildBRep() {
-  bool degenerate = buildWindings();
+  // The windings might have been built already, as part of a batch
+  bool degenerate = _windingsPrepared ? _windingsDegenerate : buildWindings();
+  _windingsPrepared = false;
 
   static const Vector3& colourVertexVec = GlobalBrush().getSettings().getVertexColour();
   const Colour4b colour_vertex(int(colourVertexVec[0]*255), int(colourVertexVec[1]*255),
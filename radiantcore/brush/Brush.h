@@ -96,6 +96,9 @@ private:
 	IUndoStateSaver* _undoStateSaver;
 	IMapFileChangeTracker* _mapFileChangeTracker;
 
+	// The material usage index of the scene this brush is inserted into
+	scene::IMaterialUsageIndex* _materialUsageIndex;
+
 	// state
 	Faces m_faces;
 	// ----
@@ -121,13 +124,17 @@ private:
 	// ----
 
 	mutable bool m_planeChanged; // b-rep evaluation required
+	bool _windingsPrepared; // windings already built by prepareWindings()
+	bool _windingsDegenerate; // result of the prepared buildWindings() call
+	bool _inScene;
 	mutable bool m_transformChanged; // transform evaluation required
 	// ----
 
 	DetailFlag _detailFlag;
 
 public:
-	/// \brief The undo memento for a brush stores only the list of face references - the faces are not copied.
+	/// \brief The undo memento for a brush stores the list of face references - the faces are not copied -
+	/// along with the state of each face. The faces don't maintain their own undo state.
 	class BrushUndoMemento :
 		public IUndoMemento
 	{
@@ -135,11 +142,19 @@ public:
 		BrushUndoMemento(const Faces& faces, DetailFlag detailFlag) :
 			_faces(faces),
 			_detailFlag(detailFlag)
-		{}
+		{
+			_faceStates.reserve(faces.size());
+
+			for (const auto& face : faces)
+			{
+				_faceStates.push_back(face->exportState());
+			}
+		}
 
 		virtual ~BrushUndoMemento() {}
 
 		Faces _faces;
+		std::vector<IUndoMementoPtr> _faceStates;
 		DetailFlag _detailFlag;
 	};
 
@@ -180,6 +195,11 @@ public:
 	void connectUndoSystem(IMapFileChangeTracker& map);
 	void disconnectUndoSystem(IMapFileChangeTracker& map);
 
+	// The faces register themselves in this index when connecting to the
+	// undo system, it must be set before connectUndoSystem() is called.
+	void setMaterialUsageIndex(scene::IMaterialUsageIndex* index);
+	scene::IMaterialUsageIndex* getMaterialUsageIndex();
+
 	// Face observer callbacks
 	void onFacePlaneChanged();
 	void onFaceShaderChanged();
@@ -205,6 +225,19 @@ public:
 
 	void evaluateBRep() const override;
 
+	// Builds the face windings ahead of the next evaluateBRep() call, which then only
+	// needs to do the remaining work. Used to build the windings of many brushes
+	// in parallel, this doesn't touch anything outside of this brush. Brushes with a
+	// pending transform are skipped, evaluateTransform() must be called before.
+	void prepareWindings();
+
+	// True if the planes changed and the windings haven't been built yet
+	bool hasPendingWindings() const;
+
+	// Brushes in the scene register themselves with the ChangedBrushSet
+	// when their planes change, to be evaluated in the next batch
+	void setInScene(bool inScene);
+
     void transformChanged();
     void evaluateTransform();
 
@@ -259,6 +292,10 @@ public:
 
 	std::size_t getNumFaces() const;
 
+	// Returns the approximate number of bytes allocated by this brush
+	// (not including the size of the Brush object itself)
+	std::size_t getAllocatedMemory() const;
+
 	bool empty() const;
 
 	/// \brief Returns true if any face of the brush contributes to the final B-Rep.
@@ -268,9 +305,20 @@ public:
 	/// Note: removal of empty faces is not performed during direct brush manipulations, because it would make a manipulation irreversible if it created an empty face.
 	void removeEmptyFaces();
 
+	// A face plane taking part in the winding construction, flipped to keep the back side
+	struct ClipPlane
+	{
+		std::size_t index;
+		Plane3 flipped;
+	};
+	using ClipPlanes = std::vector<ClipPlane>;
+
 	/// \brief Constructs \p winding from the intersection of \p plane with the other planes of the brush.
 	void windingForClipPlane(Winding& winding, const Plane3& plane) const;
 
+	/// \brief Constructs \p winding from the intersection of \p plane with the given clip planes of the brush.
+	void windingForClipPlane(Winding& winding, const Plane3& plane, const ClipPlanes& clipPlanes) const;
+
 	void update_wireframe(RenderableWireframe& wire, const bool* faces_visible) const;
 
 	void update_faces_wireframe(RenderablePointVector& wire,
@@ -310,6 +358,9 @@ private:
 	/// \brief Returns true if the face identified by \p index is preceded by another plane that takes priority over it.
 	bool plane_unique(std::size_t index) const;
 
+	/// \brief Returns the flipped planes of all valid and unique faces, in the order of the faces.
+	ClipPlanes getClipPlanes() const;
+
 	/// \brief Removes edges that are smaller than the tolerance used when generating brush windings.
 	void removeDegenerateEdges();
 
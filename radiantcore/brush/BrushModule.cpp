@@ -10,12 +10,14 @@
 #include "brush/BrushNode.h"
 #include "brush/BrushClipPlane.h"
 #include "brush/BrushVisit.h"
+#include "brush/ChangedBrushSet.h"
 #include "gamelib.h"
 
 #include "registry/registry.h"
 #include "ipreferencesystem.h"
 #include "module/StaticModule.h"
 #include "messages/TextureChanged.h"
+#include "util/BlockPool.h"
 
 #include "selection/algorithm/Primitives.h"
 
@@ -71,7 +73,7 @@ void BrushModuleImpl::toggleTextureLock() {
 
 scene::INodePtr BrushModuleImpl::createBrush()
 {
-	scene::INodePtr node = std::make_shared<BrushNode>();
+	scene::INodePtr node = util::makePooledShared<BrushNode>();
 
 	if (GlobalMapModule().getRoot())
 	{
@@ -87,6 +89,11 @@ IBrushSettings& BrushModuleImpl::getSettings()
 	return *_settings;
 }
 
+void BrushModuleImpl::evaluateChangedBrushes()
+{
+	ChangedBrushSet::Instance().evaluate();
+}
+
 // RegisterableModule implementation
 const std::string& BrushModuleImpl::getName() const {
 	static std::string _name(MODULE_BRUSHCREATOR);
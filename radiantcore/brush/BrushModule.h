@@ -48,6 +48,8 @@ public:
 
 	IBrushSettings& getSettings() override;
 
+	void evaluateChangedBrushes() override;
+
 	// ----------------------------------------------------------------------------------
 
 	// returns true if the texture lock is enabled
@@ -8,6 +8,7 @@
 #include "ientity.h"
 #include "math/Frustum.h"
 #include "math/Hash.h"
+#include "util/BlockPool.h"
 #include <functional>
 
 // Constructor
@@ -99,6 +100,15 @@ std::string BrushNode::getFingerprint()
     return hash;
 }
 
+std::size_t BrushNode::getMemoryUsage() const
+{
+    return sizeof(BrushNode) + m_brush.getAllocatedMemory() +
+        m_faceInstances.capacity() * sizeof(FaceInstance) +
+        m_edgeInstances.capacity() * sizeof(EdgeInstance) +
+        m_vertexInstances.capacity() * sizeof(brush::VertexInstance) +
+        (_selectedPoints.capacity() + _faceCentroidPointsCulled.capacity()) * sizeof(VertexCb);
+}
+
 // Snappable implementation
 void BrushNode::snapto(float snap) {
 	m_brush.snapto(snap);
@@ -259,12 +269,14 @@ void BrushNode::translate(const Vector3& translation)
 }
 
 scene::INodePtr BrushNode::clone() const {
-	return std::make_shared<BrushNode>(*this);
+	return util::makePooledShared<BrushNode>(*this);
 }
 
 void BrushNode::onInsertIntoScene(scene::IMapRootNode& root)
 {
-    m_brush.connectUndoSystem(root.getUndoChangeTracker());
+    m_brush.setMaterialUsageIndex(&root.getMaterialUsageIndex());
+    m_brush.connectUndoSystem(getChangeTracker(root));
+    m_brush.setInScene(true);
 	GlobalCounters().getCounter(counterBrushes).increment();
 
     // Update the origin information needed for transformations
@@ -284,7 +296,9 @@ void BrushNode::onRemoveFromScene(scene::IMapRootNode& root)
 	setSelectedComponents(false, SelectionSystem::eFace);
 
 	GlobalCounters().getCounter(counterBrushes).decrement();
-    m_brush.disconnectUndoSystem(root.getUndoChangeTracker());
+    m_brush.disconnectUndoSystem(getChangeTracker(root));
+    m_brush.setMaterialUsageIndex(nullptr);
+    m_brush.setInScene(false);
 
 	SelectableNode::onRemoveFromScene(root);
 }
@@ -340,6 +354,10 @@ bool BrushNode::intersectsLight(const RendererLight& light) const {
 	return light.lightAABB().intersects(worldAABB());
 }
 
+const AABB& BrushNode::litObjectAABB() const {
+	return worldAABB();
+}
+
 void BrushNode::renderComponents(RenderableCollector& collector, const VolumeTest& volume) const
 {
 	m_brush.evaluateBRep();
@@ -5,6 +5,7 @@
 #include "itraceable.h"
 #include "iscenegraph.h"
 #include "icomparablenode.h"
+#include "imemoryaccountable.h"
 
 #include "Brush.h"
 #include "scene/SelectableNode.h"
@@ -31,7 +32,8 @@ class BrushNode :
 	public LitObject,
 	public Transformable,
 	public ITraceable,
-    public scene::IComparableNode
+    public scene::IComparableNode,
+    public scene::IMemoryAccountable
 {
 	// The actual contained brush (NO reference)
 	Brush m_brush;
@@ -87,6 +89,9 @@ public:
     // IComparable implementation
     std::string getFingerprint() override;
 
+    // IMemoryAccountable implementation
+    std::size_t getMemoryUsage() const override;
+
 	// Bounded implementation
 	virtual const AABB& localAABB() const override;
 
@@ -139,6 +144,7 @@ public:
 
 	// LitObject implementation
 	bool intersectsLight(const RendererLight& light) const override;
+	const AABB& litObjectAABB() const override;
 
 	// Renderable implementation
 	void renderComponents(RenderableCollector& collector, const VolumeTest& volume) const override;
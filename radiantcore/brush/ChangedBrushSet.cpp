@@ -0,0 +1,134 @@
+#include "ChangedBrushSet.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <algorithm>
+#include "iprofiler.h"
+#include "Brush.h"
+#include "BrushNode.h"
+
+namespace brush
+{
+
+namespace
+{
+    // Below this number of brushes the threads are not worth the overhead
+    constexpr std::size_t MinBrushesForParallelBuild = 64;
+
+    // Number of brushes a worker takes from the list at once
+    constexpr std::size_t BrushesPerChunk = 16;
+}
+
+ChangedBrushSet& ChangedBrushSet::Instance()
+{
+    static ChangedBrushSet _instance;
+    return _instance;
+}
+
+void ChangedBrushSet::add(Brush& brush)
+{
+    _brushes.insert(&brush);
+}
+
+void ChangedBrushSet::remove(Brush& brush)
+{
+    _brushes.erase(&brush);
+}
+
+void ChangedBrushSet::evaluate()
+{
+    // Brushes evaluated lazily in the meantime don't need to be built anymore
+    for (auto i = _brushes.begin(); i != _brushes.end();)
+    {
+        if ((*i)->hasPendingWindings())
+        {
+            ++i;
+        }
+        else
+        {
+            i = _brushes.erase(i);
+        }
+    }
+
+    // Keep too few brushes registered, they are either evaluated lazily or join
+    // a later batch. Brushes don't register again while their windings are pending.
+    if (_brushes.size() < MinBrushesForParallelBuild) return;
+
+    profiling::ScopedZone zone("Brush windings");
+
+    std::vector<Brush*> brushes(_brushes.begin(), _brushes.end());
+
+    PrepareWindings(brushes);
+
+    // Evaluating the pending transforms might have registered the brushes again
+    _brushes.clear();
+}
+
+void ChangedBrushSet::PrepareWindings(const std::vector<Brush*>& brushes)
+{
+    if (brushes.size() < MinBrushesForParallelBuild)
+    {
+        // Leave these to the lazy evaluation
+        return;
+    }
+
+    // Pending transforms are applied to the face planes before the windings can be built.
+    // This emits scene notifications and might capture shaders (texture lock), which must
+    // not happen in the workers.
+    for (auto brush : brushes)
+    {
+        brush->evaluateTransform();
+    }
+
+    std::atomic<std::size_t> nextChunk(0);
+    auto numChunks = (brushes.size() + BrushesPerChunk - 1) / BrushesPerChunk;
+    auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), numChunks);
+
+    std::vector<std::future<void>> workers;
+    workers.reserve(numWorkers);
+
+    for (std::size_t i = 0; i < numWorkers; ++i)
+    {
+        workers.emplace_back(std::async(std::launch::async, [&]()
+        {
+            for (auto chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+            {
+                auto end = std::min(brushes.size(), (chunk + 1) * BrushesPerChunk);
+
+                for (auto b = chunk * BrushesPerChunk; b < end; ++b)
+                {
+                    brushes[b]->prepareWindings();
+                }
+            }
+        }));
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+}
+
+void ChangedBrushSet::PrepareWindings(const scene::INodePtr& root)
+{
+    if (!root) return;
+
+    profiling::ScopedZone zone("Brush windings");
+
+    std::vector<Brush*> brushes;
+
+    root->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (auto brushNode = std::dynamic_pointer_cast<BrushNode>(node); brushNode)
+        {
+            brushes.push_back(&brushNode->getBrush());
+        }
+
+        return true;
+    });
+
+    PrepareWindings(brushes);
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+#include "inode.h"
+
+class Brush;
+
+namespace brush
+{
+
+/**
+ * The brushes in the scene whose planes have changed since their B-rep has
+ * been built. Instead of constructing the windings of each brush on its own
+ * when the scene is traversed, evaluate() builds them all at once, spreading
+ * the work over all cores.
+ *
+ * Brushes register themselves while they are part of the scene, which (like
+ * any other brush modification) happens on the main thread only.
+ */
+class ChangedBrushSet
+{
+private:
+    std::unordered_set<Brush*> _brushes;
+
+public:
+    static ChangedBrushSet& Instance();
+
+    void add(Brush& brush);
+    void remove(Brush& brush);
+
+    // Builds the windings of all registered brushes and clears the set. If there
+    // are not enough brushes to build them in parallel, they stay registered.
+    void evaluate();
+
+    // Builds the windings of the given brushes, in parallel if there are enough of them.
+    // Pending transforms are evaluated up front on the calling (main) thread,
+    // the workers only construct the windings.
+    static void PrepareWindings(const std::vector<Brush*>& brushes);
+
+    // Builds the windings of all brushes below the given node, used for
+    // freshly loaded maps before the scene graph evaluates their bounds
+    static void PrepareWindings(const scene::INodePtr& root);
+};
+
+}
@@ -40,7 +40,6 @@ public:
 Face::Face(Brush& owner) :
     _owner(owner),
     _shader(texdef_name_default(), _owner.getBrushNode().getRenderSystem()),
-    _undoStateSaver(nullptr),
     _faceIsVisible(true)
 {
     setupSurfaceShader();
@@ -63,7 +62,6 @@ Face::Face(
     _owner(owner),
     _shader(shader, _owner.getBrushNode().getRenderSystem()),
     _texdef(projection),
-    _undoStateSaver(nullptr),
     _faceIsVisible(true)
 {
     setupSurfaceShader();
@@ -75,7 +73,6 @@ Face::Face(
 Face::Face(Brush& owner, const Plane3& plane) :
     _owner(owner),
     _shader("", _owner.getBrushNode().getRenderSystem()),
-    _undoStateSaver(nullptr),
     _faceIsVisible(true)
 {
     setupSurfaceShader();
@@ -88,7 +85,6 @@ Face::Face(Brush& owner, const Plane3& plane, const Matrix4& texdef,
            const std::string& shader) :
     _owner(owner),
     _shader(shader, _owner.getBrushNode().getRenderSystem()),
-    _undoStateSaver(nullptr),
     _faceIsVisible(true)
 {
     setupSurfaceShader();
@@ -107,7 +103,6 @@ Face::Face(Brush& owner, const Face& other) :
     m_plane(other.m_plane),
     _shader(other._shader.getMaterialName(), _owner.getBrushNode().getRenderSystem()),
     _texdef(other.getProjection()),
-    _undoStateSaver(nullptr),
     _faceIsVisible(other._faceIsVisible)
 {
     setupSurfaceShader();
@@ -150,28 +145,24 @@ void Face::realiseShader()
 
 void Face::connectUndoSystem(IMapFileChangeTracker& changeTracker)
 {
-    assert(!_undoStateSaver);
-
     _shader.setInUse(true);
 
-    _undoStateSaver = GlobalUndoSystem().getStateSaver(*this, changeTracker);
+    if (_owner.getMaterialUsageIndex())
+    {
+        _shader.setUsageIndex(_owner.getMaterialUsageIndex(), scene::MaterialUsage{ &_owner.getBrushNode(), this });
+    }
 }
 
 void Face::disconnectUndoSystem(IMapFileChangeTracker& changeTracker)
 {
-    assert(_undoStateSaver);
-    _undoStateSaver = nullptr;
-    GlobalUndoSystem().releaseStateSaver(*this);
-
+    _shader.setUsageIndex(nullptr, scene::MaterialUsage());
     _shader.setInUse(false);
 }
 
 void Face::undoSave()
 {
-    if (_undoStateSaver)
-    {
-        _undoStateSaver->save(*this);
-    }
+    // The face state is part of the brush memento
+    _owner.undoSave();
 }
 
 // undoable
@@ -235,17 +226,9 @@ void Face::setRenderSystem(const RenderSystemPtr& renderSystem)
 {
     _shader.setRenderSystem(renderSystem);
 
-    // Update the visibility flag, we might have switched shaders
-    const ShaderPtr& shader = _shader.getGLShader();
-
-    if (shader)
-    {
-        _faceIsVisible = shader->getMaterial()->isVisible();
-    }
-    else
-    {
-        _faceIsVisible = false; // no shader => not visible
-    }
+    // Update the visibility flag, we might have switched shaders.
+    // This doesn't capture the shader, it's captured when the face is first rendered.
+    _faceIsVisible = _shader.isMaterialVisible();
 }
 
 void Face::translate(const Vector3& translation)
@@ -347,16 +330,7 @@ void Face::shaderChanged()
     _owner.onFaceShaderChanged();
 
     // Update the visibility flag, but leave out the contributes() check
-    const ShaderPtr& shader = getFaceShader().getGLShader();
-
-    if (shader)
-    {
-        _faceIsVisible = shader->getMaterial()->isVisible();
-    }
-    else
-    {
-        _faceIsVisible = false; // no shader => not visible
-    }
+    _faceIsVisible = _shader.isMaterialVisible();
 
     planeChanged();
     SceneChangeNotify();
@@ -576,6 +550,12 @@ Winding& Face::getWinding() {
     return m_winding;
 }
 
+std::size_t Face::getAllocatedMemory() const
+{
+    // The material name is pooled and shared by all surfaces
+    return m_winding.capacity() * sizeof(WindingVertex);
+}
+
 const Plane3& Face::plane3() const
 {
     _owner.onFaceEvaluateTransform();
@@ -656,7 +636,7 @@ bool Face::isVisible() const
 
 void Face::updateFaceVisibility()
 {
-    _faceIsVisible = contributes() && getFaceShader().getGLShader()->getMaterial()->isVisible();
+    _faceIsVisible = contributes() && _shader.isMaterialVisible();
 }
 
 sigc::signal<void>& Face::signal_texdefChanged()
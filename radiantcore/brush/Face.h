@@ -56,8 +56,6 @@ private:
 	Winding m_winding;
 	Vector3 m_centroid;
 
-	IUndoStateSaver* _undoStateSaver;
-
 	// Cached visibility flag, queried during front end rendering
 	bool _faceIsVisible;
 
@@ -86,12 +84,15 @@ public:
 	// greebo: Emits the updated normals to the Winding class.
 	void updateWinding();
 
+    // Faces are not registered in the undo system themselves, their state
+    // is saved along with the owning brush. These are called when the brush
+    // is connected to or disconnected from the undo system.
     void connectUndoSystem(IMapFileChangeTracker& changeTracker);
     void disconnectUndoSystem(IMapFileChangeTracker& changeTracker);
 
 	void undoSave();
 
-	// undoable
+	// undoable, used by the brush memento
 	IUndoMementoPtr exportState() const;
 	void importState(const IUndoMementoPtr& data);
 
@@ -182,6 +183,10 @@ public:
 	void construct_centroid();
 
 	const Winding& getWinding() const;
+
+	// Returns the approximate number of bytes allocated by this face
+	// (not including the size of the Face object itself)
+	std::size_t getAllocatedMemory() const;
 	Winding& getWinding();
 
 	const Plane3& plane3() const;
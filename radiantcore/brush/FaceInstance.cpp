@@ -178,7 +178,7 @@ void FaceInstance::renderWireframe(RenderableCollector& collector, const VolumeT
 }
 
 void FaceInstance::testSelect(SelectionTest& test, SelectionIntersection& best) {
-	if (getFace().getFaceShader().getGLShader()->getMaterial()->isVisible()) {
+	if (getFace().getFaceShader().isMaterialVisible()) {
 		m_face->testSelect(test, best);
 	}
 }
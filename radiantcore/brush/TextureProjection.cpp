@@ -387,9 +387,8 @@ void TextureProjection::emitTextureCoordinates(Winding& w, const Vector3& normal
         // Store the s,t coordinates into the winding texcoord vector
         i->texcoord[0] = texcoord[0];
         i->texcoord[1] = texcoord[1];
-
-        // Save the tangent and bitangent vectors, they are the same for all the face vertices
-        i->tangent = tangent;
-        i->bitangent = bitangent;
     }
+
+    // Save the tangent and bitangent vectors, they are the same for all the face vertices
+    w.setTangents(tangent, bitangent);
 }
@@ -106,12 +106,12 @@ void Winding::render(const RenderInfo& info) const
 		glVertexAttribPointer(
             ATTR_TEXCOORD, 2, GL_DOUBLE, 0, sizeof(WindingVertex), &firstElement.texcoord
         );
-		glVertexAttribPointer(
-            ATTR_TANGENT, 3, GL_DOUBLE, 0, sizeof(WindingVertex), &firstElement.tangent
-        );
-		glVertexAttribPointer(
-            ATTR_BITANGENT, 3, GL_DOUBLE, 0, sizeof(WindingVertex), &firstElement.bitangent
-        );
+
+        // Tangents are the same for all vertices, submit them as constant attributes
+        glDisableVertexAttribArray(ATTR_TANGENT);
+        glDisableVertexAttribArray(ATTR_BITANGENT);
+        glVertexAttrib3dv(ATTR_TANGENT, _tangent);
+        glVertexAttrib3dv(ATTR_BITANGENT, _bitangent);
 	}
 	else
     {
@@ -135,6 +135,13 @@ void Winding::render(const RenderInfo& info) const
 	glDrawArrays(GL_POLYGON, 0, GLsizei(size()));
 
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    // The bump program expects the arrays to be enabled for the next renderable
+    if (info.checkFlag(RENDER_BUMP) && !info.checkFlag(RENDER_TEXTURE_CUBEMAP))
+    {
+        glEnableVertexAttribArray(ATTR_TANGENT);
+        glEnableVertexAttribArray(ATTR_BITANGENT);
+    }
 }
 
 void Winding::testSelect(SelectionTest& test, SelectionIntersection& best)
@@ -153,6 +160,22 @@ void Winding::updateNormals(const Vector3& normal)
 	}
 }
 
+void Winding::setTangents(const Vector3& tangent, const Vector3& bitangent)
+{
+	_tangent = tangent;
+	_bitangent = bitangent;
+}
+
+const Vector3& Winding::getTangent() const
+{
+	return _tangent;
+}
+
+const Vector3& Winding::getBitangent() const
+{
+	return _bitangent;
+}
+
 AABB Winding::aabb() const
 {
 	AABB returnValue;
@@ -44,6 +44,11 @@ class Winding :
 	public IWinding,
     public OpenGLRenderable
 {
+private:
+	// The texture tangent and bitangent, shared by all vertices
+	Vector3 _tangent;
+	Vector3 _bitangent;
+
 public:
 	/** greebo: Calculates the AABB of this winding
 	 */
@@ -55,6 +60,12 @@ public:
 	// The normal is the same for each vertex, so this just copies the values
 	void updateNormals(const Vector3& normal);
 
+	// Sets the tangent and bitangent vectors submitted along with the vertices
+	void setTangents(const Vector3& tangent, const Vector3& bitangent);
+
+	const Vector3& getTangent() const;
+	const Vector3& getBitangent() const;
+
 	// Submits this winding to OpenGL
 	void render(const RenderInfo& info) const;
 
@@ -13,6 +13,11 @@ class Doom3ModelDef :
 private:
 	std::size_t _parseStamp;
 
+	// The values as parsed from the declaration, before inheritance is applied
+	std::string _parsedMesh;
+	std::string _parsedSkin;
+	Anims _parsedAnims;
+
 public:
     using Ptr = std::shared_ptr<Doom3ModelDef>;
 
@@ -49,6 +54,16 @@ public:
         defFilename.clear();
 	}
 
+	// Restores the parsed values, such that the inheritance can be resolved again
+	// after the parent declaration has changed
+	void resetInheritance()
+	{
+		resolved = false;
+		mesh = _parsedMesh;
+		skin = _parsedSkin;
+		anims = _parsedAnims;
+	}
+
 	// Reads the data from the given tokens into the member variables
 	void parseFromTokens(parser::DefTokeniser& tokeniser)
 	{
@@ -100,6 +115,10 @@ public:
 	            state = NONE;
 	        }
 	    }
+
+	    _parsedMesh = mesh;
+	    _parsedSkin = skin;
+	    _parsedAnims = anims;
 	}
 };
 
@@ -7,6 +7,7 @@
 #include "icommandsystem.h"
 #include "iradiant.h"
 #include "ifilesystem.h"
+#include "iprofiler.h"
 #include "parser/DefTokeniser.h"
 #include "messages/ScopedLongRunningOperation.h"
 
@@ -15,18 +16,32 @@
 
 #include "string/case_conv.h"
 #include <functional>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "debugging/ScopedDebugTimer.h"
 #include "module/StaticModule.h"
 
 namespace eclass {
 
+namespace
+{
+    // The number of classes of an inheritance level worth a worker thread
+    const std::size_t MIN_CLASSES_PER_WORKER = 64;
+}
+
 // Constructor
 EClassManager::EClassManager() :
     _realised(false),
     _defLoader(std::bind(&EClassManager::loadDefAndResolveInheritance, this),
                std::bind(&EClassManager::onDefLoadingCompleted, this)),
-	_curParseStamp(0)
+	_curParseStamp(0),
+	_numUnchangedFiles(0)
 {}
 
 sigc::signal<void> EClassManager::defsLoadingSignal() const
@@ -138,46 +153,315 @@ void EClassManager::parseDefFiles()
 
 	// Increase the parse stamp for this run
 	_curParseStamp++;
+	_numUnchangedFiles = 0;
 
+	// Re-parsed classes are marked as unresolved, the attribute tables of
+	// their descendants are re-built after all classes have been parsed
 	{
 		ScopedDebugTimer timer("EntityDefs parsed: ");
+
+		std::vector<DefFile> files;
+		std::set<std::string> existingFiles;
+
         GlobalFileSystem().forEachFile(
             "def/", "def",
-            [&](const vfs::FileInfo& fileInfo) { parseFile(fileInfo); }
+            [&](const vfs::FileInfo& fileInfo)
+            {
+                DefFile file;
+
+                if (readFile(fileInfo, file))
+                {
+                    existingFiles.insert(fileInfo.fullPath());
+                    files.emplace_back(std::move(file));
+                }
+            }
         );
+
+		// Collect the declarations of the changed and removed files, before and after the change
+		std::set<std::string> touchedDecls;
+
+		for (const auto& file : files)
+		{
+			if (!file.needsParsing) continue;
+
+			auto& decls = _fileDecls[file.info.fullPath()];
+			touchedDecls.insert(decls.begin(), decls.end());
+
+			decls = scanDeclarations(file.contents);
+			touchedDecls.insert(decls.begin(), decls.end());
+		}
+
+		for (auto i = _fileDecls.begin(); i != _fileDecls.end();)
+		{
+			if (existingFiles.count(i->first) > 0)
+			{
+				++i;
+				continue;
+			}
+
+			touchedDecls.insert(i->second.begin(), i->second.end());
+			_fileHashes.erase(i->first);
+			i = _fileDecls.erase(i);
+		}
+
+		// Unchanged files sharing any of these declarations are parsed again, in their
+		// original order, such that the same definition wins as in a full parse.
+		// Their other declarations are touched as well, repeat until nothing is added.
+		for (bool filesAdded = true; filesAdded;)
+		{
+			filesAdded = false;
+
+			for (auto& file : files)
+			{
+				if (file.needsParsing) continue;
+
+				const auto& decls = _fileDecls[file.info.fullPath()];
+
+				if (std::any_of(decls.begin(), decls.end(),
+					[&](const std::string& decl) { return touchedDecls.count(decl) > 0; }))
+				{
+					file.needsParsing = true;
+					touchedDecls.insert(decls.begin(), decls.end());
+					filesAdded = true;
+				}
+			}
+		}
+
+		for (const auto& file : files)
+		{
+			if (file.needsParsing)
+			{
+				parseFile(file);
+			}
+			else
+			{
+				++_numUnchangedFiles;
+			}
+		}
+	}
+
+	if (_numUnchangedFiles > 0)
+	{
+		rMessage() << "EntityDefs: skipped " << _numUnchangedFiles << " unchanged files" << std::endl;
 	}
 }
 
-void EClassManager::resolveInheritance()
+std::vector<std::vector<EClassManager::InheritanceLink>> EClassManager::sortByInheritanceLevel()
 {
-	// Resolve inheritance on the model classes
+    std::unordered_map<EntityClass*, std::size_t> levelOf;
+    std::unordered_map<EntityClass*, EntityClass*> parentOf;
+    std::unordered_map<EntityClass*, std::string> unknownParents;
+
+    std::vector<std::vector<InheritanceLink>> levels;
+
+    for (const auto& pair : _entityClasses)
+    {
+        // Walk up the chain until we reach a class with a known level
+        std::vector<EntityClass*> chain;
+        std::unordered_set<EntityClass*> visited;
+
+        for (auto eclass = pair.second.get(); levelOf.count(eclass) == 0;)
+        {
+            if (!visited.insert(eclass).second)
+            {
+                // Break the cycle by treating the last class as root
+                rWarning() << "[eclassmgr] Entity class " << chain.back()->getName()
+                    << " is part of an inheritance cycle" << std::endl;
+                parentOf[chain.back()] = nullptr;
+                break;
+            }
+
+            chain.push_back(eclass);
+
+            const auto& parentName = eclass->getParentName();
+            EntityClass* parent = nullptr;
+
+            if (!parentName.empty())
+            {
+                auto found = _entityClasses.find(parentName);
+
+                if (found != _entityClasses.end())
+                {
+                    parent = found->second.get();
+                }
+                else
+                {
+                    unknownParents[eclass] = parentName;
+                }
+            }
+
+            parentOf[eclass] = parent;
+
+            if (!parent) break;
+
+            eclass = parent;
+        }
+
+        // Assign the levels, root first
+        for (auto i = chain.rbegin(); i != chain.rend(); ++i)
+        {
+            auto parent = parentOf[*i];
+            auto level = parent ? levelOf[parent] + 1 : 0;
+
+            levelOf[*i] = level;
+
+            if (levels.size() <= level)
+            {
+                levels.resize(level + 1);
+            }
+
+            levels[level].push_back(InheritanceLink{ *i, parent });
+        }
+    }
+
+    // A class needs to be resolved again if it has been re-parsed,
+    // if its parent changed or if any of its ancestors needs to be resolved
+    for (const auto& level : levels)
+    {
+        for (const auto& link : level)
+        {
+            if (link.eclass->isInheritanceResolved() && link.eclass->getParent() == link.parent &&
+                (!link.parent || link.parent->isInheritanceResolved()))
+            {
+                continue;
+            }
+
+            link.eclass->invalidateInheritance();
+
+            auto unknownParent = unknownParents.find(link.eclass);
+
+            if (unknownParent != unknownParents.end())
+            {
+                rWarning() << "[eclassmgr] Entity class "
+                    << link.eclass->getName() << " specifies unknown parent class "
+                    << unknownParent->second << std::endl;
+            }
+        }
+    }
+
+    return levels;
+}
+
+std::vector<EntityClass*> EClassManager::resolveInheritance()
+{
+    auto start = std::chrono::steady_clock::now();
+
+	// Resolve inheritance on the model classes, there are few of them,
+	// so they are all resolved again starting from their parsed values
+    for (Models::value_type& pair : _models)
+    {
+        pair.second->resetInheritance();
+    }
+
     for (Models::value_type& pair : _models)
     {
     	resolveModelInheritance(pair.first, pair.second);
     }
 
-    // Resolve inheritance for the entities. At this stage the classes
-    // will have the name of their parent, but not an actual pointer to
-    // it
-    for (EntityClasses::value_type& pair : _entityClasses)
-	{
-		// Tell the class to resolve its own inheritance using the given
-		// map as a source for parent lookup
-        pair.second->resolveInheritance(_entityClasses);
+    // Resolve inheritance for the entities, one level after the other.
+    // The classes of one level only depend on the classes of the previous levels.
+    auto levels = sortByInheritanceLevel();
 
-        // If the entity has a model path ("model" key), lookup the actual
-        // model and apply its mesh and skin to this entity.
-        if (!pair.second->getModelPath().empty())
+    std::vector<EntityClass*> changedClasses;
+
+    for (const auto& level : levels)
+    {
+        std::vector<InheritanceLink> links;
+
+        for (const auto& link : level)
+        {
+            if (!link.eclass->isInheritanceResolved())
+            {
+                links.push_back(link);
+            }
+        }
+
+        // The changed signals are emitted by the caller, not from the worker threads
+        std::vector<bool> blocked;
+
+        for (const auto& link : links)
         {
-            Models::iterator j = _models.find(pair.second->getModelPath());
+            blocked.push_back(link.eclass->isChangedSignalBlocked());
+            link.eclass->blockChangedSignal(true);
+        }
+
+        auto numWorkers = std::min<std::size_t>(
+            std::max(std::thread::hardware_concurrency(), 1u), links.size() / MIN_CLASSES_PER_WORKER);
 
-            if (j != _models.end())
+        if (numWorkers < 2)
+        {
+            for (const auto& link : links)
             {
-                pair.second->setModelPath(j->second->mesh);
-                pair.second->setSkin(j->second->skin);
+                link.eclass->resolveInheritance(link.parent);
             }
         }
+        else
+        {
+            std::atomic<std::size_t> next(0);
+            std::vector<std::future<void>> workers;
+
+            for (std::size_t i = 0; i < numWorkers; ++i)
+            {
+                workers.emplace_back(std::async(std::launch::async, [&]()
+                {
+                    for (auto index = next++; index < links.size(); index = next++)
+                    {
+                        links[index].eclass->resolveInheritance(links[index].parent);
+                    }
+                }));
+            }
+
+            for (auto& worker : workers)
+            {
+                worker.get();
+            }
+        }
+
+        for (std::size_t i = 0; i < links.size(); ++i)
+        {
+            links[i].eclass->blockChangedSignal(blocked[i]);
+            links[i].eclass->connectToParent();
+
+            changedClasses.push_back(links[i].eclass);
+        }
     }
+
+    auto numResolved = changedClasses.size();
+    std::unordered_set<EntityClass*> changed(changedClasses.begin(), changedClasses.end());
+
+    // If the entity has a model ("model" key), lookup the actual
+    // model and apply its mesh and skin to this entity. This is checked
+    // for the unchanged classes too, since the model might have changed.
+    for (EntityClasses::value_type& pair : _entityClasses)
+	{
+        const auto& modelName = pair.second->getAttribute("model").getValue();
+
+        if (modelName.empty()) continue;
+
+        Models::iterator j = _models.find(modelName);
+
+        if (j == _models.end() ||
+            (pair.second->getModelPath() == j->second->mesh && pair.second->getSkin() == j->second->skin))
+        {
+            continue;
+        }
+
+        pair.second->setModelPath(j->second->mesh);
+        pair.second->setSkin(j->second->skin);
+
+        if (changed.insert(pair.second.get()).second)
+        {
+            changedClasses.push_back(pair.second.get());
+        }
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    rMessage() << "EntityDefs resolved: " << numResolved << " of " << _entityClasses.size()
+        << " classes in " << levels.size() << " inheritance levels, " << duration << " ms" << std::endl;
+
+    return changedClasses;
 }
 
 void EClassManager::ensureDefsLoaded()
@@ -187,6 +471,8 @@ void EClassManager::ensureDefsLoaded()
 
 void EClassManager::loadDefAndResolveInheritance()
 {
+    profiling::ScopedZone zone("Entity defs parsing");
+
     _defsLoadingSignal.emit();
 
     // Hold back all changed signals
@@ -290,16 +576,32 @@ void EClassManager::forEachModelDef(const std::function<void(const IModelDefPtr&
 
 void EClassManager::reloadDefs()
 {
+    // Hold back all changed signals until the classes are resolved
+    for (const auto& eclass : _entityClasses)
+    {
+        eclass.second->blockChangedSignal(true);
+    }
+
 	// greebo: Leave all current entityclasses as they are, just invoke the
-	// FileLoader again. It will parse the files again, and look up
+	// FileLoader again. It will parse the changed files again, and look up
 	// the eclass names in the existing map. If found, the eclass
 	// will be asked to clear itself and re-parse from the tokens.
 	// This is to assure that any IEntityClassPtrs remain intact during
 	// the process, only the class contents change.
 	parseDefFiles();
 
-	// Resolve the eclass inheritance again
-	resolveInheritance();
+	// Resolve the eclass inheritance of the changed classes again
+	auto changedClasses = resolveInheritance();
+
+    for (const auto& eclass : _entityClasses)
+    {
+        eclass.second->blockChangedSignal(false);
+    }
+
+    for (auto eclass : changedClasses)
+    {
+        eclass->emitChangedSignal();
+    }
 
     _defsReloadedSignal.emit();
 }
@@ -320,6 +622,7 @@ const StringSet& EClassManager::getDependencies() const
 		_dependencies.insert(MODULE_XMLREGISTRY);
 		_dependencies.insert(MODULE_COMMANDSYSTEM);
 		_dependencies.insert(MODULE_ECLASS_COLOUR_MANAGER);
+		_dependencies.insert(MODULE_PROFILER);
 	}
 
 	return _dependencies;
@@ -361,6 +664,8 @@ void EClassManager::shutdownModule()
 	// Clear member structures
 	_entityClasses.clear();
 	_models.clear();
+	_fileHashes.clear();
+	_fileDecls.clear();
 }
 
 void EClassManager::onEclassOverrideColourChanged(const std::string& eclass, bool overrideRemoved)
@@ -408,10 +713,9 @@ void EClassManager::onFileSystemShutdown()
 
 // Parse the provided stream containing the contents of a single .def file.
 // Extract all entitydefs and create objects accordingly.
-void EClassManager::parse(TextInputStream& inStr, const vfs::FileInfo& fileInfo, const std::string& modDir)
+void EClassManager::parse(std::istream& is, const vfs::FileInfo& fileInfo, const std::string& modDir)
 {
 	// Construct a tokeniser for the stream
-	std::istream is(&inStr);
     parser::BasicDefTokeniser<std::istream> tokeniser(is);
 
     while (tokeniser.hasMoreTokens())
@@ -494,24 +798,96 @@ void EClassManager::parse(TextInputStream& inStr, const vfs::FileInfo& fileInfo,
     }
 }
 
-void EClassManager::parseFile(const vfs::FileInfo& fileInfo)
+bool EClassManager::readFile(const vfs::FileInfo& fileInfo, DefFile& defFile)
 {
 	auto file = GlobalFileSystem().openTextFile(fileInfo.fullPath());
 
-	if (!file) return;
+	if (!file) return false;
+
+	std::istream stream(&file->getInputStream());
+
+	defFile.info = fileInfo;
+	defFile.modDir = file->getModName();
+	defFile.contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+	// The classes of an unchanged file keep their parsed and resolved state
+	auto hash = std::hash<std::string>()(defFile.contents) ^ (std::hash<std::string>()(defFile.modDir) << 1);
+	auto knownHash = _fileHashes.find(fileInfo.fullPath());
+
+	defFile.needsParsing = knownHash == _fileHashes.end() || knownHash->second != hash;
 
+	_fileHashes[fileInfo.fullPath()] = hash;
+
+	return true;
+}
+
+void EClassManager::parseFile(const DefFile& file)
+{
 	try
     {
 		// Parse entity defs from the file
-		parse(file->getInputStream(), fileInfo, file->getModName());
+		std::istringstream is(file.contents);
+		parse(is, file.info, file.modDir);
 	}
     catch (parser::ParseException& e)
     {
-		rError() << "[eclassmgr] failed to parse " << fileInfo.fullPath()
+		rError() << "[eclassmgr] failed to parse " << file.info.fullPath()
 				 << " (" << e.what() << ")" << std::endl;
+
+		// Parse this file again next time, to report the error again
+		_fileHashes.erase(file.info.fullPath());
 	}
 }
 
+std::set<std::string> EClassManager::scanDeclarations(const std::string& contents)
+{
+	std::set<std::string> decls;
+
+	std::istringstream is(contents);
+    parser::BasicDefTokeniser<std::istream> tokeniser(is);
+
+	try
+	{
+		// Same structure as in parse(), the block contents are skipped
+		while (tokeniser.hasMoreTokens())
+		{
+			auto blockType = string::to_lower_copy(tokeniser.nextToken());
+
+			if (blockType == "entitydef")
+			{
+				decls.insert(blockType + " " + string::to_lower_copy(tokeniser.nextToken()));
+
+				tokeniser.assertNextToken("{");
+
+				while (tokeniser.nextToken() != "}")
+				{
+					tokeniser.skipTokens(1); // value
+				}
+			}
+			else if (blockType == "model")
+			{
+				decls.insert(blockType + " " + tokeniser.nextToken());
+
+				tokeniser.assertNextToken("{");
+
+				for (std::size_t depth = 1; depth > 0;)
+				{
+					auto token = tokeniser.nextToken();
+
+					if (token == "{") ++depth;
+					else if (token == "}") --depth;
+				}
+			}
+		}
+	}
+	catch (parser::ParseException&)
+	{
+		// The error is reported when the file is parsed, keep what has been found so far
+	}
+
+	return decls;
+}
+
 void EClassManager::onDefLoadingCompleted()
 {
     for (const auto& eclass : _entityClasses)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <set>
 #include <sigc++/connection.h>
 #include "ieclass.h"
 #include "icommandsystem.h"
@@ -49,6 +50,25 @@ class EClassManager :
 	// definitions have been parsed
 	std::size_t _curParseStamp;
 
+	// Content hashes of the parsed def files, files which didn't change
+	// since the last parse pass are skipped, their classes stay resolved
+	std::map<std::string, std::size_t> _fileHashes;
+	std::size_t _numUnchangedFiles;
+
+	// The entityDef and model declarations of each parsed def file. If a declaration
+	// is found in several files, the last one wins - all of these files are parsed
+	// again if one of them changes, such that the same definition ends up winning.
+	std::map<std::string, std::set<std::string>> _fileDecls;
+
+	// A def file read during a parse pass
+	struct DefFile
+	{
+		vfs::FileInfo info;
+		std::string modDir;
+		std::string contents;
+		bool needsParsing;
+	};
+
     sigc::signal<void> _defsLoadingSignal;
     sigc::signal<void> _defsLoadedSignal;
     sigc::signal<void> _defsReloadedSignal;
@@ -89,8 +109,15 @@ public:
     void shutdownModule() override;
 
 private:
-	// Method loading the DEF files
-    void parseFile(const vfs::FileInfo& fileInfo);
+	// Reads the given DEF file and checks whether its contents changed,
+	// returns false if the file couldn't be opened
+    bool readFile(const vfs::FileInfo& fileInfo, DefFile& defFile);
+
+	// Parses the DEF file read by readFile()
+    void parseFile(const DefFile& file);
+
+	// Returns the declarations (block type and name) found in the given DEF file contents
+	static std::set<std::string> scanDeclarations(const std::string& contents);
 
     // Since loading is happening in a worker thread, we need to ensure
     // that it's done loading before accessing any defs or models.
@@ -111,13 +138,26 @@ private:
     EntityClass::Ptr findInternal(const std::string& name);
 
 	// Parses the given inputstream for DEFs.
-	void parse(TextInputStream& inStr, const vfs::FileInfo& fileInfo, const std::string& modDir);
+	void parse(std::istream& is, const vfs::FileInfo& fileInfo, const std::string& modDir);
 
 	// Recursively resolves the inheritance of the model defs
 	void resolveModelInheritance(const std::string& name, const Doom3ModelDef::Ptr& model);
 
 	void parseDefFiles();
-	void resolveInheritance();
+
+	// Resolves the inheritance of all classes which have been (re-)parsed,
+	// and of their descendants. Returns the classes which have been changed.
+	std::vector<EntityClass*> resolveInheritance();
+
+	// Sorts the classes by the depth of their inheritance chain, such that
+	// the parents of the classes of one level are located in the previous levels.
+	// Classes which need to be resolved again are marked as unresolved.
+	struct InheritanceLink
+	{
+		EntityClass* eclass;
+		EntityClass* parent;
+	};
+	std::vector<std::vector<InheritanceLink>> sortByInheritanceLevel();
 
 	void reloadDefsCmd(const cmd::ArgumentList& args);
 
@@ -7,6 +7,7 @@
 #include "string/predicate.h"
 #include <fmt/format.h>
 #include <functional>
+#include <algorithm>
 
 namespace eclass
 {
@@ -26,6 +27,7 @@ EntityClass::EntityClass(const std::string& name, const vfs::FileInfo& fileInfo,
   _colour(-1, -1, -1),
   _colourTransparent(false),
   _fixedSize(fixedSize),
+  _attributeTableValid(false),
   _model(""),
   _skin(""),
   _inheritanceResolved(false),
@@ -157,7 +159,11 @@ void EntityClass::addAttribute(const EntityClassAttribute& attribute)
         EntityAttributeMap::value_type(attribute.getName(), attribute)
     );
 
-    if (!result.second)
+    if (result.second)
+    {
+        _attributeTableValid = false;
+    }
+    else
     {
         EntityClassAttribute& existing = result.first->second;
 
@@ -205,6 +211,33 @@ void EntityClass::forEachAttributeInternal(InternalAttrVisitor visitor,
 void EntityClass::forEachAttribute(AttributeVisitor visitor,
                                    bool editorKeys) const
 {
+    if (_attributeTableValid)
+    {
+        // The table already contains one attribute per name, sort them by name
+        std::vector<const EntityClassAttribute*> attributes;
+        attributes.reserve(_attributeTable.size());
+
+        for (const auto& entry : _attributeTable)
+        {
+            if (editorKeys || !string::istarts_with(entry.second->getName(), "editor_"))
+            {
+                attributes.push_back(entry.second);
+            }
+        }
+
+        std::sort(attributes.begin(), attributes.end(), [](const EntityClassAttribute* a, const EntityClassAttribute* b)
+        {
+            return a->getName() < b->getName();
+        });
+
+        for (auto attribute : attributes)
+        {
+            visitor(*attribute, _attributes.count(attribute->getName()) == 0);
+        }
+
+        return;
+    }
+
     // First compile a map of all attributes we need to pass to the visitor,
     // ensuring that there is only one attribute per name (i.e. we don't want to
     // visit the same-named attribute on both a child and one of its ancestors)
@@ -228,68 +261,73 @@ void EntityClass::forEachAttribute(AttributeVisitor visitor,
     }
 }
 
-// Resolve inheritance for this class
-void EntityClass::resolveInheritance(EntityClasses& classmap)
+const std::string& EntityClass::getParentName() const
 {
-    // If we have already resolved inheritance, do nothing
-    if (_inheritanceResolved)
-        return;
+    // Only consider our own spawnargs, not the ones of the previous parent
+    const std::string& parName = getAttribute("inherit", false).getValue();
 
-    // Lookup the parent name and return if it is not set. Also return if the
-    // parent name is the same as our own classname, to avoid infinite
-    // recursion.
-    std::string parName = getAttribute("inherit").getValue();
-    if (parName.empty() || parName == _name)
-        return;
+    // A class inheriting from itself has no parent
+    return parName != _name ? parName : _emptyAttribute.getValue();
+}
 
-    // Find the parent entity class
-    EntityClasses::iterator pIter = classmap.find(parName);
-    if (pIter != classmap.end())
+// Resolve inheritance for this class
+void EntityClass::resolveInheritance(EntityClass* parent)
+{
+    // If we have already resolved inheritance, only the attribute table
+    // might need to be re-built
+    if (!_inheritanceResolved)
     {
-        // Recursively resolve inheritance of parent
-        pIter->second->resolveInheritance(classmap);
+        _parent = parent;
 
-        // Set our parent pointer
-        _parent = pIter->second.get();
-    }
-    else
-    {
-        rWarning() << "[eclassmgr] Entity class "
-                              << _name << " specifies unknown parent class "
-                              << parName << std::endl;
-    }
+        // Set the resolved flag
+        _inheritanceResolved = true;
 
-    // Set the resolved flag
-    _inheritanceResolved = true;
+        if (!getAttribute("model").getValue().empty())
+        {
+            // We have a model path (probably an inherited one)
+            setModelPath(getAttribute("model").getValue());
+        }
 
-    if (!getAttribute("model").getValue().empty())
-    {
-        // We have a model path (probably an inherited one)
-        setModelPath(getAttribute("model").getValue());
-    }
+        if (getAttribute("editor_light").getValue() == "1" || getAttribute("spawnclass").getValue() == "idLight")
+        {
+            // We have a light
+            setIsLight(true);
+        }
 
-    if (getAttribute("editor_light").getValue() == "1" || getAttribute("spawnclass").getValue() == "idLight")
-    {
-        // We have a light
-        setIsLight(true);
+        if (getAttribute("editor_transparent").getValue() == "1")
+        {
+            _colourTransparent = true;
+        }
+
+        // Set up inheritance of entity colours: colours inherit from parent unless
+        // there is an explicit editor_color defined at this level
+        resetColour();
     }
 
-    if (getAttribute("editor_transparent").getValue() == "1")
+    if (!_attributeTableValid)
     {
-        _colourTransparent = true;
+        buildAttributeTable();
     }
+}
+
+void EntityClass::connectToParent()
+{
+    _parentChangedConnection.disconnect();
 
-    // Set up inheritance of entity colours: colours inherit from parent unless
-    // there is an explicit editor_color defined at this level
-    resetColour();
     if (_parent)
     {
-        _parent->changedSignal().connect(
+        _parentChangedConnection = _parent->changedSignal().connect(
             sigc::mem_fun(this, &EntityClass::resetColour)
         );
     }
 }
 
+void EntityClass::invalidateInheritance()
+{
+    _inheritanceResolved = false;
+    invalidateAttributeTable();
+}
+
 bool EntityClass::isOfType(const std::string& className)
 {
 	for (const IEntityClass* currentClass = this;
@@ -324,6 +362,13 @@ const EntityClassAttribute&
 EntityClass::getAttribute(const std::string& name,
                                bool includeInherited) const
 {
+    // The flattened table knows about the inherited attributes already
+    if (includeInherited && _attributeTableValid)
+    {
+        auto attribute = findInAttributeTable(name);
+        return attribute ? *attribute : _emptyAttribute;
+    }
+
     // First look up the attribute on this class; if found, we can simply return it
     auto f = _attributes.find(name);
     if (f != _attributes.end())
@@ -339,6 +384,79 @@ EntityClass::getAttribute(const std::string& name,
     return _parent->getAttribute(name);
 }
 
+void EntityClass::invalidateAttributeTable()
+{
+    _attributeTable.clear();
+    _attributeTableValid = false;
+}
+
+void EntityClass::buildAttributeTable()
+{
+    std::vector<AttributeTableEntry> table;
+
+    if (_parent)
+    {
+        // The parent's table is complete, so we can start from there
+        if (!_parent->_attributeTableValid)
+        {
+            _parent->buildAttributeTable();
+        }
+
+        table = _parent->_attributeTable;
+    }
+
+    auto numInherited = table.size();
+
+    for (const auto& pair : _attributes)
+    {
+        auto atom = KeyAtomTable::Intern(pair.first);
+
+        // Our own attributes override the inherited ones
+        auto inherited = std::lower_bound(table.begin(), table.begin() + numInherited, atom,
+            [](const AttributeTableEntry& entry, KeyAtomTable::Atom atom) { return entry.first < atom; });
+
+        if (inherited != table.begin() + numInherited && inherited->first == atom)
+        {
+            inherited->second = &pair.second;
+        }
+        else
+        {
+            table.emplace_back(atom, &pair.second);
+        }
+    }
+
+    std::sort(table.begin(), table.end(), [](const AttributeTableEntry& a, const AttributeTableEntry& b)
+    {
+        return a.first < b.first;
+    });
+
+    _attributeTable.swap(table);
+    _attributeTableValid = true;
+}
+
+const EntityClassAttribute* EntityClass::findInAttributeTable(std::string_view name) const
+{
+    auto atom = KeyAtomTable::Find(name);
+
+    if (atom == KeyAtomTable::InvalidAtom) return nullptr;
+
+    auto found = std::lower_bound(_attributeTable.begin(), _attributeTable.end(), atom,
+        [](const AttributeTableEntry& entry, KeyAtomTable::Atom atom) { return entry.first < atom; });
+
+    return found != _attributeTable.end() && found->first == atom ? found->second : nullptr;
+}
+
+const std::string& EntityClass::getAttributeValue(std::string_view name) const
+{
+    if (_attributeTableValid)
+    {
+        auto attribute = findInAttributeTable(name);
+        return attribute ? attribute->getValue() : _emptyAttribute.getValue();
+    }
+
+    return getAttribute(std::string(name)).getValue();
+}
+
 void EntityClass::clear()
 {
     // Don't clear the name
@@ -350,6 +468,7 @@ void EntityClass::clear()
     _fixedSize = false;
 
     _attributes.clear();
+    invalidateAttributeTable();
     _model.clear();
     _skin.clear();
     _inheritanceResolved = false;
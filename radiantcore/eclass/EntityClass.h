@@ -9,6 +9,7 @@
 #include "string/string.h"
 
 #include "parser/DefTokeniser.h"
+#include "KeyAtomTable.h"
 
 #include <vector>
 #include <map>
@@ -30,6 +31,8 @@ public:
     /// EntityClass pointer type
     using Ptr = std::shared_ptr<EntityClass>;
 
+    typedef std::map<std::string, EntityClass::Ptr> EntityClasses;
+
 private:
     typedef std::shared_ptr<std::string> StringPtr;
 
@@ -66,6 +69,14 @@ private:
     typedef std::map<std::string, EntityClassAttribute, string::ILess> EntityAttributeMap;
     EntityAttributeMap _attributes;
 
+    // Flattened attribute table including all inherited attributes, sorted
+    // by key atom. The pointers refer to the _attributes of this class or
+    // its ancestors. Built when resolving inheritance, as long as it's not
+    // valid, attribute lookups need to walk up the parent chain.
+    using AttributeTableEntry = std::pair<KeyAtomTable::Atom, const EntityClassAttribute*>;
+    std::vector<AttributeTableEntry> _attributeTable;
+    bool _attributeTableValid;
+
     // The model and skin for this entity class (if it has one)
     std::string _model;
     std::string _skin;
@@ -88,6 +99,9 @@ private:
     sigc::signal<void> _changedSignal;
     bool _blockChangeSignal;
 
+    // Connection to the parent's changed signal, to update the inherited colour
+    sigc::connection _parentChangedConnection;
+
 private:
     // Clear all contents (done before parsing from tokens)
     void clear();
@@ -99,6 +113,11 @@ private:
     void forEachAttributeInternal(InternalAttrVisitor visitor,
                                   bool editorKeys) const;
 
+    void buildAttributeTable();
+
+    // Returns the attribute from the flattened table or nullptr if not present
+    const EntityClassAttribute* findInAttributeTable(std::string_view name) const;
+
   public:
     /**
      * Static function to create a default entity class.
@@ -154,6 +173,7 @@ private:
     const EntityClassAttribute&
     getAttribute(const std::string&,
                  bool includeInherited = true) const override;
+    const std::string& getAttributeValue(std::string_view name) const override;
     void forEachAttribute(AttributeVisitor, bool) const override;
 
     const std::string& getModelPath() const override { return _model; }
@@ -172,15 +192,38 @@ private:
     /// Set the skin.
     void setSkin(const std::string& skin) { _skin = skin; }
 
+    // Returns the name of the parent class as defined by this class's own
+    // "inherit" spawnarg, or an empty string if there is no parent.
+    const std::string& getParentName() const;
+
+    bool isInheritanceResolved() const
+    {
+        return _inheritanceResolved;
+    }
+
     /**
-     * Resolve inheritance for this class.
+     * Resolve inheritance for this class and build the flattened table of
+     * all (own and inherited) attributes.
      *
-     * @param classmap
-     * A reference to the global map of entity classes, which should be searched
-     * for the parent entity.
+     * @param parent
+     * The parent class (or nullptr), its inheritance must be resolved already.
+     * Only this class is modified, such that classes of the same inheritance
+     * level can be resolved in parallel. The changed signal of the parent
+     * is connected by connectToParent() afterwards.
      */
-    typedef std::map<std::string, EntityClass::Ptr> EntityClasses;
-    void resolveInheritance(EntityClasses& classmap);
+    void resolveInheritance(EntityClass* parent);
+
+    // Subscribes to the changed signal of the parent set by resolveInheritance()
+    void connectToParent();
+
+    // Marks the inheritance as unresolved, to be resolved again after
+    // one of the ancestors has been re-parsed. The flattened attribute table
+    // is discarded, since it might refer to the ancestors' attributes.
+    void invalidateInheritance();
+
+    // Discards the flattened attribute table, it will be re-built by the next
+    // call to resolveInheritance().
+    void invalidateAttributeTable();
 
     /**
      * Return the mod name.
@@ -221,6 +264,11 @@ private:
     {
         _blockChangeSignal = block;
     }
+
+    bool isChangedSignalBlocked() const
+    {
+        return _blockChangeSignal;
+    }
 };
 
 }
@@ -0,0 +1,103 @@
+#include "KeyAtomTable.h"
+
+#include <cctype>
+#include <mutex>
+#include <stdexcept>
+
+namespace eclass
+{
+
+std::size_t KeyAtomTable::ICaseHash::operator()(std::string_view key) const
+{
+    // FNV-1a on the lower case characters
+    std::size_t hash = 14695981039346656037ULL;
+
+    for (auto c : key)
+    {
+        hash ^= static_cast<std::size_t>(std::tolower(static_cast<unsigned char>(c)));
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+bool KeyAtomTable::ICaseEqual::operator()(std::string_view a, std::string_view b) const
+{
+    if (a.size() != b.size()) return false;
+
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+KeyAtomTable::Atom KeyAtomTable::Intern(std::string_view key)
+{
+    auto& table = Instance();
+
+    {
+        std::shared_lock<std::shared_mutex> readLock(table._lock);
+
+        auto found = table._atoms.find(key);
+
+        if (found != table._atoms.end())
+        {
+            return found->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> writeLock(table._lock);
+
+    // Another thread might have interned the key in the meantime
+    auto found = table._atoms.find(key);
+
+    if (found != table._atoms.end())
+    {
+        return found->second;
+    }
+
+    const auto& storedKey = table._keys.emplace_back(key);
+    auto atom = static_cast<Atom>(table._keys.size());
+
+    table._atoms.emplace(storedKey, atom);
+
+    return atom;
+}
+
+KeyAtomTable::Atom KeyAtomTable::Find(std::string_view key)
+{
+    auto& table = Instance();
+
+    std::shared_lock<std::shared_mutex> readLock(table._lock);
+
+    auto found = table._atoms.find(key);
+
+    return found != table._atoms.end() ? found->second : InvalidAtom;
+}
+
+const std::string& KeyAtomTable::GetKey(Atom atom)
+{
+    auto& table = Instance();
+
+    std::shared_lock<std::shared_mutex> readLock(table._lock);
+
+    if (atom == InvalidAtom || atom > table._keys.size())
+    {
+        throw std::out_of_range("KeyAtomTable: invalid atom");
+    }
+
+    return table._keys[atom - 1];
+}
+
+KeyAtomTable& KeyAtomTable::Instance()
+{
+    static KeyAtomTable _instance;
+    return _instance;
+}
+
+}
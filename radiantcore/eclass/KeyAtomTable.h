@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace eclass
+{
+
+/**
+ * Process-wide table of interned spawnarg keys. Every distinct key is
+ * assigned a small integer (the atom), which is much cheaper to compare and
+ * to search for than the key string itself. Keys are compared
+ * case-insensitively, like everywhere else spawnargs are concerned.
+ *
+ * Atoms are never released again, the number of distinct keys used by
+ * the entityDefs and maps is small. The table is thread-safe, since the
+ * entityDefs are resolved by the def loader thread.
+ */
+class KeyAtomTable
+{
+public:
+    using Atom = std::uint32_t;
+
+    // The atom value which is never assigned to any key
+    static constexpr Atom InvalidAtom = 0;
+
+private:
+    struct ICaseHash
+    {
+        std::size_t operator()(std::string_view key) const;
+    };
+
+    struct ICaseEqual
+    {
+        bool operator()(std::string_view a, std::string_view b) const;
+    };
+
+    // The interned strings, the atom value is the index + 1
+    // (a deque doesn't move its elements when growing)
+    std::deque<std::string> _keys;
+
+    // Views point into the _keys storage
+    std::unordered_map<std::string_view, Atom, ICaseHash, ICaseEqual> _atoms;
+
+    mutable std::shared_mutex _lock;
+
+public:
+    // Returns the atom for the given key, a new atom is assigned if the key
+    // has not been interned yet
+    static Atom Intern(std::string_view key);
+
+    // Returns the atom for the given key, or InvalidAtom if the key has never
+    // been interned (in which case no entity or entityDef can define it)
+    static Atom Find(std::string_view key);
+
+    // Returns the key string as it has been interned first
+    static const std::string& GetKey(Atom atom);
+
+private:
+    static KeyAtomTable& Instance();
+};
+
+}
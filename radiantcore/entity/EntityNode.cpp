@@ -23,6 +23,7 @@ EntityNode::EntityNode(const IEntityClassPtr& eclass) :
 	_modelKey(*this),
 	_keyObservers(_spawnArgs),
 	_shaderParms(_keyObservers, _colourKey),
+	_spawnArgsChangeReporter(*this),
 	_direction(1,0,0)
 {
 }
@@ -43,6 +44,7 @@ EntityNode::EntityNode(const EntityNode& other) :
 	_modelKey(*this),
 	_keyObservers(_spawnArgs),
 	_shaderParms(_keyObservers, _colourKey),
+	_spawnArgsChangeReporter(*this),
 	_direction(1,0,0)
 {
 }
@@ -73,6 +75,8 @@ void EntityNode::construct()
 
 	_shaderParms.addKeyObservers();
 
+	_spawnArgs.attachObserver(&_spawnArgsChangeReporter);
+
     // Construct all attached entities
     createAttachedEntities();
 }
@@ -104,6 +108,8 @@ void EntityNode::constructClone(const EntityNode& original)
 
 void EntityNode::destruct()
 {
+	_spawnArgs.detachObserver(&_spawnArgsChangeReporter);
+
 	_shaderParms.removeKeyObservers();
 
 	removeKeyObserver("skin", _skinKeyObserver);
@@ -246,6 +252,12 @@ std::string EntityNode::getFingerprint()
     return hash;
 }
 
+std::size_t EntityNode::getMemoryUsage() const
+{
+    // Subclasses like lights and speakers are a bit larger than the base class
+    return sizeof(EntityNode) + _spawnArgs.getAllocatedMemory();
+}
+
 void EntityNode::testSelect(Selector& selector, SelectionTest& test)
 {
 	test.BeginMesh(localToWorld());
@@ -295,8 +307,8 @@ void EntityNode::onInsertIntoScene(scene::IMapRootNode& root)
 {
     GlobalCounters().getCounter(counterEntities).increment();
 
-	_spawnArgs.connectUndoSystem(root.getUndoChangeTracker());
-	_modelKey.connectUndoSystem(root.getUndoChangeTracker());
+	_spawnArgs.connectUndoSystem(getChangeTracker(root));
+	_modelKey.connectUndoSystem(getChangeTracker(root));
 
 	SelectableNode::onInsertIntoScene(root);
     TargetableNode::onInsertIntoScene(root);
@@ -307,8 +319,8 @@ void EntityNode::onRemoveFromScene(scene::IMapRootNode& root)
     TargetableNode::onRemoveFromScene(root);
 	SelectableNode::onRemoveFromScene(root);
 
-	_modelKey.disconnectUndoSystem(root.getUndoChangeTracker());
-	_spawnArgs.disconnectUndoSystem(root.getUndoChangeTracker());
+	_modelKey.disconnectUndoSystem(getChangeTracker(root));
+	_spawnArgs.disconnectUndoSystem(getChangeTracker(root));
 
     GlobalCounters().getCounter(counterEntities).decrement();
 }
@@ -4,6 +4,7 @@
 #include "ientity.h"
 #include "inamespace.h"
 #include "icomparablenode.h"
+#include "imemoryaccountable.h"
 #include "Bounded.h"
 
 #include "scene/SelectableNode.h"
@@ -34,7 +35,8 @@ class EntityNode :
 	public Namespaced,
 	public TargetableNode,
 	public Transformable,
-    public scene::IComparableNode
+    public scene::IComparableNode,
+    public scene::IMemoryAccountable
 {
 protected:
 	// The entity class
@@ -70,6 +72,37 @@ protected:
 	// Helper class observing the "shaderParmNN" spawnargs and caching their values
 	ShaderParms _shaderParms;
 
+	// Reports every spawnarg change through the root's node changed signal,
+	// this includes the changes done outside an undoable operation
+	class SpawnArgsChangeReporter :
+		public Entity::Observer
+	{
+	private:
+		EntityNode& _owner;
+
+	public:
+		SpawnArgsChangeReporter(EntityNode& owner) :
+			_owner(owner)
+		{}
+
+		void onKeyInsert(const std::string& key, EntityKeyValue& value) override
+		{
+			_owner.reportChange();
+		}
+
+		void onKeyChange(const std::string& key, const std::string& value) override
+		{
+			_owner.reportChange();
+		}
+
+		void onKeyErase(const std::string& key, EntityKeyValue& value) override
+		{
+			_owner.reportChange();
+		}
+	};
+
+	SpawnArgsChangeReporter _spawnArgsChangeReporter;
+
 	// This entity's main direction, usually determined by the angle/rotation keys
 	Vector3 _direction;
 
@@ -118,6 +151,9 @@ public:
     // IComparableNode implementation
     std::string getFingerprint() override;
 
+    // IMemoryAccountable implementation
+    std::size_t getMemoryUsage() const override;
+
 	// SelectionTestable implementation
 	virtual void testSelect(Selector& selector, SelectionTest& test) override;
 
@@ -2,7 +2,8 @@
 
 #include "ieclass.h"
 #include "debugging/debugging.h"
-#include "string/predicate.h"
+#include "string/StringPool.h"
+#include "util/BlockPool.h"
 #include <functional>
 
 namespace entity
@@ -51,9 +52,9 @@ void SpawnArgs::parseAttachments()
 
 bool SpawnArgs::isModel() const
 {
-	std::string name = getKeyValue("name");
-	std::string model = getKeyValue("model");
-	std::string classname = getKeyValue("classname");
+	auto name = getKeyValueView("name");
+	auto model = getKeyValueView("model");
+	auto classname = getKeyValueView("classname");
 
 	return (classname == "func_static" && !name.empty() && name != model);
 }
@@ -201,17 +202,24 @@ std::string SpawnArgs::getKeyValue(const std::string& key) const
 	}
 	else
 	{
-		return _eclass->getAttribute(key).getValue();
+		return _eclass->getAttributeValue(key);
 	}
 }
 
+std::string_view SpawnArgs::getKeyValueView(std::string_view key) const
+{
+	auto i = find(key);
+
+	return i != _keyValues.end() ? std::string_view(i->second->get()) : std::string_view(_eclass->getAttributeValue(key));
+}
+
 bool SpawnArgs::isInherited(const std::string& key) const
 {
 	// Check if we have the key in the local keyvalue map
 	bool definedLocally = (find(key) != _keyValues.end());
 
 	// The value is inherited, if it doesn't exist locally and the inherited one is not empty
-	return (!definedLocally && !_eclass->getAttribute(key).getValue().empty());
+	return (!definedLocally && !_eclass->getAttributeValue(key).empty());
 }
 
 void SpawnArgs::forEachAttachment(AttachmentFunc func) const
@@ -226,9 +234,24 @@ EntityKeyValuePtr SpawnArgs::getEntityKeyValue(const std::string& key)
 	return (found != _keyValues.end()) ? found->second : EntityKeyValuePtr();
 }
 
+std::size_t SpawnArgs::getAllocatedMemory() const
+{
+	std::size_t bytes = _keyValues.capacity() * sizeof(KeyValuePair) +
+		_keyAtoms.capacity() * sizeof(eclass::KeyAtomTable::Atom);
+
+	for (const auto& pair : _keyValues)
+	{
+		// The KeyValue object plus the shared_ptr's control block
+		bytes += sizeof(KeyValue) + 2 * sizeof(long) + sizeof(void*);
+		bytes += string::getHeapMemoryUsage(pair.first) + string::getHeapMemoryUsage(pair.second->get());
+	}
+
+	return bytes;
+}
+
 bool SpawnArgs::isWorldspawn() const
 {
-	return getKeyValue("classname") == "worldspawn";
+	return getKeyValueView("classname") == "worldspawn";
 }
 
 bool SpawnArgs::isContainer() const
@@ -289,6 +312,7 @@ void SpawnArgs::insert(const std::string& key, const KeyValuePtr& keyValue)
 		_keyValues.end(),
 		KeyValuePair(key, keyValue)
 	);
+	_keyAtoms.push_back(eclass::KeyAtomTable::Intern(key));
 
 	// Dereference the iterator to get a KeyValue& reference and notify the observers
 	notifyInsert(key, *i->second);
@@ -321,7 +345,7 @@ void SpawnArgs::insert(const std::string& key, const std::string& value)
 		// Allocate a new KeyValue object and insert it into the map
 		insert(
 			key,
-			KeyValuePtr(new KeyValue(value, _eclass->getAttribute(key).getValue()))
+			util::makePooledShared<KeyValue>(value, _eclass->getAttributeValue(key))
 		);
 	}
 }
@@ -338,6 +362,7 @@ void SpawnArgs::erase(const KeyValues::iterator& i)
 	KeyValuePtr value(i->second);
 
 	// Actually delete the object from the list
+	_keyAtoms.erase(_keyAtoms.begin() + (i - _keyValues.begin()));
 	_keyValues.erase(i);
 
 	// Notify about the deletion
@@ -359,36 +384,40 @@ void SpawnArgs::erase(const std::string& key)
 	}
 }
 
-SpawnArgs::KeyValues::const_iterator SpawnArgs::find(const std::string& key) const
+int SpawnArgs::findIndex(std::string_view key) const
 {
-	for (KeyValues::const_iterator i = _keyValues.begin();
-		 i != _keyValues.end();
-		 ++i)
+	auto atom = eclass::KeyAtomTable::Find(key);
+
+	// Keys which have never been interned can't be present
+	if (atom == eclass::KeyAtomTable::InvalidAtom)
 	{
-		if (string::iequals(i->first, key))
+		return -1;
+	}
+
+	for (std::size_t i = 0; i < _keyAtoms.size(); ++i)
+	{
+		if (_keyAtoms[i] == atom)
 		{
-			return i;
+			return static_cast<int>(i);
 		}
 	}
 
 	// Not found
-	return _keyValues.end();
+	return -1;
 }
 
-SpawnArgs::KeyValues::iterator SpawnArgs::find(const std::string& key)
+SpawnArgs::KeyValues::const_iterator SpawnArgs::find(std::string_view key) const
 {
-	for (KeyValues::iterator i = _keyValues.begin();
-		 i != _keyValues.end();
-		 ++i)
-	{
-		if (string::iequals(i->first, key))
-		{
-			return i;
-		}
-	}
+	auto index = findIndex(key);
 
-	// Not found
-	return _keyValues.end();
+	return index != -1 ? _keyValues.begin() + index : _keyValues.end();
+}
+
+SpawnArgs::KeyValues::iterator SpawnArgs::find(std::string_view key)
+{
+	auto index = findIndex(key);
+
+	return index != -1 ? _keyValues.begin() + index : _keyValues.end();
 }
 
 } // namespace entity
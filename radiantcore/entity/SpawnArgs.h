@@ -4,6 +4,7 @@
 
 #include <vector>
 #include "KeyValue.h"
+#include "eclass/KeyAtomTable.h"
 #include <memory>
 
 namespace entity {
@@ -31,6 +32,10 @@ class SpawnArgs: public Entity
 	typedef std::vector<KeyValuePair> KeyValues;
 	KeyValues _keyValues;
 
+	// The interned keys of the _keyValues, in the same order. Searching this
+	// compact list for an atom is much faster than comparing the key strings.
+	std::vector<eclass::KeyAtomTable::Atom> _keyAtoms;
+
 	typedef std::set<Observer*> Observers;
 	Observers _observers;
 
@@ -64,6 +69,7 @@ public:
     void forEachEntityKeyValue(const EntityKeyValueVisitFunctor& visitor) override;
 	void setKeyValue(const std::string& key, const std::string& value) override;
 	std::string getKeyValue(const std::string& key) const override;
+	std::string_view getKeyValueView(std::string_view key) const override;
 	bool isInherited(const std::string& key) const override;
     void forEachAttachment(AttachmentFunc func) const override;
 
@@ -73,6 +79,10 @@ public:
 
 	bool isModel() const override;
 
+	// Returns the approximate number of bytes allocated for the spawnargs
+	// (not including the size of the SpawnArgs object itself)
+	std::size_t getAllocatedMemory() const;
+
 	// Returns the actual pointer to a KeyValue (or NULL if not found),
 	// not just the string like getKeyValue() does.
 	// Only returns non-NULL for non-inherited keyvalues.
@@ -97,8 +107,11 @@ private:
 	void erase(const KeyValues::iterator& i);
 	void erase(const std::string& key);
 
-	KeyValues::iterator find(const std::string& key);
-	KeyValues::const_iterator find(const std::string& key) const;
+	KeyValues::iterator find(std::string_view key);
+	KeyValues::const_iterator find(std::string_view key) const;
+
+	// Returns the index of the given key in _keyValues, or -1 if not present
+	int findIndex(std::string_view key) const;
 };
 
 } // namespace entity
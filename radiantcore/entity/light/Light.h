@@ -5,6 +5,7 @@
 #include "editable.h"
 #include "render.h"
 #include "irenderable.h"
+#include "ilightnode.h"
 #include "math/Frustum.h"
 #include "transformlib.h"
 
@@ -26,7 +27,7 @@ void light_vertices(const AABB& aabb_light, Vector3 points[6]);
 void light_draw(const AABB& aabb_light, RenderStateFlags state);
 
 inline void default_extents(Vector3& extents) {
-	extents = Vector3(8,8,8);
+	extents = Vector3(LIGHT_DIAMOND_EXTENTS, LIGHT_DIAMOND_EXTENTS, LIGHT_DIAMOND_EXTENTS);
 }
 
 class LightNode;
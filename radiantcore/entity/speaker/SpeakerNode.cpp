@@ -18,7 +18,7 @@ SpeakerNode::SpeakerNode(const IEntityClassPtr& eclass) :
 	EntityNode(eclass),
 	m_originKey(std::bind(&SpeakerNode::originChanged, this)),
 	m_origin(ORIGINKEY_IDENTITY),
-	_renderableRadii(m_origin, _radiiTransformed),
+	_renderableRadii(_radiiTransformed),
 	m_useSpeakerRadii(true),
 	m_minIsSet(false),
 	m_maxIsSet(false),
@@ -35,7 +35,7 @@ SpeakerNode::SpeakerNode(const SpeakerNode& other) :
 	Snappable(other),
 	m_originKey(std::bind(&SpeakerNode::originChanged, this)),
 	m_origin(ORIGINKEY_IDENTITY),
-	_renderableRadii(m_origin, _radiiTransformed),
+	_renderableRadii(_radiiTransformed),
 	m_useSpeakerRadii(true),
 	m_minIsSet(false),
 	m_maxIsSet(false),
@@ -255,7 +255,7 @@ void SpeakerNode::renderSolid(RenderableCollector& collector,
     // radii" option is set
 	if (isSelected() || EntitySettings::InstancePtr()->getShowAllSpeakerRadii())
     {
-		collector.addRenderable(*getFillShader(), _renderableRadii, localToWorld());
+		_renderableRadii.submitGeometry(collector, *getFillShader(), localToWorld().tCol().getVector3(), true);
     }
 }
 void SpeakerNode::renderWireframe(RenderableCollector& collector,
@@ -269,10 +269,17 @@ void SpeakerNode::renderWireframe(RenderableCollector& collector,
     // radii" option is set
 	if (isSelected() || EntitySettings::InstancePtr()->getShowAllSpeakerRadii())
     {
-		collector.addRenderable(*getWireShader(), _renderableRadii, localToWorld());
+		_renderableRadii.submitGeometry(collector, *getWireShader(), localToWorld().tCol().getVector3(), false);
     }
 }
 
+void SpeakerNode::setRenderSystem(const RenderSystemPtr& renderSystem)
+{
+	EntityNode::setRenderSystem(renderSystem);
+
+	_renderableRadii.setRenderSystem(renderSystem);
+}
+
 void SpeakerNode::translate(const Vector3& translation)
 {
 	m_origin += translation;
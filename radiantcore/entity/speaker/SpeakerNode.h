@@ -111,6 +111,7 @@ public:
     scene::INodePtr clone() const override;
 
     // Renderable implementation
+    void setRenderSystem(const RenderSystemPtr& renderSystem) override;
     void renderSolid(RenderableCollector& collector, const VolumeTest& volume) const override;
     void renderWireframe(RenderableCollector& collector, const VolumeTest& volume) const override;
 
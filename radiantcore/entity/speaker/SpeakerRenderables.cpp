@@ -1,8 +1,21 @@
 #include "SpeakerRenderables.h"
 
-// the drawing functions
+// the geometry generating functions
 
-void sphereDrawFill(const Vector3& origin, float radius, int sides)
+namespace
+{
+
+inline void addSphereVertex(const Vector3& origin, const Vector3& direction, float radius,
+    std::vector<ArbitraryMeshVertex>& vertices, std::vector<unsigned int>& indices)
+{
+    indices.push_back(static_cast<unsigned int>(vertices.size()));
+    vertices.emplace_back(origin + direction * radius, direction, TexCoord2f(0, 0));
+}
+
+}
+
+void sphereGenerateFill(const Vector3& origin, float radius, int sides,
+    std::vector<ArbitraryMeshVertex>& vertices, std::vector<unsigned int>& indices)
 {
   if (radius <= 0)
     return;
@@ -10,7 +23,6 @@ void sphereDrawFill(const Vector3& origin, float radius, int sides)
   const double dt = c_2pi / static_cast<float>(sides);
   const double dp = math::PI / static_cast<float>(sides);
 
-  glBegin(GL_TRIANGLES);
   for (int i = 0; i <= sides - 1; ++i)
   {
     for (int j = 0; j <= sides - 2; ++j)
@@ -18,35 +30,13 @@ void sphereDrawFill(const Vector3& origin, float radius, int sides)
       const double t = i * dt;
       const double p = (j * dp) - (math::PI / 2.0);
 
-      {
-        Vector3 v(origin + Vector3::createForSpherical(t, p) * radius);
-        glVertex3dv(v);
-      }
+      addSphereVertex(origin, Vector3::createForSpherical(t, p), radius, vertices, indices);
+      addSphereVertex(origin, Vector3::createForSpherical(t, p + dp), radius, vertices, indices);
+      addSphereVertex(origin, Vector3::createForSpherical(t + dt, p + dp), radius, vertices, indices);
 
-      {
-        Vector3 v(origin + Vector3::createForSpherical(t, p + dp) * radius);
-        glVertex3dv(v);
-      }
-
-      {
-        Vector3 v(origin + Vector3::createForSpherical(t + dt, p + dp) * radius);
-        glVertex3dv(v);
-      }
-
-      {
-        Vector3 v(origin + Vector3::createForSpherical(t, p) * radius);
-        glVertex3dv(v);
-      }
-
-      {
-        Vector3 v(origin + Vector3::createForSpherical(t + dt, p + dp) * radius);
-        glVertex3dv(v);
-      }
-
-      {
-        Vector3 v(origin + Vector3::createForSpherical(t + dt, p) * radius);
-        glVertex3dv(v);
-      }
+      addSphereVertex(origin, Vector3::createForSpherical(t, p), radius, vertices, indices);
+      addSphereVertex(origin, Vector3::createForSpherical(t + dt, p + dp), radius, vertices, indices);
+      addSphereVertex(origin, Vector3::createForSpherical(t + dt, p), radius, vertices, indices);
     }
   }
 
@@ -56,110 +46,145 @@ void sphereDrawFill(const Vector3& origin, float radius, int sides)
     {
       const double t = i * dt;
 
-      {
-        Vector3 v(origin + Vector3::createForSpherical(t, p) * radius);
-        glVertex3dv(v);
-      }
-
-      {
-        Vector3 v(origin + Vector3::createForSpherical(t + dt, p + dp) * radius);
-        glVertex3dv(v);
-      }
-
-      {
-        Vector3 v(origin + Vector3::createForSpherical(t + dt, p) * radius);
-        glVertex3dv(v);
-      }
+      addSphereVertex(origin, Vector3::createForSpherical(t, p), radius, vertices, indices);
+      addSphereVertex(origin, Vector3::createForSpherical(t + dt, p + dp), radius, vertices, indices);
+      addSphereVertex(origin, Vector3::createForSpherical(t + dt, p), radius, vertices, indices);
     }
   }
-  glEnd();
 }
 
-void sphereDrawWire(const Vector3& origin, float radius, int sides)
+void sphereGenerateWire(const Vector3& origin, float radius, int sides,
+    std::vector<ArbitraryMeshVertex>& vertices, std::vector<unsigned int>& indices)
 {
+  // Three circles, one around each axis, drawn as line segments
+  for (int axis = 0; axis < 3; ++axis)
   {
-    glBegin(GL_LINE_LOOP);
+    auto firstVertex = static_cast<unsigned int>(vertices.size());
 
     for (int i = 0; i <= sides; i++)
     {
       float ds = sin((i * 2 * static_cast<float>(math::PI)) / sides);
       float dc = cos((i * 2 * static_cast<float>(math::PI)) / sides);
 
-      glVertex3d(
-        origin[0] + radius * dc,
-        origin[1] + radius * ds,
-        origin[2]
-      );
-    }
-
-    glEnd();
-  }
+      Vector3 direction = axis == 0 ? Vector3(dc, ds, 0) :
+                          axis == 1 ? Vector3(dc, 0, ds) : Vector3(0, dc, ds);
 
-  {
-    glBegin(GL_LINE_LOOP);
+      vertices.emplace_back(origin + direction * radius, direction, TexCoord2f(0, 0));
 
-    for (int i = 0; i <= sides; i++)
-    {
-      float ds = sin((i * 2 * static_cast<float>(math::PI)) / sides);
-      float dc = cos((i * 2 * static_cast<float>(math::PI)) / sides);
-
-      glVertex3d(
-        origin[0] + radius * dc,
-        origin[1],
-        origin[2] + radius * ds
-      );
+      if (i > 0)
+      {
+        indices.push_back(firstVertex + i - 1);
+        indices.push_back(firstVertex + i);
+      }
     }
-
-    glEnd();
   }
+}
 
-  {
-    glBegin(GL_LINE_LOOP);
-
-    for (int i = 0; i <= sides; i++)
-    {
-      float ds = sin((i * 2 * static_cast<float>(math::PI)) / sides);
-      float dc = cos((i * 2 * static_cast<float>(math::PI)) / sides);
-
-      glVertex3d(
-        origin[0],
-        origin[1] + radius * dc,
-        origin[2] + radius * ds
-      );
-    }
+namespace entity
+{
 
-    glEnd();
-  }
+namespace
+{
+    const int FILL_SPHERE_SIDES = 16;
+    const int WIRE_SPHERE_SIDES = 24;
 }
 
-void speakerDrawRadiiWire(const Vector3& origin, const SoundRadii& rad)
+RenderableSpeakerRadii::~RenderableSpeakerRadii()
 {
-  if(rad.getMin() > 0)
-    sphereDrawWire(origin, rad.getMin(), 24);
-  if(rad.getMax() > 0)
-    sphereDrawWire(origin, rad.getMax(), 24);
+	releaseGeometry();
 }
 
-void speakerDrawRadiiFill(const Vector3& origin, const SoundRadii& rad)
+void RenderableSpeakerRadii::setRenderSystem(const RenderSystemPtr& renderSystem)
 {
-  if(rad.getMin() > 0)
-    sphereDrawFill(origin, rad.getMin(), 16);
-  if(rad.getMax() > 0)
-    sphereDrawFill(origin, rad.getMax(), 16);
+	// Any existing slots belong to the previous render system's store
+	releaseGeometry();
+
+	_renderSystem = renderSystem;
 }
 
-namespace entity
+void RenderableSpeakerRadii::releaseGeometry()
 {
+	auto renderSystem = _renderSystem.lock();
 
-void RenderableSpeakerRadii::render(const RenderInfo& info) const
-{
-	//draw the radii of speaker based on speaker shader/radii keys
-	if(info.checkFlag(RENDER_FILL)) {
-		speakerDrawRadiiFill(Vector3(0,0,0), m_radii);
+	if (renderSystem)
+	{
+		auto& store = renderSystem->getGeometryStore();
+
+		if (_fillSlot != render::IGeometryStore::InvalidSlot)
+		{
+			store.deallocateSlot(_fillSlot);
+		}
+
+		if (_wireSlot != render::IGeometryStore::InvalidSlot)
+		{
+			store.deallocateSlot(_wireSlot);
+		}
 	}
-	else {
-		speakerDrawRadiiWire(Vector3(0,0,0), m_radii);
+
+	_fillSlot = render::IGeometryStore::InvalidSlot;
+	_wireSlot = render::IGeometryStore::InvalidSlot;
+}
+
+void RenderableSpeakerRadii::submitGeometry(RenderableCollector& collector, Shader& shader,
+	const Vector3& worldOrigin, bool filled) const
+{
+	auto renderSystem = _renderSystem.lock();
+
+	if (!renderSystem) return;
+
+	auto& slot = filled ? _fillSlot : _wireSlot;
+	auto& origin = filled ? _fillOrigin : _wireOrigin;
+	auto& radii = filled ? _fillRadii : _wireRadii;
+
+	std::pair<float, float> currentRadii(m_radii.getMin(), m_radii.getMax());
+
+	// Re-generate the geometry only if anything changed since the last time
+	if (slot == render::IGeometryStore::InvalidSlot || origin != worldOrigin || radii != currentRadii)
+	{
+		std::vector<ArbitraryMeshVertex> vertices;
+		std::vector<unsigned int> indices;
+
+		//draw the radii of speaker based on speaker shader/radii keys
+		for (auto radius : { currentRadii.first, currentRadii.second })
+		{
+			if (radius <= 0) continue;
+
+			if (filled)
+			{
+				sphereGenerateFill(worldOrigin, radius, FILL_SPHERE_SIDES, vertices, indices);
+			}
+			else
+			{
+				sphereGenerateWire(worldOrigin, radius, WIRE_SPHERE_SIDES, vertices, indices);
+			}
+		}
+
+		auto& store = renderSystem->getGeometryStore();
+
+		// The vertex count only depends on the number of non-zero radii,
+		// the slot can be re-used if it has the right size
+		if (slot != render::IGeometryStore::InvalidSlot && (radii.first > 0) == (currentRadii.first > 0) &&
+			(radii.second > 0) == (currentRadii.second > 0))
+		{
+			store.updateData(slot, vertices, indices);
+		}
+		else
+		{
+			if (slot != render::IGeometryStore::InvalidSlot)
+			{
+				store.deallocateSlot(slot);
+			}
+
+			slot = store.allocateSlot(vertices.size(), indices.size());
+			store.updateData(slot, vertices, indices);
+		}
+
+		origin = worldOrigin;
+		radii = currentRadii;
 	}
+
+	collector.addGeometry(shader, slot,
+		filled ? render::GeometryType::Triangles : render::GeometryType::Lines);
 }
 
 const AABB& RenderableSpeakerRadii::localAABB()
@@ -8,12 +8,14 @@
 #include "entitylib.h"
 #include "igl.h"
 #include "isound.h"
+#include "igeometrystore.h"
+#include "render/ArbitraryMeshVertex.h"
 
-// the drawing functions
-void sphereDrawFill(const Vector3& origin, float radius, int sides);
-void sphereDrawWire(const Vector3& origin, float radius, int sides);
-void speakerDrawRadiiWire(const Vector3& origin, const float envelope[2]);
-void speakerDrawRadiiFill(const Vector3& origin, const float envelope[2]);
+// Sphere geometry generators, appending the vertices and indices to the given arrays
+void sphereGenerateFill(const Vector3& origin, float radius, int sides,
+    std::vector<ArbitraryMeshVertex>& vertices, std::vector<unsigned int>& indices);
+void sphereGenerateWire(const Vector3& origin, float radius, int sides,
+    std::vector<ArbitraryMeshVertex>& vertices, std::vector<unsigned int>& indices);
 
 namespace entity {
 
@@ -21,49 +23,65 @@ namespace entity {
  * \brief
  * Renderable speaker radius class.
  *
- * This OpenGLRenderable renders the two spherical radii of a speaker,
- * representing the s_min and s_max values.
+ * This class maintains the geometry of the two spherical radii of a speaker,
+ * representing the s_min and s_max values. The spheres are stored in the
+ * render system's geometry store and are only rebuilt when the radii or the
+ * speaker origin change.
  */
 class RenderableSpeakerRadii
-: public OpenGLRenderable
 {
-	const Vector3& m_origin;
 	AABB m_aabb_local;
 
     // SoundRadii reference containing min and max radius values
 	// (the actual instance resides in the Speaker class)
 	const SoundRadii& m_radii;
 
+	RenderSystemWeakPtr _renderSystem;
+
+	// Geometry store slots for the filled and the wireframe spheres
+	mutable render::IGeometryStore::Slot _fillSlot;
+	mutable render::IGeometryStore::Slot _wireSlot;
+
+	// The values the geometry slots have been built with
+	mutable Vector3 _fillOrigin;
+	mutable Vector3 _wireOrigin;
+	mutable std::pair<float, float> _fillRadii;
+	mutable std::pair<float, float> _wireRadii;
+
 public:
 
     /**
      * \brief
-     * Construct a RenderableSpeakerRadii with the given origin.
+     * Construct a RenderableSpeakerRadii using the given radii.
      */
-	RenderableSpeakerRadii(const Vector3& origin, const SoundRadii& radii) :
-		m_origin(origin),
-		m_radii(radii)
+	RenderableSpeakerRadii(const SoundRadii& radii) :
+		m_radii(radii),
+		_fillSlot(render::IGeometryStore::InvalidSlot),
+		_wireSlot(render::IGeometryStore::InvalidSlot)
     {}
 
-    /**
-     * \brief
-     * Set the minimum radius to render.
-     */
-    //void setMin(float min, bool inMetres = false);
-
-    /**
-     * \brief
-     * Set the maximum radius to render.
-     */
-    //void setMax(float max, bool inMetres = false);
+	~RenderableSpeakerRadii();
 
 	// Gets the minimum/maximum values to render
 	float getMin();
 	float getMax();
 
-	void render(const RenderInfo& info) const;
+	// Moves the geometry to the given render system's store
+	void setRenderSystem(const RenderSystemPtr& renderSystem);
+
+	/**
+	 * Submit the (filled or wireframe) radii spheres to the given collector,
+	 * the spheres are centered around the given world origin.
+	 * Geometry is only re-generated if anything changed since the last call.
+	 */
+	void submitGeometry(RenderableCollector& collector, Shader& shader,
+		const Vector3& worldOrigin, bool filled) const;
+
 	const AABB& localAABB();
 
+private:
+	void releaseGeometry();
+
 }; // class RenderSpeakerRadii
 
 } // namespace entity
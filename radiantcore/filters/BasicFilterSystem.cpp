@@ -8,6 +8,7 @@
 #include "iregistry.h"
 #include "igame.h"
 #include "ishaders.h"
+#include "iprofiler.h"
 
 #include "module/StaticModule.h"
 #include "InstanceUpdateWalker.h"
@@ -344,6 +345,8 @@ sigc::signal<void> BasicFilterSystem::filterCollectionChangedSignal() const
 
 void BasicFilterSystem::update()
 {
+	profiling::ScopedZone zone("Filter update");
+
 	// Update shaders first, so that nodes can judge whether they're hidden on basis of their texture
 	updateShaders();
 
@@ -78,7 +78,9 @@ bool XMLFilter::isEntityVisible(const FilterRule::Type type, const Entity& entit
 		{
 			std::regex ex(ruleIter->match);
 
-			if (std::regex_match(entity.getKeyValue(ruleIter->entityKey), ex))
+			auto value = entity.getKeyValueView(ruleIter->entityKey);
+
+			if (std::regex_match(value.begin(), value.end(), ex))
 			{
 				visible = ruleIter->show;
 			}
@@ -0,0 +1,76 @@
+#include "BackgroundMapSave.h"
+
+#include "itextstream.h"
+#include "time/StopWatch.h"
+#include "MapResource.h"
+
+namespace map
+{
+
+BackgroundMapSave::BackgroundMapSave(const MapSnapshot::Ptr& snapshot, const std::string& filename,
+    std::size_t pauseTime, std::size_t numCopiedNodes) :
+    _snapshot(snapshot),
+    _filename(filename),
+    _pauseTime(pauseTime),
+    _numCopiedNodes(numCopiedNodes)
+{
+    // Resolve the info file name on this thread, it needs the game configuration
+    fs::path infoFile = _filename;
+    infoFile.replace_extension(MapResource::GetInfoFileExtension());
+    _infoFilename = infoFile.string();
+
+    _result = std::async(std::launch::async, [this]() { writeFiles(); });
+}
+
+BackgroundMapSave::BackgroundMapSave(std::size_t pauseTime) :
+    _pauseTime(pauseTime),
+    _numCopiedNodes(0)
+{}
+
+BackgroundMapSave::~BackgroundMapSave()
+{
+    // The snapshot must not be destroyed while the worker is still using it
+    wait();
+}
+
+std::size_t BackgroundMapSave::getPauseTime() const
+{
+    return _pauseTime;
+}
+
+std::size_t BackgroundMapSave::getNumCopiedNodes() const
+{
+    return _numCopiedNodes;
+}
+
+bool BackgroundMapSave::isFinished() const
+{
+    return !_result.valid() || _result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void BackgroundMapSave::wait()
+{
+    if (_result.valid())
+    {
+        _result.wait();
+    }
+}
+
+void BackgroundMapSave::writeFiles()
+{
+    util::StopWatch stopwatch;
+
+    try
+    {
+        MapResource::saveSnapshot(*_snapshot, _filename, _infoFilename);
+
+        rMessage() << "Saved " << _snapshot->getEntityCount() << " entities to " << _filename <<
+            " in the background (" << stopwatch.getMilliSecondsPassed() << " msec)" << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        rError() << "Background save of " << _filename << " failed: " << ex.what() << std::endl;
+    }
+}
+
+}
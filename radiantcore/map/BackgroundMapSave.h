@@ -0,0 +1,48 @@
+#pragma once
+
+#include <future>
+#include "imap.h"
+#include "MapSnapshot.h"
+
+namespace map
+{
+
+/**
+ * Writes a map snapshot to disk on a worker thread.
+ * The destructor blocks until the files have been written.
+ */
+class BackgroundMapSave :
+    public IBackgroundMapSave
+{
+private:
+    MapSnapshot::Ptr _snapshot;
+
+    std::string _filename;
+    std::string _infoFilename;
+
+    std::size_t _pauseTime;
+    std::size_t _numCopiedNodes;
+
+    std::future<void> _result;
+
+public:
+    // Starts writing the given snapshot to the given file (and its info file)
+    BackgroundMapSave(const MapSnapshot::Ptr& snapshot, const std::string& filename,
+        std::size_t pauseTime, std::size_t numCopiedNodes);
+
+    // Represents a save which has already been performed on the calling thread
+    BackgroundMapSave(std::size_t pauseTime);
+
+    ~BackgroundMapSave();
+
+    std::size_t getPauseTime() const override;
+    std::size_t getNumCopiedNodes() const override;
+    bool isFinished() const override;
+    void wait() override;
+
+private:
+    // Invoked on the worker thread
+    void writeFiles();
+};
+
+}
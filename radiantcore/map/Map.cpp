@@ -23,6 +23,7 @@
 #include "igame.h"
 #include "imru.h"
 #include "imapformat.h"
+#include "iprofiler.h"
 
 #include "registry/registry.h"
 #include "entitylib.h"
@@ -30,13 +31,19 @@
 #include "os/path.h"
 #include "os/file.h"
 #include "time/ScopeTimer.h"
+#include "time/StopWatch.h"
 
 #include "brush/BrushModule.h"
+#include "brush/ChangedBrushSet.h"
 #include "scene/BasicRootNode.h"
 #include "scene/PrefabBoundsAccumulator.h"
+#include "scene/MemoryReport.h"
+#include "SurfaceShader.h"
+#include "util/BlockPool.h"
 #include "map/MapFileManager.h"
 #include "map/MapPositionManager.h"
 #include "map/MapResource.h"
+#include "map/BackgroundMapSave.h"
 #include "map/algorithm/Import.h"
 #include "map/algorithm/Export.h"
 #include "scene/Traverse.h"
@@ -111,6 +118,8 @@ void Map::loadMapResourceFromLocation(const MapLocation& location)
     // Abort any ongoing merge
     abortMergeOperation();
 
+    auto poolStatisticsBefore = util::getBlockPoolStatistics();
+
 	_resource = location.isArchive ?
         GlobalMapResourceManager().createFromArchiveFile(location.path, location.archiveRelativePath) :
         GlobalMapResourceManager().createFromPath(location.path);
@@ -135,19 +144,25 @@ void Map::loadMapResourceFromLocation(const MapLocation& location)
         clearMapResource();
     }
 
+    // Build the brush windings in parallel, before the scene graph evaluates them one by one
+    brush::ChangedBrushSet::PrepareWindings(_resource->getRootNode());
+
     // Take the new node and insert it as map root
     GlobalSceneGraph().setRoot(_resource->getRootNode());
 
 	// Traverse the scenegraph and find the worldspawn
 	findWorldspawn();
 
+    auto renderSystem = std::dynamic_pointer_cast<RenderSystem>(
+        module::GlobalModuleRegistry().getModule(MODULE_RENDERSYSTEM));
+
     // Associate the Scenegaph with the global RenderSystem
-    // This usually takes a while since all editor textures are loaded - display a dialog to inform the user
+    // Brush faces and patches defer their shader capture until they are rendered for the
+    // first time, but the entities and models might still load a few textures - display a dialog
     {
         radiant::ScopedLongRunningOperation blocker(_("Loading textures..."));
 
-        GlobalSceneGraph().root()->setRenderSystem(std::dynamic_pointer_cast<RenderSystem>(
-            module::GlobalModuleRegistry().getModule(MODULE_RENDERSYSTEM)));
+        GlobalSceneGraph().root()->setRenderSystem(renderSystem);
     }
 
     // Map loading finished, emit the signal
@@ -160,6 +175,16 @@ void Map::loadMapResourceFromLocation(const MapLocation& location)
     rMessage() << GlobalCounters().getCounter(counterPatches).get() << " patches\n";
     rMessage() << GlobalCounters().getCounter(counterEntities).get() << " entities\n";
 
+    auto poolStatistics = util::getBlockPoolStatistics();
+
+    rMessage() << (poolStatistics.allocations - poolStatisticsBefore.allocations) << " pooled allocations, "
+        << (poolStatistics.chunks - poolStatisticsBefore.chunks) << " new pool chunks\n";
+
+    if (renderSystem)
+    {
+        rMessage() << renderSystem->captureDeferredShaders(0) << " surfaces waiting for their shader\n";
+    }
+
     // Let the filtersystem update the filtered status of all instances
     GlobalFilterSystem().update();
 
@@ -396,6 +421,14 @@ void Map::freeMap()
     // Abort any ongoing merge
     abortMergeOperation();
 
+    // Let a running background save finish, and drop the snapshot data
+    _backgroundSave.reset();
+
+    if (_snapshotBuilder)
+    {
+        _snapshotBuilder->clear();
+    }
+
 	// Fire the map unloading event,
 	// This will de-select stuff, clear the pointfile, etc.
     emitMapEvent(MapUnloading);
@@ -636,6 +669,67 @@ void Map::saveDirect(const std::string& filename, const MapFormatPtr& mapFormat)
     _saveInProgress = false;
 }
 
+IBackgroundMapSave::Ptr Map::saveCopyInBackground(const std::string& absolutePath)
+{
+    if (_saveInProgress || (_backgroundSave && !_backgroundSave->isFinished()))
+    {
+        return IBackgroundMapSave::Ptr();
+    }
+
+    // Release the previous snapshot, this needs to happen on this thread
+    _backgroundSave.reset();
+
+    auto format = GlobalMapFormatManager().getMapFormatForFilename(absolutePath);
+    auto root = GlobalSceneGraph().root();
+
+    if (!format || !root)
+    {
+        rWarning() << "Map::saveCopyInBackground: cannot save " << absolutePath << std::endl;
+        return IBackgroundMapSave::Ptr();
+    }
+
+    // The undo system is initialised after this module, create the builder on demand
+    if (!_snapshotBuilder)
+    {
+        _snapshotBuilder.reset(new MapSnapshotBuilder);
+    }
+
+    util::StopWatch stopwatch;
+
+    MapSnapshot::Ptr snapshot;
+    _saveInProgress = true;
+
+    try
+    {
+        snapshot = _snapshotBuilder->capture(*format, root);
+    }
+    catch (const std::exception& ex)
+    {
+        rError() << "Failed to capture the map snapshot: " << ex.what() << std::endl;
+        _saveInProgress = false;
+        return IBackgroundMapSave::Ptr();
+    }
+
+    _saveInProgress = false;
+
+    if (!snapshot)
+    {
+        // This format can't be written from a snapshot, save it right away
+        saveDirect(absolutePath, format);
+
+        _backgroundSave = std::make_shared<BackgroundMapSave>(stopwatch.getMilliSecondsPassed());
+        return _backgroundSave;
+    }
+
+    rMessage() << "Captured map snapshot in " << stopwatch.getMilliSecondsPassed() << " msec, " <<
+        _snapshotBuilder->getNumClonedNodes() << " nodes copied" << std::endl;
+
+    _backgroundSave = std::make_shared<BackgroundMapSave>(snapshot, absolutePath,
+        stopwatch.getMilliSecondsPassed(), _snapshotBuilder->getNumClonedNodes());
+
+    return _backgroundSave;
+}
+
 void Map::saveSelected(const std::string& filename, const MapFormatPtr& mapFormat)
 {
     if (_saveInProgress) return; // safeguard
@@ -889,6 +983,7 @@ void Map::registerCommands()
     GlobalCommandSystem().addCommand(LOAD_PREFAB_AT_CMD, std::bind(&Map::loadPrefabAt, this, std::placeholders::_1), 
         { cmd::ARGTYPE_STRING, cmd::ARGTYPE_VECTOR3, cmd::ARGTYPE_INT|cmd::ARGTYPE_OPTIONAL, cmd::ARGTYPE_INT | cmd::ARGTYPE_OPTIONAL });
     GlobalCommandSystem().addCommand("SaveSelectedAsPrefab", Map::saveSelectedAsPrefab);
+    GlobalCommandSystem().addCommand("PrintMemoryReport", Map::printMemoryReport);
     GlobalCommandSystem().addCommand("SaveMap", std::bind(&Map::saveMapCmd, this, std::placeholders::_1));
     GlobalCommandSystem().addCommand("SaveMapAs", Map::saveMapAs);
     GlobalCommandSystem().addCommand("SaveMapCopyAs", Map::saveMapCopyAs, { cmd::ARGTYPE_STRING | cmd::ARGTYPE_OPTIONAL });
@@ -1067,6 +1162,25 @@ void Map::saveSelectedAsPrefab(const cmd::ArgumentList& args)
     }
 }
 
+void Map::printMemoryReport(const cmd::ArgumentList& args)
+{
+    scene::MemoryReport report(GlobalSceneGraph().root());
+
+    rMessage() << "Memory usage of the map primitives (approximate):" << std::endl;
+    rMessage() << report.toString();
+
+    const auto& materialNames = SurfaceShader::MaterialNames();
+
+    rMessage() << "Pooled material names: " << materialNames.size() << " (" <<
+        materialNames.getMemoryUsage() << " bytes)" << std::endl;
+
+    auto poolStatistics = util::getBlockPoolStatistics();
+
+    rMessage() << "Pooled objects: " << poolStatistics.liveBlocks << " live, " <<
+        poolStatistics.allocations << " allocated in total, " << poolStatistics.chunks << " chunks (" <<
+        poolStatistics.reservedBytes << " bytes)" << std::endl;
+}
+
 void Map::rename(const std::string& filename)
 {
     if (_mapName != filename)
@@ -1358,6 +1472,7 @@ const StringSet& Map::getDependencies() const
 		_dependencies.insert(MODULE_FILETYPES);
 		_dependencies.insert(MODULE_MAPRESOURCEMANAGER);
         _dependencies.insert(MODULE_COMMANDSYSTEM);
+        _dependencies.insert(MODULE_PROFILER);
     }
 
     return _dependencies;
@@ -1405,6 +1520,9 @@ void Map::shutdownModule()
 {
     abortMergeOperation();
 
+    _backgroundSave.reset();
+    _snapshotBuilder.reset();
+
     GlobalRadiantCore().getMessageBus().removeListener(_shutdownListener);
 
     _scaledModelExporter.shutdown();
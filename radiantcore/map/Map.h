@@ -20,6 +20,7 @@
 #include "time/StopWatch.h"
 #include "scene/merge/MergeOperation.h"
 #include "MergeActionNode.h"
+#include "MapSnapshot.h"
 
 class TextInputStream;
 
@@ -74,6 +75,10 @@ private:
     // Point trace for leak detection
     std::unique_ptr<PointFile> _pointTrace;
 
+    // Snapshots of the scene used by background saves, created on demand
+    std::unique_ptr<MapSnapshotBuilder> _snapshotBuilder;
+    std::shared_ptr<IBackgroundMapSave> _backgroundSave;
+
 private:
     std::string getSaveConfirmationText() const;
 
@@ -144,6 +149,8 @@ public:
      */
     void saveCopyAs(const std::string& absolutePath, const MapFormatPtr& mapFormat = MapFormatPtr());
 
+    IBackgroundMapSave::Ptr saveCopyInBackground(const std::string& absolutePath) override;
+
 	/** greebo: Saves the current selection to the target <filename>.
 	 */
 	void saveSelected(const std::string& filename, const MapFormatPtr& mapFormat = MapFormatPtr());
@@ -223,6 +230,9 @@ public:
 	 */
 	static void saveSelectedAsPrefab(const cmd::ArgumentList& args);
 
+	// Prints the approximate memory usage of the map's primitives to the console
+	static void printMemoryReport(const cmd::ArgumentList& args);
+
 private:
 	/**
 	 * greebo: Asks the user if the current changes should be saved.
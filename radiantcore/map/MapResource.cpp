@@ -11,6 +11,7 @@
 #include "ifilesystem.h"
 #include "iregistry.h"
 #include "imapinfofile.h"
+#include "iprofiler.h"
 
 #include "map/Map.h"
 #include "map/RootNode.h"
@@ -34,6 +35,7 @@
 #include "infofile/InfoFileExporter.h"
 #include "messages/MapFileOperation.h"
 #include "NodeCounter.h"
+#include "MapSnapshot.h"
 #include "MapResourceLoader.h"
 
 namespace map
@@ -97,6 +99,8 @@ std::string MapResource::getAbsoluteResourcePath()
 
 bool MapResource::load()
 {
+	profiling::ScopedZone zone("Map load");
+
 	if (!_mapRoot)
     {
 		// Map not loaded yet, acquire map root node from loader
@@ -413,6 +417,8 @@ void MapResource::throwIfNotWriteable(const fs::path& path)
 void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr& root,
 						   const GraphTraversalFunc& traverse, const std::string& filename)
 {
+	profiling::ScopedZone zone("Map save");
+
 	// Actual output file paths
 	fs::path outFile = filename;
 	fs::path auxFile = outFile;
@@ -496,4 +502,52 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 	}
 }
 
+void MapResource::saveSnapshot(MapSnapshot& snapshot, const std::string& filename, const std::string& infoFilename)
+{
+	profiling::ScopedZone zone("Map snapshot save");
+
+	fs::path outFile = filename;
+	fs::path auxFile = infoFilename;
+
+	throwIfNotWriteable(outFile);
+
+	if (snapshot.hasInfoFile())
+	{
+		throwIfNotWriteable(auxFile);
+	}
+
+	std::ofstream outFileStream(outFile.string());
+
+	if (!outFileStream.is_open())
+	{
+		throw OperationException(fmt::format(_("Could not open file for writing: {0}"), outFile.string()));
+	}
+
+	snapshot.writeMap(outFileStream);
+	outFileStream.flush();
+
+	if (outFileStream.fail())
+	{
+		throw OperationException(fmt::format(_("Failure writing to file {0}"), outFile.string()));
+	}
+
+	if (!snapshot.hasInfoFile()) return;
+
+	std::ofstream auxFileStream(auxFile.string());
+
+	if (!auxFileStream.is_open())
+	{
+		throw OperationException(fmt::format(_("Could not open file for writing: {0}"), auxFile.string()));
+	}
+
+	const auto& infoFileContents = snapshot.getInfoFileContents();
+	auxFileStream.write(infoFileContents.data(), infoFileContents.size());
+	auxFileStream.flush();
+
+	if (auxFileStream.fail())
+	{
+		throw OperationException(fmt::format(_("Failure writing to file {0}"), auxFile.string()));
+	}
+}
+
 } // namespace map
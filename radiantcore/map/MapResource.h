@@ -12,6 +12,8 @@
 namespace map
 {
 
+class MapSnapshot;
+
 class MapResource :
 	public IMapResource,
 	public util::Noncopyable
@@ -59,6 +61,14 @@ public:
 	static void saveFile(const MapFormat& format, const scene::IMapRootNodePtr& root,
 						 const GraphTraversalFunc& traverse, const std::string& filename);
 
+	// Write the given snapshot to the given files, this can be called from any thread.
+	// The info file is only written if the snapshot contains one.
+	// Throws an OperationException if anything prevents successful completion
+	static void saveSnapshot(MapSnapshot& snapshot, const std::string& filename, const std::string& infoFilename);
+
+    // Returns the extension of the auxiliary info file (including the leading dot character)
+    static std::string GetInfoFileExtension();
+
 protected:
     // Implementation-specific method to open the stream of the primary .map or .mapx file
     // May return an empty reference, may throw OperationException on failure
@@ -68,9 +78,6 @@ protected:
     // May return an empty reference, may throw OperationException on failure
     virtual stream::MapResourceStream::Ptr openInfofileStream();
 
-    // Returns the extension of the auxiliary info file (including the leading dot character)
-    static std::string GetInfoFileExtension();
-
     // Returns true if the file can be written to. Also returns true if the file
     // doesn't exist (assuming the file can always be created).
     static bool FileIsWriteable(const fs::path& path);
@@ -0,0 +1,520 @@
+#include "MapSnapshot.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <sstream>
+#include "iundo.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "ientity.h"
+#include "igroupnode.h"
+#include "imapresource.h"
+#include "itextstream.h"
+
+#include "scene/ChildPrimitives.h"
+#include "scene/Clone.h"
+#include "algorithm/MapExporter.h"
+#include "infofile/InfoFileExporter.h"
+
+namespace map
+{
+
+namespace
+{
+
+// Visits the children of a node, without descending any further
+class ChildNodeVisitor :
+    public scene::NodeVisitor
+{
+private:
+    std::function<void(const scene::INodePtr&)> _functor;
+
+public:
+    ChildNodeVisitor(const std::function<void(const scene::INodePtr&)>& functor) :
+        _functor(functor)
+    {}
+
+    bool pre(const scene::INodePtr& node) override
+    {
+        _functor(node);
+        return false;
+    }
+};
+
+void foreachChildNode(const scene::INodePtr& node, const std::function<void(const scene::INodePtr&)>& functor)
+{
+    ChildNodeVisitor visitor(functor);
+    node->traverseChildren(visitor);
+}
+
+bool isPrimitive(const scene::INodePtr& node)
+{
+    return std::dynamic_pointer_cast<IBrushNode>(node) || std::dynamic_pointer_cast<IPatchNode>(node);
+}
+
+// The export events are giving the subscribers a chance to prepare the scene
+// (e.g. to store the model scale in the spawnargs), like the MapExporter does
+class ScopedExportEvents
+{
+private:
+    scene::IMapRootNodePtr _root;
+
+public:
+    ScopedExportEvents(const scene::IMapRootNodePtr& root) :
+        _root(root)
+    {
+        GlobalMapResourceManager().signal_onResourceExporting().emit(_root);
+    }
+
+    ~ScopedExportEvents()
+    {
+        GlobalMapResourceManager().signal_onResourceExported().emit(_root);
+    }
+};
+
+}
+
+bool MapSnapshot::PrimitiveCopy::isExported() const
+{
+    return !brush || brush->getIBrush().hasContributingFaces();
+}
+
+MapSnapshot::MapSnapshot(const IMapWriterPtr& writer) :
+    _writer(writer),
+    _precision(6)
+{}
+
+void MapSnapshot::writeMap(std::ostream& stream)
+{
+    stream.precision(_precision);
+    stream.write(_header.data(), _header.size());
+
+    std::size_t entityNum = 0;
+
+    // Consecutive primitives without parent entity are written by a single job
+    EntityExportJob primitiveJob{ IEntityNodePtr(), 0 };
+
+    for (const auto& copy : _entities)
+    {
+        if (!copy->entity)
+        {
+            for (const auto& primitive : copy->primitives)
+            {
+                if (!primitive.isExported()) continue;
+
+                primitiveJob.entityNum = entityNum;
+                primitiveJob.primitives.emplace_back(primitive.brush, primitive.patch);
+            }
+
+            continue;
+        }
+
+        writeExportJob(primitiveJob, stream);
+
+        EntityExportJob job{ copy->entity, entityNum++ };
+
+        for (const auto& primitive : copy->primitives)
+        {
+            if (primitive.isExported())
+            {
+                job.primitives.emplace_back(primitive.brush, primitive.patch);
+            }
+        }
+
+        writeExportJob(job, stream);
+    }
+
+    writeExportJob(primitiveJob, stream);
+
+    stream.write(_footer.data(), _footer.size());
+}
+
+void MapSnapshot::writeExportJob(EntityExportJob& job, std::ostream& stream)
+{
+    if (job.getNodeCount() == 0) return;
+
+    job.serialise(*_writer, _precision);
+
+    for (const auto& error : job.errors)
+    {
+        rError() << "Failure exporting a node: " << error << std::endl;
+    }
+
+    stream.write(job.output.data(), job.output.size());
+
+    job = EntityExportJob{ IEntityNodePtr(), 0 };
+}
+
+bool MapSnapshot::hasInfoFile() const
+{
+    return !_infoFileContents.empty();
+}
+
+const std::string& MapSnapshot::getInfoFileContents() const
+{
+    return _infoFileContents;
+}
+
+std::size_t MapSnapshot::getEntityCount() const
+{
+    return std::count_if(_entities.begin(), _entities.end(), [](const std::shared_ptr<const EntityCopy>& copy)
+    {
+        return copy->entity != nullptr;
+    });
+}
+
+MapSnapshotBuilder::MapSnapshotBuilder() :
+    _entitiesValid(false),
+    _clonedNodes(0)
+{
+    // Changes applied by undo and redo are not reported as node changes
+    _postUndoConn = GlobalUndoSystem().signal_postUndo().connect(sigc::mem_fun(this, &MapSnapshotBuilder::clear));
+    _postRedoConn = GlobalUndoSystem().signal_postRedo().connect(sigc::mem_fun(this, &MapSnapshotBuilder::clear));
+}
+
+MapSnapshotBuilder::~MapSnapshotBuilder()
+{
+    _nodeChangedConn.disconnect();
+    _postUndoConn.disconnect();
+    _postRedoConn.disconnect();
+}
+
+MapSnapshot::Ptr MapSnapshotBuilder::capture(const MapFormat& format, const scene::IMapRootNodePtr& root)
+{
+    auto writer = format.getMapWriter();
+
+    if (!writer || !writer->createEntityWriter(0))
+    {
+        return MapSnapshot::Ptr();
+    }
+
+    if (_root.lock() != root)
+    {
+        clear();
+
+        _root = root;
+        _nodeChangedConn.disconnect();
+        _nodeChangedConn = root->signal_nodeChanged().connect(sigc::mem_fun(this, &MapSnapshotBuilder::onNodeChanged));
+    }
+
+    auto snapshot = std::make_shared<MapSnapshot>(writer);
+    snapshot->_precision = MapExporter::GetFloatPrecision();
+
+    _clonedNodes = 0;
+
+    ScopedExportEvents exportEvents(root);
+
+    updateEntities(root);
+
+    snapshot->_entities.assign(_entities.begin(), _entities.end());
+
+    std::ostringstream headerStream;
+    std::ostringstream footerStream;
+    headerStream.precision(snapshot->_precision);
+    footerStream.precision(snapshot->_precision);
+
+    try
+    {
+        writer->beginWriteMap(root, headerStream);
+        writer->endWriteMap(root, footerStream);
+    }
+    catch (IMapWriter::FailureException& ex)
+    {
+        rError() << "Failure exporting the map: " << ex.what() << std::endl;
+    }
+
+    snapshot->_header = headerStream.str();
+    snapshot->_footer = footerStream.str();
+
+    if (format.allowInfoFileCreation())
+    {
+        std::ostringstream infoFileStream;
+        writeInfoFile(root, infoFileStream);
+
+        snapshot->_infoFileContents = infoFileStream.str();
+    }
+
+    return snapshot;
+}
+
+std::size_t MapSnapshotBuilder::getNumClonedNodes() const
+{
+    return _clonedNodes;
+}
+
+void MapSnapshotBuilder::clear()
+{
+    _entities.clear();
+    _entityIndices.clear();
+    _changedNodes.clear();
+    _entitiesValid = false;
+}
+
+void MapSnapshotBuilder::onNodeChanged(const scene::INodePtr& node)
+{
+    if (_entitiesValid)
+    {
+        // A previously changed node might have been replaced by a new one at the same address
+        _changedNodes[node.get()] = node;
+    }
+}
+
+void MapSnapshotBuilder::updateEntities(const scene::IMapRootNodePtr& root)
+{
+    // Sort the changed nodes by the child of the root they belong to
+    bool childrenChanged = !_entitiesValid;
+    std::set<const scene::INode*> changedEntities;
+    std::set<const scene::INode*> changedPrimitives;
+    std::map<const scene::INode*, std::vector<scene::INodePtr>> changedPrimitivesByEntity;
+
+    for (const auto& pair : _changedNodes)
+    {
+        auto node = pair.second.lock();
+
+        if (node && node == root)
+        {
+            childrenChanged = true;
+            continue;
+        }
+
+        // Removed nodes are covered by the change of their former parent
+        if (!node || !node->inScene()) continue;
+
+        auto child = node;
+        auto parent = node->getParent();
+
+        while (parent && parent != root)
+        {
+            child = parent;
+            parent = parent->getParent();
+        }
+
+        auto index = _entityIndices.find(child.get());
+
+        if (!parent || index == _entityIndices.end())
+        {
+            continue; // not part of this map or added to it, which changes the parent
+        }
+
+        if (node->getParent() == child && _entities[index->second]->primitiveIndices.count(node.get()) > 0)
+        {
+            changedPrimitives.insert(node.get());
+            changedPrimitivesByEntity[child.get()].push_back(node);
+        }
+        else
+        {
+            changedEntities.insert(child.get());
+        }
+    }
+
+    _changedNodes.clear();
+
+    if (childrenChanged)
+    {
+        std::vector<EntityCopyPtr> entities;
+        std::unordered_map<const scene::INode*, std::size_t> entityIndices;
+
+        foreachChildNode(root, [&](const scene::INodePtr& child)
+        {
+            auto existing = _entityIndices.find(child.get());
+            EntityCopyPtr previous;
+
+            if (existing != _entityIndices.end() && _entities[existing->second]->original.lock() == child)
+            {
+                previous = _entities[existing->second];
+            }
+
+            entityIndices.emplace(child.get(), entities.size());
+
+            if (previous && changedEntities.count(child.get()) == 0)
+            {
+                entities.emplace_back(previous);
+            }
+            else
+            {
+                entities.emplace_back(copyEntity(child, previous, changedPrimitives));
+                changedEntities.insert(child.get());
+            }
+        });
+
+        _entities.swap(entities);
+        _entityIndices.swap(entityIndices);
+        _entitiesValid = true;
+    }
+    else
+    {
+        for (const auto* changed : changedEntities)
+        {
+            auto& entity = _entities[_entityIndices[changed]];
+            entity = copyEntity(entity->original.lock(), entity, changedPrimitives);
+        }
+    }
+
+    // Copy the changed primitives of the entities which have not been copied as a whole
+    for (const auto& pair : changedPrimitivesByEntity)
+    {
+        if (changedEntities.count(pair.first) > 0) continue;
+
+        auto& entity = _entities[_entityIndices[pair.first]];
+
+        // The snapshots are sharing the copies, they must not be changed after being handed out
+        if (entity.use_count() > 1)
+        {
+            entity = std::make_shared<MapSnapshot::EntityCopy>(*entity);
+        }
+
+        for (const auto& primitive : pair.second)
+        {
+            entity->primitives[entity->primitiveIndices[primitive.get()]] = copyPrimitive(primitive);
+        }
+    }
+}
+
+MapSnapshotBuilder::EntityCopyPtr MapSnapshotBuilder::copyEntity(const scene::INodePtr& node,
+    const EntityCopyPtr& previous, const std::set<const scene::INode*>& changedPrimitives)
+{
+    auto copy = std::make_shared<MapSnapshot::EntityCopy>();
+    copy->original = node;
+
+    auto entity = std::dynamic_pointer_cast<IEntityNode>(node);
+
+    if (!entity)
+    {
+        // A primitive without parent entity
+        if (isPrimitive(node))
+        {
+            copy->primitives.emplace_back(copyPrimitive(node));
+        }
+
+        return copy;
+    }
+
+    if (Node_getGroupNode(node) && !entity->getEntity().isWorldspawn())
+    {
+        copyGroupEntity(node, *copy);
+        return copy;
+    }
+
+    copy->entity = std::dynamic_pointer_cast<IEntityNode>(scene::cloneSingleNode(node));
+    ++_clonedNodes;
+
+    foreachChildNode(node, [&](const scene::INodePtr& child)
+    {
+        if (!isPrimitive(child)) return;
+
+        copy->primitiveIndices.emplace(child.get(), copy->primitives.size());
+
+        // Re-use the unchanged primitives of the previous copy
+        if (previous && changedPrimitives.count(child.get()) == 0)
+        {
+            auto existing = previous->primitiveIndices.find(child.get());
+
+            if (existing != previous->primitiveIndices.end() &&
+                previous->primitives[existing->second].original.lock() == child)
+            {
+                copy->primitives.emplace_back(previous->primitives[existing->second]);
+                return;
+            }
+        }
+
+        copy->primitives.emplace_back(copyPrimitive(child));
+    });
+
+    return copy;
+}
+
+void MapSnapshotBuilder::copyGroupEntity(const scene::INodePtr& node, MapSnapshot::EntityCopy& copy)
+{
+    // The primitives of func_* entities are written relative to the entity origin. The
+    // entity is copied as a whole such that its copied primitives can be moved like the
+    // MapExporter moves the originals, whenever the entity (e.g. its origin) or any of
+    // its children changes, all of them are copied again.
+    auto clone = scene::cloneNodeIncludingDescendants(node, [&](const scene::INodePtr& original, const scene::INodePtr& cloned)
+    {
+        ++_clonedNodes;
+
+        if (original->getParent() != node || !isPrimitive(cloned)) return;
+
+        copy.primitives.emplace_back(MapSnapshot::PrimitiveCopy{ original,
+            std::dynamic_pointer_cast<IBrushNode>(cloned), std::dynamic_pointer_cast<IPatchNode>(cloned) });
+    });
+
+    scene::removeOriginFromChildPrimitives(clone);
+
+    copy.entity = std::dynamic_pointer_cast<IEntityNode>(clone);
+
+    // The windings are needed to determine the contributing faces
+    for (const auto& primitive : copy.primitives)
+    {
+        if (primitive.brush)
+        {
+            primitive.brush->getIBrush().evaluateBRep();
+        }
+    }
+}
+
+MapSnapshot::PrimitiveCopy MapSnapshotBuilder::copyPrimitive(const scene::INodePtr& node)
+{
+    auto clone = scene::cloneSingleNode(node);
+
+    if (!clone)
+    {
+        throw std::logic_error("Cannot take a snapshot of non-cloneable nodes");
+    }
+
+    ++_clonedNodes;
+
+    auto brush = std::dynamic_pointer_cast<IBrushNode>(clone);
+
+    // The windings are needed to determine the contributing faces
+    if (brush)
+    {
+        brush->getIBrush().evaluateBRep();
+    }
+
+    return MapSnapshot::PrimitiveCopy{ node, brush, std::dynamic_pointer_cast<IPatchNode>(clone) };
+}
+
+void MapSnapshotBuilder::writeInfoFile(const scene::IMapRootNodePtr& root, std::ostream& stream)
+{
+    InfoFileExporter exporter(stream);
+
+    exporter.beginSaveMap(root);
+
+    // Same numbering as used by the MapExporter
+    std::size_t entityNum = 0;
+    std::size_t primitiveNum = 0;
+
+    for (const auto& copy : _entities)
+    {
+        if (copy->entity)
+        {
+            if (auto entity = copy->original.lock())
+            {
+                exporter.visitEntity(entity, entityNum);
+            }
+        }
+
+        for (const auto& primitive : copy->primitives)
+        {
+            if (!primitive.isExported()) continue;
+
+            if (auto node = primitive.original.lock())
+            {
+                exporter.visitPrimitive(node, entityNum, primitiveNum);
+            }
+
+            ++primitiveNum;
+        }
+
+        if (copy->entity)
+        {
+            ++entityNum;
+        }
+    }
+
+    exporter.finishSaveMap(root);
+}
+
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sigc++/connection.h>
+
+#include "inode.h"
+#include "imap.h"
+#include "imapformat.h"
+#include "algorithm/EntityExportJob.h"
+
+namespace map
+{
+
+/**
+ * Immutable copy of the map contents, ready to be written on any thread.
+ *
+ * The entities and primitives are detached clones of the scene nodes,
+ * in the state they are exported in (i.e. the child primitives of func_*
+ * entities are moved relative to the entity origin). The info file is
+ * serialised while capturing, since the info file modules need to access
+ * the live scene.
+ *
+ * A snapshot should be destroyed on the thread it has been captured on.
+ */
+class MapSnapshot
+{
+private:
+    struct PrimitiveCopy
+    {
+        std::weak_ptr<scene::INode> original;
+
+        // Either of the two pointers is set
+        IBrushNodePtr brush;
+        IPatchNodePtr patch;
+
+        // Brushes without contributing faces are not written
+        bool isExported() const;
+    };
+
+    // Copy of a child node of the map root, i.e. an entity with
+    // its primitives or a primitive without parent entity
+    struct EntityCopy
+    {
+        std::weak_ptr<scene::INode> original;
+
+        // Is empty for primitives without parent entity
+        IEntityNodePtr entity;
+
+        // The primitives in scene order
+        std::vector<PrimitiveCopy> primitives;
+
+        // Position of the primitives in the above list, for entities whose
+        // primitives can be copied one by one (not set for func_* entities)
+        std::unordered_map<const scene::INode*, std::size_t> primitiveIndices;
+    };
+
+    IMapWriterPtr _writer;
+    std::streamsize _precision;
+
+    // Output of the writer's beginWriteMap() and endWriteMap()
+    std::string _header;
+    std::string _footer;
+
+    // Shared with the MapSnapshotBuilder, which doesn't change them anymore
+    std::vector<std::shared_ptr<const EntityCopy>> _entities;
+
+    // Is empty if the format doesn't create info files
+    std::string _infoFileContents;
+
+    friend class MapSnapshotBuilder;
+
+public:
+    using Ptr = std::shared_ptr<MapSnapshot>;
+
+    MapSnapshot(const IMapWriterPtr& writer);
+
+    // Serialises the map to the given stream. Writer failures are logged.
+    void writeMap(std::ostream& stream);
+
+    bool hasInfoFile() const;
+    const std::string& getInfoFileContents() const;
+
+    std::size_t getEntityCount() const;
+
+private:
+    void writeExportJob(EntityExportJob& job, std::ostream& stream);
+};
+
+/**
+ * Captures snapshots of a map. The copies of the scene nodes are kept and
+ * re-used by the next capture, only the nodes reported through the root's
+ * signal_nodeChanged() since the last capture are visited and copied again.
+ *
+ * Spawnarg changes are reported whether they are undoable or not. Undo and
+ * redo discard all copies, the next capture is copying the whole map then.
+ * The map header and the info file are written from the live map root on
+ * every capture, which covers the root's key values.
+ */
+class MapSnapshotBuilder
+{
+private:
+    using EntityCopyPtr = std::shared_ptr<MapSnapshot::EntityCopy>;
+
+    std::weak_ptr<scene::IMapRootNode> _root;
+
+    // The copies of the root's children in scene order, and their position
+    std::vector<EntityCopyPtr> _entities;
+    std::unordered_map<const scene::INode*, std::size_t> _entityIndices;
+
+    // False if the whole map needs to be copied by the next capture
+    bool _entitiesValid;
+
+    // The nodes changed since the last capture
+    std::unordered_map<const scene::INode*, std::weak_ptr<scene::INode>> _changedNodes;
+
+    std::size_t _clonedNodes;
+
+    sigc::connection _nodeChangedConn;
+    sigc::connection _postUndoConn;
+    sigc::connection _postRedoConn;
+
+public:
+    MapSnapshotBuilder();
+    ~MapSnapshotBuilder();
+
+    // Takes a snapshot of the given map, to be written in the given format.
+    // Returns an empty reference if the format's writer doesn't support entity writers.
+    MapSnapshot::Ptr capture(const MapFormat& format, const scene::IMapRootNodePtr& root);
+
+    // The number of nodes which had to be copied during the last capture
+    std::size_t getNumClonedNodes() const;
+
+    // Removes all copies, the next capture will copy the whole map
+    void clear();
+
+private:
+    void onNodeChanged(const scene::INodePtr& node);
+
+    // Brings the entity copies up to date with the scene
+    void updateEntities(const scene::IMapRootNodePtr& root);
+
+    // Copies the given child of the root. The unchanged primitives of the previous copy are re-used.
+    EntityCopyPtr copyEntity(const scene::INodePtr& node, const EntityCopyPtr& previous,
+        const std::set<const scene::INode*>& changedPrimitives);
+
+    // Copies an entity with all its descendants, moving the primitives relative to the entity origin
+    void copyGroupEntity(const scene::INodePtr& node, MapSnapshot::EntityCopy& copy);
+
+    MapSnapshot::PrimitiveCopy copyPrimitive(const scene::INodePtr& node);
+
+    // Writes the info file by passing the copied nodes to the info file modules
+    void writeInfoFile(const scene::IMapRootNodePtr& root, std::ostream& stream);
+};
+
+}
@@ -68,6 +68,16 @@ scene::ILayerManager& RootNode::getLayerManager()
 	return *_layerManager;
 }
 
+scene::IMaterialUsageIndex& RootNode::getMaterialUsageIndex()
+{
+	return _materialUsageIndex;
+}
+
+sigc::signal<void, const scene::INodePtr&>& RootNode::signal_nodeChanged()
+{
+    return _sigNodeChanged;
+}
+
 std::string RootNode::name() const 
 {
 	return _name;
@@ -105,14 +115,14 @@ void RootNode::onInsertIntoScene(IMapRootNode& root)
 
     // A RootNode supports child entities, so connect
     // the Node's TraversableNodeSet to the UndoSystem
-    Node::connectUndoSystem(root.getUndoChangeTracker());
+    Node::connectUndoSystem(getChangeTracker(root));
 }
 
 void RootNode::onRemoveFromScene(IMapRootNode& root)
 {
     // A RootNode supports child entities, so disconnect
     // the Node's TraversableNodeSet to the UndoSystem
-    Node::disconnectUndoSystem(root.getUndoChangeTracker());
+    Node::disconnectUndoSystem(getChangeTracker(root));
 
 	Node::onRemoveFromScene(root);
 }
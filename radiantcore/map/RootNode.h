@@ -7,6 +7,7 @@
 #include "iselectiongroup.h"
 #include "iselectionset.h"
 #include "scene/Node.h"
+#include "scene/MaterialUsageIndex.h"
 #include "UndoFileChangeTracker.h"
 #include "transformlib.h"
 #include "KeyValueStore.h"
@@ -46,6 +47,10 @@ private:
 
     scene::ILayerManager::Ptr _layerManager;
 
+    scene::MaterialUsageIndex _materialUsageIndex;
+
+    sigc::signal<void, const scene::INodePtr&> _sigNodeChanged;
+
 	AABB _emptyAABB;
 
 public:
@@ -62,6 +67,8 @@ public:
     selection::ISelectionGroupManager& getSelectionGroupManager() override;
     selection::ISelectionSetManager& getSelectionSetManager() override;
     scene::ILayerManager& getLayerManager() override;
+    scene::IMaterialUsageIndex& getMaterialUsageIndex() override;
+    sigc::signal<void, const scene::INodePtr&>& signal_nodeChanged() override;
 
 	// Renderable implementation (empty)
 	void renderSolid(RenderableCollector& collector, const VolumeTest& volume) const override
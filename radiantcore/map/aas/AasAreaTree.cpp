@@ -0,0 +1,227 @@
+#include "AasAreaTree.h"
+
+#include <algorithm>
+#include <limits>
+#include "ivolumetest.h"
+#include "math/Ray.h"
+
+namespace map
+{
+
+void AasAreaTree::build(std::vector<AABB> areaBounds)
+{
+    clear();
+
+    _areaBounds = std::move(areaBounds);
+
+    std::vector<int> areaNums;
+    areaNums.reserve(_areaBounds.size());
+
+    for (std::size_t i = 0; i < _areaBounds.size(); ++i)
+    {
+        if (_areaBounds[i].isValid())
+        {
+            areaNums.push_back(static_cast<int>(i));
+        }
+    }
+
+    if (areaNums.empty()) return;
+
+    // Rough estimate, the tree has about twice as many nodes as leaves
+    _nodes.reserve(2 * (areaNums.size() / MaxAreasPerLeaf + 1));
+    _areaNums.reserve(areaNums.size());
+
+    _nodes.emplace_back();
+    buildNode(0, areaNums, 0, areaNums.size());
+}
+
+void AasAreaTree::clear()
+{
+    _nodes.clear();
+    _areaNums.clear();
+    _areaBounds.clear();
+}
+
+void AasAreaTree::buildNode(std::size_t nodeIndex, std::vector<int>& areaNums, std::size_t begin, std::size_t end)
+{
+    AABB bounds;
+    AABB centres;
+
+    for (auto i = begin; i < end; ++i)
+    {
+        const auto& areaBounds = _areaBounds[areaNums[i]];
+        bounds.includeAABB(areaBounds);
+        centres.includePoint(areaBounds.getOrigin());
+    }
+
+    _nodes[nodeIndex].bounds = bounds;
+
+    if (end - begin <= MaxAreasPerLeaf)
+    {
+        _nodes[nodeIndex].first = static_cast<int>(_areaNums.size());
+        _nodes[nodeIndex].numAreas = static_cast<int>(end - begin);
+        _areaNums.insert(_areaNums.end(), areaNums.begin() + begin, areaNums.begin() + end);
+        return;
+    }
+
+    // Split at the median along the axis the area centres are spread out the most
+    const auto& extents = centres.getExtents();
+    int axis = extents.x() >= extents.y() ? (extents.x() >= extents.z() ? 0 : 2) : (extents.y() >= extents.z() ? 1 : 2);
+
+    auto middle = begin + (end - begin) / 2;
+
+    std::nth_element(areaNums.begin() + begin, areaNums.begin() + middle, areaNums.begin() + end, [&](int a, int b)
+    {
+        return _areaBounds[a].getOrigin()[axis] < _areaBounds[b].getOrigin()[axis];
+    });
+
+    // Allocate the two children next to each other, then fill them
+    auto firstChild = _nodes.size();
+    _nodes.emplace_back();
+    _nodes.emplace_back();
+
+    _nodes[nodeIndex].first = static_cast<int>(firstChild);
+    _nodes[nodeIndex].numAreas = 0;
+
+    buildNode(firstChild, areaNums, begin, middle);
+    buildNode(firstChild + 1, areaNums, middle, end);
+}
+
+void AasAreaTree::visitAllAreas(const Node& node, const std::function<void(int)>& functor) const
+{
+    if (node.numAreas > 0)
+    {
+        for (int i = 0; i < node.numAreas; ++i)
+        {
+            functor(_areaNums[node.first + i]);
+        }
+        return;
+    }
+
+    visitAllAreas(_nodes[node.first], functor);
+    visitAllAreas(_nodes[node.first + 1], functor);
+}
+
+void AasAreaTree::forEachAreaInVolume(const VolumeTest& volume, const std::function<void(int)>& functor) const
+{
+    if (_nodes.empty()) return;
+
+    std::vector<const Node*> stack(1, &_nodes.front());
+
+    while (!stack.empty())
+    {
+        const auto* node = stack.back();
+        stack.pop_back();
+
+        auto intersection = volume.TestAABB(node->bounds);
+
+        if (intersection == VOLUME_OUTSIDE) continue;
+
+        // Everything below a node fully inside the volume is visible
+        if (intersection == VOLUME_INSIDE)
+        {
+            visitAllAreas(*node, functor);
+            continue;
+        }
+
+        if (node->numAreas > 0)
+        {
+            for (int i = 0; i < node->numAreas; ++i)
+            {
+                auto areaNum = _areaNums[node->first + i];
+
+                if (volume.TestAABB(_areaBounds[areaNum]) != VOLUME_OUTSIDE)
+                {
+                    functor(areaNum);
+                }
+            }
+            continue;
+        }
+
+        stack.push_back(&_nodes[node->first]);
+        stack.push_back(&_nodes[node->first + 1]);
+    }
+}
+
+void AasAreaTree::forEachAreaContainingPoint(const Vector3& point, const std::function<void(int)>& functor) const
+{
+    if (_nodes.empty()) return;
+
+    std::vector<const Node*> stack(1, &_nodes.front());
+
+    while (!stack.empty())
+    {
+        const auto* node = stack.back();
+        stack.pop_back();
+
+        if (!node->bounds.intersects(point)) continue;
+
+        if (node->numAreas > 0)
+        {
+            for (int i = 0; i < node->numAreas; ++i)
+            {
+                auto areaNum = _areaNums[node->first + i];
+
+                if (_areaBounds[areaNum].intersects(point))
+                {
+                    functor(areaNum);
+                }
+            }
+            continue;
+        }
+
+        stack.push_back(&_nodes[node->first]);
+        stack.push_back(&_nodes[node->first + 1]);
+    }
+}
+
+int AasAreaTree::findFirstAreaHitByRay(const Ray& ray) const
+{
+    if (_nodes.empty()) return -1;
+
+    int bestArea = -1;
+    auto bestDistance = std::numeric_limits<Vector3::ElementType>::max();
+
+    std::vector<const Node*> stack(1, &_nodes.front());
+    Vector3 intersection;
+
+    while (!stack.empty())
+    {
+        const auto* node = stack.back();
+        stack.pop_back();
+
+        // Skip nodes that are not hit or only behind the best hit so far
+        if (!ray.intersectAABB(node->bounds, intersection) ||
+            (intersection - ray.origin).getLengthSquared() > bestDistance)
+        {
+            continue;
+        }
+
+        if (node->numAreas > 0)
+        {
+            for (int i = 0; i < node->numAreas; ++i)
+            {
+                auto areaNum = _areaNums[node->first + i];
+
+                if (ray.intersectAABB(_areaBounds[areaNum], intersection))
+                {
+                    auto distance = (intersection - ray.origin).getLengthSquared();
+
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        bestArea = areaNum;
+                    }
+                }
+            }
+            continue;
+        }
+
+        stack.push_back(&_nodes[node->first]);
+        stack.push_back(&_nodes[node->first + 1]);
+    }
+
+    return bestArea;
+}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include "math/AABB.h"
+
+class Ray;
+class VolumeTest;
+
+namespace map
+{
+
+/**
+ * Bounding volume hierarchy over the area bounds of an AAS file.
+ *
+ * The nodes are stored in a flat array, the children of an inner node are
+ * stored next to each other. Leaf nodes refer to a range of area numbers.
+ */
+class AasAreaTree
+{
+private:
+    struct Node
+    {
+        AABB bounds;
+
+        // Inner nodes: index of the first of the two children
+        // Leaf nodes: index of the first area number in _areaNums
+        int first;
+
+        // Number of areas in this leaf, 0 for inner nodes
+        int numAreas;
+    };
+
+    std::vector<Node> _nodes;
+    std::vector<int> _areaNums;
+
+    // The bounds of every area, indexed by area number
+    std::vector<AABB> _areaBounds;
+
+public:
+    static constexpr std::size_t MaxAreasPerLeaf = 4;
+
+    // Rebuild the tree from the given area bounds (indexed by area number).
+    // Areas with invalid bounds are not added to the tree.
+    void build(std::vector<AABB> areaBounds);
+
+    void clear();
+
+    // Invokes the functor for each area whose bounds are (partially) inside the given volume
+    void forEachAreaInVolume(const VolumeTest& volume, const std::function<void(int)>& functor) const;
+
+    // Invokes the functor for each area whose bounds contain the given point
+    void forEachAreaContainingPoint(const Vector3& point, const std::function<void(int)>& functor) const;
+
+    // Returns the area whose bounds are hit first by the given ray, or -1 if there is none
+    int findFirstAreaHitByRay(const Ray& ray) const;
+
+private:
+    void buildNode(std::size_t nodeIndex, std::vector<int>& areaNums, std::size_t begin, std::size_t end);
+    void visitAllAreas(const Node& node, const std::function<void(int)>& functor) const;
+};
+
+}
@@ -5,8 +5,13 @@
 #include "iarchive.h"
 #include "ieclass.h"
 #include "ifilesystem.h"
+#include "iregistry.h"
 #include "eclass.h"
 
+#include <fstream>
+#include "os/fs.h"
+#include "registry/registry.h"
+#include "stream/utils.h"
 #include "module/StaticModule.h"
 
 namespace map
@@ -15,6 +20,64 @@ namespace map
 namespace
 {
     const char* const AAS_TYPES_ENTITYDEF = "aas_types";
+    const char* const RKEY_USE_AAS_BINARY_CACHE = "user/ui/aasViewer/useBinaryCache";
+
+    // Binary caches are stored next to the AAS file, using this suffix
+    const char* const AAS_CACHE_SUFFIX = ".cache";
+    const char AAS_CACHE_MAGIC[8] = { 'D', 'R', 'A', 'A', 'S', 'B', 'I', 'N' };
+    const std::uint32_t AAS_CACHE_VERSION = 1;
+
+    bool getSourceStamp(const std::string& path, AasSourceStamp& stamp)
+    {
+        try
+        {
+            stamp.size = static_cast<std::uint64_t>(fs::file_size(path));
+#ifdef DR_USE_STD_FILESYSTEM
+            stamp.modificationTime = static_cast<std::int64_t>(fs::last_write_time(path).time_since_epoch().count());
+#else
+            stamp.modificationTime = static_cast<std::int64_t>(fs::last_write_time(path));
+#endif
+            return true;
+        }
+        catch (fs::filesystem_error&)
+        {
+            return false;
+        }
+    }
+
+    void writeCacheHeader(std::ostream& stream, const AasSourceStamp& stamp, const std::string& formatName)
+    {
+        stream.write(AAS_CACHE_MAGIC, sizeof(AAS_CACHE_MAGIC));
+        stream::writeLittleEndian<std::uint32_t>(stream, AAS_CACHE_VERSION);
+        stream::writeLittleEndian<std::uint64_t>(stream, stamp.size);
+        stream::writeLittleEndian<std::int64_t>(stream, stamp.modificationTime);
+        stream::writeLittleEndian<std::uint32_t>(stream, static_cast<std::uint32_t>(formatName.size()));
+        stream.write(formatName.data(), formatName.size());
+    }
+
+    // Returns true if the header matches the given source stamp, the format name is returned
+    bool readCacheHeader(std::istream& stream, const AasSourceStamp& expectedStamp, std::string& formatName)
+    {
+        char magic[sizeof(AAS_CACHE_MAGIC)];
+        stream.read(magic, sizeof(magic));
+
+        if (!stream || !std::equal(magic, magic + sizeof(magic), AAS_CACHE_MAGIC)) return false;
+
+        if (stream::readLittleEndian<std::uint32_t>(stream) != AAS_CACHE_VERSION) return false;
+
+        AasSourceStamp stamp;
+        stamp.size = stream::readLittleEndian<std::uint64_t>(stream);
+        stamp.modificationTime = stream::readLittleEndian<std::int64_t>(stream);
+
+        auto nameLength = stream::readLittleEndian<std::uint32_t>(stream);
+
+        if (!stream || !(stamp == expectedStamp) || nameLength > 256) return false;
+
+        formatName.resize(nameLength);
+        stream.read(&formatName[0], nameLength);
+
+        return static_cast<bool>(stream);
+    }
 }
 
 AasFileManager::AasFileManager() :
@@ -136,6 +199,92 @@ std::list<AasFileInfo> AasFileManager::getAasFilesForMap(const std::string& mapP
     return list;
 }
 
+IAasFilePtr AasFileManager::loadAasFile(const AasFileInfo& info)
+{
+    bool useCache = registry::getValue<bool>(RKEY_USE_AAS_BINARY_CACHE);
+    std::string cachePath = info.absolutePath + AAS_CACHE_SUFFIX;
+
+    AasSourceStamp stamp;
+    useCache = useCache && getSourceStamp(info.absolutePath, stamp);
+
+    if (useCache)
+    {
+        auto aasFile = loadFromCache(cachePath, stamp);
+
+        if (aasFile) return aasFile;
+    }
+
+    ArchiveTextFilePtr file = GlobalFileSystem().openTextFileInAbsolutePath(info.absolutePath);
+
+    if (!file) return IAasFilePtr();
+
+    std::istream stream(&file->getInputStream());
+    IAasFileLoaderPtr loader = getLoaderForStream(stream);
+
+    if (!loader || !loader->canLoad(stream)) return IAasFilePtr();
+
+    stream.seekg(0, std::ios_base::beg);
+
+    IAasFilePtr aasFile = loader->loadFromStream(stream);
+
+    if (aasFile && useCache)
+    {
+        writeCache(cachePath, stamp, *loader, *aasFile);
+    }
+
+    return aasFile;
+}
+
+IAasFilePtr AasFileManager::loadFromCache(const std::string& cachePath, const AasSourceStamp& stamp)
+{
+    std::ifstream cache(cachePath, std::ios::binary);
+
+    if (!cache) return IAasFilePtr();
+
+    std::string formatName;
+
+    if (!readCacheHeader(cache, stamp, formatName)) return IAasFilePtr();
+
+    for (const IAasFileLoaderPtr& loader : _loaders)
+    {
+        if (loader->getAasFormatName() == formatName)
+        {
+            return loader->loadFromBinaryCache(cache);
+        }
+    }
+
+    return IAasFilePtr();
+}
+
+void AasFileManager::writeCache(const std::string& cachePath, const AasSourceStamp& stamp,
+    IAasFileLoader& loader, const IAasFile& aasFile)
+{
+    std::ofstream cache(cachePath, std::ios::binary | std::ios::trunc);
+
+    if (!cache)
+    {
+        rWarning() << "Could not write AAS cache file " << cachePath << std::endl;
+        return;
+    }
+
+    writeCacheHeader(cache, stamp, loader.getAasFormatName());
+
+    if (!loader.writeBinaryCache(aasFile, cache))
+    {
+        // Don't leave an incomplete cache behind
+        cache.close();
+
+        try
+        {
+            fs::remove(cachePath);
+        }
+        catch (fs::filesystem_error& ex)
+        {
+            rWarning() << "Could not remove incomplete AAS cache file: " << ex.what() << std::endl;
+        }
+    }
+}
+
 const std::string& AasFileManager::getName() const
 {
 	static std::string _name(MODULE_AASFILEMANAGER);
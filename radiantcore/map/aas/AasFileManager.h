@@ -2,10 +2,23 @@
 
 #include "iaasfile.h"
 #include <set>
+#include <cstdint>
 
 namespace map
 {
 
+// Size and modification time of an AAS file, used to validate its binary cache
+struct AasSourceStamp
+{
+    std::uint64_t size = 0;
+    std::int64_t modificationTime = 0;
+
+    bool operator==(const AasSourceStamp& other) const
+    {
+        return size == other.size && modificationTime == other.modificationTime;
+    }
+};
+
 class AasFileManager :
     public IAasFileManager
 {
@@ -28,6 +41,7 @@ public:
     AasTypeList getAasTypes() override;
     AasType getAasTypeByName(const std::string& typeName) override;
     std::list<AasFileInfo> getAasFilesForMap(const std::string& mapPath) override;
+    IAasFilePtr loadAasFile(const AasFileInfo& info) override;
 
     // RegisterableModule implementation
 	const std::string& getName() const override;
@@ -36,6 +50,10 @@ public:
 
 private:
     void ensureAasTypesLoaded();
+
+    IAasFilePtr loadFromCache(const std::string& cachePath, const AasSourceStamp& stamp);
+    void writeCache(const std::string& cachePath, const AasSourceStamp& stamp,
+        IAasFileLoader& loader, const IAasFile& aasFile);
 };
 
 } // namespace
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <cstdlib>
+#include <string>
+#include "parser/DefTokeniser.h"
+
+namespace map
+{
+
+/**
+ * Tokeniser working directly on the (null-terminated) contents of an AAS file.
+ *
+ * Uses the same rules as the DefTokeniser ({}() are kept delimiters, quotes
+ * and comments are respected), but additionally provides methods to read
+ * numbers and single-character tokens without constructing a std::string
+ * for each of them. The large sections of an AAS file consist of numbers
+ * and braces only, for these the typed methods should be used.
+ */
+class AasTokeniser :
+    public parser::DefTokeniser
+{
+private:
+    // The buffer must outlive this tokeniser
+    const char* _pos;
+    const char* _end;
+
+public:
+    AasTokeniser(const std::string& buffer) :
+        _pos(buffer.c_str()),
+        _end(buffer.c_str() + buffer.size())
+    {
+        skipWhitespaceAndComments();
+    }
+
+    bool hasMoreTokens() const override
+    {
+        return _pos < _end;
+    }
+
+    std::string nextToken() override
+    {
+        if (!hasMoreTokens())
+        {
+            throw parser::ParseException("AasTokeniser: no more tokens");
+        }
+
+        auto tokenEnd = findTokenEnd();
+        std::string token;
+
+        if (*_pos == '"')
+        {
+            token.assign(_pos + 1, tokenEnd - 1);
+        }
+        else
+        {
+            token.assign(_pos, tokenEnd);
+        }
+
+        _pos = tokenEnd;
+        skipWhitespaceAndComments();
+
+        return token;
+    }
+
+    std::string peek() const override
+    {
+        if (!hasMoreTokens())
+        {
+            throw parser::ParseException("AasTokeniser: no more tokens");
+        }
+
+        auto tokenEnd = findTokenEnd();
+
+        return *_pos == '"' ? std::string(_pos + 1, tokenEnd - 1) : std::string(_pos, tokenEnd);
+    }
+
+    // Consumes the next token, which must be the given single character
+    void assertNextChar(char expected)
+    {
+        if (!hasMoreTokens() || *_pos != expected || findTokenEnd() != _pos + 1)
+        {
+            throw parser::ParseException(std::string("AasTokeniser: Assertion failed: Required \"") +
+                expected + "\", found \"" + (hasMoreTokens() ? peek() : std::string()) + "\"");
+        }
+
+        ++_pos;
+        skipWhitespaceAndComments();
+    }
+
+    // Returns true if the next token is the given single character (without consuming it)
+    bool nextCharIs(char c) const
+    {
+        return hasMoreTokens() && *_pos == c;
+    }
+
+    // Consumes the next token without returning it
+    void skipToken()
+    {
+        if (!hasMoreTokens())
+        {
+            throw parser::ParseException("AasTokeniser: no more tokens");
+        }
+
+        _pos = findTokenEnd();
+        skipWhitespaceAndComments();
+    }
+
+    long nextInt()
+    {
+        char* numberEnd = nullptr;
+        auto value = std::strtol(_pos, &numberEnd, 10);
+
+        finishNumber(numberEnd);
+
+        return value;
+    }
+
+    double nextDouble()
+    {
+        char* numberEnd = nullptr;
+        auto value = std::strtod(_pos, &numberEnd);
+
+        finishNumber(numberEnd);
+
+        return value;
+    }
+
+private:
+    static bool isWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v';
+    }
+
+    static bool isKeptDelimiter(char c)
+    {
+        return c == '{' || c == '}' || c == '(' || c == ')';
+    }
+
+    void skipWhitespaceAndComments()
+    {
+        while (_pos < _end)
+        {
+            if (isWhitespace(*_pos))
+            {
+                ++_pos;
+            }
+            else if (*_pos == '/' && _pos + 1 < _end && _pos[1] == '/')
+            {
+                while (_pos < _end && *_pos != '\n') ++_pos;
+            }
+            else if (*_pos == '/' && _pos + 1 < _end && _pos[1] == '*')
+            {
+                _pos += 2;
+
+                while (_pos < _end && !(*_pos == '*' && _pos + 1 < _end && _pos[1] == '/')) ++_pos;
+
+                _pos = _pos < _end ? _pos + 2 : _end;
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    // Returns the end of the token starting at the current position
+    const char* findTokenEnd() const
+    {
+        if (isKeptDelimiter(*_pos))
+        {
+            return _pos + 1;
+        }
+
+        if (*_pos == '"')
+        {
+            auto closingQuote = _pos + 1;
+            while (closingQuote < _end && *closingQuote != '"') ++closingQuote;
+
+            if (closingQuote == _end)
+            {
+                throw parser::ParseException("AasTokeniser: missing closing quote");
+            }
+
+            return closingQuote + 1;
+        }
+
+        auto tokenEnd = _pos;
+        while (tokenEnd < _end && !isWhitespace(*tokenEnd) && !isKeptDelimiter(*tokenEnd)) ++tokenEnd;
+
+        return tokenEnd;
+    }
+
+    void finishNumber(const char* numberEnd)
+    {
+        // The number must span the whole token
+        if (numberEnd == _pos || numberEnd != findTokenEnd())
+        {
+            throw parser::ParseException("AasTokeniser: expected a number, found \"" +
+                (hasMoreTokens() ? peek() : std::string()) + "\"");
+        }
+
+        _pos = numberEnd;
+        skipWhitespaceAndComments();
+    }
+};
+
+}
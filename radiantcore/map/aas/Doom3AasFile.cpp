@@ -1,8 +1,7 @@
 #include "Doom3AasFile.h"
 
 #include "itextstream.h"
-#include "string/convert.h"
-#include "Util.h"
+#include "stream/utils.h"
 
 namespace map
 {
@@ -95,7 +94,7 @@ const IAasFile::Area& Doom3AasFile::getArea(int areaNum) const
     return _areas[areaNum];
 }
 
-void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
+void Doom3AasFile::parseFromTokens(AasTokeniser& tok)
 {
     while (tok.hasMoreTokens())
     {
@@ -107,74 +106,84 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "planes")
         {
-            std::size_t planesCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t planesCount = parseCount(tok);
 
             _planes.reserve(planesCount);
 
-            tok.assertNextToken("{");
+            tok.assertNextChar('{');
 
             // num ( a b c dist )
             for (std::size_t i = 0; i < planesCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // plane index
+                tok.nextInt(); // plane index
 
-                tok.assertNextToken("(");
+                tok.assertNextChar('(');
 
                 Plane3 plane;
-                plane.normal().x() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.normal().y() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.normal().z() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.dist() = string::convert<Vector3::ElementType>(tok.nextToken());
+                plane.normal().x() = tok.nextDouble();
+                plane.normal().y() = tok.nextDouble();
+                plane.normal().z() = tok.nextDouble();
+                plane.dist() = tok.nextDouble();
 
                 _planes.push_back(plane);
 
-                tok.assertNextToken(")");
+                tok.assertNextChar(')');
             }
 
-            tok.assertNextToken("}");
+            tok.assertNextChar('}');
         }
         else if (token == "vertices")
         {
-            std::size_t vertCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t vertCount = parseCount(tok);
 
             _vertices.reserve(vertCount);
 
-            tok.assertNextToken("{");
+            tok.assertNextChar('{');
 
             // num ( x y z )
             for (std::size_t i = 0; i < vertCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // index
-                _vertices.push_back(parseVector3(tok)); // components
+                tok.nextInt(); // index
+
+                tok.assertNextChar('(');
+
+                Vector3 vertex;
+                vertex.x() = tok.nextDouble();
+                vertex.y() = tok.nextDouble();
+                vertex.z() = tok.nextDouble();
+
+                _vertices.push_back(vertex); // components
+
+                tok.assertNextChar(')');
             }
 
-            tok.assertNextToken("}");
+            tok.assertNextChar('}');
         }
         else if (token == "edges")
         {
-            std::size_t edgeCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t edgeCount = parseCount(tok);
 
             _edges.reserve(edgeCount);
 
-            tok.assertNextToken("{");
+            tok.assertNextChar('{');
 
             // num ( vertIdx1 vertIdx2 )
             for (std::size_t i = 0; i < edgeCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // index
+                tok.nextInt(); // index
 
-                tok.assertNextToken("(");
+                tok.assertNextChar('(');
 
                 Edge edge;
-                edge.vertexNumber[0] = string::convert<int>(tok.nextToken());
-                edge.vertexNumber[1] = string::convert<int>(tok.nextToken());
+                edge.vertexNumber[0] = static_cast<int>(tok.nextInt());
+                edge.vertexNumber[1] = static_cast<int>(tok.nextInt());
 
-                tok.assertNextToken(")");
+                tok.assertNextChar(')');
 
                 _edges.push_back(edge); // components
             }
 
-            tok.assertNextToken("}");
+            tok.assertNextChar('}');
         }
         else if (token == "edgeIndex")
         {
@@ -182,34 +191,34 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "faces")
         {
-            std::size_t faceCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t faceCount = parseCount(tok);
 
             _faces.reserve(faceCount);
 
-            tok.assertNextToken("{");
+            tok.assertNextChar('{');
 
             // num ( planeNum flags areas[0] areas[1] firstEdge numEdges )
             for (std::size_t i = 0; i < faceCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // number
+                tok.nextInt(); // number
 
-                tok.assertNextToken("(");
+                tok.assertNextChar('(');
 
                 Face face;
 
-                face.planeNum = string::convert<int>(tok.nextToken());
-                face.flags = string::convert<unsigned short>(tok.nextToken());
-                face.areas[0] = string::convert<short>(tok.nextToken());
-                face.areas[1] = string::convert<short>(tok.nextToken());
-                face.firstEdge = string::convert<int>(tok.nextToken());
-                face.numEdges = string::convert<int>(tok.nextToken());
+                face.planeNum = static_cast<int>(tok.nextInt());
+                face.flags = static_cast<unsigned short>(tok.nextInt());
+                face.areas[0] = static_cast<short>(tok.nextInt());
+                face.areas[1] = static_cast<short>(tok.nextInt());
+                face.firstEdge = static_cast<int>(tok.nextInt());
+                face.numEdges = static_cast<int>(tok.nextInt());
 
                 _faces.push_back(face);
 
-                tok.assertNextToken(")");
+                tok.assertNextChar(')');
             }
 
-            tok.assertNextToken("}");
+            tok.assertNextChar('}');
         }
         else if (token == "faceIndex")
         {
@@ -217,55 +226,46 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "areas")
         {
-            std::size_t areaCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t areaCount = parseCount(tok);
 
             _areas.reserve(areaCount);
 
-            tok.assertNextToken("{");
+            tok.assertNextChar('{');
 
             // num ( flags contents firstFace numFaces cluster clusterAreaNum ) reachabilityCount { reachabilities }
             for (std::size_t i = 0; i < areaCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // number
+                tok.nextInt(); // number
 
-                tok.assertNextToken("(");
+                tok.assertNextChar('(');
 
                 Area area;
 
-                area.flags = string::convert<unsigned short>(tok.nextToken());
-                area.contents = string::convert<unsigned short>(tok.nextToken());
-                area.firstFace = string::convert<int>(tok.nextToken());
-                area.numFaces = string::convert<int>(tok.nextToken());
-                area.cluster = string::convert<short>(tok.nextToken());
-                area.clusterAreaNum = string::convert<short>(tok.nextToken());
+                area.flags = static_cast<unsigned short>(tok.nextInt());
+                area.contents = static_cast<unsigned short>(tok.nextInt());
+                area.firstFace = static_cast<int>(tok.nextInt());
+                area.numFaces = static_cast<int>(tok.nextInt());
+                area.cluster = static_cast<short>(tok.nextInt());
+                area.clusterAreaNum = static_cast<short>(tok.nextInt());
+                area.travelFlags = 0;
 
                 _areas.push_back(area);
 
-                tok.assertNextToken(")");
+                tok.assertNextChar(')');
 
                 // Skip over reachabilities for the moment being
-                /*std::size_t reachCount = */string::convert<std::size_t>(tok.nextToken());
-                tok.assertNextToken("{");
-
-                while (tok.nextToken() != "}")
-                {
-                    // do nothing
-                }
+                tok.nextInt(); // reachability count
+                skipBlock(tok);
             }
 
             // Skip the step LinkReversedReachability();
 
-            tok.assertNextToken("}");
+            tok.assertNextChar('}');
         }
         else if (token == "nodes" || token == "portals" || token == "portalIndex" || token == "clusters")
         {
-            tok.nextToken(); // integer
-            tok.assertNextToken("{");
-
-            while (tok.nextToken() != "}")
-            {
-                // do nothing
-            }
+            tok.nextInt(); // integer
+            skipBlock(tok);
         }
         else
         {
@@ -283,6 +283,51 @@ void Doom3AasFile::finishAreas()
         area.center = calcReachableGoalForArea(area);
 		area.bounds = calcAreaBounds(area);
     }
+
+    buildAreaTree();
+}
+
+void Doom3AasFile::buildAreaTree()
+{
+    std::vector<AABB> areaBounds;
+    areaBounds.reserve(_areas.size());
+
+    for (const Area& area : _areas)
+    {
+        areaBounds.push_back(area.bounds);
+    }
+
+    _areaTree.build(std::move(areaBounds));
+}
+
+int Doom3AasFile::findAreaByPoint(const Vector3& point) const
+{
+    int result = -1;
+    Vector3::ElementType smallestVolume = 0;
+
+    _areaTree.forEachAreaContainingPoint(point, [&](int areaNum)
+    {
+        const auto& extents = _areas[areaNum].bounds.getExtents();
+        auto volume = extents.x() * extents.y() * extents.z();
+
+        if (result == -1 || volume < smallestVolume)
+        {
+            result = areaNum;
+            smallestVolume = volume;
+        }
+    });
+
+    return result;
+}
+
+int Doom3AasFile::pickArea(const Ray& ray) const
+{
+    return _areaTree.findFirstAreaHitByRay(ray);
+}
+
+void Doom3AasFile::forEachAreaInVolume(const VolumeTest& volume, const std::function<void(int)>& functor) const
+{
+    _areaTree.forEachAreaInVolume(volume, functor);
 }
 
 #define INTSIGNBITSET(i)		(((const unsigned int)(i)) >> 31)
@@ -389,25 +434,224 @@ Vector3 Doom3AasFile::calcReachableGoalForArea(const IAasFile::Area& area) const
     return center;
 }
 
-void Doom3AasFile::parseIndex(parser::DefTokeniser& tok, Index& index)
+void Doom3AasFile::parseIndex(AasTokeniser& tok, Index& index)
 {
-    std::size_t idxCount = string::convert<std::size_t>(tok.nextToken());
+    std::size_t idxCount = parseCount(tok);
 
     index.reserve(idxCount);
 
-    tok.assertNextToken("{");
+    tok.assertNextChar('{');
 
     // num ( idx )
     for (std::size_t i = 0; i < idxCount; ++i)
     {
-        string::convert<int>(tok.nextToken()); // number
+        tok.nextInt(); // number
+
+        tok.assertNextChar('(');
+        index.push_back(static_cast<int>(tok.nextInt()));
+        tok.assertNextChar(')');
+    }
+
+    tok.assertNextChar('}');
+}
+
+std::size_t Doom3AasFile::parseCount(AasTokeniser& tok)
+{
+    auto count = tok.nextInt();
+
+    if (count < 0)
+    {
+        throw parser::ParseException("Invalid element count: " + std::to_string(count));
+    }
+
+    return static_cast<std::size_t>(count);
+}
+
+void Doom3AasFile::skipBlock(AasTokeniser& tok)
+{
+    tok.assertNextChar('{');
+
+    while (!tok.nextCharIs('}'))
+    {
+        tok.skipToken();
+    }
+
+    tok.assertNextChar('}');
+}
+
+namespace
+{
+    // Upper limit for the element count of a single section, to reject broken caches
+    const std::uint64_t MAX_BINARY_ELEMENTS = 1 << 28;
+
+    inline void writeVector3(std::ostream& stream, const Vector3& vector)
+    {
+        stream::writeLittleEndian<double>(stream, vector.x());
+        stream::writeLittleEndian<double>(stream, vector.y());
+        stream::writeLittleEndian<double>(stream, vector.z());
+    }
 
-        tok.assertNextToken("(");
-        index.push_back(string::convert<int>(tok.nextToken()));
-        tok.assertNextToken(")");
+    inline Vector3 readVector3(std::istream& stream)
+    {
+        auto x = stream::readLittleEndian<double>(stream);
+        auto y = stream::readLittleEndian<double>(stream);
+        auto z = stream::readLittleEndian<double>(stream);
+
+        return Vector3(x, y, z);
     }
 
-    tok.assertNextToken("}");
+    // Writes the element count followed by each element
+    template<typename ElementType, typename WriteFunc>
+    void writeSection(std::ostream& stream, const std::vector<ElementType>& elements, WriteFunc write)
+    {
+        stream::writeLittleEndian<std::uint64_t>(stream, elements.size());
+
+        for (const auto& element : elements)
+        {
+            write(element);
+        }
+    }
+
+    // Reads the element count and the elements, returns false on failure
+    template<typename ElementType, typename ReadFunc>
+    bool readSection(std::istream& stream, std::vector<ElementType>& elements, ReadFunc read)
+    {
+        auto count = stream::readLittleEndian<std::uint64_t>(stream);
+
+        if (!stream || count > MAX_BINARY_ELEMENTS) return false;
+
+        elements.clear();
+        elements.reserve(static_cast<std::size_t>(count));
+
+        for (std::uint64_t i = 0; i < count && stream; ++i)
+        {
+            elements.push_back(read());
+        }
+
+        return static_cast<bool>(stream);
+    }
+}
+
+void Doom3AasFile::writeToBinary(std::ostream& stream) const
+{
+    writeSection(stream, _planes, [&](const Plane3& plane)
+    {
+        writeVector3(stream, plane.normal());
+        stream::writeLittleEndian<double>(stream, plane.dist());
+    });
+
+    writeSection(stream, _vertices, [&](const Vector3& vertex)
+    {
+        writeVector3(stream, vertex);
+    });
+
+    writeSection(stream, _edges, [&](const Edge& edge)
+    {
+        stream::writeLittleEndian<std::int32_t>(stream, edge.vertexNumber[0]);
+        stream::writeLittleEndian<std::int32_t>(stream, edge.vertexNumber[1]);
+    });
+
+    writeSection(stream, _edgeIndex, [&](int index)
+    {
+        stream::writeLittleEndian<std::int32_t>(stream, index);
+    });
+
+    writeSection(stream, _faces, [&](const Face& face)
+    {
+        stream::writeLittleEndian<std::int32_t>(stream, face.planeNum);
+        stream::writeLittleEndian<std::uint16_t>(stream, face.flags);
+        stream::writeLittleEndian<std::int32_t>(stream, face.numEdges);
+        stream::writeLittleEndian<std::int32_t>(stream, face.firstEdge);
+        stream::writeLittleEndian<std::int16_t>(stream, face.areas[0]);
+        stream::writeLittleEndian<std::int16_t>(stream, face.areas[1]);
+    });
+
+    writeSection(stream, _faceIndex, [&](int index)
+    {
+        stream::writeLittleEndian<std::int32_t>(stream, index);
+    });
+
+    // The area bounds and centres are stored too, they don't need to be calculated again
+    writeSection(stream, _areas, [&](const Area& area)
+    {
+        stream::writeLittleEndian<std::int32_t>(stream, area.numFaces);
+        stream::writeLittleEndian<std::int32_t>(stream, area.firstFace);
+        writeVector3(stream, area.bounds.getOrigin());
+        writeVector3(stream, area.bounds.getExtents());
+        writeVector3(stream, area.center);
+        stream::writeLittleEndian<std::uint16_t>(stream, area.flags);
+        stream::writeLittleEndian<std::uint16_t>(stream, area.contents);
+        stream::writeLittleEndian<std::int16_t>(stream, area.cluster);
+        stream::writeLittleEndian<std::int16_t>(stream, area.clusterAreaNum);
+        stream::writeLittleEndian<std::int32_t>(stream, area.travelFlags);
+    });
+}
+
+bool Doom3AasFile::readFromBinary(std::istream& stream)
+{
+    bool success = readSection(stream, _planes, [&]()
+    {
+        Plane3 plane;
+        plane.normal() = readVector3(stream);
+        plane.dist() = stream::readLittleEndian<double>(stream);
+        return plane;
+    });
+
+    success = success && readSection(stream, _vertices, [&]()
+    {
+        return readVector3(stream);
+    });
+
+    success = success && readSection(stream, _edges, [&]()
+    {
+        Edge edge;
+        edge.vertexNumber[0] = stream::readLittleEndian<std::int32_t>(stream);
+        edge.vertexNumber[1] = stream::readLittleEndian<std::int32_t>(stream);
+        return edge;
+    });
+
+    success = success && readSection(stream, _edgeIndex, [&]()
+    {
+        return static_cast<int>(stream::readLittleEndian<std::int32_t>(stream));
+    });
+
+    success = success && readSection(stream, _faces, [&]()
+    {
+        Face face;
+        face.planeNum = stream::readLittleEndian<std::int32_t>(stream);
+        face.flags = stream::readLittleEndian<std::uint16_t>(stream);
+        face.numEdges = stream::readLittleEndian<std::int32_t>(stream);
+        face.firstEdge = stream::readLittleEndian<std::int32_t>(stream);
+        face.areas[0] = stream::readLittleEndian<std::int16_t>(stream);
+        face.areas[1] = stream::readLittleEndian<std::int16_t>(stream);
+        return face;
+    });
+
+    success = success && readSection(stream, _faceIndex, [&]()
+    {
+        return static_cast<int>(stream::readLittleEndian<std::int32_t>(stream));
+    });
+
+    success = success && readSection(stream, _areas, [&]()
+    {
+        Area area;
+        area.numFaces = stream::readLittleEndian<std::int32_t>(stream);
+        area.firstFace = stream::readLittleEndian<std::int32_t>(stream);
+        area.bounds.origin = readVector3(stream);
+        area.bounds.extents = readVector3(stream);
+        area.center = readVector3(stream);
+        area.flags = stream::readLittleEndian<std::uint16_t>(stream);
+        area.contents = stream::readLittleEndian<std::uint16_t>(stream);
+        area.cluster = stream::readLittleEndian<std::int16_t>(stream);
+        area.clusterAreaNum = stream::readLittleEndian<std::int16_t>(stream);
+        area.travelFlags = stream::readLittleEndian<std::int32_t>(stream);
+        return area;
+    });
+
+    if (!success) return false;
+
+    buildAreaTree();
+    return true;
 }
 
 }
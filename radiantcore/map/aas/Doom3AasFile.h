@@ -1,9 +1,12 @@
 #pragma once
 
 #include "iaasfile.h"
-#include "parser/DefTokeniser.h"
+#include "AasTokeniser.h"
+#include "AasAreaTree.h"
 #include "Doom3AasFileSettings.h"
 #include <vector>
+#include <ostream>
+#include <istream>
 #include "math/Plane3.h"
 #include "math/AABB.h"
 
@@ -28,6 +31,9 @@ private:
 
     std::vector<Area> _areas;
 
+    // Spatial index over the area bounds
+    AasAreaTree _areaTree;
+
 public:
     virtual std::size_t     getNumPlanes() const override;
     virtual const Plane3&   getPlane(std::size_t planeNum) const override;
@@ -49,11 +55,23 @@ public:
     virtual std::size_t     getNumAreas() const override;
     virtual const Area&     getArea(int areaNum) const override;
 
-    void parseFromTokens(parser::DefTokeniser& tok);
+    int findAreaByPoint(const Vector3& point) const override;
+    int pickArea(const Ray& ray) const override;
+    void forEachAreaInVolume(const VolumeTest& volume, const std::function<void(int)>& functor) const override;
+
+    void parseFromTokens(AasTokeniser& tok);
+
+    // Binary representation used by the AAS cache files. The settings
+    // are not part of it, a file read from binary uses default settings.
+    void writeToBinary(std::ostream& stream) const;
+    bool readFromBinary(std::istream& stream);
 
 private:
-    void parseIndex(parser::DefTokeniser& tok, Index& index);
+    void parseIndex(AasTokeniser& tok, Index& index);
+    std::size_t parseCount(AasTokeniser& tok);
+    void skipBlock(AasTokeniser& tok);
     void finishAreas();
+    void buildAreaTree();
     Vector3 calcReachableGoalForArea(const IAasFile::Area& area) const;
     Vector3 calcFaceCenter(int faceNum) const;
     Vector3 calcAreaCenter(const IAasFile::Area& area) const;
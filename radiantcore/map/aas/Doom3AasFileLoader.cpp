@@ -5,6 +5,7 @@
 #include "parser/DefTokeniser.h"
 #include "string/convert.h"
 #include "Doom3AasFile.h"
+#include "AasTokeniser.h"
 #include "module/StaticModule.h"
 
 namespace map
@@ -54,8 +55,10 @@ IAasFilePtr Doom3AasFileLoader::loadFromStream(std::istream& stream)
 
     // We assume that the stream is rewound to the beginning
 
-    // Instantiate a tokeniser to read the version tag
-	parser::BasicDefTokeniser<std::istream> tok(stream);
+    // Read the whole file in one go, the tokeniser works on the buffer directly
+    std::string buffer(std::istreambuf_iterator<char>(stream), {});
+
+	AasTokeniser tok(buffer);
 
     try
 	{
@@ -81,6 +84,29 @@ IAasFilePtr Doom3AasFileLoader::loadFromStream(std::istream& stream)
     return aasFile;
 }
 
+bool Doom3AasFileLoader::writeBinaryCache(const IAasFile& aasFile, std::ostream& stream)
+{
+    auto doom3File = dynamic_cast<const Doom3AasFile*>(&aasFile);
+
+    if (!doom3File) return false;
+
+    doom3File->writeToBinary(stream);
+
+    return static_cast<bool>(stream);
+}
+
+IAasFilePtr Doom3AasFileLoader::loadFromBinaryCache(std::istream& stream)
+{
+    Doom3AasFilePtr aasFile = std::make_shared<Doom3AasFile>();
+
+    if (!aasFile->readFromBinary(stream))
+    {
+        return IAasFilePtr();
+    }
+
+    return aasFile;
+}
+
 void Doom3AasFileLoader::parseVersion(parser::DefTokeniser& tok) const
 {
     // Require a "Version" token
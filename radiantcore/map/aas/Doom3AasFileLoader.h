@@ -20,6 +20,8 @@ public:
 
 	virtual bool canLoad(std::istream& stream) const override;
     virtual IAasFilePtr loadFromStream(std::istream& stream) override;
+    virtual bool writeBinaryCache(const IAasFile& aasFile, std::ostream& stream) override;
+    virtual IAasFilePtr loadFromBinaryCache(std::istream& stream) override;
 
     // RegisterableModule implementation
 	virtual const std::string& getName() const override;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "imapformat.h"
+
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace map
+{
+
+/**
+ * A single entity with its primitives, which can be serialised independently
+ * of the rest of the map (e.g. on a worker thread) using a writer acquired
+ * through IMapWriter::createEntityWriter().
+ */
+struct EntityExportJob
+{
+	// Is empty for primitives without parent entity
+	IEntityNodePtr entity;
+	std::size_t entityNum;
+
+	// Either of the two pointers is set
+	std::vector<std::pair<IBrushNodePtr, IPatchNodePtr>> primitives;
+
+	// The serialised entity and the errors reported by the writer
+	std::string output;
+	std::vector<std::string> errors;
+
+	// Serialise the entity and its primitives to the output string, using an
+	// entity writer created by the given map writer
+	void serialise(const IMapWriter& mapWriter, std::streamsize precision)
+	{
+		auto writer = mapWriter.createEntityWriter(entityNum);
+
+		std::ostringstream stream;
+		stream.precision(precision);
+
+		// Writer failures don't stop the export, they are collected to be logged later on
+		auto write = [&](const std::function<void()>& writeFunc)
+		{
+			try
+			{
+				writeFunc();
+			}
+			catch (IMapWriter::FailureException& ex)
+			{
+				errors.emplace_back(ex.what());
+			}
+		};
+
+		if (entity)
+		{
+			write([&]() { writer->beginWriteEntity(entity, stream); });
+		}
+
+		for (const auto& primitive : primitives)
+		{
+			if (primitive.first)
+			{
+				write([&]() { writer->beginWriteBrush(primitive.first, stream); });
+				write([&]() { writer->endWriteBrush(primitive.first, stream); });
+			}
+			else
+			{
+				write([&]() { writer->beginWritePatch(primitive.second, stream); });
+				write([&]() { writer->endWritePatch(primitive.second, stream); });
+			}
+		}
+
+		if (entity)
+		{
+			write([&]() { writer->endWriteEntity(entity, stream); });
+		}
+
+		output = stream.str();
+	}
+
+	// The number of scene nodes exported by this job
+	std::size_t getNodeCount() const
+	{
+		return primitives.size() + (entity ? 1 : 0);
+	}
+};
+
+}
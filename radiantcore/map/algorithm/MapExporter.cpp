@@ -1,6 +1,9 @@
 #include "MapExporter.h"
 
 #include <ostream>
+#include <atomic>
+#include <future>
+#include <thread>
 #include "i18n.h"
 #include "itextstream.h"
 #include "ibrush.h"
@@ -23,6 +26,7 @@ namespace map
 	{
 		const char* const RKEY_FLOAT_PRECISION = "/mapFormat/floatPrecision";
 		const char* const RKEY_MAP_SAVE_STATUS_INTERLEAVE = "user/ui/map/saveStatusInterleave";
+		const char* const RKEY_MAP_SAVE_IN_PARALLEL = "user/ui/map/parallelSave";
 	}
 
 MapExporter::MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root, std::ostream& mapStream, std::size_t nodeCount) :
@@ -34,7 +38,9 @@ MapExporter::MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root,
 	_curNodeCount(0),
 	_entityNum(0),
 	_primitiveNum(0),
-    _sendProgressMessages(true)
+    _sendProgressMessages(true),
+	_exportInParallel(false),
+	_exportJobIsOpen(false)
 {
 	construct();
 }
@@ -50,7 +56,9 @@ MapExporter::MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root,
 	_curNodeCount(0),
 	_entityNum(0),
 	_primitiveNum(0),
-    _sendProgressMessages(true)
+    _sendProgressMessages(true),
+	_exportInParallel(false),
+	_exportJobIsOpen(false)
 {
 	construct();
 }
@@ -68,17 +76,24 @@ MapExporter::~MapExporter()
 void MapExporter::construct()
 {
 	// Prepare the output stream
+	_mapStream.precision(GetFloatPrecision());
+
+	// Entities can be serialised in parallel if the writer is able to provide per-entity writers
+	_exportInParallel = registry::getValue<bool>(RKEY_MAP_SAVE_IN_PARALLEL) && _writer.createEntityWriter(0);
+
+	// Add origin to func_* children before writing
+	prepareScene();
+}
+
+std::streamsize MapExporter::GetFloatPrecision()
+{
 	game::IGamePtr curGame = GlobalGameManager().currentGame();
 	assert(curGame);
 
 	xml::NodeList nodes = curGame->getLocalXPath(RKEY_FLOAT_PRECISION);
 	assert(!nodes.empty());
 
-	int precision = string::convert<int>(nodes[0].getAttributeValue("value"));
-	_mapStream.precision(precision);
-
-	// Add origin to func_* children before writing
-	prepareScene();
+	return string::convert<int>(nodes[0].getAttributeValue("value"));
 }
 
 void MapExporter::exportMap(const scene::INodePtr& root, const GraphTraversalFunc& traverse)
@@ -113,6 +128,11 @@ void MapExporter::exportMap(const scene::INodePtr& root, const GraphTraversalFun
 	// Perform the actual map traversal
 	traverse(root, *this);
 
+	if (_exportInParallel)
+	{
+		writeExportJobs();
+	}
+
 	try
 	{
 		auto mapRoot = std::dynamic_pointer_cast<scene::IMapRootNode>(root);
@@ -145,10 +165,19 @@ bool MapExporter::pre(const scene::INodePtr& node)
 
 		if (entity)
 		{
-			// Progress dialog handling
-			onNodeProgress();
-			
-			_writer.beginWriteEntity(entity, _mapStream);
+			if (_exportInParallel)
+			{
+				// The entity is written after the traversal, progress is reported then
+				_exportJobs.push_back(EntityExportJob{ entity, _entityNum });
+				_exportJobIsOpen = true;
+			}
+			else
+			{
+				// Progress dialog handling
+				onNodeProgress();
+
+				_writer.beginWriteEntity(entity, _mapStream);
+			}
 
 			if (_infoFileExporter) _infoFileExporter->visitEntity(node, _entityNum);
 
@@ -159,10 +188,17 @@ bool MapExporter::pre(const scene::INodePtr& node)
 
 		if (brush && brush->getIBrush().hasContributingFaces())
 		{
-			// Progress dialog handling
-			onNodeProgress();
-
-			_writer.beginWriteBrush(brush, _mapStream);
+			if (_exportInParallel)
+			{
+				addPrimitiveToExportJob(brush, IPatchNodePtr());
+			}
+			else
+			{
+				// Progress dialog handling
+				onNodeProgress();
+
+				_writer.beginWriteBrush(brush, _mapStream);
+			}
 
 			if (_infoFileExporter) _infoFileExporter->visitPrimitive(node, _entityNum, _primitiveNum);
 
@@ -173,10 +209,17 @@ bool MapExporter::pre(const scene::INodePtr& node)
 
 		if (patch)
 		{
-			// Progress dialog handling
-			onNodeProgress();
-
-			_writer.beginWritePatch(patch, _mapStream);
+			if (_exportInParallel)
+			{
+				addPrimitiveToExportJob(IBrushNodePtr(), patch);
+			}
+			else
+			{
+				// Progress dialog handling
+				onNodeProgress();
+
+				_writer.beginWritePatch(patch, _mapStream);
+			}
 
 			if (_infoFileExporter) _infoFileExporter->visitPrimitive(node, _entityNum, _primitiveNum);
 
@@ -199,7 +242,14 @@ void MapExporter::post(const scene::INodePtr& node)
 
 		if (entity)
 		{
-			_writer.endWriteEntity(entity, _mapStream);
+			if (_exportInParallel)
+			{
+				_exportJobIsOpen = false;
+			}
+			else
+			{
+				_writer.endWriteEntity(entity, _mapStream);
+			}
 
 			_entityNum++;
 			return;
@@ -209,7 +259,10 @@ void MapExporter::post(const scene::INodePtr& node)
 
 		if (brush && brush->getIBrush().hasContributingFaces())
 		{
-			_writer.endWriteBrush(brush, _mapStream);
+			if (!_exportInParallel)
+			{
+				_writer.endWriteBrush(brush, _mapStream);
+			}
 			_primitiveNum++;
 			return;
 		}
@@ -218,7 +271,10 @@ void MapExporter::post(const scene::INodePtr& node)
 
 		if (patch)
 		{
-			_writer.endWritePatch(patch, _mapStream);
+			if (!_exportInParallel)
+			{
+				_writer.endWritePatch(patch, _mapStream);
+			}
 			_primitiveNum++;
 			return;
 		}
@@ -229,6 +285,97 @@ void MapExporter::post(const scene::INodePtr& node)
 	}
 }
 
+void MapExporter::addPrimitiveToExportJob(const IBrushNodePtr& brush, const IPatchNodePtr& patch)
+{
+	// Primitives without parent entity get a job of their own
+	if (!_exportJobIsOpen)
+	{
+		_exportJobs.push_back(EntityExportJob{ IEntityNodePtr(), _entityNum });
+		_exportJobIsOpen = true;
+	}
+
+	_exportJobs.back().primitives.emplace_back(brush, patch);
+}
+
+void MapExporter::writeExportJobs()
+{
+	if (_exportJobs.empty()) return;
+
+	auto precision = _mapStream.precision();
+
+	std::vector<std::promise<void>> finished(_exportJobs.size());
+	std::vector<std::future<void>> jobResults;
+	jobResults.reserve(finished.size());
+
+	for (auto& promise : finished)
+	{
+		jobResults.emplace_back(promise.get_future());
+	}
+
+	std::atomic<std::size_t> nextJob(0);
+	std::atomic<bool> cancelled(false);
+
+	auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), _exportJobs.size());
+
+	// The worker futures are declared last, such that the threads are joined
+	// before anything they refer to goes out of scope
+	std::vector<std::future<void>> workers;
+
+	for (std::size_t i = 0; i < numWorkers; ++i)
+	{
+		workers.emplace_back(std::async(std::launch::async, [&]()
+		{
+			for (auto job = nextJob++; job < _exportJobs.size() && !cancelled; job = nextJob++)
+			{
+				try
+				{
+					_exportJobs[job].serialise(_writer, precision);
+					finished[job].set_value();
+				}
+				catch (...)
+				{
+					finished[job].set_exception(std::current_exception());
+				}
+			}
+		}));
+	}
+
+	try
+	{
+		// Write the results in entity order, as soon as they are available
+		for (std::size_t i = 0; i < _exportJobs.size(); ++i)
+		{
+			jobResults[i].get();
+
+			auto& job = _exportJobs[i];
+
+			for (const auto& error : job.errors)
+			{
+				rError() << "Failure exporting a node: " << error << std::endl;
+			}
+
+			_mapStream.write(job.output.data(), job.output.size());
+
+			// Progress dialog handling, once per exported node
+			for (std::size_t node = 0; node < job.getNodeCount(); ++node)
+			{
+				onNodeProgress();
+			}
+
+			// Free the memory of this job
+			job = EntityExportJob();
+		}
+	}
+	catch (...)
+	{
+		// Let the workers finish quickly, they are joined when leaving this scope
+		cancelled = true;
+		throw;
+	}
+
+	_exportJobs.clear();
+}
+
 void MapExporter::onNodeProgress()
 {
 	_curNodeCount++;
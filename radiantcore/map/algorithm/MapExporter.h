@@ -8,7 +8,9 @@
 
 #include "../infofile/InfoFileExporter.h"
 #include "EventRateLimiter.h"
+#include "EntityExportJob.h"
 
+#include <vector>
 #include <sigc++/signal.h>
 
 namespace map
@@ -55,6 +57,15 @@ private:
 
     bool _sendProgressMessages;
 
+	// True if entities are collected during traversal and serialised
+	// in parallel using per-entity writers
+	bool _exportInParallel;
+
+	std::vector<EntityExportJob> _exportJobs;
+
+	// True while the last job can receive further primitives
+	bool _exportJobIsOpen;
+
 public:
 	// The constructor prepares the scene and the output stream
 	MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root,
@@ -80,6 +91,9 @@ public:
     // Don't send any progress messages through the MessageBus while exporting
     void disableProgressMessages();
 
+	// The number of digits to write floating point values with, as defined by the current game
+	static std::streamsize GetFloatPrecision();
+
 private:
 	// Common code shared by the constructors
 	void construct();
@@ -93,6 +107,13 @@ private:
 	void finishScene();
 
 	void recalculateBrushWindings();
+
+	// Parallel export: collects the primitive into the currently open job
+	void addPrimitiveToExportJob(const IBrushNodePtr& brush, const IPatchNodePtr& patch);
+
+	// Serialises the collected jobs using worker threads, writing the output
+	// to the map stream in the order the entities have been visited
+	void writeExportJobs();
 };
 typedef std::shared_ptr<MapExporter> MapExporterPtr;
 
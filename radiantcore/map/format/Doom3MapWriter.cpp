@@ -23,7 +23,11 @@ inline std::string escapeLineBreaks(const std::string& input)
 }
 
 Doom3MapWriter::Doom3MapWriter() :
-	_entityCount(0),
+	Doom3MapWriter(0)
+{}
+
+Doom3MapWriter::Doom3MapWriter(std::size_t firstEntityNum) :
+	_entityCount(firstEntityNum),
 	_primitiveCount(0)
 {}
 
@@ -96,4 +100,9 @@ void Doom3MapWriter::endWritePatch(const IPatchNodePtr& patch, std::ostream& str
 	// nothing
 }
 
+IMapWriterPtr Doom3MapWriter::createEntityWriter(std::size_t entityNum) const
+{
+	return std::make_shared<Doom3MapWriter>(entityNum);
+}
+
 } // namespace
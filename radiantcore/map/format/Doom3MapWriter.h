@@ -21,6 +21,9 @@ protected:
 public:
 	Doom3MapWriter();
 
+	// Construct a writer starting with the given entity number
+	Doom3MapWriter(std::size_t firstEntityNum);
+
 	virtual void beginWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream) override;
 	virtual void endWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream) override;
 
@@ -36,6 +39,8 @@ public:
 	virtual void beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override;
 	virtual void endWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override;
 
+	virtual IMapWriterPtr createEntityWriter(std::size_t entityNum) const override;
+
 protected:
 	void writeEntityKeyValues(const IEntityNodePtr& entity, std::ostream& stream);
 };
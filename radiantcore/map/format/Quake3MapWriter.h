@@ -15,6 +15,8 @@ class Quake3MapWriter :
 	public Doom3MapWriter
 {
 public:
+	using Doom3MapWriter::Doom3MapWriter;
+
 	virtual void beginWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream) override
 	{
 		// Write an empty line at the beginning of the file
@@ -38,6 +40,11 @@ public:
 		// Export patchDef2 to stream (patchDef3 is not supported)
 		PatchDefExporter::exportQ3PatchDef2(stream, patch);
 	}
+
+	virtual IMapWriterPtr createEntityWriter(std::size_t entityNum) const override
+	{
+		return std::make_shared<Quake3MapWriter>(entityNum);
+	}
 };
 
 } // namespace
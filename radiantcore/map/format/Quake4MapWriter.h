@@ -14,6 +14,8 @@ class Quake4MapWriter :
 	public Doom3MapWriter
 {
 public:
+	using Doom3MapWriter::Doom3MapWriter;
+
 	virtual void beginWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream) override
 	{
 		// Write the version tag
@@ -28,6 +30,11 @@ public:
 		// Export brushDef3 definition to stream, but without contents flags
 		BrushDef3Exporter::exportBrush(stream, brush, false);
 	}
+
+	virtual IMapWriterPtr createEntityWriter(std::size_t entityNum) const override
+	{
+		return std::make_shared<Quake4MapWriter>(entityNum);
+	}
 };
 
 } // namespace
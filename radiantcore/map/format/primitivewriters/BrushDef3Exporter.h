@@ -3,6 +3,7 @@
 #include "ibrush.h"
 #include "math/Plane3.h"
 #include "math/Matrix4.h"
+#include "stream/utils.h"
 
 namespace map
 {
@@ -20,7 +21,7 @@ namespace
 			}
 			else
 			{
-				os << d;
+				stream::writeDouble(os, d);
 			}
 		}
 		else
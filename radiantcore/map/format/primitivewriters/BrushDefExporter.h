@@ -3,6 +3,7 @@
 #include "ibrush.h"
 #include "math/Plane3.h"
 #include "math/Matrix4.h"
+#include "stream/utils.h"
 #include "shaderlib.h"
 
 #include "string/predicate.h"
@@ -23,7 +24,7 @@ namespace
 			}
 			else
 			{
-				os << d;
+				stream::writeDouble(os, d);
 			}
 		}
 		else
@@ -2,6 +2,7 @@
 
 #include "shaderlib.h"
 #include "ipatch.h"
+#include "stream/utils.h"
 
 #include "string/predicate.h"
 
@@ -20,7 +21,7 @@ namespace
 			}
 			else
 			{
-				os << d;
+				stream::writeDouble(os, d);
 			}
 		}
 		else
@@ -25,12 +25,10 @@ std::string ComplexName::getFullname() const
 
 namespace
 {
-    // Find the first integer not in the given set
-    std::string findFirstUnusedNumber(const PostfixSet& set)
+    // Find the first integer not in the given set, starting at the given value
+    std::string findFirstUnusedNumber(const PostfixSet& set, int start)
     {
-        static const int LOWEST_VAL = 1;
-
-        for (int i = LOWEST_VAL; i < INT_MAX; ++i)
+        for (int i = start; i < INT_MAX; ++i)
         {
 			std::string testPostfix = string::to_string(i);
 
@@ -47,12 +45,41 @@ namespace
 }
 
 std::string ComplexName::makePostfixUnique(const PostfixSet& postfixes)
+{
+    int firstCandidate = 1;
+    return makePostfixUnique(postfixes, firstCandidate);
+}
+
+std::string ComplexName::makePostfixUnique(const PostfixSet& postfixes, int& firstCandidate)
 {
     // If our postfix is already in the set, change it to a unique value
     if (postfixes.find(_postFix) != postfixes.end())
     {
-        _postFix = findFirstUnusedNumber(postfixes);
+        _postFix = findFirstUnusedNumber(postfixes, firstCandidate);
+
+        // All numbers up to the one we took are in use now
+        firstCandidate = getPostfixNumber(_postFix) + 1;
     }
 
     return _postFix;
 }
+
+int ComplexName::getPostfixNumber(const std::string& postfix)
+{
+    // Leading zeros and overly long digit strings don't map to a plain number
+    if (postfix.empty() || postfix.size() > 9 || postfix[0] < '1' || postfix[0] > '9')
+    {
+        return 0;
+    }
+
+    int number = 0;
+
+    for (auto c : postfix)
+    {
+        if (c < '0' || c > '9') return 0;
+
+        number = number * 10 + (c - '0');
+    }
+
+    return number;
+}
@@ -46,4 +46,16 @@ public:
      * Set of existing postfixes which must not be used.
      */
     std::string makePostfixUnique(const PostfixSet& postfixes);
+
+    /**
+     * \brief
+     * Same as above, the search for an unused number starts at the given
+     * value, all lower numbers are assumed to be in use. If a new postfix
+     * is chosen, the start value is advanced to the number following it.
+     */
+    std::string makePostfixUnique(const PostfixSet& postfixes, int& firstCandidate);
+
+    /// Returns the numeric value of the given postfix, or 0 if the postfix
+    /// is not the plain string form of a positive number (e.g. "-" or "05")
+    static int getPostfixNumber(const std::string& postfix);
 };
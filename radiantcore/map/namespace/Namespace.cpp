@@ -282,9 +282,11 @@ void Namespace::ensureNoConflicts(const scene::INodePtr& foreignRoot, const std:
 
     // Build a union set containing all imported names and all existing names.
     // We need to know all existing names to ensure that newly created names are
-    // unique in *both* namespaces
-    UniqueNameSet allNames = _uniqueNames;
-    allNames.merge(foreignNamespace._uniqueNames);
+    // unique in *both* namespaces. A name keeps its prefix when being renamed,
+    // so only the existing names sharing a prefix with the imported ones matter,
+    // this avoids copying the whole target namespace on every paste.
+    UniqueNameSet allNames = foreignNamespace._uniqueNames;
+    allNames.mergeMatchingPrefixes(_uniqueNames);
 
     // Process each object in the to-be-imported tree of nodes, ensuring that it
     // has a unique name
@@ -2,6 +2,7 @@
 
 #include <set>
 #include <map>
+#include <algorithm>
 
 #include "ComplexName.h"
 
@@ -12,10 +13,19 @@
  */
 class UniqueNameSet
 {
+    struct Postfixes
+    {
+        PostfixSet used;
+
+        // All numbers below this one are known to be in use, the search
+        // for an unused postfix can start here (instead of at 1 each time)
+        int firstCandidate = 1;
+    };
+
     // This maps name prefixes to a set of used postfixes
     // e.g. "func_static_" => ["1","3","4","5","05","10"]
     // Allows fairly quick lookup of used names and postfixes
-    typedef std::map<std::string, PostfixSet> Names;
+    typedef std::map<std::string, Postfixes> Names;
     Names _names;
 
 public:
@@ -26,7 +36,7 @@ public:
         // Cycle through all prefixes and see if the postfixset is non-empty, break on first hit
         for (const auto& i : _names)
         {
-            if (!i.second.empty())
+            if (!i.second.used.empty())
             {
                 return false;
             }
@@ -50,7 +60,7 @@ public:
         if (found == _names.end())
 		{
             // The name is not yet in the list, insert it afresh
-            auto result = _names.insert(std::make_pair(name.getNameWithoutPostfix(), PostfixSet()));
+            auto result = _names.insert(std::make_pair(name.getNameWithoutPostfix(), Postfixes()));
 
             assert(result.second); // insert must succeed, we didn't find this just before
 
@@ -59,7 +69,7 @@ public:
         }
 
         // The prefix is inserted at this point, add the postfix to the set
-        auto result = found->second.insert(name.getPostfix());
+        auto result = found->second.used.insert(name.getPostfix());
 
         // Return the boolean of the insertion result, it is true on successful insertion
         return result.second;
@@ -82,8 +92,20 @@ public:
         }
 
         // The prefix has been found, remove the postfix from the set
-        // Return true if the erase method removed any elements
-        return found->second.erase(name.getPostfix()) > 0;
+        if (found->second.used.erase(name.getPostfix()) == 0)
+        {
+            return false;
+        }
+
+        // A number below the search start might have become available again
+        auto number = ComplexName::getPostfixNumber(name.getPostfix());
+
+        if (number > 0 && number < found->second.firstCandidate)
+        {
+            found->second.firstCandidate = number;
+        }
+
+        return true;
     }
 
     /**
@@ -103,7 +125,7 @@ public:
         if (found == _names.end()) 
 		{
             // The name is not yet in the list, we can add it with the given postfix
-            auto result = _names.insert(std::make_pair(name.getNameWithoutPostfix(), PostfixSet()));
+            auto result = _names.insert(std::make_pair(name.getNameWithoutPostfix(), Postfixes()));
 
             assert(result.second); // insert must succeed, we didn't find this just before
 
@@ -116,12 +138,12 @@ public:
 
         // Acquire a new unique postfix (if necessary) for this name to make it
         // unique
-        PostfixSet& postfixSet = found->second;
+        Postfixes& postfixes = found->second;
 
         ComplexName uniqueName(name);
 
-        std::string postfix = uniqueName.makePostfixUnique(postfixSet);
-        postfixSet.insert(postfix);
+        std::string postfix = uniqueName.makePostfixUnique(postfixes.used, postfixes.firstCandidate);
+        postfixes.used.insert(postfix);
 
         return uniqueName.getFullname();
     }
@@ -152,7 +174,7 @@ public:
         if (found != _names.end()) 
 		{
             // We know the name "trunk", does the number exist?
-            const PostfixSet& postfixSet = found->second;
+            const PostfixSet& postfixSet = found->second.used;
 
             // If we know the number too, the full name exists
             return postfixSet.find(name.getPostfix()) != postfixSet.end();
@@ -178,7 +200,10 @@ public:
             if (local != _names.end())
 			{
                 // Prefix exists, merge the postfixes
-                local->second.insert(i.second.begin(), i.second.end());
+                local->second.used.insert(i.second.used.begin(), i.second.used.end());
+
+                // All numbers below either of the two start values are taken in the union
+                local->second.firstCandidate = std::max(local->second.firstCandidate, i.second.firstCandidate);
             }
             else
 			{
@@ -187,4 +212,24 @@ public:
             }
         }
     }
+
+    /**
+     * Copies those names from the <other> UniqueNameSet into this one which
+     * are using one of the prefixes already present in this set. Names with
+     * other prefixes can't conflict with the names in this set, this is much
+     * cheaper than a full merge() if this set is small.
+     */
+    void mergeMatchingPrefixes(const UniqueNameSet& other)
+    {
+        for (auto& i : _names)
+        {
+            auto found = other._names.find(i.first);
+
+            if (found != other._names.end())
+            {
+                i.second.used.insert(found->second.used.begin(), found->second.used.end());
+                i.second.firstCandidate = std::max(i.second.firstCandidate, found->second.firstCandidate);
+            }
+        }
+    }
 };
@@ -26,14 +26,14 @@ StaticModelNode::~StaticModelNode()
 
 void StaticModelNode::onInsertIntoScene(scene::IMapRootNode& root)
 {
-    _model->connectUndoSystem(root.getUndoChangeTracker());
+    _model->connectUndoSystem(getChangeTracker(root));
     
     Node::onInsertIntoScene(root);
 }
 
 void StaticModelNode::onRemoveFromScene(scene::IMapRootNode& root)
 {
-    _model->disconnectUndoSystem(root.getUndoChangeTracker());
+    _model->disconnectUndoSystem(getChangeTracker(root));
 
     Node::onRemoveFromScene(root);
 }
@@ -90,6 +90,11 @@ bool StaticModelNode::intersectsLight(const RendererLight& light) const
     return light.lightAABB().intersects(worldAABB());
 }
 
+const AABB& StaticModelNode::litObjectAABB() const
+{
+    return worldAABB();
+}
+
 void StaticModelNode::renderSolid(RenderableCollector& collector, const VolumeTest& volume) const
 {
     assert(_renderEntity);
@@ -72,6 +72,7 @@ public:
 
 	// LitObject test function
 	bool intersectsLight(const RendererLight& light) const override;
+	const AABB& litObjectAABB() const override;
 
 	// Renderable implementation
   	void renderSolid(RenderableCollector& collector, const VolumeTest& volume) const override;
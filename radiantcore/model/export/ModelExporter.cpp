@@ -29,8 +29,6 @@ ArbitraryMeshVertex convertWindingVertex(const WindingVertex& in)
 	out.vertex = in.vertex;
 	out.normal = in.normal;
 	out.texcoord = in.texcoord;
-	out.bitangent = in.bitangent;
-	out.tangent = in.tangent;
 	out.colour.set(1.0, 1.0, 1.0);
 
 	return out;
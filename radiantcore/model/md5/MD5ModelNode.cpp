@@ -72,6 +72,11 @@ bool MD5ModelNode::intersectsLight(const RendererLight& light) const
     return light.lightAABB().intersects(worldAABB());
 }
 
+const AABB& MD5ModelNode::litObjectAABB() const
+{
+    return worldAABB();
+}
+
 void MD5ModelNode::renderSolid(RenderableCollector& collector, const VolumeTest& volume) const
 {
     assert(_renderEntity);
@@ -126,8 +126,35 @@ void ModuleRegistry::initialiseModuleRecursive(const std::string& name)
 		fmt::format(_("Initialising Module: {0}"), module->getName()),
 		_progress);
 
+	auto begin = std::chrono::steady_clock::now();
+
 	// Initialise the module itself, now that the dependencies are ready
 	module->initialiseModule(_context);
+
+	auto end = std::chrono::steady_clock::now();
+
+	_timeline.emplace_back(InitialisationRecord
+	{
+		name,
+		static_cast<std::size_t>(std::chrono::duration_cast<std::chrono::microseconds>(begin - _initialisationStart).count()),
+		static_cast<std::size_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count())
+	});
+}
+
+void ModuleRegistry::logTimeline()
+{
+	auto phaseDuration = std::chrono::steady_clock::now() - _initialisationStart;
+
+	rMessage() << "Module initialisation timeline (start, duration in ms):" << std::endl;
+
+	for (const auto& record : _timeline)
+	{
+		rMessage() << fmt::format("{0:>10.1f} {1:>10.1f}  {2}", record.beginUsec / 1000.0,
+			record.durationUsec / 1000.0, record.name) << std::endl;
+	}
+
+	rMessage() << fmt::format("Modules initialised in {0:.1f} ms",
+		std::chrono::duration_cast<std::chrono::microseconds>(phaseDuration).count() / 1000.0) << std::endl;
 }
 
 void ModuleRegistry::initialiseCoreModule()
@@ -171,6 +198,8 @@ void ModuleRegistry::loadAndInitialiseModules()
 	_progress = 0.1f;
 	_sigModuleInitialisationProgress.emit(_("Initialising Modules"), _progress);
 
+	_initialisationStart = std::chrono::steady_clock::now();
+
 	for (ModulesMap::iterator i = _uninitialisedModules.begin();
 		 i != _uninitialisedModules.end(); ++i)
 	{
@@ -179,6 +208,8 @@ void ModuleRegistry::loadAndInitialiseModules()
 		initialiseModuleRecursive(i->first);
 	}
 
+	logTimeline();
+
 	_uninitialisedModules.clear();
 
 	// Make sure this isn't called again
@@ -247,6 +278,11 @@ RegisterableModulePtr ModuleRegistry::getModule(const std::string& name) const {
 	return returnValue;
 }
 
+const ModuleRegistry::InitialisationTimeline& ModuleRegistry::getInitialisationTimeline() const
+{
+	return _timeline;
+}
+
 const IApplicationContext& ModuleRegistry::getApplicationContext() const
 {
 	return _context;
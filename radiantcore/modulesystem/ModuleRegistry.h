@@ -2,6 +2,7 @@
 
 #include <map>
 #include <list>
+#include <chrono>
 #include "imodule.h"
 
 namespace module 
@@ -31,6 +32,10 @@ private:
 	// After initialisiation, modules get enlisted here.
 	ModulesMap _initialisedModules;
 
+	// The initialiseModule() calls and their timing
+	InitialisationTimeline _timeline;
+	std::chrono::steady_clock::time_point _initialisationStart;
+
 	// Set to TRUE as soon as initialiseModules() is finished
 	bool _modulesInitialised;
 
@@ -61,6 +66,8 @@ public:
 	// Initialise all registered modules
     void loadAndInitialiseModules() override;
 
+    const InitialisationTimeline& getInitialisationTimeline() const override;
+
 	// Shutdown all modules
     void shutdownModules() override;
 
@@ -103,6 +110,9 @@ private:
 	// Initialises the module (including dependencies, recursively).
 	void initialiseModuleRecursive(const std::string& name);
 
+	// Writes the initialisation timeline to the log
+	void logTimeline();
+
 }; // class Registry
 
 } // namespace module
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "iparticlestage.h"
+
+#include "math/Vector3.h"
+#include "math/Vector4.h"
+
+namespace particles
+{
+
+/**
+ * \brief
+ * Flat copy of the values of an IStageDef, as needed to generate the particle geometry.
+ *
+ * The particle bunches evaluate the stage settings for every particle in every frame,
+ * reading them from this plain structure avoids the virtual getter calls in the inner
+ * loops. It also allows the bunches to be updated in worker threads, since the
+ * compiled stage doesn't change while the geometry is generated.
+ *
+ * All values are copied without conversion, such that the generated geometry
+ * is the same as if they were read from the stage def.
+ */
+struct CompiledStage
+{
+	// Replacement for IParticleParameter
+	struct Parameter
+	{
+		float from;
+		float to;
+
+		float evaluate(float fraction) const
+		{
+			return from + fraction * (to - from);
+		}
+	};
+
+	int count;
+	float duration;
+	int cycleMsec;
+	float cycles;
+	float bunching;
+	float timeOffset;
+
+	Vector4 colour;
+	Vector4 fadeColour;
+
+	float fadeInFraction;
+	float fadeOutFraction;
+	float fadeIndexFraction;
+
+	int animationFrames;
+	float animationRate;
+
+	float initialAngle;
+
+	bool randomDistribution;
+	bool useEntityColour;
+
+	float gravity;
+	bool worldGravity;
+
+	Vector3 offset;
+
+	IStageDef::OrientationType orientationType;
+	float orientationParms[4];
+
+	IStageDef::DistributionType distributionType;
+	float distributionParms[4];
+
+	IStageDef::DirectionType directionType;
+	float directionParms[4];
+
+	IStageDef::CustomPathType customPathType;
+	float customPathParms[8];
+
+	Parameter size;
+	Parameter aspect;
+	Parameter speed;
+	Parameter rotationSpeed;
+
+	CompiledStage()
+	{}
+
+	CompiledStage(const IStageDef& stage)
+	{
+		compile(stage);
+	}
+
+	// Copy the current values of the given stage
+	void compile(const IStageDef& stage)
+	{
+		count = stage.getCount();
+		duration = stage.getDuration();
+		cycleMsec = stage.getCycleMsec();
+		cycles = stage.getCycles();
+		bunching = stage.getBunching();
+		timeOffset = stage.getTimeOffset();
+
+		colour = stage.getColour();
+		fadeColour = stage.getFadeColour();
+
+		fadeInFraction = stage.getFadeInFraction();
+		fadeOutFraction = stage.getFadeOutFraction();
+		fadeIndexFraction = stage.getFadeIndexFraction();
+
+		animationFrames = stage.getAnimationFrames();
+		animationRate = stage.getAnimationRate();
+
+		initialAngle = stage.getInitialAngle();
+
+		randomDistribution = stage.getRandomDistribution();
+		useEntityColour = stage.getUseEntityColour();
+
+		gravity = stage.getGravity();
+		worldGravity = stage.getWorldGravityFlag();
+
+		offset = stage.getOffset();
+
+		orientationType = stage.getOrientationType();
+		distributionType = stage.getDistributionType();
+		directionType = stage.getDirectionType();
+		customPathType = stage.getCustomPathType();
+
+		for (int i = 0; i < 4; ++i)
+		{
+			orientationParms[i] = stage.getOrientationParm(i);
+			distributionParms[i] = stage.getDistributionParm(i);
+			directionParms[i] = stage.getDirectionParm(i);
+		}
+
+		for (int i = 0; i < 8; ++i)
+		{
+			customPathParms[i] = stage.getCustomPathParm(i);
+		}
+
+		size = compileParameter(stage.getSize());
+		aspect = compileParameter(stage.getAspect());
+		speed = compileParameter(stage.getSpeed());
+		rotationSpeed = compileParameter(stage.getRotationSpeed());
+	}
+
+private:
+	static Parameter compileParameter(const IParticleParameter& param)
+	{
+		return Parameter{ param.getFrom(), param.getTo() };
+	}
+};
+
+} // namespace
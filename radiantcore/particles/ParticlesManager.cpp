@@ -12,6 +12,7 @@
 #include "ifiletypes.h"
 #include "iarchive.h"
 #include "igame.h"
+#include "iprofiler.h"
 #include "i18n.h"
 
 #include "parser/DefTokeniser.h"
@@ -224,6 +225,7 @@ const StringSet& ParticlesManager::getDependencies() const
 		_dependencies.insert(MODULE_VIRTUALFILESYSTEM);
 		_dependencies.insert(MODULE_COMMANDSYSTEM);
 		_dependencies.insert(MODULE_FILETYPES);
+		_dependencies.insert(MODULE_PROFILER);
 	}
 
 	return _dependencies;
@@ -246,6 +248,8 @@ void ParticlesManager::initialiseModule(const IApplicationContext& ctx)
 
 void ParticlesManager::reloadParticleDefs()
 {
+	profiling::ScopedZone zone("Particle defs parsing");
+
 	ScopedDebugTimer timer("Particle definitions parsed: ");
 
     GlobalFileSystem().forEachFile(
@@ -1,8 +1,19 @@
 #include "RenderableParticle.h"
 
+#include <thread>
+#include <future>
+#include <atomic>
+#include <algorithm>
+
 namespace particles
 {
 
+namespace
+{
+	// The number of visible particles above which the stages are updated in parallel
+	const std::size_t MIN_PARTICLES_PER_BATCH = 2048;
+}
+
 RenderableParticle::RenderableParticle(const IParticleDefPtr& particleDef) :
 	_particleDef(), // don't initialise the ptr yet
 	_random(rand()), // use a random seed
@@ -38,15 +49,61 @@ void RenderableParticle::update(const Matrix4& viewRotation)
 	// the camera rotation.
 	Matrix4 invViewRotation = viewRotation.getInverse();
 
-	// Traverse the stages and call update
+	// Traverse the stages and set up the bunches visible at this time
+	std::vector<RenderableParticleStage*> stages;
+	std::size_t numParticles = 0;
+
 	for (ShaderMap::const_iterator i = _shaderMap.begin(); i != _shaderMap.end(); ++i)
 	{
 		for (RenderableParticleStageList::const_iterator stage = i->second.stages.begin();
 			 stage != i->second.stages.end(); ++stage)
 		{
-			(*stage)->update(time, invViewRotation);
+			(*stage)->prepareBunches(time, invViewRotation);
+
+			stages.push_back(stage->get());
+			numParticles += (*stage)->getNumActiveParticles();
 		}
 	}
+
+	updateStages(stages, numParticles);
+}
+
+void RenderableParticle::updateStages(const std::vector<RenderableParticleStage*>& stages, std::size_t numParticles)
+{
+	auto numWorkers = std::min<std::size_t>(
+		std::max(std::thread::hardware_concurrency(), 1u), stages.size());
+
+	// Small systems are not worth the thread overhead
+	if (numWorkers < 2 || numParticles < MIN_PARTICLES_PER_BATCH)
+	{
+		for (auto stage : stages)
+		{
+			stage->updateBunches();
+		}
+
+		return;
+	}
+
+	// Each bunch is re-seeding its own random number generator and writes
+	// to its own quad buffer, the stages can be processed in any order
+	std::atomic<std::size_t> next(0);
+	std::vector<std::future<void>> workers;
+
+	for (std::size_t i = 0; i < numWorkers; ++i)
+	{
+		workers.emplace_back(std::async(std::launch::async, [&]()
+		{
+			for (auto index = next++; index < stages.size(); index = next++)
+			{
+				stages[index]->updateBunches();
+			}
+		}));
+	}
+
+	for (auto& worker : workers)
+	{
+		worker.get();
+	}
 }
 
 // Front-end render methods
@@ -159,6 +216,25 @@ void RenderableParticle::calculateBounds()
 	}
 }
 
+void RenderableParticle::setRandomSeed(unsigned int seed)
+{
+	_random.seed(seed);
+
+	// The stages draw their bunch seeds from the generator
+	setupStages();
+}
+
+void RenderableParticle::foreachVertex(const VertexVisitor& visitor) const
+{
+	for (const ShaderMap::value_type& pair : _shaderMap)
+	{
+		for (const RenderableParticleStagePtr& stage : pair.second.stages)
+		{
+			stage->foreachVertex(visitor);
+		}
+	}
+}
+
 // Sort stages into groups sharing a material, without capturing the shader yet
 void RenderableParticle::setupStages()
 {
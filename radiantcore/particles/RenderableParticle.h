@@ -87,9 +87,15 @@ public:
 	// Updates bounds from stages and returns the value
 	const AABB& getBounds() override;
 
+	void setRandomSeed(unsigned int seed) override;
+	void foreachVertex(const VertexVisitor& visitor) const override;
+
 private:
 	void calculateBounds();
 
+	// Generates the geometry of the given (prepared) stages, in parallel if worthwhile
+	void updateStages(const std::vector<RenderableParticleStage*>& stages, std::size_t numParticles);
+
 	// Sort stages into groups sharing a material, without capturing the shader yet
 	void setupStages();
 
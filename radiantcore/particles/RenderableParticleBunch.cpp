@@ -9,14 +9,12 @@ namespace particles
 {
 
 RenderableParticleBunch::RenderableParticleBunch(std::size_t index,
-	Rand48::result_type randSeed, const IStageDef& stage, const Matrix4& viewRotation,
+	Rand48::result_type randSeed, const CompiledStage& stage, const Matrix4& viewRotation,
     const Vector3& direction, const Vector3& entityColour) :
     _index(index),
     _stage(stage),
     _quads(),
     _randSeed(randSeed),
-    _distributeParticlesRandomly(_stage.getRandomDistribution()),
-    _offset(_stage.getOffset()),
     _viewRotation(viewRotation),
     _direction(direction),
     _entityColour(entityColour)
@@ -30,7 +28,7 @@ void RenderableParticleBunch::update(std::size_t time)
     _quads.clear();
 
     // Length of one cycle (duration + deadtime)
-    std::size_t cycleMsec = static_cast<std::size_t>(_stage.getCycleMsec());
+    std::size_t cycleMsec = static_cast<std::size_t>(_stage.cycleMsec);
 
     if (cycleMsec == 0)
     {
@@ -38,7 +36,7 @@ void RenderableParticleBunch::update(std::size_t time)
     }
 
     // Reserve enough space for all the particles (non-animated case)
-    _quads.reserve(_stage.getCount() * 4);
+    _quads.reserve(_stage.count * 4);
 
     // Normalise the global input time into local cycle time
     // The cycleTime may be larger than the _stage.cycleMsec argument if bunching is turned off
@@ -47,18 +45,29 @@ void RenderableParticleBunch::update(std::size_t time)
     // Reset the random number generator using our stored seed
     _random.seed(_randSeed);
 
+    // Check if the main direction is different to the z axis
+    Vector3 dir = _direction.getNormalised();
+    Vector3 zDir(0,0,1);
+
+    double deviation = dir.angle(zDir);
+
+    _directionRotation = deviation != 0 ? Matrix4::getRotation(zDir, dir) : Matrix4::getIdentity();
+
+    // if "world" is set, use -z as gravity direction, otherwise use the reverse emitter direction
+    _gravityDirection = _stage.worldGravity ? Vector3(0,0,-1) : -dir;
+
     // Calculate the time between each particle spawn
     // When bunching is set to 1 the spacing is 0, and vice versa.
-    std::size_t stageDurationMsec = static_cast<std::size_t>(SEC2MS(_stage.getDuration()));
+    std::size_t stageDurationMsec = static_cast<std::size_t>(SEC2MS(_stage.duration));
 
-    float spawnSpacing = _stage.getBunching() * static_cast<float>(stageDurationMsec) / _stage.getCount();
+    float spawnSpacing = _stage.bunching * static_cast<float>(stageDurationMsec) / _stage.count;
 
     // This is the spacing between each particle
     std::size_t spawnSpacingMsec = static_cast<std::size_t>(spawnSpacing);
 
     // Generate all particle quads, regardless of their visibility
     // Visibility is considered by not rendering particles that haven't been spawned yet
-    for (std::size_t i = 0; i < static_cast<std::size_t>(_stage.getCount()); ++i)
+    for (std::size_t i = 0; i < static_cast<std::size_t>(_stage.count); ++i)
     {
         // Consider bunching parameter
         std::size_t particleStartTimeMsec = i * spawnSpacingMsec;
@@ -87,7 +96,7 @@ void RenderableParticleBunch::update(std::size_t time)
         calculateOrigin(particle);
 
         // Get the initial angle value
-        particle.angle = _stage.getInitialAngle();
+        particle.angle = _stage.initialAngle;
 
         if (particle.angle == 0)
         {
@@ -109,19 +118,19 @@ void RenderableParticleBunch::update(std::size_t time)
         // Calculate the time-dependent angle
         // according to docs, half the quads have negative rotation speed
         int rotFactor = i % 2 == 0 ? -1 : 1;
-        particle.angle += rotFactor * integrate(_stage.getRotationSpeed(), particle.timeSecs);
+        particle.angle += rotFactor * integrate(_stage.rotationSpeed, particle.timeSecs);
 
         // Calculate render colour for this particle
         calculateColour(particle);
 
         // Consider quad size
-        particle.size = _stage.getSize().evaluate(particle.timeFraction);
+        particle.size = _stage.size.evaluate(particle.timeFraction);
 
         // Consider aspect ratio
-        particle.aspect = _stage.getAspect().evaluate(particle.timeFraction);
+        particle.aspect = _stage.aspect.evaluate(particle.timeFraction);
 
         // Consider animation frames
-        particle.animFrames = static_cast<std::size_t>(_stage.getAnimationFrames());
+        particle.animFrames = static_cast<std::size_t>(_stage.animationFrames);
 
         if (particle.animFrames > 0)
         {
@@ -130,7 +139,7 @@ void RenderableParticleBunch::update(std::size_t time)
         }
 
         // For aimed orientation, we need to override particle height and aspect
-        if (_stage.getOrientationType() == IStageDef::ORIENTATION_AIMED)
+        if (_stage.orientationType == IStageDef::ORIENTATION_AIMED)
         {
             pushAimedParticles(particle, stageDurationMsec);
         }
@@ -169,6 +178,17 @@ void RenderableParticleBunch::render(const RenderInfo& info) const
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 }
 
+void RenderableParticleBunch::foreachVertex(const IRenderableParticle::VertexVisitor& visitor) const
+{
+    for (const ParticleQuad& quad : _quads)
+    {
+        for (const ParticleQuad::Vertex& vertex : quad.verts)
+        {
+            visitor(vertex.vertex, vertex.texcoord, vertex.colour);
+        }
+    }
+}
+
 const AABB& RenderableParticleBunch::getBounds()
 {
     if (!_bounds.isValid())
@@ -218,10 +238,10 @@ Matrix4 RenderableParticleBunch::getAimedMatrix(const Vector3& particleVelocity)
 void RenderableParticleBunch::calculateAnim(ParticleRenderInfo& particle)
 {
     // At a given time, two particles can be visible at most
-    float frameRate = _stage.getAnimationRate();
+    float frameRate = _stage.animationRate;
 
     // The time interval for cross-fading, fall back to entire duration * 3 for zero animation rates
-    float frameIntervalSecs = frameRate > 0 ? 1.0f / frameRate : 3 * _stage.getDuration();
+    float frameIntervalSecs = frameRate > 0 ? 1.0f / frameRate : 3 * _stage.duration;
 
     // Calculate the current frame number, wrap around
     particle.curFrame = static_cast<std::size_t>(floor(particle.timeSecs / frameIntervalSecs)) % particle.animFrames;
@@ -246,14 +266,14 @@ void RenderableParticleBunch::calculateAnim(ParticleRenderInfo& particle)
 
 void RenderableParticleBunch::calculateColour(ParticleRenderInfo& particle)
 {
-    Vector4 mainColour = !_stage.getUseEntityColour() ?
-        _stage.getColour() : Vector4(_entityColour.x(), _entityColour.y(), _entityColour.z(), 1);
+    Vector4 mainColour = !_stage.useEntityColour ?
+        _stage.colour : Vector4(_entityColour.x(), _entityColour.y(), _entityColour.z(), 1);
 
     // We start with the stage's standard colour
     particle.colour = mainColour;
 
     // Consider fade index fraction, which can spawn particles already faded to some extent
-    float fadeIndexFraction = _stage.getFadeIndexFraction();
+    float fadeIndexFraction = _stage.fadeIndexFraction;
 
     if (fadeIndexFraction > 0)
     {
@@ -263,7 +283,7 @@ void RenderableParticleBunch::calculateColour(ParticleRenderInfo& particle)
 
         // Use the particle index as "time", normalised to [0..1]
         // such that particle with higher index start more faded
-        float pIdx = static_cast<float>(particle.index) / _stage.getCount();
+        float pIdx = static_cast<float>(particle.index) / _stage.count;
 
         // Calculate how much we should be faded already
         float startFrac = 1.0f - fadeIndexFraction;
@@ -273,54 +293,46 @@ void RenderableParticleBunch::calculateColour(ParticleRenderInfo& particle)
         // those particles with time >= fadeIndexFraction get faded.
         if (frac > 0)
         {
-            particle.colour = lerpColour(particle.colour, _stage.getFadeColour(), frac);
+            particle.colour = lerpColour(particle.colour, _stage.fadeColour, frac);
         }
     }
 
-    float fadeInFraction = _stage.getFadeInFraction();
+    float fadeInFraction = _stage.fadeInFraction;
 
     if (fadeInFraction > 0 && particle.timeFraction <= fadeInFraction)
     {
-        particle.colour = lerpColour(_stage.getFadeColour(), mainColour, particle.timeFraction / fadeInFraction);
+        particle.colour = lerpColour(_stage.fadeColour, mainColour, particle.timeFraction / fadeInFraction);
     }
 
-    float fadeOutFraction = _stage.getFadeOutFraction();
+    float fadeOutFraction = _stage.fadeOutFraction;
     float fadeOutFractionInverse = 1.0f - fadeOutFraction;
 
     if (fadeOutFraction > 0 && particle.timeFraction >= fadeOutFractionInverse)
     {
-        particle.colour = lerpColour(mainColour, _stage.getFadeColour(), (particle.timeFraction - fadeOutFractionInverse) / fadeOutFraction);
+        particle.colour = lerpColour(mainColour, _stage.fadeColour, (particle.timeFraction - fadeOutFractionInverse) / fadeOutFraction);
     }
 }
 
 void RenderableParticleBunch::calculateOrigin(ParticleRenderInfo& particle)
 {
-    // Check if the main direction is different to the z axis
-    Vector3 dir = _direction.getNormalised();
-    Vector3 zDir(0,0,1);
-
-    double deviation = dir.angle(zDir);
-
-    Matrix4 rotation = deviation != 0 ? Matrix4::getRotation(zDir, dir) : Matrix4::getIdentity();
-
     // Consider offset as starting point
-    particle.origin = rotation.transformPoint(_offset);
+    particle.origin = _directionRotation.transformPoint(_stage.offset);
 
-    switch (_stage.getCustomPathType())
+    switch (_stage.customPathType)
     {
     case IStageDef::PATH_STANDARD: // Standard path calculation
         {
             // Consider particle distribution
-            Vector3 distributionOffset = getDistributionOffset(particle, _distributeParticlesRandomly);
+            Vector3 distributionOffset = getDistributionOffset(particle);
 
             // Add this to the origin
             particle.origin += distributionOffset;
 
             // Calculate particle direction, pass distribution offset (this is needed for DIRECTION_OUTWARD)
-            Vector3 particleDirection = getDirection(particle, rotation, distributionOffset);
+            Vector3 particleDirection = getDirection(particle, _directionRotation, distributionOffset);
 
             // Consider speed
-            particle.origin += particleDirection * integrate(_stage.getSpeed(), particle.timeSecs);
+            particle.origin += particleDirection * integrate(_stage.speed, particle.timeSecs);
         }
         break;
 
@@ -333,18 +345,18 @@ void RenderableParticleBunch::calculateOrigin(ParticleRenderInfo& particle)
             // instead the particles seem to bunch themselves at the poles).
 
             // Sphere radius
-            float radius = _stage.getCustomPathParm(2);
+            float radius = _stage.customPathParms[2];
 
             // Generate starting conditions speed (+/-50%)
             float rand = 2 * particle.rand[0] - 1.0f;
             float radialSpeedFactor = 1.0f + 0.5f * rand * rand;
 
             // greebo: factor 0.4 is empirical, I measured a few D3 particles for their circulation times
-            float radialSpeed = _stage.getCustomPathParm(0) * radialSpeedFactor * 0.4f;
+            float radialSpeed = _stage.customPathParms[0] * radialSpeedFactor * 0.4f;
 
             rand = 2 * particle.rand[1] - 1.0f;
             float axialSpeedFactor = 1.0f + 0.5f * rand * rand;
-            float axialSpeed = _stage.getCustomPathParm(1) * axialSpeedFactor * 0.4f;
+            float axialSpeed = _stage.customPathParms[1] * axialSpeedFactor * 0.4f;
 
             float phi0 = 2 * static_cast<float>(math::PI) * particle.rand[2];
             float theta0 = static_cast<float>(math::PI) * particle.rand[3];
@@ -371,12 +383,12 @@ void RenderableParticleBunch::calculateOrigin(ParticleRenderInfo& particle)
             // their velocities (radial and axial) are also random (both negative and positive
             // velocities are allowed).
 
-            float sizeX = _stage.getCustomPathParm(0);
-            float sizeY = _stage.getCustomPathParm(1);
-            float sizeZ = _stage.getCustomPathParm(2);
+            float sizeX = _stage.customPathParms[0];
+            float sizeY = _stage.customPathParms[1];
+            float sizeZ = _stage.customPathParms[2];
 
-            float radialSpeed = _stage.getCustomPathParm(3) * (2 * particle.rand[0] - 1.0f);
-            float axialSpeed = _stage.getCustomPathParm(4) * (2 * particle.rand[1] - 1.0f);
+            float radialSpeed = _stage.customPathParms[3] * (2 * particle.rand[0] - 1.0f);
+            float axialSpeed = _stage.customPathParms[4] * (2 * particle.rand[1] - 1.0f);
 
             float phi0 = 2 * static_cast<float>(math::PI) * particle.rand[2];
             float z0 = sizeZ * (2 * particle.rand[3] - 1.0f);
@@ -404,15 +416,12 @@ void RenderableParticleBunch::calculateOrigin(ParticleRenderInfo& particle)
     };
 
     // Consider gravity
-    // if "world" is set, use -z as gravity direction, otherwise use the reverse emitter direction
-    Vector3 gravity = _stage.getWorldGravityFlag() ? Vector3(0,0,-1) : -_direction.getNormalised();
-
-    particle.origin += gravity * _stage.getGravity() * particle.timeSecs * particle.timeSecs * 0.5f;
+    particle.origin += _gravityDirection * _stage.gravity * particle.timeSecs * particle.timeSecs * 0.5f;
 }
 
 Vector3 RenderableParticleBunch::getDirection(ParticleRenderInfo& particle, const Matrix4& rotation, const Vector3& distributionOffset)
 {
-    switch (_stage.getDirectionType())
+    switch (_stage.directionType)
     {
     case IStageDef::DIRECTION_CONE:
         {
@@ -420,7 +429,7 @@ Vector3 RenderableParticleBunch::getDirection(ParticleRenderInfo& particle, cons
             float u = particle.rand[3];
 
             // Scale the variable v such that it takes uniform values in the interval [(1+cos(angle))/2 .. 1]
-            float angleRad = _stage.getDirectionParm(0) * static_cast<float>(math::PI) / 180.0f;
+            float angleRad = _stage.directionParms[0] * static_cast<float>(math::PI) / 180.0f;
             float v0 = (1 + cos(angleRad)) * 0.5f;
             float v1 = 1;
 
@@ -442,7 +451,7 @@ Vector3 RenderableParticleBunch::getDirection(ParticleRenderInfo& particle, cons
             Vector3 direction = distributionOffset.getNormalised();
 
             // Consider upwards bias
-            direction.z() += _stage.getDirectionParm(0);
+            direction.z() += _stage.directionParms[0];
 
             return direction; // CHECKME: Use .getNormalised() ?
         }
@@ -451,9 +460,11 @@ Vector3 RenderableParticleBunch::getDirection(ParticleRenderInfo& particle, cons
     };
 }
 
-Vector3 RenderableParticleBunch::getDistributionOffset(ParticleRenderInfo& particle, bool distributeParticlesRandomly)
+Vector3 RenderableParticleBunch::getDistributionOffset(ParticleRenderInfo& particle)
 {
-    switch (_stage.getDistributionType())
+    bool distributeParticlesRandomly = _stage.randomDistribution;
+
+    switch (_stage.distributionType)
     {
         // Rectangular distribution
         case IStageDef::DISTRIBUTION_RECT:
@@ -473,18 +484,18 @@ Vector3 RenderableParticleBunch::getDistributionOffset(ParticleRenderInfo& parti
 
             // If random distribution is off, particles get spawned at <sizex, sizey, sizez>
 
-            return Vector3(randX * _stage.getDistributionParm(0),
-                           randY * _stage.getDistributionParm(1),
-                           randZ * _stage.getDistributionParm(2));
+            return Vector3(randX * _stage.distributionParms[0],
+                           randY * _stage.distributionParms[1],
+                           randZ * _stage.distributionParms[2]);
         }
 
         case IStageDef::DISTRIBUTION_CYLINDER:
         {
             // Get the cylinder dimensions
-            float sizeX = _stage.getDistributionParm(0);
-            float sizeY = _stage.getDistributionParm(1);
-            float sizeZ = _stage.getDistributionParm(2);
-            float ringFrac = _stage.getDistributionParm(3);
+            float sizeX = _stage.distributionParms[0];
+            float sizeY = _stage.distributionParms[1];
+            float sizeZ = _stage.distributionParms[2];
+            float ringFrac = _stage.distributionParms[3];
 
             // greebo: Some tests showed that for the cylinder type
             // the fourth parameter ("ringfraction") is only effective if >1,
@@ -518,10 +529,10 @@ Vector3 RenderableParticleBunch::getDistributionOffset(ParticleRenderInfo& parti
         case IStageDef::DISTRIBUTION_SPHERE:
         {
             // Get the sphere dimensions
-            float maxX = _stage.getDistributionParm(0);
-            float maxY = _stage.getDistributionParm(1);
-            float maxZ = _stage.getDistributionParm(2);
-            float ringFrac = _stage.getDistributionParm(3);
+            float maxX = _stage.distributionParms[0];
+            float maxY = _stage.distributionParms[1];
+            float maxZ = _stage.distributionParms[2];
+            float ringFrac = _stage.distributionParms[3];
 
             float minX = maxX * ringFrac;
             float minY = maxY * ringFrac;
@@ -572,8 +583,8 @@ void RenderableParticleBunch::pushQuad(ParticleRenderInfo& particle, const Vecto
 
 void RenderableParticleBunch::pushAimedParticles(ParticleRenderInfo& particle, std::size_t stageDurationMsec)
 {
-    int trails = static_cast<int>(_stage.getOrientationParm(0)); // trails
-    float aimedTime = _stage.getOrientationParm(1); // time
+    int trails = static_cast<int>(_stage.orientationParms[0]); // trails
+    float aimedTime = _stage.orientationParms[1]; // time
 
     if (trails < 0)
     {
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "irender.h"
-#include "iparticlestage.h"
+#include "iparticles.h"
 
 #include "math/AABB.h"
 #include "math/Vector2.h"
@@ -10,6 +10,7 @@
 
 #include "ParticleQuad.h"
 #include "ParticleRenderInfo.h"
+#include "CompiledStage.h"
 
 namespace particles
 {
@@ -24,8 +25,8 @@ class RenderableParticleBunch : public OpenGLRenderable
 	// The bunch index
 	std::size_t _index;
 
-	// The stage this bunch is part of
-	const IStageDef& _stage;
+	// The stage this bunch is part of (instance owned by RenderableParticleStage)
+	const CompiledStage& _stage;
 
 	// The quads of this particle bunch
 	typedef std::vector<ParticleQuad> Quads;
@@ -37,18 +38,17 @@ class RenderableParticleBunch : public OpenGLRenderable
 	// The randomiser itself, which is reset everytime we rebuild the geometry
 	Rand48 _random;
 
-	// The flag whether to spawn particles at random locations (standard path calculation)
-	bool _distributeParticlesRandomly;
-
-	// Stage-specific offset
-	const Vector3& _offset;
-
 	// The matrix to orient quads (owned by the RenderableParticleStage)
 	const Matrix4& _viewRotation;
 
 	// The particle direction (instance owned by RenderableParticle)
 	const Vector3& _direction;
 
+	// Rotating the z axis into the particle direction, and the gravity direction,
+	// both derived from _direction at the beginning of each update
+	Matrix4 _directionRotation;
+	Vector3 _gravityDirection;
+
 	// The bounds of this quad group, calculated on demand
 	AABB _bounds;
 
@@ -59,7 +59,7 @@ public:
 	// Each bunch has a defined zero-based index
 	RenderableParticleBunch(std::size_t index,
 							Rand48::result_type randSeed,
-							const IStageDef& stage,
+							const CompiledStage& stage,
 							const Matrix4& viewRotation,
 							const Vector3& direction,
 							const Vector3& entityColour);
@@ -77,11 +77,14 @@ public:
 
 	const AABB& getBounds();
 
+	// Visits the vertices of all quads
+	void foreachVertex(const IRenderableParticle::VertexVisitor& visitor) const;
+
 private:
 	// Time is measured in seconds!
-	float integrate(const IParticleParameter& param, float time)
+	float integrate(const CompiledStage::Parameter& param, float time)
 	{
-		return (param.getTo() - param.getFrom()) / _stage.getDuration() * time*time * 0.5f + param.getFrom() * time;
+		return (param.to - param.from) / _stage.duration * time*time * 0.5f + param.from * time;
 	}
 
 	Vector4 lerpColour(const Vector4& startColour, const Vector4& endColour, float fraction)
@@ -100,7 +103,7 @@ private:
 	// The rotation is used to deviate the offsets should be normalised and not degenerate
 	Vector3 getDirection(ParticleRenderInfo& particle, const Matrix4& rotation, const Vector3& distributionOffset);
 
-	Vector3 getDistributionOffset(ParticleRenderInfo& particle, bool distributeParticlesRandomly);
+	Vector3 getDistributionOffset(ParticleRenderInfo& particle);
 
 	// Calculates the matrix which rotates faces towards the viewer (used for "aimed" orientation)
 	Matrix4 getAimedMatrix(const Vector3& particleVelocity);
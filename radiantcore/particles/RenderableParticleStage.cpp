@@ -9,6 +9,8 @@ RenderableParticleStage::RenderableParticleStage(
 		const Vector3& direction,
 		const Vector3& entityColour) :
 	_stageDef(stage),
+	_stage(stage),
+	_localTimeMsec(0),
 	_numSeeds(32),
 	_seeds(_numSeeds),
 	_bunches(2), // two bunches
@@ -40,12 +42,21 @@ void RenderableParticleStage::render(const RenderInfo& info) const
 
 // Generate particle geometry, time is absolute in msecs
 void RenderableParticleStage::update(std::size_t time, const Matrix4& viewRotation)
+{
+	prepareBunches(time, viewRotation);
+	updateBunches();
+}
+
+void RenderableParticleStage::prepareBunches(std::size_t time, const Matrix4& viewRotation)
 {
 	// Invalidate our bounds information
 	_bounds = AABB();
 
+	// Pick up any changes made to the stage def
+	_stage.compile(_stageDef);
+
 	// Check time offset (msecs)
-	std::size_t timeOffset = static_cast<std::size_t>(SEC2MS(_stageDef.getTimeOffset()));
+	std::size_t timeOffset = static_cast<std::size_t>(SEC2MS(_stage.timeOffset));
 
 	if (time < timeOffset)
 	{
@@ -58,29 +69,38 @@ void RenderableParticleStage::update(std::size_t time, const Matrix4& viewRotati
 	// Time >= timeOffset at this point
 
 	// Get rid of the time offset
-	std::size_t localtimeMsec = time - timeOffset;
+	_localTimeMsec = time - timeOffset;
 
 	// Consider stage orientation (x,y,z,view,aimed)
 	calculateStageViewRotation(viewRotation);
 
 	// Make sure the correct bunches are allocated for this stage time
-	ensureBunches(localtimeMsec);
+	ensureBunches(_localTimeMsec);
+}
 
+void RenderableParticleStage::updateBunches()
+{
 	// The 0 bunch is the active one, the 1 bunch is the previous one if not null
 
 	// Tell the particle batches to update their geometry
 	if (_bunches[0] != NULL)
 	{
-		// Get one of our seed values
-		_bunches[0]->update(localtimeMsec);
+		_bunches[0]->update(_localTimeMsec);
 	}
 
 	if (_bunches[1] != NULL)
 	{
-		_bunches[1]->update(localtimeMsec);
+		_bunches[1]->update(_localTimeMsec);
 	}
 }
 
+std::size_t RenderableParticleStage::getNumActiveParticles() const
+{
+	std::size_t numBunches = (_bunches[0] ? 1 : 0) + (_bunches[1] ? 1 : 0);
+
+	return _stage.count > 0 ? numBunches * static_cast<std::size_t>(_stage.count) : 0;
+}
+
 const AABB& RenderableParticleStage::getBounds()
 {
 	if (!_bounds.isValid())
@@ -91,6 +111,19 @@ const AABB& RenderableParticleStage::getBounds()
 	return _bounds;
 }
 
+void RenderableParticleStage::foreachVertex(const IRenderableParticle::VertexVisitor& visitor) const
+{
+	if (_bunches[0])
+	{
+		_bunches[0]->foreachVertex(visitor);
+	}
+
+	if (_bunches[1])
+	{
+		_bunches[1]->foreachVertex(visitor);
+	}
+}
+
 const IStageDef& RenderableParticleStage::getDef() const
 {
 	return _stageDef;
@@ -98,7 +131,7 @@ const IStageDef& RenderableParticleStage::getDef() const
 
 void RenderableParticleStage::calculateStageViewRotation(const Matrix4& viewRotation)
 {
-	switch (_stageDef.getOrientationType())
+	switch (_stage.orientationType)
 	{
 	case IStageDef::ORIENTATION_AIMED:
 		_viewRotation = viewRotation;
@@ -136,7 +169,7 @@ void RenderableParticleStage::calculateStageViewRotation(const Matrix4& viewRota
 void RenderableParticleStage::ensureBunches(std::size_t localTimeMSec)
 {
 	// Check which bunches is active at this time
-	float cycleFrac = floor(static_cast<float>(localTimeMSec) / _stageDef.getCycleMsec());
+	float cycleFrac = floor(static_cast<float>(localTimeMSec) / _stage.cycleMsec);
 
 	std::size_t curCycleIndex = static_cast<std::size_t>(cycleFrac);
 
@@ -162,7 +195,7 @@ void RenderableParticleStage::ensureBunches(std::size_t localTimeMSec)
 		RenderableParticleBunchPtr cur = getExistingBunchByIndex(curCycleIndex);
 		RenderableParticleBunchPtr prev = getExistingBunchByIndex(prevCycleIndex);
 
-		std::size_t numCycles = static_cast<std::size_t>(_stageDef.getCycles());
+		std::size_t numCycles = static_cast<std::size_t>(_stage.cycles);
 
 		if (numCycles > 0 && curCycleIndex > numCycles)
 		{
@@ -197,7 +230,7 @@ void RenderableParticleStage::ensureBunches(std::size_t localTimeMSec)
 RenderableParticleBunchPtr RenderableParticleStage::createBunch(std::size_t cycleIndex)
 {
 	return RenderableParticleBunchPtr(new RenderableParticleBunch(
-		cycleIndex, getSeed(cycleIndex), _stageDef, _viewRotation, _direction, _entityColour));
+		cycleIndex, getSeed(cycleIndex), _stage, _viewRotation, _direction, _entityColour));
 }
 
 Rand48::result_type RenderableParticleStage::getSeed(std::size_t cycleIndex)
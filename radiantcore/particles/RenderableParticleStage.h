@@ -21,6 +21,13 @@ class RenderableParticleStage :
 	// The stage def we're rendering
 	const IStageDef& _stageDef;
 
+	// The values of the stage def, copied at the beginning of each update.
+	// The bunches are referencing this instance.
+	CompiledStage _stage;
+
+	// The stage time of the last update, without the time offset
+	std::size_t _localTimeMsec;
+
 	// We use these values as seeds whenever we instantiate a new bunch of particles
 	// each bunch has a distinct index and is using the same seed during the lifetime
 	// of this particle stage
@@ -52,8 +59,20 @@ public:
 	// Generate particle geometry, time is absolute in msecs
 	void update(std::size_t time, const Matrix4& viewRotation);
 
+	// Split version of update(): prepareBunches() compiles the stage def and sets up
+	// the bunches active at the given time, updateBunches() generates their geometry.
+	// updateBunches() doesn't access the stage def, it can be called in a worker thread.
+	void prepareBunches(std::size_t time, const Matrix4& viewRotation);
+	void updateBunches();
+
+	// The number of particles of the active bunches
+	std::size_t getNumActiveParticles() const;
+
 	const AABB& getBounds();
 
+	// Visits the vertices of the active bunches
+	void foreachVertex(const IRenderableParticle::VertexVisitor& visitor) const;
+
     /// Return the stage definition associated with this renderable
 	const IStageDef& getDef() const;
 
@@ -195,8 +195,9 @@ void Patch::renderWireframe(RenderableCollector& collector, const VolumeTest& vo
     // Defer the tesselation calculation to the last minute
     const_cast<Patch&>(*this).updateTesselation();
 
-    collector.addRenderable(*entity.getWireShader(),
-        _patchDef3 ? _fixedWireframeRenderable : _wireframeRenderable, localToWorld);
+    // The grid lines are in world coordinates already
+    const auto& wireframe = _patchDef3 ? _fixedWireframeRenderable : _wireframeRenderable;
+    wireframe.submitGeometry(collector, *entity.getWireShader());
 }
 
 // greebo: This renders the patch components, namely the lattice and the corner controls
@@ -221,6 +222,9 @@ void Patch::setRenderSystem(const RenderSystemPtr& renderSystem)
     _renderSystem = renderSystem;
     _shader.setRenderSystem(renderSystem);
 
+    _wireframeRenderable.setRenderSystem(renderSystem);
+    _fixedWireframeRenderable.setRenderSystem(renderSystem);
+
 #if DEBUG_PATCH_NTB_VECTORS
     _renderableNTBVectors.setRenderSystem(renderSystem);
 #endif
@@ -356,6 +360,14 @@ const std::string& Patch::getShader() const
     return _shader.getMaterialName();
 }
 
+std::size_t Patch::getAllocatedMemory() const
+{
+    return (_ctrl.capacity() + _ctrlTransformed.capacity()) * sizeof(PatchControl) +
+        _mesh.vertices.capacity() * sizeof(ArbitraryMeshVertex) +
+        (_mesh.indices.capacity() + _latticeIndices.capacity()) * sizeof(RenderIndex) +
+        _ctrl_vertices.capacity() * sizeof(VertexCb);
+}
+
 void Patch::setShader(const std::string& name)
 {
     undoSave();
@@ -380,10 +392,7 @@ SurfaceShader& Patch::getSurfaceShader()
 
 bool Patch::hasVisibleMaterial() const
 {
-    if (!_shader.getGLShader()) return false;
-
-    const MaterialPtr& material = _shader.getGLShader()->getMaterial();
-    return material && material->isVisible();
+    return _shader.isMaterialVisible();
 }
 
 int Patch::getShaderFlags() const
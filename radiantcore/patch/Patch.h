@@ -169,6 +169,10 @@ public:
     const SurfaceShader& getSurfaceShader() const;
     SurfaceShader& getSurfaceShader();
 
+	// Returns the approximate number of bytes allocated by this patch
+	// (not including the size of the Patch object itself)
+	std::size_t getAllocatedMemory() const;
+
 	// greebo: returns true if the patch's shader is visible, false otherwise
 	bool hasVisibleMaterial() const override;
 
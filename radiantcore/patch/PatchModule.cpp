@@ -16,6 +16,7 @@
 
 #include "module/StaticModule.h"
 #include "messages/TextureChanged.h"
+#include "util/BlockPool.h"
 
 namespace patch
 {
@@ -27,7 +28,7 @@ namespace
 
 scene::INodePtr PatchModule::createPatch(PatchDefType type)
 {
-	scene::INodePtr node = std::make_shared<PatchNode>(type);
+	scene::INodePtr node = util::makePooledShared<PatchNode>(type);
 
 	if (GlobalMapModule().getRoot())
 	{
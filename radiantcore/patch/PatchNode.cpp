@@ -6,6 +6,7 @@
 #include "icounter.h"
 #include "math/Frustum.h"
 #include "math/Hash.h"
+#include "util/BlockPool.h"
 
 // Construct a PatchNode with no arguments
 PatchNode::PatchNode(patch::PatchDefType type) :
@@ -82,6 +83,13 @@ std::string PatchNode::getFingerprint()
     return hash;
 }
 
+std::size_t PatchNode::getMemoryUsage() const
+{
+    return sizeof(PatchNode) + m_patch.getAllocatedMemory() +
+        m_ctrl_instances.capacity() * sizeof(PatchControlInstance) +
+        m_render_selected.capacity() * sizeof(VertexCb);
+}
+
 void PatchNode::allocate(std::size_t size) {
 	// Clear the control instance vector and reserve <size> memory
 	m_ctrl_instances.clear();
@@ -248,7 +256,7 @@ bool PatchNode::isVisible() const
 
 bool PatchNode::hasVisibleMaterial() const
 {
-	return m_patch.getSurfaceShader().getGLShader()->getMaterial()->isVisible();
+	return m_patch.getSurfaceShader().isMaterialVisible();
 }
 
 void PatchNode::selectedChangedComponent(const ISelectable& selectable) {
@@ -260,15 +268,16 @@ void PatchNode::selectedChangedComponent(const ISelectable& selectable) {
 // Clones this node, allocates a new Node on the heap and passes itself to the constructor of the new node
 scene::INodePtr PatchNode::clone() const
 {
-	return std::make_shared<PatchNode>(*this);
+	return util::makePooledShared<PatchNode>(*this);
 }
 
 void PatchNode::onInsertIntoScene(scene::IMapRootNode& root)
 {
     // Mark the GL shader as used from now on, this is used by the TextureBrowser's filtering
     m_patch.getSurfaceShader().setInUse(true);
+    m_patch.getSurfaceShader().setUsageIndex(&root.getMaterialUsageIndex(), scene::MaterialUsage{ this, nullptr });
 
-	m_patch.connectUndoSystem(root.getUndoChangeTracker());
+	m_patch.connectUndoSystem(getChangeTracker(root));
 	GlobalCounters().getCounter(counterPatches).increment();
 
     // Update the origin information needed for transformations
@@ -287,8 +296,9 @@ void PatchNode::onRemoveFromScene(scene::IMapRootNode& root)
 
 	GlobalCounters().getCounter(counterPatches).decrement();
 
-	m_patch.disconnectUndoSystem(root.getUndoChangeTracker());
+	m_patch.disconnectUndoSystem(getChangeTracker(root));
 
+    m_patch.getSurfaceShader().setUsageIndex(nullptr, scene::MaterialUsage());
     m_patch.getSurfaceShader().setInUse(false);
 
 	SelectableNode::onRemoveFromScene(root);
@@ -303,6 +313,10 @@ bool PatchNode::intersectsLight(const RendererLight& light) const {
 	return light.lightAABB().intersects(worldAABB());
 }
 
+const AABB& PatchNode::litObjectAABB() const {
+	return worldAABB();
+}
+
 void PatchNode::renderSolid(RenderableCollector& collector, const VolumeTest& volume) const
 {
 	// Don't render invisible shaders
@@ -362,7 +376,7 @@ void PatchNode::setRenderSystem(const RenderSystemPtr& renderSystem)
 void PatchNode::renderComponents(RenderableCollector& collector, const VolumeTest& volume) const
 {
 	// Don't render invisible shaders
-	if (!m_patch.getSurfaceShader().getGLShader()->getMaterial()->isVisible()) return;
+	if (!m_patch.getSurfaceShader().isMaterialVisible()) return;
 
 	// greebo: Don't know yet, what evaluateTransform() is really doing
 	const_cast<Patch&>(m_patch).evaluateTransform();
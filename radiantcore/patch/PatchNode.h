@@ -2,6 +2,7 @@
 
 #include "irenderable.h"
 #include "icomparablenode.h"
+#include "imemoryaccountable.h"
 #include "iscenegraph.h"
 #include "itraceable.h"
 #include "imap.h"
@@ -24,7 +25,8 @@ class PatchNode :
 	public LitObject,
 	public Transformable,
 	public ITraceable,
-    public scene::IComparableNode
+    public scene::IComparableNode,
+    public scene::IMemoryAccountable
 {
 	selection::DragPlanes m_dragPlanes;
 
@@ -65,6 +67,9 @@ public:
     // IComparableNode implementation
     std::string getFingerprint() override;
 
+    // IMemoryAccountable implementation
+    std::size_t getMemoryUsage() const override;
+
 	// Bounded implementation
 	const AABB& localAABB() const override;
 
@@ -125,6 +130,7 @@ public:
 
 	// LitObject implementation
 	bool intersectsLight(const RendererLight& light) const override;
+	const AABB& litObjectAABB() const override;
 
 	// Renderable implementation
 
@@ -1,38 +1,93 @@
 #include "PatchRenderables.h"
 
-void RenderablePatchWireframe::render(const RenderInfo& info) const
+RenderablePatchWireframe::RenderablePatchWireframe(const PatchTesselation& tess) :
+    _tess(tess),
+    _slot(render::IGeometryStore::InvalidSlot),
+    _slotVertices(0),
+    _slotIndices(0),
+    _needsUpdate(true)
+{}
+
+RenderablePatchWireframe::~RenderablePatchWireframe()
 {
-    // No colour changing
-    glDisableClientState(GL_COLOR_ARRAY);
-    if (info.checkFlag(RENDER_VERTEX_COLOUR))
+    releaseGeometry();
+}
+
+void RenderablePatchWireframe::setRenderSystem(const RenderSystemPtr& renderSystem)
+{
+    // Any existing slot belongs to the previous render system's store
+    releaseGeometry();
+
+    _renderSystem = renderSystem;
+    _needsUpdate = true;
+}
+
+void RenderablePatchWireframe::releaseGeometry() const
+{
+    auto renderSystem = _renderSystem.lock();
+
+    if (renderSystem && _slot != render::IGeometryStore::InvalidSlot)
     {
-        glColor3f(1, 1, 1);
+        renderSystem->getGeometryStore().deallocateSlot(_slot);
     }
 
-    if (_tess.vertices.empty()) return;
+    _slot = render::IGeometryStore::InvalidSlot;
+    _slotVertices = 0;
+    _slotIndices = 0;
+}
 
-    if (_needsUpdate)
+void RenderablePatchWireframe::submitGeometry(RenderableCollector& collector, Shader& shader) const
+{
+    auto renderSystem = _renderSystem.lock();
+
+    if (!renderSystem || _tess.vertices.empty() || _tess.width == 0 || _tess.height == 0) return;
+
+    if (_needsUpdate || _slot == render::IGeometryStore::InvalidSlot)
     {
         _needsUpdate = false;
 
-        // Create a VBO and add the vertex data
-        VertexBuffer_T currentVBuf;
-        currentVBuf.addVertices(_tess.vertices.begin(), _tess.vertices.end());
+        // The vertices form a row-major grid, connect each of them
+        // to its right and its lower neighbour
+        std::vector<unsigned int> indices;
+        indices.reserve(2 * ((_tess.width - 1) * _tess.height + _tess.width * (_tess.height - 1)));
 
-        // Submit index batches
-        const RenderIndex* strip_indices = &_tess.indices.front();
-        for (std::size_t i = 0;
-            i < _tess.numStrips;
-            i++, strip_indices += _tess.lenStrips)
+        for (std::size_t row = 0; row < _tess.height; ++row)
         {
-            currentVBuf.addIndexBatch(strip_indices, _tess.lenStrips);
+            for (std::size_t col = 0; col < _tess.width; ++col)
+            {
+                auto index = static_cast<unsigned int>(row * _tess.width + col);
+
+                if (col + 1 < _tess.width)
+                {
+                    indices.push_back(index);
+                    indices.push_back(index + 1);
+                }
+
+                if (row + 1 < _tess.height)
+                {
+                    indices.push_back(index);
+                    indices.push_back(index + static_cast<unsigned int>(_tess.width));
+                }
+            }
         }
 
-        // Render all index batches
-        _vertexBuf.replaceData(currentVBuf);
+        auto& store = renderSystem->getGeometryStore();
+
+        // Re-allocate the slot only if the tesselation size changed
+        if (_slot == render::IGeometryStore::InvalidSlot ||
+            _slotVertices != _tess.vertices.size() || _slotIndices != indices.size())
+        {
+            releaseGeometry();
+
+            _slot = store.allocateSlot(_tess.vertices.size(), indices.size());
+            _slotVertices = _tess.vertices.size();
+            _slotIndices = indices.size();
+        }
+
+        store.updateData(_slot, _tess.vertices, indices);
     }
 
-    _vertexBuf.renderAllBatches(GL_QUAD_STRIP);
+    collector.addGeometry(shader, _slot, render::GeometryType::Lines);
 }
 
 void RenderablePatchWireframe::queueUpdate()
@@ -6,36 +6,52 @@
 #pragma once
 
 #include "igl.h"
+#include "irender.h"
+#include "irenderable.h"
 #include "PatchTesselation.h"
 
 #include "render/VertexBuffer.h"
 #include "render/IndexedVertexBuffer.h"
 
-/// Helper class to render a PatchTesselation in wireframe mode
-class RenderablePatchWireframe :
-	public OpenGLRenderable
+/**
+ * Helper class to render a PatchTesselation in wireframe mode. The edges of
+ * the tesselated grid are kept in the render system's geometry store, they are
+ * only re-generated after queueUpdate() has been called.
+ */
+class RenderablePatchWireframe
 {
 protected:
 	// Geometry source
 	const PatchTesselation& _tess;
 
-	// VertexBuffer for rendering
-	typedef render::IndexedVertexBuffer<Vertex3f> VertexBuffer_T;
-	mutable VertexBuffer_T _vertexBuf;
+	RenderSystemWeakPtr _renderSystem;
+
+	// The geometry store slot and the sizes it has been allocated with
+	mutable render::IGeometryStore::Slot _slot;
+	mutable std::size_t _slotVertices;
+	mutable std::size_t _slotIndices;
 
 	mutable bool _needsUpdate;
 
 public:
-	RenderablePatchWireframe(const PatchTesselation& tess) :
-		_tess(tess),
-		_needsUpdate(true)
-	{ }
+	RenderablePatchWireframe(const PatchTesselation& tess);
 
-	virtual ~RenderablePatchWireframe() {}
+	RenderablePatchWireframe(const RenderablePatchWireframe& other) = delete;
+	RenderablePatchWireframe& operator=(const RenderablePatchWireframe& other) = delete;
 
-    void render(const RenderInfo& info) const;
+	virtual ~RenderablePatchWireframe();
+
+	// Moves the geometry to the given render system's store
+	void setRenderSystem(const RenderSystemPtr& renderSystem);
+
+	// Submit the grid lines to the given collector. Since patches are
+	// always in world coordinates, no transform is applied.
+	void submitGeometry(RenderableCollector& collector, Shader& shader) const;
 
     void queueUpdate();
+
+private:
+	void releaseGeometry() const;
 };
 
 /// Helper class to render a fixed geometry PatchTesselation in wireframe mode
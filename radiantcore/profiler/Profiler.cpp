@@ -0,0 +1,366 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include "itextstream.h"
+#include "i18n.h"
+#include "module/StaticModule.h"
+#include "command/ExecutionFailure.h"
+
+namespace profiling
+{
+
+namespace
+{
+    // Maximum number of events kept per thread, about 2 MB
+    const std::size_t EVENTS_PER_THREAD = 1 << 16;
+
+    // Sessions are unique across profiler instances, such that the thread
+    // buffers of a previous instance are never re-used by accident
+    std::atomic<std::size_t> _nextSession(1);
+
+    // The buffer of the calling thread and the pool it belongs to,
+    // the buffer is returned to the pool when the thread exits
+    struct ThreadBufferRef
+    {
+        const Profiler* owner = nullptr;
+        std::shared_ptr<Profiler::ThreadBuffer> buffer;
+        std::weak_ptr<Profiler::BufferPool> pool;
+
+        ~ThreadBufferRef()
+        {
+            release();
+        }
+
+        void release()
+        {
+            if (auto pool = this->pool.lock(); pool && buffer)
+            {
+                pool->release(buffer);
+            }
+
+            owner = nullptr;
+            buffer.reset();
+            pool.reset();
+        }
+    };
+
+    thread_local ThreadBufferRef _threadBuffer;
+
+    void writeEscaped(std::ostream& stream, const char* str)
+    {
+        for (auto c = str; *c != '\0'; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                stream << '\\';
+            }
+
+            stream << *c;
+        }
+    }
+}
+
+Profiler::ThreadBuffer::ThreadBuffer(std::size_t threadNum, std::size_t session, std::size_t capacity) :
+    _threadNum(threadNum),
+    _session(session),
+    _capacity((capacity + EventsPerChunk - 1) / EventsPerChunk * EventsPerChunk),
+    _chunks(_capacity / EventsPerChunk),
+    _numAdded(0)
+{}
+
+std::size_t Profiler::ThreadBuffer::getThreadNum() const
+{
+    return _threadNum;
+}
+
+std::size_t Profiler::ThreadBuffer::getSession() const
+{
+    return _session;
+}
+
+void Profiler::ThreadBuffer::add(const Event& event)
+{
+    auto index = _numAdded.load(std::memory_order_relaxed);
+
+    // Once the buffer is full, this overwrites the oldest event
+    auto slot = index % _capacity;
+    auto& chunk = _chunks[slot / EventsPerChunk];
+
+    if (!chunk)
+    {
+        chunk.reset(new Event[EventsPerChunk]);
+    }
+
+    chunk[slot % EventsPerChunk] = event;
+
+    // Publish the event (and the chunk) to foreachEvent()
+    _numAdded.store(index + 1, std::memory_order_release);
+}
+
+const Profiler::Event& Profiler::ThreadBuffer::getEvent(std::size_t index) const
+{
+    auto slot = index % _capacity;
+    return _chunks[slot / EventsPerChunk][slot % EventsPerChunk];
+}
+
+void Profiler::ThreadBuffer::foreachEvent(const std::function<void(const Event&)>& functor) const
+{
+    auto numAdded = _numAdded.load(std::memory_order_acquire);
+    auto first = numAdded > _capacity ? numAdded - _capacity : 0;
+
+    std::vector<Event> events;
+    events.reserve(numAdded - first);
+
+    for (auto i = first; i < numAdded; ++i)
+    {
+        events.push_back(getEvent(i));
+    }
+
+    // The owning thread might have overwritten some of the copied events
+    // in the meantime, including the one it might be writing right now
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto numAddedNow = _numAdded.load(std::memory_order_relaxed) + 1;
+    auto firstValid = std::max(first, numAddedNow > _capacity ? numAddedNow - _capacity : 0);
+
+    for (auto i = firstValid; i < numAdded; ++i)
+    {
+        functor(events[i - first]);
+    }
+}
+
+Profiler::BufferPool::BufferPool() :
+    _session(0)
+{}
+
+void Profiler::BufferPool::reset(std::size_t session)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _session = session;
+    _buffers.clear();
+    _unusedBuffers.clear();
+}
+
+std::shared_ptr<Profiler::ThreadBuffer> Profiler::BufferPool::acquire()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    if (!_unusedBuffers.empty())
+    {
+        auto buffer = std::move(_unusedBuffers.back());
+        _unusedBuffers.pop_back();
+        return buffer;
+    }
+
+    // Buffers are numbered in the order of their first event
+    _buffers.emplace_back(std::make_shared<ThreadBuffer>(_buffers.size(), _session, EVENTS_PER_THREAD));
+
+    return _buffers.back();
+}
+
+void Profiler::BufferPool::release(const std::shared_ptr<ThreadBuffer>& buffer)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    // Buffers of a previous session have been discarded already
+    if (buffer->getSession() == _session)
+    {
+        _unusedBuffers.push_back(buffer);
+    }
+}
+
+std::vector<std::shared_ptr<Profiler::ThreadBuffer>> Profiler::BufferPool::getBuffers()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _buffers;
+}
+
+Profiler::Profiler() :
+    _running(false),
+    _startTime(Clock::now().time_since_epoch().count()),
+    _session(_nextSession++),
+    _buffers(std::make_shared<BufferPool>())
+{
+    _buffers->reset(_session);
+}
+
+bool Profiler::isRunning() const
+{
+    return _running.load(std::memory_order_relaxed);
+}
+
+void Profiler::start()
+{
+    stop();
+
+    auto session = _nextSession++;
+    _buffers->reset(session);
+
+    _session = session;
+    _startTime = Clock::now().time_since_epoch().count();
+    _running = true;
+
+    rMessage() << "Profiler started" << std::endl;
+}
+
+void Profiler::stop()
+{
+    if (_running.exchange(false))
+    {
+        rMessage() << "Profiler stopped" << std::endl;
+    }
+}
+
+void Profiler::addZone(const char* name, Clock::time_point begin, Clock::time_point end)
+{
+    if (!isRunning()) return;
+
+    auto timestamp = getMicroseconds(begin);
+    auto duration = static_cast<double>(getMicroseconds(end) - timestamp);
+
+    getThreadBuffer().add(Event{ Event::Type::Zone, name, timestamp, duration });
+}
+
+void Profiler::setCounter(const char* name, double value)
+{
+    if (!isRunning()) return;
+
+    getThreadBuffer().add(Event{ Event::Type::Counter, name, getMicroseconds(Clock::now()), value });
+}
+
+void Profiler::markFrame(const char* name)
+{
+    if (!isRunning()) return;
+
+    getThreadBuffer().add(Event{ Event::Type::Frame, name, getMicroseconds(Clock::now()), 0 });
+}
+
+void Profiler::writeTrace(std::ostream& stream)
+{
+    auto buffers = _buffers->getBuffers();
+
+    stream << "{\"traceEvents\":[";
+
+    bool first = true;
+
+    auto beginEvent = [&](const char* name, const char* phase, std::size_t threadNum)
+    {
+        stream << (first ? "\n" : ",\n") << "{\"name\":\"";
+        writeEscaped(stream, name);
+        stream << "\",\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << threadNum;
+        first = false;
+    };
+
+    for (const auto& buffer : buffers)
+    {
+        auto threadNum = buffer->getThreadNum();
+
+        beginEvent("thread_name", "M", threadNum);
+        stream << ",\"args\":{\"name\":\"Thread " << threadNum << "\"}}";
+
+        buffer->foreachEvent([&](const Event& event)
+        {
+            switch (event.type)
+            {
+            case Event::Type::Zone:
+                beginEvent(event.name, "X", threadNum);
+                stream << ",\"ts\":" << event.timestamp << ",\"dur\":" << event.value << "}";
+                break;
+
+            case Event::Type::Counter:
+                beginEvent(event.name, "C", threadNum);
+                stream << ",\"ts\":" << event.timestamp << ",\"args\":{\"value\":" << event.value << "}}";
+                break;
+
+            case Event::Type::Frame:
+                beginEvent(event.name, "i", threadNum);
+                stream << ",\"ts\":" << event.timestamp << ",\"s\":\"p\"}";
+                break;
+            }
+        });
+    }
+
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer()
+{
+    if (_threadBuffer.owner != this || _threadBuffer.buffer->getSession() != _session)
+    {
+        // Return the buffer of another profiler instance to its pool, the
+        // buffer of a previous session is just dropped
+        _threadBuffer.release();
+
+        _threadBuffer.owner = this;
+        _threadBuffer.buffer = _buffers->acquire();
+        _threadBuffer.pool = _buffers;
+    }
+
+    return *_threadBuffer.buffer;
+}
+
+std::int64_t Profiler::getMicroseconds(Clock::time_point time) const
+{
+    Clock::time_point startTime(Clock::duration(_startTime.load()));
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - startTime).count();
+}
+
+void Profiler::startCmd(const cmd::ArgumentList& args)
+{
+    start();
+}
+
+void Profiler::stopCmd(const cmd::ArgumentList& args)
+{
+    stop();
+
+    auto path = !args.empty() ? args[0].getString() :
+        module::GlobalModuleRegistry().getApplicationContext().getSettingsPath() + "trace.json";
+
+    std::ofstream stream(path);
+
+    if (!stream)
+    {
+        throw cmd::ExecutionFailure(fmt::format(_("Cannot write the profiler trace to {0}"), path));
+    }
+
+    writeTrace(stream);
+
+    rMessage() << "Profiler trace written to " << path << std::endl;
+}
+
+const std::string& Profiler::getName() const
+{
+    static std::string _name(MODULE_PROFILER);
+    return _name;
+}
+
+const StringSet& Profiler::getDependencies() const
+{
+    static StringSet _dependencies;
+
+    if (_dependencies.empty())
+    {
+        _dependencies.insert(MODULE_COMMANDSYSTEM);
+    }
+
+    return _dependencies;
+}
+
+void Profiler::initialiseModule(const IApplicationContext& ctx)
+{
+    rMessage() << getName() << "::initialiseModule called." << std::endl;
+
+    // Zones are recorded in worker threads too (e.g. VFS reads of the def loaders),
+    // make sure the GlobalProfiler() reference is acquired on the main thread
+    GlobalProfiler();
+
+    GlobalCommandSystem().addCommand("ProfilerStart", std::bind(&Profiler::startCmd, this, std::placeholders::_1));
+    GlobalCommandSystem().addCommand("ProfilerStop", std::bind(&Profiler::stopCmd, this, std::placeholders::_1),
+        { cmd::ARGTYPE_STRING | cmd::ARGTYPE_OPTIONAL });
+}
+
+module::StaticModule<Profiler> profilerModule;
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "iprofiler.h"
+#include "icommandsystem.h"
+
+namespace profiling
+{
+
+class Profiler :
+    public IProfiler
+{
+public:
+    struct Event
+    {
+        enum class Type
+        {
+            Zone,
+            Counter,
+            Frame,
+        };
+
+        Type type;
+        const char* name;
+
+        // Microseconds since the start of the recording
+        std::int64_t timestamp;
+
+        // The duration of a zone in microseconds or the counter value
+        double value;
+    };
+
+    // The events of a single thread, the oldest events are overwritten
+    // when the buffer is full. Only the thread owning the buffer is adding
+    // events, which doesn't need any locks. The memory is allocated in chunks
+    // as the events come in.
+    class ThreadBuffer
+    {
+    private:
+        static constexpr std::size_t EventsPerChunk = 4096;
+
+        std::size_t _threadNum;
+        std::size_t _session;
+        std::size_t _capacity;
+
+        // Allocated by the owning thread when first needed, released with the buffer
+        std::vector<std::unique_ptr<Event[]>> _chunks;
+
+        // The number of events added so far, increased after the event has been written
+        std::atomic<std::size_t> _numAdded;
+
+    public:
+        ThreadBuffer(std::size_t threadNum, std::size_t session, std::size_t capacity);
+
+        std::size_t getThreadNum() const;
+        std::size_t getSession() const;
+
+        // Must only be called by the thread owning this buffer
+        void add(const Event& event);
+
+        // Visits the events in the order they have been recorded, this can be called
+        // from any thread. Events overwritten in the meantime are left out.
+        void foreachEvent(const std::function<void(const Event&)>& functor) const;
+
+    private:
+        const Event& getEvent(std::size_t index) const;
+    };
+
+    // The buffers of the current recording session. A thread returns its buffer
+    // when it exits, the buffer is then handed to the next thread needing one.
+    // The events remain available to writeTrace() until the next session starts.
+    class BufferPool
+    {
+    private:
+        std::mutex _lock;
+        std::size_t _session;
+
+        std::vector<std::shared_ptr<ThreadBuffer>> _buffers;
+        std::vector<std::shared_ptr<ThreadBuffer>> _unusedBuffers;
+
+    public:
+        BufferPool();
+
+        // Discards all buffers, the ones acquired later on belong to the given session
+        void reset(std::size_t session);
+
+        // Returns an unused buffer of the current session or creates a new one
+        std::shared_ptr<ThreadBuffer> acquire();
+
+        // Called when the thread owning the given buffer exits
+        void release(const std::shared_ptr<ThreadBuffer>& buffer);
+
+        std::vector<std::shared_ptr<ThreadBuffer>> getBuffers();
+    };
+
+private:
+    std::atomic<bool> _running;
+
+    // The time the recording has been started, in ticks since the clock's epoch
+    std::atomic<Clock::rep> _startTime;
+
+    // Incremented on every start(), outdated thread buffers are replaced
+    std::atomic<std::size_t> _session;
+
+    std::shared_ptr<BufferPool> _buffers;
+
+public:
+    Profiler();
+
+    bool isRunning() const override;
+    void start() override;
+    void stop() override;
+    void addZone(const char* name, Clock::time_point begin, Clock::time_point end) override;
+    void setCounter(const char* name, double value) override;
+    void markFrame(const char* name) override;
+    void writeTrace(std::ostream& stream) override;
+
+    // RegisterableModule implementation
+    const std::string& getName() const override;
+    const StringSet& getDependencies() const override;
+    void initialiseModule(const IApplicationContext& ctx) override;
+
+private:
+    ThreadBuffer& getThreadBuffer();
+    std::int64_t getMicroseconds(Clock::time_point time) const;
+
+    void startCmd(const cmd::ArgumentList& args);
+    void stopCmd(const cmd::ArgumentList& args);
+};
+
+}
@@ -4,6 +4,7 @@
 #include "igl.h"
 #include "itextstream.h"
 #include "iradiant.h"
+#include "iprofiler.h"
 
 #include "math/Matrix4.h"
 #include "module/StaticModule.h"
@@ -11,6 +12,7 @@
 #include "debugging/debugging.h"
 
 #include <functional>
+#include <chrono>
 
 namespace render {
 
@@ -113,6 +115,30 @@ ShaderPtr OpenGLRenderSystem::capture(const std::string& name)
     return shd;
 }
 
+void OpenGLRenderSystem::deferCapture(IDeferredShaderCapture& client)
+{
+    _deferredCaptures.insert(&client);
+}
+
+void OpenGLRenderSystem::cancelDeferredCapture(IDeferredShaderCapture& client)
+{
+    _deferredCaptures.erase(&client);
+}
+
+std::size_t OpenGLRenderSystem::captureDeferredShaders(std::size_t maxCount)
+{
+    for (std::size_t i = 0; i < maxCount && !_deferredCaptures.empty(); ++i)
+    {
+        // Remove the client before it captures, it has nothing to cancel then
+        auto client = *_deferredCaptures.begin();
+        _deferredCaptures.erase(_deferredCaptures.begin());
+
+        client->captureShaderNow();
+    }
+
+    return _deferredCaptures.size();
+}
+
 /*
  * Render all states in the ShaderCache along with their renderables. This
  * is where the actual OpenGL rendering starts.
@@ -122,6 +148,8 @@ void OpenGLRenderSystem::render(RenderStateFlags globalstate,
                                const Matrix4& projection,
                                const Vector3& viewer)
 {
+    profiling::ScopedZone zone("Render back-end");
+
     glPushAttrib(GL_ALL_ATTRIB_BITS);
 
     // Set the projection and modelview matrices
@@ -202,22 +230,63 @@ void OpenGLRenderSystem::render(RenderStateFlags globalstate,
     glHint(GL_FOG_HINT, GL_NICEST);
     glDisable(GL_FOG);
 
-    // Iterate over the sorted mapping between OpenGLStates and their
-    // OpenGLShaderPasses (containing the renderable geometry), and render the
-    // contents of each bucket. Each pass is passed a reference to the "current"
-    // state, which it can change.
-    for (OpenGLStates::iterator i = _state_sorted.begin();
-        i != _state_sorted.end();
-        ++i)
+    // Transfer all geometry that changed since the last frame
+    _geometryStore.syncToBufferObjects();
+
+    _frameStats = FrameStatistics();
+
+    buildRenderQueue();
+
+    // Render the contents of each queued bucket. Each pass is passed a reference
+    // to the "current" state, which it can change.
+    const RenderQueue::Entry* previous = nullptr;
+
+    for (const auto& entry : _renderQueue.getEntries())
+    {
+        entry.pass->render(entry, previous, current, globalstate, viewer, _time, _frameStats);
+        previous = &entry;
+    }
+
+    for (const auto& entry : _renderQueue.getEntries())
+    {
+        entry.pass->clearRenderables();
+    }
+
+    _geometryStore.onFrameFinished();
+
+    glPopAttrib();
+}
+
+void OpenGLRenderSystem::buildRenderQueue()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    _renderQueue.clear();
+
+    // Walk the sorted mapping between OpenGLStates and their OpenGLShaderPasses,
+    // the position in this map is part of the sort key of each entry
+    std::size_t passIndex = 0;
+
+    for (const auto& pair : _state_sorted)
     {
-        // Render the OpenGLShaderPass
-        if (!i->second->empty())
+        if (!pair.second->empty())
         {
-            i->second->render(current, globalstate, viewer, _time);
+            pair.second->addToRenderQueue(_renderQueue, passIndex);
         }
+
+        ++passIndex;
     }
 
-    glPopAttrib();
+    _renderQueue.sort();
+
+    _frameStats.queueEntries = _renderQueue.size();
+    _frameStats.queueBuildTimeUsec = static_cast<std::size_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+const FrameStatistics& OpenGLRenderSystem::getFrameStatistics() const
+{
+    return _frameStats;
 }
 
 void OpenGLRenderSystem::realise()
@@ -268,6 +337,17 @@ void OpenGLRenderSystem::unrealise()
         // Unrealise the GLPrograms
         _glProgramFactory->unrealise();
     }
+
+    if (GlobalOpenGLContext().getSharedContext())
+    {
+        // The buffer objects are re-created on the next render pass
+        _geometryStore.destroyBufferObjects();
+    }
+}
+
+GeometryStore& OpenGLRenderSystem::getGeometryStore()
+{
+    return _geometryStore;
 }
 
 GLProgramFactory& OpenGLRenderSystem::getGLProgramFactory()
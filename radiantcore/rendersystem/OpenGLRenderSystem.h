@@ -3,10 +3,13 @@
 #include "irender.h"
 #include <sigc++/connection.h>
 #include <map>
+#include <unordered_set>
 #include "imodule.h"
 #include "backend/OpenGLStateManager.h"
 #include "backend/OpenGLShader.h"
 #include "backend/OpenGLStateLess.h"
+#include "backend/GeometryStore.h"
+#include "backend/RenderQueue.h"
 
 namespace render
 {
@@ -26,6 +29,9 @@ class OpenGLRenderSystem
 	typedef std::map<std::string, OpenGLShaderPtr> ShaderMap;
 	ShaderMap _shaders;
 
+	// Clients waiting for their shader to be captured, see deferCapture()
+	std::unordered_set<IDeferredShaderCapture*> _deferredCaptures;
+
 	// whether this module has been realised
 	bool _realised;
 
@@ -43,6 +49,15 @@ class OpenGLRenderSystem
 	// Render time
 	std::size_t _time;
 
+	// Persistent vertex and index storage, shared by all shaders
+	GeometryStore _geometryStore;
+
+	// Draw buckets of the current frame, in render order
+	RenderQueue _renderQueue;
+
+	// Counters of the last render() call
+	FrameStatistics _frameStats;
+
 	sigc::signal<void> _sigExtensionsInitialised;
 
 	sigc::connection _materialDefsLoaded;
@@ -62,6 +77,9 @@ public:
     /* RenderSystem implementation */
 
 	ShaderPtr capture(const std::string& name) override;
+	void deferCapture(IDeferredShaderCapture& client) override;
+	void cancelDeferredCapture(IDeferredShaderCapture& client) override;
+	std::size_t captureDeferredShaders(std::size_t maxCount) override;
 	void render(RenderStateFlags globalstate,
 				const Matrix4& modelview,
 				const Matrix4& projection,
@@ -77,6 +95,9 @@ public:
     ShaderProgram getCurrentShaderProgram() const override;
     void setShaderProgram(ShaderProgram prog) override;
 
+    GeometryStore& getGeometryStore() override;
+    const FrameStatistics& getFrameStatistics() const override;
+
 	void extensionsInitialised() override;
 	sigc::signal<void> signal_extensionsInitialised() override;
 
@@ -101,6 +122,10 @@ public:
     virtual const StringSet& getDependencies() const override;
     virtual void initialiseModule(const IApplicationContext& ctx) override;
     virtual void shutdownModule() override;
+
+private:
+	// Collect the non-empty buckets of all passes and sort them
+	void buildRenderQueue();
 };
 typedef std::shared_ptr<OpenGLRenderSystem> OpenGLRenderSystemPtr;
 
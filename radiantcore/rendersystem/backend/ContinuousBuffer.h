@@ -0,0 +1,308 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+
+namespace render
+{
+
+/**
+ * \brief
+ * A single contiguous array of elements, divided into independently
+ * allocated blocks. Blocks never change their position once allocated,
+ * the buffer grows at its end if no free block is large enough.
+ *
+ * Modifications are tracked as a single dirty element range, which can be
+ * used to transfer only the changed part of the buffer to a GL buffer object.
+ */
+template<typename ElementType>
+class ContinuousBuffer
+{
+public:
+    using Handle = std::uint32_t;
+
+    static constexpr std::size_t DefaultInitialSize = 8192;
+
+private:
+    struct Block
+    {
+        std::size_t offset;
+        std::size_t size;
+        std::size_t numUsed;
+        bool occupied;
+    };
+
+    std::vector<ElementType> _buffer;
+
+    // All blocks, indexed by handle
+    std::vector<Block> _blocks;
+
+    // Handles of unused entries in _blocks, to be re-used
+    std::vector<Handle> _unusedHandles;
+
+    // Free blocks, keyed by offset (for merging neighbours)
+    std::map<std::size_t, Handle> _freeBlocksByOffset;
+
+    // Free blocks, keyed by size (for best-fit allocation)
+    std::multimap<std::size_t, Handle> _freeBlocksBySize;
+
+    // Range of modified elements [begin, end)
+    std::size_t _dirtyBegin;
+    std::size_t _dirtyEnd;
+
+public:
+    ContinuousBuffer(std::size_t initialSize = DefaultInitialSize)
+    {
+        _buffer.resize(initialSize);
+        clearDirtyRange();
+
+        // The whole buffer forms a single free block
+        addFreeBlock(createBlock(0, initialSize));
+    }
+
+    Handle allocate(std::size_t requiredSize)
+    {
+        // Empty blocks would share their offset with the next block
+        requiredSize = std::max<std::size_t>(requiredSize, 1);
+
+        // Find the smallest free block fitting the requested size
+        auto candidate = _freeBlocksBySize.lower_bound(requiredSize);
+
+        if (candidate == _freeBlocksBySize.end())
+        {
+            grow(requiredSize);
+            candidate = _freeBlocksBySize.lower_bound(requiredSize);
+        }
+
+        auto handle = candidate->second;
+        removeFreeBlock(handle);
+
+        auto& block = _blocks[handle];
+
+        // Split off the remainder into a new free block
+        if (block.size > requiredSize)
+        {
+            auto remainder = createBlock(block.offset + requiredSize, block.size - requiredSize);
+            _blocks[handle].size = requiredSize;
+            addFreeBlock(remainder);
+        }
+
+        _blocks[handle].occupied = true;
+        _blocks[handle].numUsed = 0;
+
+        return handle;
+    }
+
+    void deallocate(Handle handle)
+    {
+        auto& block = getOccupiedBlock(handle);
+        block.occupied = false;
+        block.numUsed = 0;
+
+        // Merge with the following block if that one is free
+        auto next = _freeBlocksByOffset.find(block.offset + block.size);
+
+        if (next != _freeBlocksByOffset.end())
+        {
+            auto nextHandle = next->second;
+            removeFreeBlock(nextHandle);
+            _blocks[handle].size += _blocks[nextHandle].size;
+            releaseBlock(nextHandle);
+        }
+
+        // Merge with the preceding block if that one is free
+        auto following = _freeBlocksByOffset.lower_bound(_blocks[handle].offset);
+
+        if (following != _freeBlocksByOffset.begin())
+        {
+            auto previousHandle = std::prev(following)->second;
+            auto& previous = _blocks[previousHandle];
+
+            if (previous.offset + previous.size == _blocks[handle].offset)
+            {
+                removeFreeBlock(previousHandle);
+                previous.size += _blocks[handle].size;
+                releaseBlock(handle);
+                addFreeBlock(previousHandle);
+                return;
+            }
+        }
+
+        addFreeBlock(handle);
+    }
+
+    // Copies the given elements to the start of the block,
+    // the number of elements must not exceed the allocated block size
+    template<typename Iter_T>
+    void setData(Handle handle, Iter_T begin, Iter_T end)
+    {
+        auto& block = getOccupiedBlock(handle);
+        auto numElements = static_cast<std::size_t>(std::distance(begin, end));
+
+        if (numElements > block.size)
+        {
+            throw std::logic_error("ContinuousBuffer: data exceeds the allocated block size");
+        }
+
+        std::copy(begin, end, _buffer.begin() + block.offset);
+        block.numUsed = numElements;
+
+        markDirty(block.offset, numElements);
+    }
+
+    // Direct access to the elements of a block, used to post-process uploaded data.
+    // The caller needs to call markDirty() afterwards.
+    ElementType* getBlockData(Handle handle)
+    {
+        return _buffer.data() + getOccupiedBlock(handle).offset;
+    }
+
+    std::size_t getOffset(Handle handle) const
+    {
+        return _blocks.at(handle).offset;
+    }
+
+    // The allocated size of the block, throws std::logic_error for invalid handles
+    std::size_t getSize(Handle handle) const
+    {
+        return getOccupiedBlock(handle).size;
+    }
+
+    std::size_t getNumUsedElements(Handle handle) const
+    {
+        return _blocks.at(handle).numUsed;
+    }
+
+    // The start of the whole buffer, all block offsets are relative to this
+    const ElementType* getBufferStart() const
+    {
+        return _buffer.data();
+    }
+
+    // The total number of elements in this buffer (including unused ones)
+    std::size_t getCapacity() const
+    {
+        return _buffer.size();
+    }
+
+    void markDirty(std::size_t offset, std::size_t numElements)
+    {
+        if (numElements == 0) return;
+
+        _dirtyBegin = std::min(_dirtyBegin, offset);
+        _dirtyEnd = std::max(_dirtyEnd, offset + numElements);
+    }
+
+    bool hasDirtyRange() const
+    {
+        return _dirtyBegin < _dirtyEnd;
+    }
+
+    std::size_t getDirtyBegin() const
+    {
+        return _dirtyBegin;
+    }
+
+    std::size_t getDirtyEnd() const
+    {
+        return _dirtyEnd;
+    }
+
+    void clearDirtyRange()
+    {
+        _dirtyBegin = std::numeric_limits<std::size_t>::max();
+        _dirtyEnd = 0;
+    }
+
+private:
+    Block& getOccupiedBlock(Handle handle)
+    {
+        return const_cast<Block&>(static_cast<const ContinuousBuffer&>(*this).getOccupiedBlock(handle));
+    }
+
+    const Block& getOccupiedBlock(Handle handle) const
+    {
+        if (handle >= _blocks.size() || !_blocks[handle].occupied)
+        {
+            throw std::logic_error("ContinuousBuffer: invalid block handle");
+        }
+
+        return _blocks[handle];
+    }
+
+    Handle createBlock(std::size_t offset, std::size_t size)
+    {
+        Block block{ offset, size, 0, false };
+
+        if (!_unusedHandles.empty())
+        {
+            auto handle = _unusedHandles.back();
+            _unusedHandles.pop_back();
+            _blocks[handle] = block;
+            return handle;
+        }
+
+        _blocks.push_back(block);
+        return static_cast<Handle>(_blocks.size() - 1);
+    }
+
+    void releaseBlock(Handle handle)
+    {
+        _blocks[handle].size = 0;
+        _unusedHandles.push_back(handle);
+    }
+
+    void addFreeBlock(Handle handle)
+    {
+        _freeBlocksByOffset.emplace(_blocks[handle].offset, handle);
+        _freeBlocksBySize.emplace(_blocks[handle].size, handle);
+    }
+
+    void removeFreeBlock(Handle handle)
+    {
+        _freeBlocksByOffset.erase(_blocks[handle].offset);
+
+        auto range = _freeBlocksBySize.equal_range(_blocks[handle].size);
+
+        for (auto i = range.first; i != range.second; ++i)
+        {
+            if (i->second == handle)
+            {
+                _freeBlocksBySize.erase(i);
+                break;
+            }
+        }
+    }
+
+    // Enlarge the buffer such that a free block of at least the given size is available
+    void grow(std::size_t requiredSize)
+    {
+        auto oldSize = _buffer.size();
+        auto newSize = std::max(oldSize * 2, oldSize + requiredSize);
+
+        _buffer.resize(newSize);
+
+        // Add the new space as free block, merging it with a free block at the end
+        auto last = _freeBlocksByOffset.empty() ? _freeBlocksByOffset.end() :
+            std::prev(_freeBlocksByOffset.end());
+
+        if (last != _freeBlocksByOffset.end() &&
+            _blocks[last->second].offset + _blocks[last->second].size == oldSize)
+        {
+            auto handle = last->second;
+            removeFreeBlock(handle);
+            _blocks[handle].size += newSize - oldSize;
+            addFreeBlock(handle);
+        }
+        else
+        {
+            addFreeBlock(createBlock(oldSize, newSize - oldSize));
+        }
+    }
+};
+
+}
@@ -0,0 +1,360 @@
+#include "GeometryStore.h"
+
+#include "debugging/gl.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace render
+{
+
+namespace
+{
+    // The slot handle combines the handles of the vertex and the index block
+    inline IGeometryStore::Slot getSlot(std::uint32_t vertexHandle, std::uint32_t indexHandle)
+    {
+        return (static_cast<IGeometryStore::Slot>(vertexHandle) << 32) | indexHandle;
+    }
+
+    inline std::uint32_t getVertexHandle(IGeometryStore::Slot slot)
+    {
+        return static_cast<std::uint32_t>(slot >> 32);
+    }
+
+    inline std::uint32_t getIndexHandle(IGeometryStore::Slot slot)
+    {
+        return static_cast<std::uint32_t>(slot & 0xFFFFFFFFu);
+    }
+
+    inline bool persistentMappingAvailable()
+    {
+        return GLEW_ARB_buffer_storage && GLEW_ARB_sync;
+    }
+
+    const GLbitfield PERSISTENT_MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+}
+
+void GeometryStore::markDirty(BufferObject& buffer, std::size_t begin, std::size_t end)
+{
+    if (begin >= end) return;
+
+    if (buffer.dirtyBegin >= buffer.dirtyEnd)
+    {
+        buffer.dirtyBegin = begin;
+        buffer.dirtyEnd = end;
+        return;
+    }
+
+    buffer.dirtyBegin = std::min(buffer.dirtyBegin, begin);
+    buffer.dirtyEnd = std::max(buffer.dirtyEnd, end);
+}
+
+void GeometryStore::clearDirtyRange(BufferObject& buffer)
+{
+    buffer.dirtyBegin = 0;
+    buffer.dirtyEnd = 0;
+}
+
+GeometryStore::GeometryStore() :
+    _currentFrame(0)
+{
+    for (auto& frame : _frameBuffers)
+    {
+        frame.vertices.target = GL_ARRAY_BUFFER;
+        frame.indices.target = GL_ELEMENT_ARRAY_BUFFER;
+    }
+}
+
+GeometryStore::~GeometryStore()
+{
+    // The GL context might be gone already, we can't delete any
+    // buffer objects here, this has to happen in destroyBufferObjects()
+}
+
+IGeometryStore::Slot GeometryStore::allocateSlot(std::size_t numVertices, std::size_t numIndices)
+{
+    auto vertexHandle = _vertices.allocate(numVertices);
+    auto indexHandle = _indices.allocate(numIndices);
+
+    return getSlot(vertexHandle, indexHandle);
+}
+
+void GeometryStore::updateData(Slot slot, const std::vector<ArbitraryMeshVertex>& vertices,
+    const std::vector<unsigned int>& indices)
+{
+    auto vertexHandle = getVertexHandle(slot);
+    auto indexHandle = getIndexHandle(slot);
+
+    // Check both sizes first, such that a failing call leaves the slot untouched
+    if (vertices.size() > _vertices.getSize(vertexHandle) || indices.size() > _indices.getSize(indexHandle))
+    {
+        throw std::logic_error("GeometryStore: data exceeds the allocated slot size");
+    }
+
+    _vertices.setData(vertexHandle, vertices.begin(), vertices.end());
+    _indices.setData(indexHandle, indices.begin(), indices.end());
+
+    // Rebase the indices to the slot's position in the vertex buffer
+    auto firstVertex = static_cast<unsigned int>(_vertices.getOffset(vertexHandle));
+
+    if (firstVertex > 0)
+    {
+        auto* index = _indices.getBlockData(indexHandle);
+
+        for (std::size_t i = 0; i < indices.size(); ++i)
+        {
+            index[i] += firstVertex;
+        }
+    }
+}
+
+void GeometryStore::deallocateSlot(Slot slot)
+{
+    _vertices.deallocate(getVertexHandle(slot));
+    _indices.deallocate(getIndexHandle(slot));
+}
+
+IGeometryStore::RenderParameters GeometryStore::getRenderParameters(Slot slot) const
+{
+    auto indexHandle = getIndexHandle(slot);
+
+    return RenderParameters
+    {
+        _indices.getOffset(indexHandle),
+        _indices.getNumUsedElements(indexHandle),
+    };
+}
+
+void GeometryStore::syncToBufferObjects()
+{
+    if (!GLEW_VERSION_1_5) return; // client memory will be used for drawing
+
+    // Every set of buffer objects needs to receive the changes made since the last sync
+    for (auto& frame : _frameBuffers)
+    {
+        markDirty(frame.vertices, _vertices.getDirtyBegin(), _vertices.getDirtyEnd());
+        markDirty(frame.indices, _indices.getDirtyBegin(), _indices.getDirtyEnd());
+    }
+
+    _vertices.clearDirtyRange();
+    _indices.clearDirtyRange();
+
+    // Without persistent mapping, glBufferSubData takes care of the synchronisation
+    auto numFrameBuffers = persistentMappingAvailable() ? _frameBuffers.size() : 1;
+
+    // Move on to the next set, the GPU might still be drawing from the current one
+    _currentFrame = (_currentFrame + 1) % numFrameBuffers;
+    auto& frame = _frameBuffers[_currentFrame];
+
+    syncBuffer(frame.vertices, frame.fence, _vertices.getBufferStart(), sizeof(ArbitraryMeshVertex),
+        _vertices.getCapacity());
+    syncBuffer(frame.indices, frame.fence, _indices.getBufferStart(), sizeof(unsigned int),
+        _indices.getCapacity());
+}
+
+void GeometryStore::syncBuffer(BufferObject& buffer, GLsync& fence, const void* data,
+    std::size_t elementSize, std::size_t capacity)
+{
+    auto requiredSize = capacity * elementSize;
+
+    // The continuous buffer has been resized (or we don't have a buffer object yet),
+    // the whole data needs to be transferred to a new buffer object. The GL
+    // keeps the old one alive until all pending draw calls are done.
+    if (buffer.id == 0 || buffer.size != requiredSize)
+    {
+        deleteBufferObject(buffer);
+        createBufferObject(buffer, requiredSize, data);
+        clearDirtyRange(buffer);
+        return;
+    }
+
+    if (buffer.dirtyBegin >= buffer.dirtyEnd) return; // nothing changed
+
+    auto offset = buffer.dirtyBegin * elementSize;
+    auto size = (buffer.dirtyEnd - buffer.dirtyBegin) * elementSize;
+    auto source = static_cast<const char*>(data) + offset;
+
+    if (buffer.mappedData != nullptr)
+    {
+        // Don't overwrite anything the GPU might still be reading from. This only
+        // blocks if the frame last drawn from this set is still being processed.
+        waitForFence(fence);
+        std::memcpy(static_cast<char*>(buffer.mappedData) + offset, source, size);
+    }
+    else
+    {
+        glBindBuffer(buffer.target, buffer.id);
+        glBufferSubData(buffer.target, offset, size, source);
+        glBindBuffer(buffer.target, 0);
+    }
+
+    clearDirtyRange(buffer);
+
+    debug::assertNoGlErrors();
+}
+
+void GeometryStore::createBufferObject(BufferObject& buffer, std::size_t size, const void* data)
+{
+    glGenBuffers(1, &buffer.id);
+    glBindBuffer(buffer.target, buffer.id);
+
+    if (persistentMappingAvailable())
+    {
+        glBufferStorage(buffer.target, size, data, PERSISTENT_MAP_FLAGS);
+        buffer.mappedData = glMapBufferRange(buffer.target, 0, size, PERSISTENT_MAP_FLAGS);
+    }
+    else
+    {
+        glBufferData(buffer.target, size, data, GL_DYNAMIC_DRAW);
+    }
+
+    glBindBuffer(buffer.target, 0);
+    buffer.size = size;
+
+    debug::assertNoGlErrors();
+}
+
+void GeometryStore::deleteBufferObject(BufferObject& buffer)
+{
+    if (buffer.id == 0) return;
+
+    if (buffer.mappedData != nullptr)
+    {
+        glBindBuffer(buffer.target, buffer.id);
+        glUnmapBuffer(buffer.target);
+        glBindBuffer(buffer.target, 0);
+        buffer.mappedData = nullptr;
+    }
+
+    glDeleteBuffers(1, &buffer.id);
+    buffer.id = 0;
+    buffer.size = 0;
+}
+
+void GeometryStore::waitForFence(GLsync& fence)
+{
+    if (fence == nullptr) return;
+
+    while (true)
+    {
+        auto result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+        if (result != GL_TIMEOUT_EXPIRED) break; // got signaled (or failed)
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void GeometryStore::onFrameFinished()
+{
+    auto& frame = _frameBuffers[_currentFrame];
+
+    // Only persistently mapped buffers need the fence
+    if (frame.vertices.mappedData == nullptr && frame.indices.mappedData == nullptr) return;
+
+    if (frame.fence != nullptr)
+    {
+        glDeleteSync(frame.fence);
+    }
+
+    frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void GeometryStore::destroyBufferObjects()
+{
+    for (auto& frame : _frameBuffers)
+    {
+        if (frame.fence != nullptr)
+        {
+            glDeleteSync(frame.fence);
+            frame.fence = nullptr;
+        }
+
+        deleteBufferObject(frame.vertices);
+        deleteBufferObject(frame.indices);
+    }
+
+    _currentFrame = 0;
+}
+
+void GeometryStore::bindBuffers(RenderStateFlags flags)
+{
+    using Traits = VertexTraits<ArbitraryMeshVertex>;
+
+    const char* base = nullptr;
+    const auto& frame = _frameBuffers[_currentFrame];
+
+    if (frame.vertices.id != 0 && frame.indices.id != 0)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, frame.vertices.id);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, frame.indices.id);
+    }
+    else
+    {
+        // No buffer objects, pass the client memory
+        base = reinterpret_cast<const char*>(_vertices.getBufferStart());
+    }
+
+    const GLsizei stride = sizeof(ArbitraryMeshVertex);
+    auto offset = [&](const void* attributeOffset)
+    {
+        return base + reinterpret_cast<std::size_t>(attributeOffset);
+    };
+
+    glVertexPointer(3, GL_DOUBLE, stride, offset(Traits::VERTEX_OFFSET()));
+
+    if (flags & RENDER_LIGHTING)
+    {
+        // The normal array has already been enabled by the shader pass
+        glNormalPointer(GL_DOUBLE, stride, offset(Traits::NORMAL_OFFSET()));
+    }
+
+    if (flags & (RENDER_TEXTURE_2D | RENDER_TEXTURE_CUBEMAP))
+    {
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(2, GL_DOUBLE, stride, offset(Traits::TEXCOORD_OFFSET()));
+    }
+
+    if (flags & RENDER_VERTEX_COLOUR)
+    {
+        glEnableClientState(GL_COLOR_ARRAY);
+        glColorPointer(3, GL_DOUBLE, stride,
+            base + offsetof(ArbitraryMeshVertex, colour));
+    }
+
+    debug::assertNoGlErrors();
+}
+
+void GeometryStore::unbindBuffers(RenderStateFlags flags)
+{
+    if (flags & RENDER_VERTEX_COLOUR)
+    {
+        glDisableClientState(GL_COLOR_ARRAY);
+    }
+
+    if (flags & (RENDER_TEXTURE_2D | RENDER_TEXTURE_CUBEMAP))
+    {
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    }
+
+    const auto& frame = _frameBuffers[_currentFrame];
+
+    if (frame.vertices.id != 0 && frame.indices.id != 0)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+}
+
+const GLvoid* GeometryStore::getIndexPointer(std::size_t firstIndex) const
+{
+    if (_frameBuffers[_currentFrame].indices.id != 0)
+    {
+        return reinterpret_cast<const GLvoid*>(firstIndex * sizeof(unsigned int));
+    }
+
+    return _indices.getBufferStart() + firstIndex;
+}
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include "irender.h"
+#include "igl.h"
+#include "render/ArbitraryMeshVertex.h"
+#include "ContinuousBuffer.h"
+
+namespace render
+{
+
+/**
+ * \brief
+ * Implementation of the IGeometryStore interface, owned by the OpenGLRenderSystem.
+ *
+ * All vertices and indices are kept in two continuous buffers in client memory,
+ * which are mirrored to GL buffer objects. If the GL implementation supports
+ * it, the buffer objects are persistently mapped, such that changed ranges can be
+ * copied over without any further GL calls. In this case a few sets of buffer
+ * objects are used in turns, each of them fenced separately.
+ *
+ * Indices are stored rebased to the slot's position in the vertex buffer, which
+ * allows the backend to draw any number of slots using glMultiDrawElements.
+ */
+class GeometryStore final :
+    public IGeometryStore
+{
+private:
+    ContinuousBuffer<ArbitraryMeshVertex> _vertices;
+    ContinuousBuffer<unsigned int> _indices;
+
+    // A GL buffer object mirroring one of the continuous buffers
+    struct BufferObject
+    {
+        GLenum target = 0;
+        GLuint id = 0;
+        std::size_t size = 0; // in bytes
+
+        // Non-null if the buffer is persistently mapped
+        void* mappedData = nullptr;
+
+        // Element range [begin, end) changed since this buffer object has last been written to
+        std::size_t dirtyBegin = 0;
+        std::size_t dirtyEnd = 0;
+    };
+
+    // The buffer objects used to draw a single frame
+    struct FrameBuffers
+    {
+        BufferObject vertices;
+        BufferObject indices;
+
+        // Fence placed after the last frame drawn from these buffers, to be waited
+        // on before writing to them again (used with persistent mapping only)
+        GLsync fence = nullptr;
+    };
+
+    // Persistently mapped buffers are used in turns, such that a frame never needs
+    // to wait for the GPU to finish drawing the previous one before the data can
+    // be updated. Without persistent mapping only the first set is used.
+    static constexpr std::size_t NumFrameBuffers = 3;
+    std::array<FrameBuffers, NumFrameBuffers> _frameBuffers;
+
+    // The set used for drawing the current frame
+    std::size_t _currentFrame;
+
+public:
+    GeometryStore();
+    ~GeometryStore();
+
+    // IGeometryStore implementation
+    Slot allocateSlot(std::size_t numVertices, std::size_t numIndices) override;
+    void updateData(Slot slot, const std::vector<ArbitraryMeshVertex>& vertices,
+        const std::vector<unsigned int>& indices) override;
+    void deallocateSlot(Slot slot) override;
+    RenderParameters getRenderParameters(Slot slot) const override;
+
+    // Backend methods, these need a current GL context
+
+    // Transfer all data modified since the last call to the buffer objects
+    void syncToBufferObjects();
+
+    // Bind the buffer objects and set the vertex array pointers according to
+    // the given render flags. In case no buffer objects are available, the
+    // pointers are set up to use the client memory.
+    void bindBuffers(RenderStateFlags flags);
+    void unbindBuffers(RenderStateFlags flags);
+
+    // Returns the offset to pass to glDrawElements for the given index position
+    const GLvoid* getIndexPointer(std::size_t firstIndex) const;
+
+    // Called after all draw calls of a frame have been issued
+    void onFrameFinished();
+
+    // Release the GL buffer objects, data will be re-uploaded on the next sync
+    void destroyBufferObjects();
+
+private:
+    void syncBuffer(BufferObject& buffer, GLsync& fence, const void* data,
+        std::size_t elementSize, std::size_t capacity);
+    void createBufferObject(BufferObject& buffer, std::size_t size, const void* data);
+    void deleteBufferObject(BufferObject& buffer);
+    void waitForFence(GLsync& fence);
+
+    static void markDirty(BufferObject& buffer, std::size_t begin, std::size_t end);
+    static void clearDirtyRange(BufferObject& buffer);
+};
+
+}
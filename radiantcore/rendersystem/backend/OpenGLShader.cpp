@@ -110,6 +110,20 @@ void OpenGLShader::addRenderable(const OpenGLRenderable& renderable,
     }
 }
 
+void OpenGLShader::addGeometry(IGeometryStore::Slot slot, GeometryType type)
+{
+    if (!_isVisible) return;
+
+    for (const OpenGLShaderPassPtr& pass : _shaderPasses)
+    {
+        // Store geometry is not lit, so it cannot be drawn in interaction passes
+        if (!pass->state().testRenderFlag(RENDER_BUMP))
+        {
+            pass->addGeometry(slot, type);
+        }
+    }
+}
+
 void OpenGLShader::setVisible(bool visible)
 {
     // Control visibility by inserting or removing our shader passes from the GL
@@ -95,6 +95,7 @@ public:
 					   const Matrix4& modelview,
 					   const LightSources* lights,
                        const IRenderEntity* entity) override;
+    void addGeometry(IGeometryStore::Slot slot, GeometryType type) override;
     void setVisible(bool visible) override;
     bool isVisible() const override;
     void incrementUsed() override;
@@ -1,5 +1,6 @@
 #include "OpenGLShaderPass.h"
 #include "OpenGLShader.h"
+#include "../OpenGLRenderSystem.h"
 
 #include "math/Matrix4.h"
 #include "math/AABB.h"
@@ -541,15 +542,21 @@ void OpenGLShaderPass::addRenderable(const OpenGLRenderable& renderable,
 {
     if (entity)
     {
-        // Find or insert the render entity in our map
-        auto i = _renderables.find(entity);
-        if (i == _renderables.end())
+        // Find or assign the bucket of this render entity
+        auto i = _entityBuckets.find(entity);
+        if (i == _entityBuckets.end())
         {
-            i = _renderables.insert(std::make_pair(entity, Renderables())).first;
+            auto bucket = static_cast<std::uint32_t>(_entityBuckets.size());
+            i = _entityBuckets.insert(std::make_pair(entity, bucket)).first;
+
+            if (bucket == _entityRenderables.size())
+            {
+                _entityRenderables.emplace_back();
+            }
         }
 
         // Add this renderable to the list of renderables associated with the entity
-        i->second.push_back(
+        _entityRenderables[i->second].push_back(
             TransformedRenderable(renderable, modelview, light, entity)
         );
     }
@@ -561,43 +568,170 @@ void OpenGLShaderPass::addRenderable(const OpenGLRenderable& renderable,
     }
 }
 
-// Render the bucket contents
-void OpenGLShaderPass::render(OpenGLState& current,
-                              unsigned int flagsMask,
-                              const Vector3& viewer,
-                              std::size_t time)
+void OpenGLShaderPass::addGeometry(IGeometryStore::Slot slot, GeometryType type)
 {
-    // Reset the texture matrix
-    glMatrixMode(GL_TEXTURE);
-    glLoadMatrixd(Matrix4::getIdentity());
+    _geometry[type].push_back(slot);
+}
 
-    glMatrixMode(GL_MODELVIEW);
+bool OpenGLShaderPass::hasGeometry() const
+{
+    for (const auto& pair : _geometry)
+    {
+        if (!pair.second.empty()) return true;
+    }
 
-    // Apply our state to the current state object
-    applyState(current, flagsMask, viewer, time, NULL);
+    return false;
+}
 
-    if (!_renderablesWithoutEntity.empty())
+namespace
+{
+
+inline GLenum getPrimitiveMode(GeometryType type)
+{
+    switch (type)
     {
-        renderAllContained(_renderablesWithoutEntity, current, viewer, time);
+    case GeometryType::Triangles: return GL_TRIANGLES;
+    case GeometryType::Lines: return GL_LINES;
+    case GeometryType::Points: return GL_POINTS;
     }
 
-    for (RenderablesByEntity::const_iterator i = _renderables.begin();
-         i != _renderables.end();
-         ++i)
+    throw std::logic_error("Unknown geometry type");
+}
+
+}
+
+void OpenGLShaderPass::drawGeometry(OpenGLState& current, FrameStatistics& stats)
+{
+    if (!hasGeometry()) return;
+
+    auto& store = _owner.getRenderSystem().getGeometryStore();
+
+    store.bindBuffers(current.getRenderFlags());
+
+    for (auto& pair : _geometry)
     {
+        auto& slots = pair.second;
+
+        if (slots.empty()) continue;
+
+        _drawCounts.clear();
+        _drawIndices.clear();
+
+        for (auto slot : slots)
+        {
+            auto params = store.getRenderParameters(slot);
+
+            if (params.indexCount == 0) continue;
+
+            _drawCounts.push_back(static_cast<GLsizei>(params.indexCount));
+            _drawIndices.push_back(store.getIndexPointer(params.firstIndex));
+        }
+
+        if (!_drawCounts.empty())
+        {
+            glMultiDrawElements(getPrimitiveMode(pair.first), _drawCounts.data(),
+                GL_UNSIGNED_INT, _drawIndices.data(), static_cast<GLsizei>(_drawCounts.size()));
+            ++stats.drawCalls;
+        }
+
+        slots.clear();
+    }
+
+    store.unbindBuffers(current.getRenderFlags());
+
+    debug::assertNoGlErrors();
+}
+
+void OpenGLShaderPass::addToRenderQueue(RenderQueue& queue, std::size_t passIndex)
+{
+    auto sortKey = queue.getSortKey(_glState, passIndex);
+
+    if (!_renderablesWithoutEntity.empty() || hasGeometry())
+    {
+        queue.add(sortKey, *this, nullptr, RenderQueue::NoEntityBucket);
+    }
+
+    for (const auto& pair : _entityBuckets)
+    {
+        queue.add(sortKey, *this, pair.first, pair.second);
+    }
+}
+
+// Render the bucket contents
+void OpenGLShaderPass::render(const RenderQueue::Entry& entry,
+                              const RenderQueue::Entry* previous,
+                              OpenGLState& current,
+                              unsigned int flagsMask,
+                              const Vector3& viewer,
+                              std::size_t time,
+                              FrameStatistics& stats)
+{
+    bool continuesPass = previous != nullptr && previous->pass == this;
+
+    // Consecutive buckets of the same pass only need to re-apply the state
+    // if the stages have to be evaluated against the new entity
+    if (continuesPass && !hasEntityDependentState())
+    {
+        ++stats.skippedStateChanges;
+    }
+    else
+    {
+        if (!continuesPass)
+        {
+            // Reset the texture matrix
+            glMatrixMode(GL_TEXTURE);
+            glLoadMatrixd(Matrix4::getIdentity());
+
+            glMatrixMode(GL_MODELVIEW);
+        }
+
         // Apply our state to the current state object
-        applyState(current, flagsMask, viewer, time, i->first);
+        applyState(current, flagsMask, viewer, time, entry.entity);
+        ++stats.stateChanges;
+    }
 
-        if (!stateIsActive())
+    if (entry.bucket == RenderQueue::NoEntityBucket)
+    {
+        if (!_renderablesWithoutEntity.empty())
         {
-            continue;
+            renderAllContained(_renderablesWithoutEntity, current, viewer, time, stats);
         }
 
-        renderAllContained(i->second, current, viewer, time);
+        // Geometry store slots are not associated to an entity either
+        drawGeometry(current, stats);
+        return;
+    }
+
+    if (!stateIsActive())
+    {
+        return;
     }
 
+    renderAllContained(_entityRenderables[entry.bucket], current, viewer, time, stats);
+}
+
+void OpenGLShaderPass::clearRenderables()
+{
     _renderablesWithoutEntity.clear();
-    _renderables.clear();
+
+    // Keep the bucket vectors, they are likely to be needed next frame
+    for (std::size_t i = 0; i < _entityBuckets.size(); ++i)
+    {
+        _entityRenderables[i].clear();
+    }
+
+    _entityBuckets.clear();
+
+    for (auto& pair : _geometry)
+    {
+        pair.second.clear();
+    }
+}
+
+bool OpenGLShaderPass::hasEntityDependentState() const
+{
+    return _glState.stage0 || _glState.stage1 || _glState.stage2 ||
+        _glState.stage3 || _glState.stage4;
 }
 
 bool OpenGLShaderPass::stateIsActive()
@@ -668,7 +802,8 @@ void OpenGLShaderPass::setUpLightingCalculation(OpenGLState& current,
 void OpenGLShaderPass::renderAllContained(const Renderables& renderables,
                                           OpenGLState& current,
                                           const Vector3& viewer,
-                                          std::size_t time)
+                                          std::size_t time,
+                                          FrameStatistics& stats)
 {
     // Keep a pointer to the last transform matrix used
     const Matrix4* transform = nullptr;
@@ -712,6 +847,8 @@ void OpenGLShaderPass::renderAllContained(const Renderables& renderables,
         r.renderable->render(info);
     }
 
+    stats.drawCalls += renderables.size();
+
     // Cleanup
     glPopMatrix();
 }
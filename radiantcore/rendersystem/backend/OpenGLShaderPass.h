@@ -3,6 +3,8 @@
 #include "math/Vector3.h"
 #include "math/Matrix4.h"
 #include "iglrender.h"
+#include "igeometrystore.h"
+#include "RenderQueue.h"
 
 #include <vector>
 #include <map>
@@ -16,6 +18,7 @@ namespace render
 {
 
 class OpenGLShader;
+struct FrameStatistics;
 
 /**
  * @brief A single component pass of an OpenGL shader.
@@ -66,9 +69,19 @@ protected:
 	typedef std::vector<TransformedRenderable> Renderables;
 	Renderables _renderablesWithoutEntity;
 
-	// Renderables sorted by RenderEntity
-	typedef std::map<const IRenderEntity*, Renderables> RenderablesByEntity;
-	RenderablesByEntity _renderables;
+	// Renderables sorted by RenderEntity, each entity refers to a bucket
+	// in _entityRenderables. The buckets are re-used in the next frame.
+	typedef std::map<const IRenderEntity*, std::uint32_t> EntityBuckets;
+	EntityBuckets _entityBuckets;
+	std::vector<Renderables> _entityRenderables;
+
+	// Geometry store slots submitted for this frame, sorted by primitive type
+	typedef std::map<GeometryType, std::vector<IGeometryStore::Slot>> GeometrySlots;
+	GeometrySlots _geometry;
+
+	// Buffers for the glMultiDrawElements arguments, kept to avoid re-allocations
+	std::vector<GLsizei> _drawCounts;
+	std::vector<const GLvoid*> _drawIndices;
 
 protected:
 
@@ -93,13 +106,20 @@ protected:
 	// Returns true if the stage associated to this pass is active and should be rendered
 	bool stateIsActive();
 
+	// Returns true if any of the stages needs to be evaluated for each entity
+	bool hasEntityDependentState() const;
+
 	void setupTextureMatrix(GLenum textureUnit, const IShaderLayer::Ptr& stage);
 
 	// Render all of the given TransformedRenderables
 	void renderAllContained(const Renderables& renderables,
 							OpenGLState& current,
 						    const Vector3& viewer,
-							std::size_t time);
+							std::size_t time,
+							FrameStatistics& stats);
+
+	// Draw all submitted geometry store slots, one multi-draw call per primitive type
+	void drawGeometry(OpenGLState& current, FrameStatistics& stats);
 
     /* Helper functions to enable/disable particular GL states */
 
@@ -154,6 +174,12 @@ public:
 					   const RendererLight* light = nullptr,
                        const IRenderEntity* entity = nullptr);
 
+	/**
+	 * Add a slot of the render system's geometry store to be drawn in
+	 * this pass. Geometry slots are drawn without any transform or light.
+	 */
+	void addGeometry(IGeometryStore::Slot slot, GeometryType type);
+
 	/**
 	 * Return the OpenGL state associated with this bucket.
 	 */
@@ -172,9 +198,19 @@ public:
 		return &_glState;
 	}
 
+	/**
+	 * Add one render queue entry for each entity this pass has renderables
+	 * for, plus one for the renderables and geometry without entity.
+	 */
+	void addToRenderQueue(RenderQueue& queue, std::size_t passIndex);
+
 	/**
 	 * \brief
-     * Render the renderables attached to this shader pass.
+     * Render the bucket referred to by the given render queue entry.
+     *
+     * \param previous
+     * The entry rendered right before this one (or nullptr). If it refers to
+     * the same pass, state changes are only applied if required.
      *
      * \param current
      * The current OpenGL state variables.
@@ -184,22 +220,32 @@ public:
      *
      * \param viewer
      * Viewer location in world space.
-     *
      */
-	void render(OpenGLState& current,
+	void render(const RenderQueue::Entry& entry,
+				const RenderQueue::Entry* previous,
+				OpenGLState& current,
 				unsigned int flagsMask,
 				const Vector3& viewer,
-				std::size_t time);
+				std::size_t time,
+				FrameStatistics& stats);
+
+	/**
+	 * Remove all renderables and geometry submitted during this frame.
+	 */
+	void clearRenderables();
 
 	/**
 	 * Returns true if this shaderpass doesn't have anything to render.
 	 */
 	bool empty() const
 	{
-		return _renderables.empty() && _renderablesWithoutEntity.empty();
+		return _entityBuckets.empty() && _renderablesWithoutEntity.empty() && !hasGeometry();
 	}
 
 	friend std::ostream& operator<<(std::ostream& st, const OpenGLShaderPass& self);
+
+private:
+	bool hasGeometry() const;
 };
 
 typedef std::shared_ptr<OpenGLShaderPass> OpenGLShaderPassPtr;
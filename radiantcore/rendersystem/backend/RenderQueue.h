@@ -0,0 +1,149 @@
+#pragma once
+
+#include "irender.h"
+#include "iglrender.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+class IRenderEntity;
+
+namespace render
+{
+
+class OpenGLShaderPass;
+
+/**
+ * \brief
+ * Flat list of draw buckets, rebuilt by the render system on every frame.
+ *
+ * Every non-empty shader pass adds one entry per entity it has renderables
+ * for. The entries are sorted by a 64-bit key derived from the pass state,
+ * such that passes sharing the same program, texture and blend settings end
+ * up next to each other. The entry vector is kept between frames to avoid
+ * re-allocating it over and over.
+ *
+ * Key layout (most significant bits first):
+ *
+ * 63-51: sort position (biased to be non-negative)
+ * 50-47: GL program (per-frame table index, 0 = fixed function)
+ * 46-31: texture0
+ * 30-23: blend and depth settings
+ * 22-0:  pass index (in OpenGLStates order)
+ *
+ * Entries sharing the same key belong to the same pass, these are
+ * kept in submission order, i.e. the entity-less bucket comes first.
+ */
+class RenderQueue
+{
+public:
+    // Bucket index used for renderables without entity
+    static constexpr std::uint32_t NoEntityBucket = std::numeric_limits<std::uint32_t>::max();
+
+    struct Entry
+    {
+        std::uint64_t sortKey;
+
+        // Submission order, used as tie-breaker
+        std::uint32_t order;
+
+        // The bucket index within the pass (or NoEntityBucket)
+        std::uint32_t bucket;
+
+        OpenGLShaderPass* pass;
+        const IRenderEntity* entity;
+    };
+
+private:
+    std::vector<Entry> _entries;
+
+    // Programs seen during this frame, the index + 1 is used in the sort key
+    std::vector<const GLProgram*> _programs;
+
+    static constexpr unsigned int ProgramBits = 4;
+    static constexpr std::size_t MaxProgramSlot = (1 << ProgramBits) - 1;
+    static constexpr std::uint64_t PassIndexMask = (1 << 23) - 1;
+
+public:
+    void clear()
+    {
+        _entries.clear();
+        _programs.clear();
+    }
+
+    bool empty() const
+    {
+        return _entries.empty();
+    }
+
+    std::size_t size() const
+    {
+        return _entries.size();
+    }
+
+    // Calculate the sort key of the given pass state
+    std::uint64_t getSortKey(const OpenGLState& state, std::size_t passIndex)
+    {
+        auto sortPos = static_cast<std::uint64_t>(state.getSortPosition() - OpenGLState::SORT_FIRST);
+
+        std::uint64_t blendDepth = 0;
+
+        if (state.testRenderFlag(RENDER_BLEND))
+        {
+            blendDepth |= 0x80 | (((state.m_blend_src * 31 + state.m_blend_dst) & 0x7) << 4);
+        }
+
+        if (state.testRenderFlag(RENDER_DEPTHWRITE))
+        {
+            blendDepth |= 0x08;
+        }
+
+        // The depth functions are GL_NEVER..GL_ALWAYS (0x200..0x207)
+        blendDepth |= state.getDepthFunc() & 0x7;
+
+        return ((sortPos & 0x1FFF) << 51) |
+            (static_cast<std::uint64_t>(getProgramSlot(state.glProgram)) << 47) |
+            ((static_cast<std::uint64_t>(state.texture0) & 0xFFFF) << 31) |
+            (blendDepth << 23) |
+            (passIndex & PassIndexMask);
+    }
+
+    void add(std::uint64_t sortKey, OpenGLShaderPass& pass, const IRenderEntity* entity, std::uint32_t bucket)
+    {
+        _entries.push_back(Entry{ sortKey, static_cast<std::uint32_t>(_entries.size()), bucket, &pass, entity });
+    }
+
+    void sort()
+    {
+        std::sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b)
+        {
+            return a.sortKey != b.sortKey ? a.sortKey < b.sortKey : a.order < b.order;
+        });
+    }
+
+    const std::vector<Entry>& getEntries() const
+    {
+        return _entries;
+    }
+
+private:
+    std::size_t getProgramSlot(const GLProgram* program)
+    {
+        if (program == nullptr) return 0;
+
+        auto found = std::find(_programs.begin(), _programs.end(), program);
+
+        if (found != _programs.end())
+        {
+            return std::min<std::size_t>(found - _programs.begin() + 1, MaxProgramSlot);
+        }
+
+        _programs.push_back(program);
+
+        return std::min(_programs.size(), MaxProgramSlot);
+    }
+};
+
+}
@@ -3,6 +3,7 @@
 #include "inode.h"
 
 #include "OctreeNode.h"
+#include <vector>
 
 namespace scene
 {
@@ -126,6 +127,37 @@ ISPNodePtr Octree::getRoot() const
 	return _root;
 }
 
+void Octree::foreachNodeInBounds(const BoundsQuery& query, const std::function<bool(const INodePtr&)>& functor) const
+{
+	if (query.bounds.empty()) return;
+
+	// The root is always visited, it is holding the nodes not fitting into the tree
+	std::vector<const ISPNode*> stack(1, _root.get());
+
+	while (!stack.empty())
+	{
+		const auto* node = stack.back();
+		stack.pop_back();
+
+		for (const auto& member : node->getMembers())
+		{
+			if (query.matches(member->worldAABB()) && !functor(member))
+			{
+				return;
+			}
+		}
+
+		// The members of a child are within its bounds, skip the ones out of reach
+		for (const auto& child : node->getChildNodes())
+		{
+			if (query.touches(child->getBounds()))
+			{
+				stack.push_back(child.get());
+			}
+		}
+	}
+}
+
 void Octree::notifyLink(const scene::INodePtr& sceneNode, OctreeNode* node)
 {
 	std::pair<NodeMapping::iterator, bool> result =
@@ -63,6 +63,8 @@ public:
 	// Returns the root node of this SP tree
 	ISPNodePtr getRoot() const;
 
+	void foreachNodeInBounds(const BoundsQuery& query, const std::function<bool(const INodePtr&)>& functor) const override;
+
 	// Callback used by the OctreeNodes to let the tree update its caching structures
 	void notifyLink(const scene::INodePtr& sceneNode, OctreeNode* node);
 	void notifyUnlink(const scene::INodePtr& sceneNode, OctreeNode* node);
@@ -2,6 +2,7 @@
 
 #include "ivolumetest.h"
 #include "itextstream.h"
+#include "iprofiler.h"
 
 #include "scene/InstanceWalkers.h"
 #include "debugging/debugging.h"
@@ -227,6 +228,12 @@ void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, const INode::Visi
 
         foreachNodeInVolume_r(*root, volume, functor, visitHidden);
 
+        if (GlobalProfiler().isRunning())
+        {
+            GlobalProfiler().setCounter("Visited octree nodes", _visitedSPNodes);
+            GlobalProfiler().setCounter("Skipped octree nodes", _skippedSPNodes);
+        }
+
         _visitedSPNodes = _skippedSPNodes = 0;
     }
 
@@ -250,6 +257,20 @@ void SceneGraph::foreachVisibleNodeInVolume(const VolumeTest& volume, Walker& wa
 		false); // don't visit hidden
 }
 
+void SceneGraph::foreachNodeInBounds(const BoundsQuery& query, const INode::VisitorFunc& functor)
+{
+    // Update the bounds and the Octree before starting, see foreachNodeInVolume
+    if (_root != nullptr) _root->worldAABB();
+
+    {
+        util::ScopedBoolLock traversal(_traversalOngoing);
+
+        _spacePartition->foreachNodeInBounds(query, functor);
+    }
+
+    flushActionBuffer();
+}
+
 bool SceneGraph::foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& volume, 
 									   const INode::VisitorFunc& functor, bool visitHidden)
 {
@@ -334,7 +355,13 @@ const std::string& SceneGraphModule::getName() const
 
 const StringSet& SceneGraphModule::getDependencies() const
 {
-	static StringSet _dependencies; // no deps
+	static StringSet _dependencies;
+
+	if (_dependencies.empty())
+	{
+		_dependencies.insert(MODULE_PROFILER);
+	}
+
 	return _dependencies;
 }
 
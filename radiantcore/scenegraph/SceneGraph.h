@@ -90,6 +90,7 @@ public:
     void foreachVisibleNode(const INode::VisitorFunc& functor) override;
     void foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) override;
     void foreachVisibleNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) override;
+    void foreachNodeInBounds(const BoundsQuery& query, const INode::VisitorFunc& functor) override;
 
     ISpacePartitionSystemPtr getSpacePartition() override;
 private:
@@ -1,6 +1,7 @@
 #include "SceneGraphFactory.h"
 
 #include "itextstream.h"
+#include "iprofiler.h"
 #include "SceneGraph.h"
 
 namespace scene
@@ -19,7 +20,13 @@ const std::string& SceneGraphFactory::getName() const
 
 const StringSet& SceneGraphFactory::getDependencies() const
 {
-	static StringSet _dependencies; // no dependencies
+	static StringSet _dependencies;
+
+	if (_dependencies.empty())
+	{
+		_dependencies.insert(MODULE_PROFILER);
+	}
+
 	return _dependencies;
 }
 
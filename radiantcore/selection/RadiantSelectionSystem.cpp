@@ -8,6 +8,8 @@
 #include "iradiant.h"
 #include "ieventmanager.h"
 #include "ipreferencesystem.h"
+#include "iprofiler.h"
+#include "ibrush.h"
 #include "SelectionPool.h"
 #include "module/StaticModule.h"
 #include "brush/csg/CSG.h"
@@ -586,6 +588,11 @@ void RadiantSelectionSystem::deselectAll() {
 
 void RadiantSelectionSystem::selectPoint(SelectionTest& test, EModifier modifier, bool face)
 {
+    profiling::ScopedZone zone("Select point");
+
+    // Build the windings of all changed brushes at once, before the selection tests do it one by one
+    GlobalBrushCreator().evaluateChangedBrushes();
+
     // If the user is holding the replace modifiers (default: Alt-Shift), deselect the current selection
     if (modifier == SelectionSystem::eReplace) {
         if (face) {
@@ -715,6 +722,11 @@ void RadiantSelectionSystem::performPointSelection(const SelectablesList& candid
 
 void RadiantSelectionSystem::selectArea(SelectionTest& test, SelectionSystem::EModifier modifier, bool face)
 {
+    profiling::ScopedZone zone("Select area");
+
+    // Build the windings of all changed brushes at once, before the selection tests do it one by one
+    GlobalBrushCreator().evaluateChangedBrushes();
+
     // If we are in replace mode, deselect all the components or previous selections
     if (modifier == SelectionSystem::eReplace)
     {
@@ -15,6 +15,7 @@
 #include "selectionlib.h"
 #include "entitylib.h"
 #include "scene/SelectionIndex.h"
+#include "ispacepartition.h"
 
 #include "SelectionPolicies.h"
 #include "selection/SceneWalkers.h"
@@ -31,6 +32,7 @@
 #include "patch/PatchNode.h"
 
 #include <stack>
+#include <unordered_set>
 
 namespace selection
 {
@@ -537,53 +539,56 @@ void deleteSelectionCmd(const cmd::ArgumentList& args)
 /**
  * Selects all objects that intersect one of the bounding AABBs.
  * The exact intersection-method is specified through TSelectionPolicy,
- * which must implement an evalute() method taking an AABB and the scene::INodePtr.
+ * which must implement an evalute() method taking an AABB and the scene::INodePtr,
+ * and a getCandidateQuery() method returning the spatial query for the given AABBs.
+ *
+ * Only the candidates returned by the scene's space partition are evaluated.
+ * The result is the same as if the scene had been traversed from the root,
+ * skipping hidden subgraphs and the children of selected nodes.
  */
 template<class TSelectionPolicy>
-class SelectByBounds :
-	public scene::NodeVisitor
+class SelectByBounds
 {
-    const std::vector<AABB>& _aabbs;	// selection aabbs
-	TSelectionPolicy policy;	// type that contains a custom intersection method aabb<->aabb
-
 public:
-	SelectByBounds(const std::vector<AABB>& aabbs) :
-		_aabbs(aabbs)
-	{}
-
-	bool pre(const scene::INodePtr& node) override
-    {
-		// Don't traverse hidden nodes
-		if (!node->visible()) return false;
-
-		ISelectablePtr selectable = Node_getSelectable(node);
-
-		// ignore worldspawn
-        Entity* entity = Node_getEntity(node);
+	// Returns the nodes passing the policy test against any of the given AABBs
+	static std::vector<scene::INodePtr> FindNodes(const std::vector<AABB>& aabbs)
+	{
+		TSelectionPolicy policy;
 
-		if (entity != NULL && entity->isWorldspawn())
-        {
-			return true;
-		}
+		std::vector<scene::INodePtr> candidates;
+		std::unordered_set<const scene::INode*> passed;
 
-    	bool selected = false;
+		GlobalSceneGraph().foreachNodeInBounds(policy.getCandidateQuery(aabbs), [&](const scene::INodePtr& node)
+		{
+			if (!isSelectionCandidate(node)) return true;
 
-		if (selectable && node->getParent() && !node->isRoot())
-        {
-			for (const auto& aabb : _aabbs)
-            {
+			for (const auto& aabb : aabbs)
+			{
 				// Check if the selectable passes the AABB test
 				if (policy.evaluate(aabb, node))
-                {
-					selectable->setSelected(true);
-					selected = true;
+				{
+					candidates.push_back(node);
+					passed.insert(node.get());
 					break;
 				}
 			}
+
+			return true;
+		});
+
+		std::vector<scene::INodePtr> result;
+		result.reserve(candidates.size());
+
+		for (const auto& node : candidates)
+		{
+			// Children of selected nodes are not considered
+			if (!hasAncestorIn(node, passed))
+			{
+				result.push_back(node);
+			}
 		}
 
-		// Only traverse the children of this node, if the node itself couldn't be selected
-		return !selected;
+		return result;
 	}
 
 	/**
@@ -628,8 +633,10 @@ public:
 
     static void DoSelection(const std::vector<AABB>& aabbs)
     {
-        SelectByBounds<TSelectionPolicy> walker(aabbs);
-        GlobalSceneGraph().root()->traverse(walker);
+        for (const auto& node : FindNodes(aabbs))
+        {
+            Node_setSelected(node, true);
+        }
 
         SceneChangeNotify();
     }
@@ -638,6 +645,41 @@ public:
     {
         DoSelection(std::vector<AABB>{ bounds });
     }
+
+private:
+	static bool isSelectionCandidate(const scene::INodePtr& node)
+	{
+		if (!Node_getSelectable(node) || !node->getParent() || node->isRoot())
+		{
+			return false;
+		}
+
+		// ignore worldspawn
+		Entity* entity = Node_getEntity(node);
+
+		if (entity != nullptr && entity->isWorldspawn())
+		{
+			return false;
+		}
+
+		// Hidden nodes and the children of hidden nodes are not considered
+		for (auto n = node; n; n = n->getParent())
+		{
+			if (!n->visible()) return false;
+		}
+
+		return true;
+	}
+
+	static bool hasAncestorIn(const scene::INodePtr& node, const std::unordered_set<const scene::INode*>& nodes)
+	{
+		for (auto parent = node->getParent(); parent; parent = parent->getParent())
+		{
+			if (nodes.count(parent.get()) > 0) return true;
+		}
+
+		return false;
+	}
 };
 
 void selectInside(const cmd::ArgumentList& args)
@@ -794,8 +836,7 @@ void snapSelectionToGrid(const cmd::ArgumentList& args)
 	}
 }
 
-class IntersectionFinder :
-	public scene::NodeVisitor
+class IntersectionFinder
 {
 private:
 	const Ray& _ray;
@@ -816,9 +857,9 @@ public:
 		return _bestPoint;
 	}
 
-	bool pre(const scene::INodePtr& node)
+	bool visit(const scene::INodePtr& node)
 	{
-		if (node == _self) return false;
+		if (isSelfOrChildOfSelf(node)) return true;
 		if (!node->visible()) return true;
 
 		const AABB& aabb = node->worldAABB();
@@ -854,6 +895,17 @@ public:
 
 		return true;
 	}
+
+private:
+	bool isSelfOrChildOfSelf(const scene::INodePtr& node) const
+	{
+		for (auto n = node; n; n = n->getParent())
+		{
+			if (n == _self) return true;
+		}
+
+		return false;
+	}
 };
 
 Vector3 getLowestVertexOfModel(const model::IModel& model, const Matrix4& localToWorld)
@@ -935,7 +987,15 @@ void floorNode(const scene::INodePtr& node)
 	Ray ray(objectOrigin + Vector3(0, 0, 1), Vector3(0, 0, -1));
 
 	IntersectionFinder finder(ray, node);
-	GlobalSceneGraph().root()->traverseChildren(finder);
+
+	// Only the nodes in the vertical column around the trace need to be tested
+	scene::BoundsQuery column({ AABB(ray.origin, Vector3(0, 0, 0)) }, scene::BoundsQueryType::ColumnIntersects);
+	column.columnAxis = 2;
+
+	GlobalSceneGraph().foreachNodeInBounds(column, [&](const scene::INodePtr& candidate)
+	{
+		return finder.visit(candidate);
+	});
 
 	if ((finder.getIntersection() - ray.origin).getLengthSquared() > 0)
 	{
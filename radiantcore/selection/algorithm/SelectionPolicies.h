@@ -3,6 +3,13 @@
 #include "math/AABB.h"
 #include "ilightnode.h"
 #include "iorthoview.h"
+#include "ispacepartition.h"
+
+/**
+ * Besides the evaluate() method, each policy provides a BoundsQuery returning
+ * all candidates possibly passing the test against the given boxes, such that
+ * only a small part of the scene needs to be evaluated.
+ */
 
 /**
   SelectionPolicy for SelectByBounds
@@ -25,14 +32,37 @@ public:
 			other = light->getSelectAABB();
 		}
 
-		// Determine the viewtype
-		EViewType viewType = GlobalXYWndManager().getActiveViewType();
+		unsigned int axis1 = 0;
+		unsigned int axis2 = 1;
+		getViewAxes(axis1, axis2);
 
+		// Check if the AABB is contained
+		auto dist1 = fabs(other.origin[axis1] - box.origin[axis1]) + fabs(other.extents[axis1]);
+		auto dist2 = fabs(other.origin[axis2] - box.origin[axis2]) + fabs(other.extents[axis2]);
+
+		return (dist1 < fabs(box.extents[axis1]) && dist2 < fabs(box.extents[axis2]));
+	}
+
+	scene::BoundsQuery getCandidateQuery(const std::vector<AABB>& boxes) const
+	{
 		unsigned int axis1 = 0;
 		unsigned int axis2 = 1;
+		getViewAxes(axis1, axis2);
+
+		scene::BoundsQuery query(boxes, scene::BoundsQueryType::ColumnIntersects);
 
-		// Determine which axes have to be compared
-		switch (viewType) {
+		// The column is extending along the axis perpendicular to the view
+		query.columnAxis = 3 - axis1 - axis2;
+		query.tolerance = LIGHT_DIAMOND_EXTENTS;
+
+		return query;
+	}
+
+private:
+	// Determine which axes have to be compared, based on the active view type
+	static void getViewAxes(unsigned int& axis1, unsigned int& axis2)
+	{
+		switch (GlobalXYWndManager().getActiveViewType()) {
 			case XY:
 				axis1 = 0;
 				axis2 = 1;
@@ -46,12 +76,6 @@ public:
 				axis2 = 2;
 			break;
 		};
-
-		// Check if the AABB is contained
-		auto dist1 = fabs(other.origin[axis1] - box.origin[axis1]) + fabs(other.extents[axis1]);
-		auto dist2 = fabs(other.origin[axis2] - box.origin[axis2]) + fabs(other.extents[axis2]);
-
-		return (dist1 < fabs(box.extents[axis1]) && dist2 < fabs(box.extents[axis2]));
 	}
 };
 
@@ -73,6 +97,11 @@ public:
 
 		return true;
 	}
+
+	scene::BoundsQuery getCandidateQuery(const std::vector<AABB>& boxes) const
+	{
+		return scene::BoundsQuery(boxes, scene::BoundsQueryType::Intersects);
+	}
 };
 
 /**
@@ -103,6 +132,15 @@ public:
 
 		return true;
 	}
+
+	scene::BoundsQuery getCandidateQuery(const std::vector<AABB>& boxes) const
+	{
+		// Lights are tested using their diamond, which might exceed the light volume
+		scene::BoundsQuery query(boxes, scene::BoundsQueryType::Intersects);
+		query.tolerance = LIGHT_DIAMOND_EXTENTS;
+
+		return query;
+	}
 };
 
 /**
@@ -136,4 +174,12 @@ public:
 
         return true;
     }
+    scene::BoundsQuery getCandidateQuery(const std::vector<AABB>& boxes) const
+    {
+        // Lights are tested using their diamond, which might exceed the light volume
+        scene::BoundsQuery query(boxes, scene::BoundsQueryType::Intersects);
+        query.tolerance = LIGHT_DIAMOND_EXTENTS;
+
+        return query;
+    }
 };
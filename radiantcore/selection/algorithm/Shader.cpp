@@ -1,8 +1,10 @@
 #include "Shader.h"
 
+#include <set>
 #include "i18n.h"
 #include "iselection.h"
 #include "iscenegraph.h"
+#include "imap.h"
 #include "itextstream.h"
 #include "iselectiontest.h"
 #include "igroupnode.h"
@@ -783,60 +785,40 @@ void normaliseTexture(const cmd::ArgumentList& args)
 	radiant::TextureChangedMessage::Send();
 }
 
-class ByShaderSelector :
-	public scene::NodeVisitor
+namespace
 {
-private:
-	std::string _shaderName;
 
-	bool _select;
-
-public:
-	ByShaderSelector(const std::string& shaderName, bool select = true) :
-		_shaderName(shaderName),
-		_select(select)
-	{}
-
-	bool pre(const scene::INodePtr& node)
-	{
-		Brush* brush = Node_getBrush(node);
-
-		if (brush != NULL)
-		{
-			if (brush->hasShader(_shaderName))
-			{
-				Node_setSelected(node, _select);
-			}
-
-			return false; // don't traverse primitives
-		}
-
-		Patch* patch = Node_getPatch(node);
+// (De-)selects all brushes and patches using the given material
+void setSelectionByShader(const std::string& shaderName, bool select)
+{
+	const auto& root = GlobalSceneGraph().root();
 
-		if (patch != NULL)
-		{
-			if (patch->getShader() == _shaderName)
-			{
-				Node_setSelected(node, _select);
-			}
+	if (!root) return;
 
-			return false; // don't traverse primitives
-		}
+	std::set<scene::INode*> nodes;
 
+	root->getMaterialUsageIndex().foreachUsage(shaderName, [&](const scene::MaterialUsage& usage)
+	{
+		nodes.insert(usage.node);
 		return true;
+	});
+
+	for (auto node : nodes)
+	{
+		Node_setSelected(node->getSelf(), select);
 	}
-};
+}
+
+}
 
 void selectItemsByShader(const std::string& shaderName)
 {
-	ByShaderSelector selector(shaderName, true);
-	GlobalSceneGraph().root()->traverseChildren(selector);
+	setSelectionByShader(shaderName, true);
 }
 
 void deselectItemsByShader(const std::string& shaderName)
 {
-	ByShaderSelector selector(shaderName, false);
-	GlobalSceneGraph().root()->traverseChildren(selector);
+	setSelectionByShader(shaderName, false);
 }
 
 void selectItemsByShaderCmd(const cmd::ArgumentList& args)
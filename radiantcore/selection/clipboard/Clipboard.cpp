@@ -7,11 +7,17 @@
 #include "imapformat.h"
 #include "iclipboard.h"
 #include "ishaderclipboard.h"
+#include "iselectiongroup.h"
+#include "iscenegraph.h"
 #include "string/trim.h"
+#include "scene/BasicRootNode.h"
+#include "scene/Clone.h"
+#include "scene/Traverse.h"
 
 #include "map/Map.h"
 #include "brush/FaceInstance.h"
 #include "map/algorithm/Import.h"
+#include "map/algorithm/MapExporter.h"
 #include "selection/algorithm/General.h"
 #include "selection/algorithm/Transformation.h"
 #include "command/ExecutionNotPossible.h"
@@ -23,8 +29,157 @@ namespace selection
 namespace clipboard
 {
 
+namespace
+{
+
+// Clones the visited nodes below the given root, keeping their selection
+// group memberships (using the same group IDs in the root's group manager)
+class SubgraphCloner :
+    public scene::NodeVisitor
+{
+private:
+    scene::IMapRootNodePtr _root;
+    scene::Path _path;
+
+public:
+    SubgraphCloner(const scene::IMapRootNodePtr& root) :
+        _root(root),
+        _path(root)
+    {}
+
+    bool pre(const scene::INodePtr& node) override
+    {
+        if (node->isRoot())
+        {
+            return false;
+        }
+
+        _path.push(scene::cloneSingleNode(node));
+        return true;
+    }
+
+    void post(const scene::INodePtr& node) override
+    {
+        if (node->isRoot())
+        {
+            return;
+        }
+
+        if (_path.top() && _path.parent())
+        {
+            _path.parent()->addChildNode(_path.top());
+            copyGroups(node, _path.top());
+        }
+
+        _path.pop();
+    }
+
+private:
+    void copyGroups(const scene::INodePtr& source, const scene::INodePtr& clone)
+    {
+        auto groupSelectable = std::dynamic_pointer_cast<IGroupSelectable>(source);
+
+        if (!groupSelectable) return;
+
+        for (auto id : groupSelectable->getGroupIds())
+        {
+            _root->getSelectionGroupManager().findOrCreateSelectionGroup(id)->addNode(clone);
+        }
+    }
+};
+
+// The selection of the last copy operation, as detached clones. Pasting
+// them again doesn't need to go through the map text, which is only
+// generated when another application asks for the clipboard contents.
+std::shared_ptr<scene::BasicRootNode> _copiedNodes;
+sigc::connection _modulesUninitialisingConn;
+
+// Returns the copied nodes, as long as the system clipboard still holds them
+std::shared_ptr<scene::BasicRootNode> getCopiedNodes()
+{
+    if (_copiedNodes && module::GlobalModuleRegistry().moduleExists(MODULE_CLIPBOARD) &&
+        !GlobalClipboard().isProvidingString())
+    {
+        // Something else has been copied in the meantime
+        _copiedNodes.reset();
+    }
+
+    return _copiedNodes;
+}
+
+// Serialises the given nodes in the portable map format
+std::string exportToPortableFormat(const scene::IMapRootNodePtr& root)
+{
+    auto format = GlobalMapFormatManager().getMapFormatByName(map::PORTABLE_MAP_FORMAT_NAME);
+    auto writer = format->getMapWriter();
+
+    std::stringstream out;
+
+    {
+        map::MapExporter exporter(*writer, root, out);
+        exporter.disableProgressMessages();
+        exporter.exportMap(root, scene::traverse);
+    }
+
+    return out.str();
+}
+
+void copySelectedNodes()
+{
+    auto root = std::make_shared<scene::BasicRootNode>();
+
+    SubgraphCloner cloner(root);
+    scene::traverseSelected(GlobalSceneGraph().root(), cloner);
+
+    _copiedNodes = root;
+
+    // The nodes need to be gone before the modules are shut down
+    if (!_modulesUninitialisingConn.connected())
+    {
+        _modulesUninitialisingConn = module::GlobalModuleRegistry().signal_modulesUninitialising().connect(
+            []() { _copiedNodes.reset(); });
+    }
+
+    if (module::GlobalModuleRegistry().moduleExists(MODULE_CLIPBOARD))
+    {
+        std::weak_ptr<scene::BasicRootNode> weakRoot = root;
+
+        GlobalClipboard().setStringProvider([=]()
+        {
+            auto copiedRoot = weakRoot.lock();
+            return copiedRoot ? exportToPortableFormat(copiedRoot) : std::string();
+        });
+    }
+}
+
+void pasteCopiedNodes(const scene::IMapRootNodePtr& copiedNodes)
+{
+    GlobalSelectionSystem().setSelectedAll(false);
+
+    // Clone the nodes once more, the clipboard contents can be pasted many times
+    auto root = std::make_shared<scene::BasicRootNode>();
+
+    SubgraphCloner cloner(root);
+    copiedNodes->traverseChildren(cloner);
+
+    // Adjust all new names to fit into the existing map namespace
+    map::algorithm::prepareNamesForImport(GlobalMap().getRoot(), root);
+
+    map::algorithm::importMap(root);
+}
+
+}
+
 void pasteToMap()
 {
+    auto copiedNodes = getCopiedNodes();
+
+    if (copiedNodes)
+    {
+        pasteCopiedNodes(copiedNodes);
+        return;
+    }
+
 	if (!module::GlobalModuleRegistry().moduleExists(MODULE_CLIPBOARD))
 	{
 		throw cmd::ExecutionNotPossible(_("No clipboard module attached, cannot perform this action."));
@@ -38,20 +193,9 @@ void copy(const cmd::ArgumentList& args)
 {
 	if (FaceInstance::Selection().empty())
     {
-		if (!module::GlobalModuleRegistry().moduleExists(MODULE_CLIPBOARD))
-		{
-			throw cmd::ExecutionNotPossible(_("No clipboard module attached, cannot perform this action."));
-		}
-
-		// When exporting to the system clipboard, use the portable format
-		auto format = GlobalMapFormatManager().getMapFormatByName(map::PORTABLE_MAP_FORMAT_NAME);
-
-        // Stream selected objects into a stringstream
-        std::stringstream out;
-        GlobalMap().exportSelected(out, format);
-
-        // Copy the resulting string to the clipboard
-		GlobalClipboard().setString(out.str());
+        // Keep a copy of the selected nodes, the system clipboard receives
+        // the nodes in the portable map format when it's asking for text
+        copySelectedNodes();
 	}
 	else
 	{
@@ -61,7 +205,8 @@ void copy(const cmd::ArgumentList& args)
 
 std::string getMaterialNameFromClipboard()
 {
-    if (!module::GlobalModuleRegistry().moduleExists(MODULE_CLIPBOARD))
+    // Don't convert our own copied nodes to text, they're not a material name
+    if (!module::GlobalModuleRegistry().moduleExists(MODULE_CLIPBOARD) || getCopiedNodes())
     {
         return std::string();
     }
@@ -14,9 +14,10 @@ namespace clipboard
 void pasteToMap();
 
 /**
- * Either copies the current map selection to the clipboard (in map format)
- * or (when faces are selected component-wise) copies the current shader 
- * from selected faces.
+ * Either copies the current map selection to the clipboard or (when faces
+ * are selected component-wise) copies the current shader from selected faces.
+ * The selected nodes are kept as copies, they're converted to the portable
+ * map format only when another application requests the clipboard contents.
  */
 void copy(const cmd::ArgumentList& args);
 
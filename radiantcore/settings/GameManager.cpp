@@ -9,6 +9,7 @@
 #include "itextstream.h"
 #include "ifilesystem.h"
 #include "ipreferencesystem.h"
+#include "iprofiler.h"
 
 #include "os/file.h"
 #include "os/dir.h"
@@ -58,6 +59,7 @@ const StringSet& Manager::getDependencies() const
 		_dependencies.insert(MODULE_VIRTUALFILESYSTEM);
 		_dependencies.insert(MODULE_COMMANDSYSTEM);
 		_dependencies.insert(MODULE_PREFERENCESYSTEM);
+		_dependencies.insert(MODULE_PROFILER);
 		_dependencies.insert(MODULE_FILETYPES);
 	}
 
@@ -297,6 +299,8 @@ void Manager::setMapAndPrefabPaths(const std::string& baseGamePath)
 
 void Manager::initialiseVfs()
 {
+	profiling::ScopedZone zone("VFS initialise");
+
 	// Ensure that all paths are normalised
 	GameConfigUtil::EnsurePathsNormalised(_config);
 
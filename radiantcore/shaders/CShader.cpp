@@ -80,27 +80,55 @@ TexturePtr CShader::getEditorImage()
 {
     if (!_editorTexture)
     {
-        auto editorTex = _template->getEditorTexture();
+        // Pass the call to the GLTextureManager to realise this image
+        _editorTexture = GetTextureManager().getBinding(getEditorTextureExpression());
+    }
+
+    return _editorTexture;
+}
+
+bool CShader::isEditorImageRealised()
+{
+    return _editorTexture != nullptr;
+}
+
+Material::EditorImageLoader CShader::getEditorImageLoader()
+{
+    auto editorTex = getEditorTextureExpression();
 
-        if (!editorTex)
+    return [editorTex]()
+    {
+        return editorTex ? editorTex->getImage() : ImagePtr();
+    };
+}
+
+void CShader::realiseEditorImage(const ImagePtr& image)
+{
+    if (!_editorTexture)
+    {
+        _editorTexture = GetTextureManager().getBinding(getEditorTextureExpression(), image);
+    }
+}
+
+MapExpressionPtr CShader::getEditorTextureExpression()
+{
+    auto editorTex = _template->getEditorTexture();
+
+    if (!editorTex)
+    {
+        // If there is no editor expression defined, use the an image from a layer, but no Bump or speculars
+        for (const auto& layer : _layers)
         {
-            // If there is no editor expression defined, use the an image from a layer, but no Bump or speculars
-            for (const auto& layer : _layers)
+            if (layer->getType() != IShaderLayer::BUMP && layer->getType() != IShaderLayer::SPECULAR &&
+                std::dynamic_pointer_cast<MapExpression>(layer->getMapExpression()))
             {
-                if (layer->getType() != IShaderLayer::BUMP && layer->getType() != IShaderLayer::SPECULAR &&
-                    std::dynamic_pointer_cast<MapExpression>(layer->getMapExpression()))
-                {
-                    editorTex = std::static_pointer_cast<MapExpression>(layer->getMapExpression());
-                    break;
-                }
+                editorTex = std::static_pointer_cast<MapExpression>(layer->getMapExpression());
+                break;
             }
         }
-
-        // Pass the call to the GLTextureManager to realise this image
-        _editorTexture = GetTextureManager().getBinding(editorTex);
     }
 
-    return _editorTexture;
+    return editorTex;
 }
 
 IMapExpression::Ptr CShader::getEditorImageExpression()
@@ -390,6 +418,24 @@ void CShader::revertModifications()
     _sigMaterialModified.emit();
 }
 
+void CShader::setDefinition(const ShaderDefinition& definition)
+{
+    _originalTemplate = definition.shaderTemplate;
+    _template = _originalTemplate;
+    _fileInfo = definition.file;
+
+    subscribeToTemplateChanges();
+
+    // The images are acquired again from the new template
+    _editorTexture.reset();
+    _texLightFalloff.reset();
+
+    unrealise();
+    realise();
+
+    _sigMaterialModified.emit();
+}
+
 sigc::signal<void>& CShader::sig_materialChanged()
 {
     return _sigMaterialModified;
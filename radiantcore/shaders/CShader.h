@@ -68,6 +68,9 @@ public:
     IMapExpression::Ptr getEditorImageExpression() override;
     void setEditorImageExpressionFromString(const std::string& editorImagePath) override;
 	bool isEditorImageNoTex() override;
+    bool isEditorImageRealised() override;
+    EditorImageLoader getEditorImageLoader() override;
+    void realiseEditorImage(const ImagePtr& image) override;
 	TexturePtr lightFalloffImage() override;
 	std::string getName() const override;
 	bool IsInUse() const override;
@@ -152,6 +155,10 @@ public:
 
     void commitModifications();
     void revertModifications() override;
+
+    // Replaces the template and file info with the given (re-parsed) definition,
+    // discarding any modifications. Observers are notified through the changed signal.
+    void setDefinition(const ShaderDefinition& definition);
     sigc::signal<void>& sig_materialChanged() override;
 
     void refreshImageMaps() override;
@@ -163,6 +170,9 @@ private:
     void ensureTemplateCopy();
     void subscribeToTemplateChanges();
     void updateEditorImage();
+
+    // Returns the map expression the editor image is created from
+    MapExpressionPtr getEditorTextureExpression();
 };
 typedef std::shared_ptr<CShader> CShaderPtr;
 
@@ -13,6 +13,7 @@
 #include "iradiant.h"
 #include "igame.h"
 #include "iarchive.h"
+#include "iprofiler.h"
 
 #include "xmlutil/Node.h"
 #include "xmlutil/MissingXMLNodeException.h"
@@ -32,6 +33,7 @@
 #include "materials/ParseLib.h"
 #include "parser/DefBlockTokeniser.h"
 #include <functional>
+#include <chrono>
 
 namespace
 {
@@ -84,6 +86,8 @@ void Doom3ShaderSystem::destroy()
 
 ShaderLibraryPtr Doom3ShaderSystem::loadMaterialFiles()
 {
+    profiling::ScopedZone zone("Material parsing");
+
     // Get the shaders path and extension from the XML game file
     auto materialsFolder = getMaterialsFolderName();
     auto extension = getMaterialFileExtension();
@@ -152,9 +156,73 @@ void Doom3ShaderSystem::freeShaders() {
     activeShadersChangedNotify();
 }
 
-void Doom3ShaderSystem::refresh() {
-    unrealise();
-    realise();
+void Doom3ShaderSystem::refresh()
+{
+    if (!_realised)
+    {
+        realise();
+        return;
+    }
+
+    reloadChangedMaterialFiles();
+}
+
+void Doom3ShaderSystem::reloadChangedMaterialFiles()
+{
+    ensureDefsLoaded();
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Parse the changed files into a separate library
+    auto knownHashes = _library->getFileHashes();
+    ShaderLibraryPtr changes;
+
+    while (true)
+    {
+        changes = std::make_shared<ShaderLibrary>();
+
+        ShaderFileLoader<ShaderLibrary> loader(GlobalFileSystem(), *changes,
+            getMaterialsFolderName(), getMaterialFileExtension());
+        loader.parseFiles(knownHashes);
+
+        // The first declaration of a name wins, unchanged files declaring any of the
+        // names of the changed files are parsed along with them, in their original order
+        auto sharingFiles = _library->findFilesSharingDeclarations(*changes);
+
+        if (sharingFiles.empty()) break;
+
+        for (const auto& file : sharingFiles)
+        {
+            knownHashes.erase(file);
+        }
+    }
+
+    auto changeSet = _library->applyChangedFiles(*changes);
+
+    // Release the images no longer used by any material
+    _textureManager->checkBindings();
+
+    for (const auto& name : changeSet.removed)
+    {
+        _sigMaterialRemoved.emit(name);
+    }
+
+    for (const auto& name : changeSet.added)
+    {
+        _sigMaterialCreated.emit(name);
+    }
+
+    if (!changeSet.empty())
+    {
+        activeShadersChangedNotify();
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    rMessage() << "Material files reloaded: " << changeSet.numChangedFiles << " changed files, "
+        << changeSet.changed.size() << " changed, " << changeSet.added.size() << " added, "
+        << changeSet.removed.size() << " removed materials in " << duration << " ms" << std::endl;
 }
 
 // Is the shader system realised
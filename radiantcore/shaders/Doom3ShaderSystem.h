@@ -68,7 +68,7 @@ public:
 	// greebo: Emits the defs unloaded signal and frees the shaders
     void unrealise() override;
 
-	// Flushes the shaders from memory and reloads the material files
+	// Re-parses the changed material files and updates the affected materials
     void refresh() override;
 
 	// Is the shader system realised
@@ -152,6 +152,10 @@ private:
     * (doesn't load any textures yet).	*/
     ShaderLibraryPtr loadMaterialFiles();
 
+    // Parses the material files that changed since they were loaded and
+    // updates the definitions and realised materials in the existing library
+    void reloadChangedMaterialFiles();
+
 	void testShaderExpressionParsing();
 
     std::string ensureNonConflictingName(const std::string& name);
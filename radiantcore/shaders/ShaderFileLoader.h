@@ -1,6 +1,13 @@
 #pragma once
 
 #include <regex>
+#include <map>
+#include <set>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <sstream>
+#include <algorithm>
 
 #include "iarchive.h"
 #include "ifilesystem.h"
@@ -27,9 +34,18 @@ template<typename ShaderLibrary_T> class ShaderFileLoader
     // List of shader definition files to parse
     std::vector<vfs::FileInfo> _files;
 
+    // The blocks of a single file, as read by a worker thread
+    struct ParsedFile
+    {
+        std::size_t hash = 0;
+        bool parsed = false;
+        std::vector<parser::BlockTokeniser::Block> blocks;
+    };
+
 private:
 
-    bool parseTable(const parser::BlockTokeniser::Block& block, const vfs::FileInfo& fileInfo)
+    bool parseTable(const parser::BlockTokeniser::Block& block, const vfs::FileInfo& fileInfo,
+                    std::set<std::string>& declarations)
     {
         if (block.name.length() <= 5 || !string::starts_with(block.name, "table"))
         {
@@ -44,6 +60,7 @@ private:
         if (std::regex_match(block.name, matches, expr))
         {
             auto tableName = matches[1].str();
+            declarations.insert("table " + tableName);
 
             auto table = std::make_shared<TableDefinition>(tableName, block.contents);
 
@@ -58,20 +75,54 @@ private:
         return false;
     }
 
-    // Parse a shader file with the given contents and filename
-    void parseShaderFile(std::istream& inStr, const vfs::FileInfo& fileInfo)
+    // Read the file and split it into blocks, unless its hash matches the known one.
+    // This is called from the worker threads, it doesn't touch the library.
+    void readShaderFile(const vfs::FileInfo& fileInfo, const std::map<std::string, std::size_t>& knownHashes,
+                        ParsedFile& parsedFile)
     {
+        // Open the file
+        auto file = _vfs.openTextFile(fileInfo.fullPath());
+
+        if (!file)
+        {
+            throw std::runtime_error("Unable to read shaderfile: " + fileInfo.name);
+        }
+
+        std::istream is(&(file->getInputStream()));
+        std::string contents((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+
+        parsedFile.hash = std::hash<std::string>()(contents);
+
+        auto knownHash = knownHashes.find(fileInfo.fullPath());
+
+        if (knownHash != knownHashes.end() && knownHash->second == parsedFile.hash)
+        {
+            return; // unchanged
+        }
+
         // Parse the file with a blocktokeniser, the actual block contents
         // will be parsed separately.
-        parser::BasicDefBlockTokeniser<std::istream> tokeniser(inStr);
+        std::istringstream stream(contents);
+        parser::BasicDefBlockTokeniser<std::istream> tokeniser(stream);
+        parsedFile.parsed = true;
 
         while (tokeniser.hasMoreBlocks())
         {
-            // Get the next block
-            parser::BlockTokeniser::Block block = tokeniser.nextBlock();
+            parsedFile.blocks.emplace_back(tokeniser.nextBlock());
+        }
+    }
+
+    // Add the blocks of a shader file to the library
+    void parseShaderFile(ParsedFile& parsedFile, const vfs::FileInfo& fileInfo)
+    {
+        if (!parsedFile.parsed) return; // unchanged file
 
+        std::set<std::string> declarations;
+
+        for (auto& block : parsedFile.blocks)
+        {
             // Try to parse tables
-            if (parseTable(block, fileInfo))
+            if (parseTable(block, fileInfo, declarations))
             {
                 continue; // table successfully parsed
             }
@@ -87,6 +138,7 @@ private:
             }
 
             string::replace_all(block.name, "\\", "/"); // use forward slashes
+            declarations.insert(block.name);
 
             auto shaderTemplate = std::make_shared<ShaderTemplate>(block.name, block.contents);
 
@@ -99,6 +151,8 @@ private:
                 rError() << "[shaders] " << fileInfo.name << ": shader " << block.name << " already defined." << std::endl;
             }
         }
+
+        _library.setFileDeclarations(fileInfo.fullPath(), std::move(declarations));
     }
 
 public:
@@ -119,22 +173,41 @@ public:
         );
     }
 
-    void parseFiles()
+    /**
+     * Parse the material files and add their declarations to the library.
+     * The files are read and split into blocks in parallel, the declarations
+     * are added in file order. Files whose content hash matches the one in the given
+     * map are skipped. The hashes of all files are stored in the library.
+     */
+    void parseFiles(const std::map<std::string, std::size_t>& knownHashes = {})
     {
-        for (const vfs::FileInfo& fileInfo: _files)
-        {
-            // Open the file
-            auto file = _vfs.openTextFile(fileInfo.fullPath());
+        std::vector<ParsedFile> parsedFiles(_files.size());
 
-            if (file)
-            {
-                std::istream is(&(file->getInputStream()));
-                parseShaderFile(is, fileInfo);
-            }
-            else
+        auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), _files.size());
+
+        std::atomic<std::size_t> next(0);
+        std::vector<std::future<void>> workers;
+
+        for (std::size_t i = 0; i < numWorkers; ++i)
+        {
+            workers.emplace_back(std::async(std::launch::async, [&]()
             {
-                throw std::runtime_error("Unable to read shaderfile: " + fileInfo.name);
-            }
+                for (auto index = next++; index < _files.size(); index = next++)
+                {
+                    readShaderFile(_files[index], knownHashes, parsedFiles[index]);
+                }
+            }));
+        }
+
+        for (auto& worker : workers)
+        {
+            worker.get();
+        }
+
+        for (std::size_t i = 0; i < _files.size(); ++i)
+        {
+            _library.setFileHash(_files[i].fullPath(), parsedFiles[i].hash);
+            parseShaderFile(parsedFiles[i], _files[i]);
         }
     }
 };
@@ -1,6 +1,7 @@
 #include "ShaderLibrary.h"
 
 #include <iostream>
+#include <set>
 #include <utility>
 #include "iimage.h"
 #include "itextstream.h"
@@ -184,6 +185,8 @@ void ShaderLibrary::clear()
 	_shaders.clear();
 	_definitions.clear();
     _tables.clear();
+    _fileHashes.clear();
+    _fileDeclarations.clear();
 }
 
 std::size_t ShaderLibrary::getNumDefinitions()
@@ -222,4 +225,222 @@ bool ShaderLibrary::addTableDefinition(const TableDefinitionPtr& def)
     return result.second;
 }
 
+void ShaderLibrary::setFileHash(const std::string& fullPath, std::size_t hash)
+{
+    _fileHashes[fullPath] = hash;
+}
+
+const ShaderLibrary::FileHashes& ShaderLibrary::getFileHashes() const
+{
+    return _fileHashes;
+}
+
+void ShaderLibrary::setFileDeclarations(const std::string& fullPath, std::set<std::string>&& declarations)
+{
+    _fileDeclarations[fullPath] = std::move(declarations);
+}
+
+std::set<std::string> ShaderLibrary::findFilesSharingDeclarations(const ShaderLibrary& changes) const
+{
+    // The names declared by the parsed files, before and after the change
+    std::set<std::string> touched;
+
+    for (const auto& pair : changes._fileDeclarations)
+    {
+        touched.insert(pair.second.begin(), pair.second.end());
+
+        auto known = _fileDeclarations.find(pair.first);
+
+        if (known != _fileDeclarations.end())
+        {
+            touched.insert(known->second.begin(), known->second.end());
+        }
+    }
+
+    // The names declared by removed files
+    for (const auto& pair : _fileDeclarations)
+    {
+        if (changes._fileHashes.count(pair.first) == 0)
+        {
+            touched.insert(pair.second.begin(), pair.second.end());
+        }
+    }
+
+    std::set<std::string> result;
+
+    for (const auto& pair : _fileDeclarations)
+    {
+        if (changes._fileHashes.count(pair.first) == 0 || changes._fileDeclarations.count(pair.first) > 0)
+        {
+            continue; // removed or already parsed
+        }
+
+        for (const auto& name : pair.second)
+        {
+            if (touched.count(name) > 0)
+            {
+                result.insert(pair.first);
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+ShaderLibrary::ChangeSet ShaderLibrary::applyChangedFiles(ShaderLibrary& changes)
+{
+    ChangeSet result;
+
+    // The parsed files (changed ones and the ones sharing declarations with them) and the removed ones
+    std::set<std::string> changedFiles;
+
+    for (const auto& pair : _fileHashes)
+    {
+        auto found = changes._fileHashes.find(pair.first);
+
+        if (found == changes._fileHashes.end())
+        {
+            changedFiles.insert(pair.first);
+            ++result.numChangedFiles;
+        }
+        else if (found->second != pair.second)
+        {
+            ++result.numChangedFiles;
+        }
+    }
+
+    for (const auto& pair : changes._fileHashes)
+    {
+        if (_fileHashes.count(pair.first) == 0)
+        {
+            ++result.numChangedFiles;
+        }
+    }
+
+    for (const auto& pair : changes._fileDeclarations)
+    {
+        changedFiles.insert(pair.first);
+    }
+
+    std::set<std::string> previousTables;
+
+    for (const auto& file : changedFiles)
+    {
+        auto declarations = _fileDeclarations.find(file);
+
+        if (declarations == _fileDeclarations.end()) continue;
+
+        for (const auto& name : declarations->second)
+        {
+            if (name.compare(0, 6, "table ") == 0)
+            {
+                previousTables.insert(name.substr(6));
+            }
+        }
+
+        _fileDeclarations.erase(declarations);
+    }
+
+    for (auto& pair : changes._fileDeclarations)
+    {
+        _fileDeclarations[pair.first] = std::move(pair.second);
+    }
+
+    _fileHashes = changes._fileHashes;
+
+    if (changedFiles.empty())
+    {
+        return result;
+    }
+
+    // Take out the definitions of the changed files
+    ShaderDefinitionMap previous;
+
+    for (auto i = _definitions.begin(); i != _definitions.end();)
+    {
+        if (changedFiles.count(i->second.file.fullPath()) > 0)
+        {
+            previous.insert(_definitions.extract(i++));
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    for (const auto& pair : changes._definitions)
+    {
+        auto existing = _definitions.find(pair.first);
+
+        if (existing != _definitions.end())
+        {
+            // Files sharing a declaration with the changed ones are parsed along with them
+            // (see findFilesSharingDeclarations), otherwise keep the existing definition
+            if (_fileHashes.count(existing->second.file.fullPath()) > 0)
+            {
+                rError() << "[shaders] " << pair.second.file.name << ": shader " << pair.first << " already defined." << std::endl;
+                continue;
+            }
+
+            // This replaces an auto-generated or an unsaved definition
+            previous.insert(_definitions.extract(existing));
+        }
+
+        auto old = previous.find(pair.first);
+
+        if (old == previous.end())
+        {
+            _definitions.emplace(pair.first, pair.second);
+            result.added.push_back(pair.first);
+            continue;
+        }
+
+        if (old->second.shaderTemplate->getBlockContents() == pair.second.shaderTemplate->getBlockContents())
+        {
+            // Unchanged declaration, keep the existing template
+            old->second.file = pair.second.file;
+            _definitions.insert(previous.extract(old));
+            continue;
+        }
+
+        previous.erase(old);
+        _definitions.emplace(pair.first, pair.second);
+        result.changed.push_back(pair.first);
+    }
+
+    // Whatever is left is no longer declared in any file
+    for (const auto& pair : previous)
+    {
+        result.removed.push_back(pair.first);
+    }
+
+    // Replace the tables of the parsed and removed files
+    for (const auto& name : previousTables)
+    {
+        _tables.erase(name);
+    }
+
+    for (const auto& pair : changes._tables)
+    {
+        _tables[pair.first] = pair.second;
+    }
+
+    // Update the realised materials, removed ones will receive a default definition
+    for (const auto& names : { result.changed, result.removed })
+    {
+        for (const auto& name : names)
+        {
+            auto shader = _shaders.find(name);
+
+            if (shader != _shaders.end())
+            {
+                shader->second->setDefinition(getDefinition(name));
+            }
+        }
+    }
+
+    return result;
+}
+
 } // namespace shaders
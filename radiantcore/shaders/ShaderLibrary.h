@@ -3,6 +3,8 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <vector>
+#include <set>
 #include "CShader.h"
 #include "TableDefinition.h"
 
@@ -11,6 +13,29 @@ namespace shaders
 
 class ShaderLibrary
 {
+public:
+    // Content hashes of the parsed material files, keyed by their full VFS path
+    typedef std::map<std::string, std::size_t> FileHashes;
+
+    // The material and table ("table <name>") declarations of each parsed material file
+    typedef std::map<std::string, std::set<std::string>> FileDeclarations;
+
+    // The material names affected by applyChangedFiles()
+    struct ChangeSet
+    {
+        std::size_t numChangedFiles = 0;
+
+        std::vector<std::string> added;
+        std::vector<std::string> changed;
+        std::vector<std::string> removed;
+
+        bool empty() const
+        {
+            return added.empty() && changed.empty() && removed.empty();
+        }
+    };
+
+private:
 	// The shader definitions act as precursor for a real shader
 	// These are referenced by name.
 	ShaderDefinitionMap _definitions;
@@ -24,6 +49,9 @@ class ShaderLibrary
 
     std::unique_ptr<ShaderDefinition> _emptyDefinition;
 
+    FileHashes _fileHashes;
+    FileDeclarations _fileDeclarations;
+
 public:
 
 	/* greebo: Add a shader definition to the internal list
@@ -80,6 +108,35 @@ public:
 
     // Method for adding tables, returns FALSE if a def with the same name already exists
     bool addTableDefinition(const TableDefinitionPtr& def);
+
+    // Remembers the content hash of a parsed material file
+    void setFileHash(const std::string& fullPath, std::size_t hash);
+
+    const FileHashes& getFileHashes() const;
+
+    // Remembers the declarations found in a parsed material file
+    void setFileDeclarations(const std::string& fullPath, std::set<std::string>&& declarations);
+
+    /**
+     * Returns the files known to this library which are unchanged according to the
+     * given library, but declare any of the names declared by the changed or removed
+     * files, before or after the change. If a name is declared more than once, the
+     * first declaration in file order wins, these files need to be parsed again
+     * along with the changed ones to arrive at the same result.
+     */
+    std::set<std::string> findFilesSharingDeclarations(const ShaderLibrary& changes) const;
+
+    /**
+     * Merges the given library into this one. The other library has been
+     * populated from the material files whose hashes differ from the ones known
+     * to this library (plus the ones returned by findFilesSharingDeclarations()),
+     * it knows the hashes of all current material files.
+     *
+     * The definitions and tables of the parsed or removed files are replaced,
+     * declarations whose contents didn't change keep their existing template.
+     * Realised materials of changed or removed definitions are updated in place.
+     */
+    ChangeSet applyChangedFiles(ShaderLibrary& changes);
 };
 typedef std::shared_ptr<ShaderLibrary> ShaderLibraryPtr;
 
@@ -38,18 +38,10 @@ void GLTextureManager::checkBindings()
     }
 }
 
-TexturePtr GLTextureManager::getBinding(const NamedBindablePtr& bindable)
+TexturePtr GLTextureManager::findOrBindTexture(const std::string& identifier,
+    const std::function<TexturePtr()>& bindTexture)
 {
-    // Check if we got an empty MapExpression, and return the NOT FOUND texture
-    // if so
-    if (!bindable)
-    {
-        return getShaderNotFound();
-    }
-
     // Check if we already have the texture, otherwise construct it
-    auto identifier = bindable->getIdentifier();
-
     auto existing = _textures.find(identifier);
 
     if (existing != _textures.end())
@@ -59,18 +51,47 @@ TexturePtr GLTextureManager::getBinding(const NamedBindablePtr& bindable)
     }
 
     // Create and insert texture object, if it is valid
-    auto texture = bindable->bindTexture(identifier);
+    auto texture = bindTexture();
 
     if (texture)
     {
         _textures.emplace(identifier, texture);
         return texture;
     }
-     
+
     rError() << "[shaders] Unable to load texture: " << identifier << std::endl;
     return getShaderNotFound();
 }
 
+TexturePtr GLTextureManager::getBinding(const NamedBindablePtr& bindable)
+{
+    // Check if we got an empty MapExpression, and return the NOT FOUND texture
+    // if so
+    if (!bindable)
+    {
+        return getShaderNotFound();
+    }
+
+    auto identifier = bindable->getIdentifier();
+
+    return findOrBindTexture(identifier, [&]() { return bindable->bindTexture(identifier); });
+}
+
+TexturePtr GLTextureManager::getBinding(const MapExpressionPtr& expression, const ImagePtr& image)
+{
+    if (!expression)
+    {
+        return getShaderNotFound();
+    }
+
+    auto identifier = expression->getIdentifier();
+
+    return findOrBindTexture(identifier, [&]()
+    {
+        return image ? image->bindTexture(identifier) : TexturePtr();
+    });
+}
+
 TexturePtr GLTextureManager::getBinding(const std::string& fullPath)
 {
     // check if the texture has to be loaded
@@ -3,6 +3,7 @@
 
 #include "ishaders.h"
 #include <map>
+#include <functional>
 #include "../MapExpression.h"
 #include "texturelib.h"
 
@@ -23,6 +24,10 @@ private:
 	// Constructs the fallback textures like "Shader Image Missing"
 	TexturePtr loadStandardTexture(const std::string& filename);
 
+	// Returns the cached texture with the given identifier, or binds and caches
+	// the one returned by the given function. Falls back to the not-found texture.
+	TexturePtr findOrBindTexture(const std::string& identifier, const std::function<TexturePtr()>& bindTexture);
+
 public:
 
     /**
@@ -31,6 +36,14 @@ public:
      */
 	TexturePtr getBinding(const NamedBindablePtr& bindable);
 
+    /**
+     * \brief
+     * Construct a bound texture from the given image, which has been produced
+     * by the map expression beforehand (e.g. in a worker thread). If the
+     * texture of this expression exists already, the image is not used.
+     */
+	TexturePtr getBinding(const MapExpressionPtr& expression, const ImagePtr& image);
+
 	/** greebo: This loads a texture directly from the disk using the
 	 * 			specified <fullPath>.
 	 *
@@ -3,6 +3,7 @@
 #include "itextstream.h"
 #include "ifilesystem.h"
 #include "iarchive.h"
+#include "iprofiler.h"
 #include "module/StaticModule.h"
 
 #include <iostream>
@@ -69,6 +70,8 @@ void Doom3SkinCache::ensureDefsLoaded()
 
 void Doom3SkinCache::loadSkinFiles()
 {
+	profiling::ScopedZone zone("Skin defs parsing");
+
 	rMessage() << "[skins] Loading skins." << std::endl;
 
 	// Use a functor to traverse the skins directory, catching any parse
@@ -216,6 +219,7 @@ const StringSet& Doom3SkinCache::getDependencies() const
 	if (_dependencies.empty())
     {
 		_dependencies.insert(MODULE_VIRTUALFILESYSTEM);
+		_dependencies.insert(MODULE_PROFILER);
 	}
 
 	return _dependencies;
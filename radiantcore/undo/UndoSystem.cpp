@@ -5,6 +5,7 @@
 #include "itextstream.h"
 #include "ipreferencesystem.h"
 #include "iscenegraph.h"
+#include "iprofiler.h"
 
 #include <iostream>
 
@@ -96,6 +97,8 @@ void UndoSystem::finish(const std::string& command)
 
 void UndoSystem::undo()
 {
+	profiling::ScopedZone zone("Undo");
+
 	if (_undoStack.empty())
 	{
 		rMessage() << "Undo: no undo available" << std::endl;
@@ -131,6 +134,8 @@ void UndoSystem::undo()
 
 void UndoSystem::redo()
 {
+	profiling::ScopedZone zone("Redo");
+
 	if (_redoStack.empty())
 	{
 		rMessage() << "Redo: no redo available" << std::endl;
@@ -1,6 +1,7 @@
 #include "DeflatedInputStream.h"
 
 #include <zlib.h>
+#include "iprofiler.h"
 
 namespace archive
 {
@@ -24,6 +25,8 @@ DeflatedInputStream::~DeflatedInputStream()
 
 DeflatedInputStream::size_type DeflatedInputStream::read(byte_type* buffer, size_type length)
 {
+	profiling::ScopedZone zone("VFS inflate");
+
 	// Tell inflate() to load the data directly to the given buffer
 	_zipStream->next_out = buffer;
 	_zipStream->avail_out = static_cast<uInt>(length);
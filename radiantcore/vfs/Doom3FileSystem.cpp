@@ -23,6 +23,7 @@
 #include "iregistry.h"
 #include "igame.h"
 #include "itextstream.h"
+#include "iprofiler.h"
 
 #include "string/string.h"
 #include "string/join.h"
@@ -227,6 +228,8 @@ FileInfo Doom3FileSystem::getFileInfo(const std::string& vfsRelativePath)
 
 ArchiveFilePtr Doom3FileSystem::openFile(const std::string& filename)
 {
+    profiling::ScopedZone zone("VFS open file");
+
     if (filename.find("\\") != std::string::npos)
     {
         rError() << "Filename contains backslash: " << filename << std::endl;
@@ -262,6 +265,8 @@ ArchiveFilePtr Doom3FileSystem::openFileInAbsolutePath(const std::string& filena
 
 ArchiveTextFilePtr Doom3FileSystem::openTextFile(const std::string& filename)
 {
+    profiling::ScopedZone zone("VFS open text file");
+
     for (const ArchiveDescriptor& descriptor : _archives)
     {
         ArchiveTextFilePtr file = descriptor.archive->openTextFile(filename);
@@ -313,6 +318,8 @@ void Doom3FileSystem::forEachFile(const std::string& basedir,
                                   const VisitorFunc& visitorFunc,
                                   std::size_t depth)
 {
+    profiling::ScopedZone zone("VFS file traversal");
+
     std::string dirWithSlash = os::standardPathWithSlash(basedir);
 
     // Look for an assets.lst in the base dir
@@ -436,6 +443,12 @@ const std::string& Doom3FileSystem::getName() const
 const StringSet& Doom3FileSystem::getDependencies() const
 {
     static StringSet _dependencies;
+
+    if (_dependencies.empty())
+    {
+        _dependencies.insert(MODULE_PROFILER);
+    }
+
     return _dependencies;
 }
 
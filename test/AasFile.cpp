@@ -0,0 +1,165 @@
+#include "RadiantTest.h"
+
+#include <fstream>
+#include <sstream>
+#include "iaasfile.h"
+#include "math/Ray.h"
+#include "os/fs.h"
+
+namespace test
+{
+
+using AasFileTest = RadiantTest;
+
+namespace
+{
+
+map::IAasFilePtr loadTestAasFile(const std::string& path)
+{
+    std::ifstream stream(path);
+    EXPECT_TRUE(stream) << "Cannot open " << path;
+
+    auto loader = GlobalAasFileManager().getLoaderForStream(stream);
+    EXPECT_TRUE(loader) << "No loader for " << path;
+
+    stream.seekg(0, std::ios_base::beg);
+
+    return loader ? loader->loadFromStream(stream) : map::IAasFilePtr();
+}
+
+void expectAasFilesAreEqual(const map::IAasFile& a, const map::IAasFile& b)
+{
+    EXPECT_EQ(a.getNumPlanes(), b.getNumPlanes());
+    EXPECT_EQ(a.getNumVertices(), b.getNumVertices());
+    EXPECT_EQ(a.getNumEdges(), b.getNumEdges());
+    EXPECT_EQ(a.getNumEdgeIndexes(), b.getNumEdgeIndexes());
+    EXPECT_EQ(a.getNumFaces(), b.getNumFaces());
+    EXPECT_EQ(a.getNumFaceIndexes(), b.getNumFaceIndexes());
+    ASSERT_EQ(a.getNumAreas(), b.getNumAreas());
+
+    for (std::size_t i = 0; i < a.getNumVertices(); ++i)
+    {
+        EXPECT_EQ(a.getVertex(i), b.getVertex(i));
+    }
+
+    for (int i = 0; i < static_cast<int>(a.getNumAreas()); ++i)
+    {
+        EXPECT_EQ(a.getArea(i).flags, b.getArea(i).flags);
+        EXPECT_EQ(a.getArea(i).firstFace, b.getArea(i).firstFace);
+        EXPECT_EQ(a.getArea(i).numFaces, b.getArea(i).numFaces);
+        EXPECT_EQ(a.getArea(i).bounds.getOrigin(), b.getArea(i).bounds.getOrigin());
+        EXPECT_EQ(a.getArea(i).bounds.getExtents(), b.getArea(i).bounds.getExtents());
+        EXPECT_EQ(a.getArea(i).center, b.getArea(i).center);
+    }
+}
+
+}
+
+TEST_F(AasFileTest, ParseAasFile)
+{
+    auto aasFile = loadTestAasFile(_context.getTestProjectPath() + "maps/aas_test.aas48");
+    ASSERT_TRUE(aasFile);
+
+    EXPECT_EQ(aasFile->getNumPlanes(), 2);
+    EXPECT_EQ(aasFile->getNumVertices(), 4);
+    EXPECT_EQ(aasFile->getNumEdges(), 3);
+    EXPECT_EQ(aasFile->getNumEdgeIndexes(), 4);
+    EXPECT_EQ(aasFile->getNumFaces(), 3);
+    EXPECT_EQ(aasFile->getNumFaceIndexes(), 2);
+    ASSERT_EQ(aasFile->getNumAreas(), 3);
+
+    EXPECT_EQ(aasFile->getVertex(3), Vector3(128, 64, 64));
+    EXPECT_EQ(aasFile->getArea(1).bounds.getOrigin(), Vector3(32, 32, 32));
+    EXPECT_EQ(aasFile->getArea(2).bounds.getOrigin(), Vector3(96, 32, 32));
+    EXPECT_EQ(aasFile->getArea(2).bounds.getExtents(), Vector3(32, 32, 32));
+}
+
+TEST_F(AasFileTest, FindAreaByPoint)
+{
+    auto aasFile = loadTestAasFile(_context.getTestProjectPath() + "maps/aas_test.aas48");
+    ASSERT_TRUE(aasFile);
+
+    EXPECT_EQ(aasFile->findAreaByPoint(Vector3(10, 10, 10)), 1);
+    EXPECT_EQ(aasFile->findAreaByPoint(Vector3(100, 10, 10)), 2);
+    EXPECT_EQ(aasFile->findAreaByPoint(Vector3(500, 0, 0)), -1);
+}
+
+TEST_F(AasFileTest, PickArea)
+{
+    auto aasFile = loadTestAasFile(_context.getTestProjectPath() + "maps/aas_test.aas48");
+    ASSERT_TRUE(aasFile);
+
+    EXPECT_EQ(aasFile->pickArea(Ray(Vector3(-100, 32, 32), Vector3(1, 0, 0))), 1);
+    EXPECT_EQ(aasFile->pickArea(Ray(Vector3(300, 32, 32), Vector3(-1, 0, 0))), 2);
+    EXPECT_EQ(aasFile->pickArea(Ray(Vector3(-100, 32, 32), Vector3(-1, 0, 0))), -1);
+}
+
+TEST_F(AasFileTest, BinaryCacheRoundTrip)
+{
+    auto path = _context.getTestProjectPath() + "maps/aas_test.aas48";
+    auto aasFile = loadTestAasFile(path);
+    ASSERT_TRUE(aasFile);
+
+    std::ifstream stream(path);
+    auto loader = GlobalAasFileManager().getLoaderForStream(stream);
+    ASSERT_TRUE(loader);
+
+    std::stringstream cache;
+    EXPECT_TRUE(loader->writeBinaryCache(*aasFile, cache));
+
+    cache.seekg(0, std::ios_base::beg);
+    auto cachedFile = loader->loadFromBinaryCache(cache);
+    ASSERT_TRUE(cachedFile);
+
+    expectAasFilesAreEqual(*aasFile, *cachedFile);
+
+    // The spatial lookup is available on the cached file too
+    EXPECT_EQ(cachedFile->findAreaByPoint(Vector3(100, 10, 10)), 2);
+}
+
+TEST_F(AasFileTest, TruncatedBinaryCacheIsRejected)
+{
+    auto path = _context.getTestProjectPath() + "maps/aas_test.aas48";
+    auto aasFile = loadTestAasFile(path);
+    ASSERT_TRUE(aasFile);
+
+    std::ifstream stream(path);
+    auto loader = GlobalAasFileManager().getLoaderForStream(stream);
+    ASSERT_TRUE(loader);
+
+    std::stringstream cache;
+    EXPECT_TRUE(loader->writeBinaryCache(*aasFile, cache));
+
+    auto data = cache.str();
+    std::stringstream truncated(data.substr(0, data.size() / 2));
+
+    EXPECT_FALSE(loader->loadFromBinaryCache(truncated));
+}
+
+TEST_F(AasFileTest, LoadAasFileWritesCache)
+{
+    fs::path aasPath = _context.getTemporaryDataPath();
+    aasPath /= "aas_test.aas48";
+    fs::copy(_context.getTestProjectPath() + "maps/aas_test.aas48", aasPath);
+
+    fs::path cachePath = aasPath.string() + ".cache";
+    EXPECT_FALSE(fs::exists(cachePath));
+
+    map::AasFileInfo info;
+    info.absolutePath = aasPath.string();
+
+    auto aasFile = GlobalAasFileManager().loadAasFile(info);
+    ASSERT_TRUE(aasFile);
+    EXPECT_TRUE(fs::exists(cachePath)) << "Cache file has not been written";
+
+    // Second load is served from the cache
+    auto cachedFile = GlobalAasFileManager().loadAasFile(info);
+    ASSERT_TRUE(cachedFile);
+
+    expectAasFilesAreEqual(*aasFile, *cachedFile);
+
+    fs::remove(cachePath);
+    fs::remove(aasPath);
+}
+
+}
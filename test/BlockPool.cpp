@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+#include "util/BlockPool.h"
+
+namespace test
+{
+
+namespace
+{
+
+struct PooledObject
+{
+    std::string name;
+    double values[5];
+
+    PooledObject(const std::string& name_) :
+        name(name_),
+        values{ 0, 1, 2, 3, 4 }
+    {}
+};
+
+}
+
+TEST(BlockPoolTest, ReleasedBlocksAreReused)
+{
+    auto& pool = util::BlockPool<48, 8>::Instance();
+
+    auto first = pool.allocate();
+    pool.deallocate(first);
+
+    // The free list is handing out the most recently released block
+    auto second = pool.allocate();
+    EXPECT_EQ(first, second);
+
+    pool.deallocate(second);
+}
+
+TEST(BlockPoolTest, SharedObjectsAreCounted)
+{
+    auto before = util::getBlockPoolStatistics();
+
+    std::vector<std::shared_ptr<PooledObject>> objects;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        objects.emplace_back(util::makePooledShared<PooledObject>(std::to_string(i)));
+    }
+
+    auto during = util::getBlockPoolStatistics();
+
+    EXPECT_EQ(during.allocations - before.allocations, 1000);
+    EXPECT_EQ(during.liveBlocks - before.liveBlocks, 1000);
+    EXPECT_GT(during.chunks, 0);
+
+    EXPECT_EQ(objects[500]->name, "500");
+    EXPECT_EQ(objects[999]->values[4], 4);
+
+    // A weak reference keeps the block (holding the control block) alive
+    std::weak_ptr<PooledObject> weak = objects.front();
+    objects.clear();
+
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(util::getBlockPoolStatistics().liveBlocks, before.liveBlocks + 1);
+
+    weak.reset();
+
+    EXPECT_EQ(util::getBlockPoolStatistics().liveBlocks, before.liveBlocks);
+}
+
+}
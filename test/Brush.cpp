@@ -4,8 +4,13 @@
 #include "imap.h"
 #include "iselection.h"
 #include "itransformable.h"
+#include "iundo.h"
+#include "irender.h"
+#include "ipatch.h"
 #include "scenelib.h"
 #include "math/Quaternion.h"
+#include "algorithm/Primitives.h"
+#include "scene/MemoryReport.h"
 
 namespace test
 {
@@ -177,4 +182,273 @@ TEST_F(BrushTest, FacePlaneTranslate)
     });
 }
 
+TEST_F(BrushTest, FaceChangesAreUndoneWithBrush)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/numbers/1");
+
+    auto& face = Node_getIBrush(brush)->getFace(0);
+    auto originalProjection = face.getProjectionMatrix();
+
+    // Change the material and the texture projection of a single face
+    {
+        UndoableCommand cmd("changeFace");
+        face.setShader("textures/numbers/2");
+        face.shiftTexdef(0.5f, 0.25f);
+    }
+
+    auto changedProjection = face.getProjectionMatrix();
+
+    EXPECT_EQ(face.getShader(), "textures/numbers/2");
+    EXPECT_NE(changedProjection, originalProjection);
+
+    // The face state is part of the brush memento
+    GlobalUndoSystem().undo();
+
+    EXPECT_EQ(face.getShader(), "textures/numbers/1");
+    EXPECT_EQ(face.getProjectionMatrix(), originalProjection);
+
+    GlobalUndoSystem().redo();
+
+    EXPECT_EQ(face.getShader(), "textures/numbers/2");
+    EXPECT_EQ(face.getProjectionMatrix(), changedProjection);
+}
+
+// Brushes evaluated as part of the parallel batch produce the same windings as the ones built on their own
+TEST_F(BrushTest, ChangedBrushesAreEvaluatedInBatch)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto createBrush = [](const scene::INodePtr& parent, const Vector3& origin)
+    {
+        auto brushNode = parent ? algorithm::createCubicBrush(parent, origin) : GlobalBrushCreator().createBrush();
+
+        if (!parent)
+        {
+            // Same sequence as in createCubicBrush, without inserting the brush into the scene
+            auto& brush = *Node_getIBrush(brushNode);
+            auto translation = Matrix4::getTranslation(origin);
+
+            brush.addFace(Plane3(+1, 0, 0, 64).transform(translation));
+            brush.addFace(Plane3(-1, 0, 0, 64).transform(translation));
+            brush.addFace(Plane3(0, +1, 0, 64).transform(translation));
+            brush.addFace(Plane3(0, -1, 0, 64).transform(translation));
+            brush.addFace(Plane3(0, 0, +1, 64).transform(translation));
+            brush.addFace(Plane3(0, 0, -1, 64).transform(translation));
+            brush.setShader("_default");
+            brush.evaluateBRep();
+        }
+
+        // Cut off a corner, which changes the planes of the brush
+        Node_getIBrush(brushNode)->addFace(
+            Plane3(Vector3(1, 1, 1).getNormalised(), 32).transform(Matrix4::getTranslation(origin)));
+
+        return brushNode;
+    };
+
+    // Enough brushes to have them built in parallel
+    std::vector<scene::INodePtr> brushes;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        brushes.push_back(createBrush(worldspawn, Vector3(i * 160, (i % 7) * 32, 0)));
+    }
+
+    GlobalBrushCreator().evaluateChangedBrushes();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        auto reference = createBrush(scene::INodePtr(), Vector3(i * 160, (i % 7) * 32, 0));
+
+        auto& brush = *Node_getIBrush(brushes[i]);
+        auto& referenceBrush = *Node_getIBrush(reference);
+
+        brush.evaluateBRep();
+        referenceBrush.evaluateBRep();
+
+        ASSERT_EQ(brush.getNumFaces(), referenceBrush.getNumFaces());
+
+        for (std::size_t f = 0; f < brush.getNumFaces(); ++f)
+        {
+            EXPECT_EQ(brush.getFace(f).getWinding(), referenceBrush.getFace(f).getWinding())
+                << "Winding mismatch in face " << f << " of brush " << i;
+        }
+
+        scene::removeNodeFromParent(brushes[i]);
+    }
+}
+
+TEST_F(BrushTest, TransformedBrushesAreEvaluatedInBatch)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto createBrush = [](const scene::INodePtr& parent, const Vector3& origin)
+    {
+        auto brushNode = GlobalBrushCreator().createBrush();
+
+        if (parent)
+        {
+            parent->addChildNode(brushNode);
+        }
+
+        auto& brush = *Node_getIBrush(brushNode);
+        auto translation = Matrix4::getTranslation(origin);
+
+        brush.addFace(Plane3(+1, 0, 0, 64).transform(translation));
+        brush.addFace(Plane3(-1, 0, 0, 64).transform(translation));
+        brush.addFace(Plane3(0, +1, 0, 64).transform(translation));
+        brush.addFace(Plane3(0, -1, 0, 64).transform(translation));
+        brush.addFace(Plane3(0, 0, +1, 64).transform(translation));
+        brush.addFace(Plane3(0, 0, -1, 64).transform(translation));
+        brush.setShader("_default");
+        brush.evaluateBRep();
+
+        // Move the brush without freezing the transform, it's evaluated along with the windings
+        Node_getTransformable(brushNode)->setTranslation(Vector3(16, 32, 8));
+
+        return brushNode;
+    };
+
+    // Enough brushes to have them built in parallel
+    std::vector<scene::INodePtr> brushes;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        brushes.push_back(createBrush(worldspawn, Vector3(i * 160, (i % 7) * 32, 0)));
+    }
+
+    GlobalBrushCreator().evaluateChangedBrushes();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        auto reference = createBrush(scene::INodePtr(), Vector3(i * 160, (i % 7) * 32, 0));
+
+        auto& brush = *Node_getIBrush(brushes[i]);
+        auto& referenceBrush = *Node_getIBrush(reference);
+
+        brush.evaluateBRep();
+        referenceBrush.evaluateBRep();
+
+        ASSERT_EQ(brush.getNumFaces(), referenceBrush.getNumFaces());
+
+        for (std::size_t f = 0; f < brush.getNumFaces(); ++f)
+        {
+            EXPECT_EQ(brush.getFace(f).getWinding(), referenceBrush.getFace(f).getWinding())
+                << "Winding mismatch in face " << f << " of brush " << i;
+        }
+
+        scene::removeNodeFromParent(brushes[i]);
+    }
+}
+
+TEST_F(BrushTest, FaceShadersAreCapturedOnFirstUse)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument("maps/altar.map"));
+
+    std::size_t numSurfaces = 0;
+    scene::INodePtr firstBrush;
+
+    GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& entity)
+    {
+        entity->foreachNode([&](const scene::INodePtr& child)
+        {
+            if (Node_isBrush(child))
+            {
+                numSurfaces += Node_getIBrush(child)->getNumFaces();
+
+                if (!firstBrush)
+                {
+                    firstBrush = child;
+                }
+            }
+            else if (Node_isPatch(child))
+            {
+                ++numSurfaces;
+            }
+
+            return true;
+        });
+
+        return true;
+    });
+
+    ASSERT_TRUE(firstBrush);
+
+    // Nothing has been rendered yet, no surface captured its shader
+    EXPECT_EQ(GlobalRenderSystem().captureDeferredShaders(0), numSurfaces);
+
+    // The visibility is known without capturing the shaders
+    auto& brush = *Node_getIBrush(firstBrush);
+    EXPECT_TRUE(brush.hasVisibleMaterial());
+    EXPECT_EQ(GlobalRenderSystem().captureDeferredShaders(0), numSurfaces);
+
+    // Fitting the texture needs the image dimensions, which captures the shader of this face only
+    brush.getFace(0).fitTexture(1, 1);
+    EXPECT_EQ(GlobalRenderSystem().captureDeferredShaders(0), numSurfaces - 1);
+
+    // Capture the remaining ones in two batches
+    EXPECT_EQ(GlobalRenderSystem().captureDeferredShaders(numSurfaces / 2), numSurfaces - 1 - numSurfaces / 2);
+    EXPECT_EQ(GlobalRenderSystem().captureDeferredShaders(numSurfaces), 0u);
+
+    EXPECT_TRUE(brush.hasVisibleMaterial());
+}
+
+TEST_F(BrushTest, MemoryReport)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument("maps/altar.map"));
+
+    std::size_t numEntities = 0;
+    std::size_t numBrushes = 0;
+    std::size_t numPatches = 0;
+    std::size_t numFaces = 0;
+
+    GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& entity)
+    {
+        ++numEntities;
+
+        entity->foreachNode([&](const scene::INodePtr& child)
+        {
+            if (Node_isBrush(child))
+            {
+                ++numBrushes;
+                numFaces += Node_getIBrush(child)->getNumFaces();
+            }
+            else if (Node_isPatch(child))
+            {
+                ++numPatches;
+            }
+
+            return true;
+        });
+
+        return true;
+    });
+
+    scene::MemoryReport report(GlobalMapModule().getRoot());
+
+    EXPECT_EQ(report.getUsage(scene::INode::Type::Entity).count, numEntities);
+    EXPECT_EQ(report.getUsage(scene::INode::Type::Brush).count, numBrushes);
+    EXPECT_EQ(report.getUsage(scene::INode::Type::Patch).count, numPatches);
+    EXPECT_EQ(report.getNumFaces(), numFaces);
+    EXPECT_GT(report.getNumWindingVertices(), numFaces * 2);
+
+    // Every brush accounts at least for its winding vertices
+    EXPECT_GE(report.getUsage(scene::INode::Type::Brush).bytes,
+        report.getNumWindingVertices() * sizeof(WindingVertex));
+    EXPECT_GT(report.getUsage(scene::INode::Type::Patch).bytes, 0);
+    EXPECT_GT(report.getUsage(scene::INode::Type::Entity).bytes, 0);
+
+    std::size_t total = 0;
+    for (const auto& pair : report.getMap())
+    {
+        total += pair.second.bytes;
+    }
+
+    EXPECT_EQ(report.getTotalBytes(), total);
+    EXPECT_NE(report.toString().find("brush"), std::string::npos);
+
+    // The console command prints the same report
+    GlobalCommandSystem().executeCommand("PrintMemoryReport");
+}
+
 }
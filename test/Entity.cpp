@@ -1,5 +1,8 @@
 #include "RadiantTest.h"
 
+#include <fstream>
+#include <set>
+
 #include "ieclass.h"
 #include "ientity.h"
 #include "irendersystemfactory.h"
@@ -8,12 +11,16 @@
 #include "ishaders.h"
 #include "icolourscheme.h"
 #include "ieclasscolours.h"
+#include "imap.h"
+#include "iundo.h"
 
 #include "render/NopVolumeTest.h"
 #include "string/convert.h"
 #include "transformlib.h"
 #include "registry/registry.h"
 #include "eclass.h"
+#include "entitylib.h"
+#include "scenelib.h"
 #include "string/join.h"
 
 namespace test
@@ -193,6 +200,80 @@ TEST_F(EntityTest, ReloadDefsOnUnchangedFiles)
     checkBucketEntityDef(eclass);
 }
 
+TEST_F(EntityTest, ReloadDefsKeepsUnchangedClasses)
+{
+    auto eclass = GlobalEntityClassManager().findClass("light_extinguishable");
+    ASSERT_TRUE(eclass);
+
+    auto parent = eclass->getParent();
+    ASSERT_TRUE(parent != nullptr);
+
+    std::size_t changedCount = 0;
+    auto conn = eclass->changedSignal().connect([&]() { ++changedCount; });
+
+    // None of the def files changed, so the class must not be touched
+    GlobalEntityClassManager().reloadDefs();
+
+    conn.disconnect();
+
+    EXPECT_EQ(changedCount, 0);
+    EXPECT_EQ(eclass->getParent(), parent);
+    EXPECT_EQ(eclass->getAttribute("spawnclass").getValue(), "idLight");
+    EXPECT_EQ(eclass->getAttribute("AIUse").getValue(), "AIUSE_LIGHTSOURCE");
+}
+
+TEST_F(EntityTest, ReloadDefsKeepsLastDefinitionAcrossFiles)
+{
+    auto firstFile = _context.getTestProjectPath() + "def/reload_test_1.def";
+    auto secondFile = _context.getTestProjectPath() + "def/reload_test_2.def";
+
+    auto writeDef = [](const std::string& path, const std::string& value)
+    {
+        std::ofstream stream(path);
+
+        if (!value.empty())
+        {
+            stream << "entityDef reload_test_class\n{\n\t\"test_value\" \"" << value << "\"\n}\n";
+        }
+    };
+
+    auto getValue = []()
+    {
+        return GlobalEntityClassManager().findClass("reload_test_class")->getAttribute("test_value").getValue();
+    };
+
+    writeDef(firstFile, "first");
+    writeDef(secondFile, "second");
+
+    GlobalEntityClassManager().reloadDefs();
+
+    // The file order depends on the file system, the last parsed definition wins
+    auto winner = getValue();
+    EXPECT_TRUE(winner == "first" || winner == "second");
+
+    auto winningFile = winner == "first" ? firstFile : secondFile;
+    auto losingFile = winner == "first" ? secondFile : firstFile;
+
+    // Changing the earlier definition doesn't affect the result
+    writeDef(losingFile, "changed");
+    GlobalEntityClassManager().reloadDefs();
+    EXPECT_EQ(getValue(), winner);
+
+    // Neither does removing it
+    writeDef(losingFile, "");
+    GlobalEntityClassManager().reloadDefs();
+    EXPECT_EQ(getValue(), winner);
+
+    // Without the later definition, the earlier one is used
+    writeDef(losingFile, "restored");
+    writeDef(winningFile, "");
+    GlobalEntityClassManager().reloadDefs();
+    EXPECT_EQ(getValue(), "restored");
+
+    fs::remove(firstFile);
+    fs::remove(secondFile);
+}
+
 TEST_F(EntityTest, CannotCreateEntityWithoutClass)
 {
     // Creating with a null entity class should throw an exception
@@ -284,6 +365,76 @@ TEST_F(EntityTest, EnumerateInheritedSpawnargs)
     EXPECT_EQ(keyValues["noshadows"], "0");
 }
 
+TEST_F(EntityTest, KeyValueLookupIgnoresCase)
+{
+    auto light = createByClassName("light");
+    auto& spawnArgs = light->getEntity();
+
+    spawnArgs.setKeyValue("MyCustomKey", "1");
+    EXPECT_EQ(spawnArgs.getKeyValue("mycustomkey"), "1");
+    EXPECT_EQ(spawnArgs.getKeyValueView("MYCUSTOMKEY"), "1");
+
+    // Setting the key with a different case overwrites the existing value
+    spawnArgs.setKeyValue("MYCUSTOMKEY", "2");
+    EXPECT_EQ(spawnArgs.getKeyValue("MyCustomKey"), "2");
+
+    std::size_t count = 0;
+    spawnArgs.forEachKeyValue([&](const std::string& k, const std::string&) {
+        if (string::iequals(k, "mycustomkey")) ++count;
+    });
+    EXPECT_EQ(count, 1);
+
+    // Removing the key using yet another case
+    spawnArgs.setKeyValue("myCUSTOMkey", "");
+    EXPECT_EQ(spawnArgs.getKeyValue("MyCustomKey"), "");
+
+    // Keys which have never been used anywhere
+    EXPECT_EQ(spawnArgs.getKeyValue("this_key_is_never_used_by_anything"), "");
+    EXPECT_EQ(spawnArgs.getKeyValueView("this_key_is_never_used_by_anything"), "");
+}
+
+TEST_F(EntityTest, GetKeyValueViewIncludesInherited)
+{
+    auto light = createByClassName("atdm:light_base");
+    auto& spawnArgs = light->getEntity();
+
+    // Inherited from the entityDef and its parent
+    EXPECT_EQ(spawnArgs.getKeyValueView("AIUse"), "AIUSE_LIGHTSOURCE");
+    EXPECT_EQ(spawnArgs.getKeyValueView("spawnclass"), "idLight");
+    EXPECT_TRUE(spawnArgs.isInherited("spawnclass"));
+
+    // Override the inherited value
+    spawnArgs.setKeyValue("AIUse", "AIUSE_NONE");
+    EXPECT_EQ(spawnArgs.getKeyValueView("aiuse"), "AIUSE_NONE");
+    EXPECT_FALSE(spawnArgs.isInherited("AIUse"));
+
+    EXPECT_EQ(spawnArgs.getKeyValueView("classname"), "atdm:light_base");
+}
+
+TEST_F(EntityTest, EntityClassAttributeValueAfterReload)
+{
+    auto cls = GlobalEntityClassManager().findClass("light_extinguishable");
+    ASSERT_TRUE(cls);
+
+    auto checkAttributes = [&]()
+    {
+        // Inherited, overridden and own attributes, looked up case-insensitively
+        EXPECT_EQ(cls->getAttributeValue("spawnclass"), "idLight");
+        EXPECT_EQ(cls->getAttributeValue("aiuse"), "AIUSE_LIGHTSOURCE");
+        EXPECT_EQ(cls->getAttributeValue("editor_displayFolder"), "Lights/Base Entities, DoNotUse");
+        EXPECT_EQ(cls->getAttributeValue("this_key_is_never_used_by_anything"), "");
+
+        EXPECT_EQ(cls->getAttributeValue("editor_color"), cls->getAttribute("editor_color").getValue());
+    };
+
+    checkAttributes();
+
+    // The flattened attributes must be rebuilt after the parents have been re-parsed
+    GlobalEntityClassManager().reloadDefs();
+
+    checkAttributes();
+}
+
 TEST_F(EntityTest, GetKeyValuePairs)
 {
     auto torch = createByClassName("atdm:torch_brazier");
@@ -366,6 +517,146 @@ TEST_F(EntityTest, CopySpawnargs)
     EXPECT_EQ(overlap.size(), 0);
 }
 
+TEST_F(EntityTest, WriteBackUnchangedOrigins)
+{
+    loadMap("altar.map");
+
+    // An entity without origin spawnarg
+    auto funcStatic = createByClassName("func_static");
+    scene::addNodeToContainer(funcStatic, GlobalMapModule().getRoot());
+    ASSERT_EQ(funcStatic->getEntity().getKeyValue("origin"), "");
+
+    // Remember the spawnargs of all entities before the round trip
+    std::vector<std::pair<Entity*, StringMap>> entities;
+
+    GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (auto entity = Node_getEntity(node); entity != nullptr)
+        {
+            StringMap spawnargs;
+            entity->forEachKeyValue([&](const std::string& key, const std::string& value)
+            {
+                spawnargs.emplace(key, value);
+            });
+
+            entities.emplace_back(entity, std::move(spawnargs));
+        }
+
+        return true;
+    });
+
+    {
+        UndoableCommand cmd("writeBackOrigins");
+
+        for (const auto& pair : entities)
+        {
+            EXPECT_FALSE(scene::setEntityOrigin(*pair.first, scene::getEntityOrigin(*pair.first)));
+        }
+    }
+
+    // No spawnarg should have been added or re-formatted, the worldspawn
+    // and the func_static above still have no origin
+    for (const auto& pair : entities)
+    {
+        StringMap spawnargs;
+        pair.first->forEachKeyValue([&](const std::string& key, const std::string& value)
+        {
+            spawnargs.emplace(key, value);
+        });
+
+        EXPECT_EQ(spawnargs, pair.second) << "Spawnargs of " << pair.first->getKeyValue("name") << " changed";
+    }
+
+    // A changed origin is written, except for the worldspawn
+    {
+        UndoableCommand cmd("changeOrigins");
+
+        EXPECT_TRUE(scene::setEntityOrigin(funcStatic->getEntity(), Vector3(16, -8, 0.5)));
+        EXPECT_FALSE(scene::setEntityOrigin(*Node_getEntity(GlobalMapModule().getWorldspawn()), Vector3(16, -8, 0.5)));
+    }
+
+    EXPECT_EQ(funcStatic->getEntity().getKeyValue("origin"), "16 -8 0.5");
+    EXPECT_EQ(Node_getEntity(GlobalMapModule().getWorldspawn())->getKeyValue("origin"), "");
+}
+
+TEST_F(EntityTest, WriteBackUnchangedKeyValues)
+{
+    loadMap("altar.map");
+
+    // An entity without origin spawnarg
+    auto funcStatic = createByClassName("func_static");
+    scene::addNodeToContainer(funcStatic, GlobalMapModule().getRoot());
+
+    auto getSpawnargs = [](const Entity& entity)
+    {
+        StringMap spawnargs;
+        entity.forEachKeyValue([&](const std::string& key, const std::string& value)
+        {
+            spawnargs.emplace(key, value);
+        });
+        return spawnargs;
+    };
+
+    // Remember the spawnargs of all entities, and the keys used by any of them
+    std::vector<std::pair<Entity*, StringMap>> entities;
+    std::set<std::string> keys = { "origin", "editor_usage" };
+
+    GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (auto entity = Node_getEntity(node); entity != nullptr)
+        {
+            entities.emplace_back(entity, getSpawnargs(*entity));
+
+            for (const auto& pair : entities.back().second)
+            {
+                keys.insert(pair.first);
+            }
+        }
+
+        return true;
+    });
+
+    ASSERT_GT(entities.size(), 1);
+
+    // Read every key of every entity and write the (possibly inherited) values back
+    {
+        UndoableCommand cmd("writeBackKeyValues");
+
+        for (const auto& key : keys)
+        {
+            std::vector<std::string> values;
+
+            for (const auto& pair : entities)
+            {
+                values.emplace_back(pair.first->getKeyValue(key));
+            }
+
+            for (std::size_t i = 0; i < entities.size(); ++i)
+            {
+                EXPECT_FALSE(scene::setEntityKeyValue(*entities[i].first, key, values[i]));
+            }
+        }
+    }
+
+    // No spawnarg should have been added, removed or changed
+    for (const auto& pair : entities)
+    {
+        EXPECT_EQ(getSpawnargs(*pair.first), pair.second) << "Spawnargs of " << pair.first->getKeyValue("name") << " changed";
+    }
+
+    EXPECT_EQ(funcStatic->getEntity().getKeyValue("origin"), "");
+    EXPECT_EQ(Node_getEntity(GlobalMapModule().getWorldspawn())->getKeyValue("origin"), "");
+
+    // A changed value is written and read back
+    {
+        UndoableCommand cmd("changeKeyValue");
+        EXPECT_TRUE(scene::setEntityKeyValue(funcStatic->getEntity(), "editor_usage", "changed"));
+    }
+
+    EXPECT_EQ(funcStatic->getEntity().getKeyValue("editor_usage"), "changed");
+    EXPECT_EQ(getSpawnargs(funcStatic->getEntity()).count("editor_usage"), 1);
+}
+
 TEST_F(EntityTest, SelectEntity)
 {
     auto light = createByClassName("light");
@@ -400,6 +691,7 @@ namespace
         // Count of submitted renderables and lights
         int renderables = 0;
         int lights = 0;
+        int geometrySlots = 0;
 
         // List of actual RendererLight objects
         std::list<const RendererLight*> lightPtrs;
@@ -416,6 +708,12 @@ namespace
             renderablePtrs.push_back(std::make_pair(&shader, &renderable));
         }
 
+        void addGeometry(Shader& shader, render::IGeometryStore::Slot slot,
+                         render::GeometryType type) override
+        {
+            ++geometrySlots;
+        }
+
         void addLight(const RendererLight& light)
         {
             ++lights;
@@ -734,6 +1032,28 @@ TEST_F(EntityTest, RenderSelectedLightEntity)
     EXPECT_EQ(renderF.collector.lights, 0);
 }
 
+TEST_F(EntityTest, RenderSelectedSpeakerRadii)
+{
+    auto speaker = createByClassName("speaker");
+    speaker->getEntity().setKeyValue("s_mindistance", "1");
+    speaker->getEntity().setKeyValue("s_maxdistance", "4");
+
+    RenderFixture renderF;
+    speaker->setRenderSystem(renderF.backend);
+
+    // Unselected speakers don't submit their radii
+    speaker->renderWireframe(renderF.collector, renderF.volumeTest);
+    EXPECT_EQ(renderF.collector.geometrySlots, 0);
+
+    // The selected speaker submits the radii through the geometry store
+    Node_getSelectable(speaker)->setSelected(true);
+    speaker->renderWireframe(renderF.collector, renderF.volumeTest);
+    EXPECT_EQ(renderF.collector.geometrySlots, 1);
+
+    speaker->renderSolid(renderF.collector, renderF.volumeTest);
+    EXPECT_EQ(renderF.collector.geometrySlots, 2);
+}
+
 TEST_F(EntityTest, RenderLightAsLightSource)
 {
     auto light = createByClassName("light_torchflame_small");
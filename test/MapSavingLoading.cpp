@@ -17,6 +17,9 @@
 #include "algorithm/XmlUtils.h"
 #include "algorithm/Primitives.h"
 #include "os/file.h"
+#include "registry/registry.h"
+#include "scene/Traverse.h"
+#include "stream/utils.h"
 #include <sigc++/connection.h>
 
 using namespace std::chrono_literals;
@@ -1218,4 +1221,264 @@ TEST_F(MapSavingTest, saveWarnsAboutOverwriteAndUserCancels)
     EXPECT_EQ(contents.str(), tempContents);
 }
 
+namespace
+{
+
+std::string exportMapToString(const std::string& formatName, bool inParallel)
+{
+    registry::setValue("user/ui/map/parallelSave", inParallel);
+
+    auto format = GlobalMapFormatManager().getMapFormatByName(formatName);
+    EXPECT_TRUE(format) << "Format not found: " << formatName;
+
+    auto writer = format->getMapWriter();
+    std::ostringstream stream;
+
+    {
+        auto root = GlobalMapModule().getRoot();
+        auto exporter = GlobalMapModule().createMapExporter(*writer, root, stream);
+        exporter->exportMap(root, scene::traverse);
+    }
+
+    return stream.str();
+}
+
+}
+
+TEST_F(MapSavingTest, writeDoubleMatchesStreamOutput)
+{
+    std::vector<double> values = { 0, 1, -1, 0.5, 1.0 / 3.0, -2.0 / 3.0, 1e-7, 123456789.123456789,
+        -1e20, 1e300, 4.9e-324, 0.1, 64, -0.000123456789012345, 3.14159265358979 };
+
+    for (auto precision : { 0, 1, 6, 15, 17 })
+    {
+        for (auto value : values)
+        {
+            std::ostringstream expected;
+            expected.precision(precision);
+            expected << value;
+
+            std::ostringstream actual;
+            actual.precision(precision);
+            stream::writeDouble(actual, value);
+
+            EXPECT_EQ(actual.str(), expected.str()) << "Precision " << precision << ", value " << value;
+        }
+    }
+}
+
+TEST_F(MapSavingTest, parallelExportIsByteIdentical)
+{
+    loadMap("altar.map");
+    checkAltarScene();
+
+    for (const auto& formatName : { "Doom3MapLoader", "Quake4MapLoader", "Quake3MapLoader" })
+    {
+        auto sequentialOutput = exportMapToString(formatName, false);
+        auto parallelOutput = exportMapToString(formatName, true);
+
+        EXPECT_FALSE(sequentialOutput.empty());
+        EXPECT_EQ(parallelOutput, sequentialOutput) << "Output differs for format " << formatName;
+    }
+
+    // Exporting must leave the scene intact
+    checkAltarScene();
+}
+
+namespace
+{
+
+std::string loadFileContents(const fs::path& path)
+{
+    std::ifstream stream(path.string());
+    return std::string(std::istreambuf_iterator<char>(stream), {});
+}
+
+// Saves the current map both synchronously and in the background and compares the files
+void expectBackgroundSaveMatchesSynchronousSave(const fs::path& folder, const std::string& suffix)
+{
+    auto synchronousPath = folder / ("altar_synchronous" + suffix + ".map");
+    auto backgroundPath = folder / ("altar_background" + suffix + ".map");
+
+    GlobalCommandSystem().executeCommand("SaveMapCopyAs", synchronousPath.string());
+
+    auto save = GlobalMapModule().saveCopyInBackground(backgroundPath.string());
+    ASSERT_TRUE(save);
+
+    save->wait();
+    EXPECT_TRUE(save->isFinished());
+
+    EXPECT_TRUE(os::fileOrDirExists(fs::path(backgroundPath).replace_extension("darkradiant")));
+
+    auto expected = loadFileContents(synchronousPath);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(loadFileContents(backgroundPath), expected) << "Background save differs (" << suffix << ")";
+}
+
+}
+
+TEST_F(MapSavingTest, backgroundSaveMatchesSynchronousSave)
+{
+    loadMap("altar.map");
+    checkAltarScene();
+
+    fs::path tempPath = _context.getTemporaryDataPath();
+
+    expectBackgroundSaveMatchesSynchronousSave(tempPath, "_initial");
+
+    // The second snapshot re-uses the unchanged nodes of the first one
+    algorithm::setWorldspawnKeyValue("snapshot_test", "1");
+
+    auto brush = algorithm::findFirstBrush(GlobalMapModule().getRoot(), [](const IBrushNodePtr&) { return true; });
+    ASSERT_TRUE(brush);
+
+    {
+        UndoableCommand cmd("changeMaterial");
+        Node_getIBrush(brush)->setShader("textures/common/caulk");
+    }
+
+    expectBackgroundSaveMatchesSynchronousSave(tempPath, "_changed");
+
+    // Changes applied by undo must be picked up too
+    GlobalUndoSystem().undo();
+
+    expectBackgroundSaveMatchesSynchronousSave(tempPath, "_undone");
+
+    // Exporting must leave the scene intact
+    checkAltarScene();
+}
+
+TEST_F(MapSavingTest, undoableChangeIncreasesNodeRevision)
+{
+    loadMap("altar.map");
+
+    auto brush = algorithm::findFirstBrush(GlobalMapModule().getRoot(), [](const IBrushNodePtr&) { return true; });
+    ASSERT_TRUE(brush);
+
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto brushRevision = brush->getChangeRevision();
+    auto worldspawnRevision = worldspawn->getChangeRevision();
+
+    {
+        UndoableCommand cmd("changeMaterial");
+        Node_getIBrush(brush)->setShader("textures/common/caulk");
+    }
+
+    EXPECT_GT(brush->getChangeRevision(), brushRevision);
+    EXPECT_EQ(worldspawn->getChangeRevision(), worldspawnRevision);
+
+    algorithm::setWorldspawnKeyValue("revision_test", "1");
+
+    EXPECT_GT(worldspawn->getChangeRevision(), worldspawnRevision);
+}
+
+TEST_F(MapSavingTest, backgroundSaveFollowsEntityOriginChanges)
+{
+    loadMap("altar.map");
+
+    fs::path tempPath = _context.getTemporaryDataPath();
+
+    expectBackgroundSaveMatchesSynchronousSave(tempPath, "_initial");
+
+    // The child brushes are written relative to the entity origin,
+    // they need to follow the origin even if they're not changed themselves
+    auto funcStatic = algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_66");
+    ASSERT_TRUE(funcStatic);
+
+    {
+        UndoableCommand cmd("changeOrigin");
+        Node_getEntity(funcStatic)->setKeyValue("origin", "-120 64 -140");
+    }
+
+    expectBackgroundSaveMatchesSynchronousSave(tempPath, "_origin");
+}
+
+TEST_F(MapSavingTest, backgroundSaveCopiesChangedNodesOnly)
+{
+    loadMap("altar.map");
+
+    auto backgroundPath = _context.getTemporaryDataPath() + "altar_changed_nodes.map";
+
+    auto saveAndGetNumCopiedNodes = [&]()
+    {
+        auto save = GlobalMapModule().saveCopyInBackground(backgroundPath);
+        EXPECT_TRUE(save);
+
+        save->wait();
+        return save->getNumCopiedNodes();
+    };
+
+    // The first snapshot copies the whole map, the second one re-uses everything
+    EXPECT_GT(saveAndGetNumCopiedNodes(), 0);
+    EXPECT_EQ(saveAndGetNumCopiedNodes(), 0);
+
+    // A changed worldspawn brush is copied on its own
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush = algorithm::findFirstBrush(worldspawn, [](const IBrushNodePtr&) { return true; });
+    ASSERT_TRUE(brush);
+
+    {
+        UndoableCommand cmd("changeMaterial");
+        Node_getIBrush(brush)->setShader("textures/common/caulk");
+    }
+
+    EXPECT_EQ(saveAndGetNumCopiedNodes(), 1);
+
+    // The children of func_* entities are copied along with the entity
+    auto funcStatic = algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_66");
+    ASSERT_TRUE(funcStatic);
+
+    auto childBrush = algorithm::findFirstBrush(funcStatic, [](const IBrushNodePtr&) { return true; });
+    ASSERT_TRUE(childBrush);
+
+    {
+        UndoableCommand cmd("changeMaterial");
+        Node_getIBrush(childBrush)->setShader("textures/common/caulk");
+    }
+
+    auto numPrimitives = algorithm::getChildCount(funcStatic, [](const scene::INodePtr& node) { return Node_isBrush(node) || Node_isPatch(node); });
+    EXPECT_EQ(saveAndGetNumCopiedNodes(), numPrimitives + 1);
+
+    // Nothing changed since then
+    EXPECT_EQ(saveAndGetNumCopiedNodes(), 0);
+}
+
+TEST_F(MapSavingTest, backgroundSaveFollowsNonUndoableChanges)
+{
+    loadMap("altar.map");
+
+    fs::path tempPath = _context.getTemporaryDataPath();
+
+    expectBackgroundSaveMatchesSynchronousSave(tempPath, "_initial");
+
+    // Spawnargs changed outside an undoable operation
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto funcStatic = algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_66");
+    ASSERT_TRUE(funcStatic);
+
+    EXPECT_FALSE(GlobalUndoSystem().operationStarted());
+    Node_getEntity(worldspawn)->setKeyValue("non_undoable_key", "1");
+    Node_getEntity(funcStatic)->setKeyValue("origin", "-120 64 -140");
+
+    expectBackgroundSaveMatchesSynchronousSave(tempPath, "_spawnargs");
+
+    Node_getEntity(worldspawn)->setKeyValue("non_undoable_key", "");
+
+    expectBackgroundSaveMatchesSynchronousSave(tempPath, "_erased");
+
+    // Key values of the map root end up in the info file
+    GlobalMapModule().getRoot()->setProperty("non_undoable_property", "some_value");
+
+    auto backgroundPath = tempPath / "altar_root_property.map";
+    auto save = GlobalMapModule().saveCopyInBackground(backgroundPath.string());
+    ASSERT_TRUE(save);
+
+    save->wait();
+
+    auto infoFile = loadFileContents(fs::path(backgroundPath).replace_extension("darkradiant"));
+    EXPECT_NE(infoFile.find("\"non_undoable_property\""), std::string::npos);
+    EXPECT_NE(infoFile.find("\"some_value\""), std::string::npos);
+}
+
 }
@@ -2,6 +2,7 @@
 #include "TdmMissionSetup.h"
 
 #include <regex>
+#include <fstream>
 #include "ishaders.h"
 #include "string/trim.h"
 #include "string/replace.h"
@@ -1233,6 +1234,108 @@ TEST_F(MaterialExportTest, WritingMaterialFiles)
         << "New definition not found in file";
 }
 
+TEST_F(MaterialExportTest, RefreshUpdatesChangedMaterialsOnly)
+{
+    // Create a backup copy of the material file we're going to manipulate
+    fs::path exportTestFile = _context.getTestProjectPath() + "materials/exporttest.mtr";
+    BackupCopy backup(exportTestFile);
+
+    auto changedMaterial = GlobalMaterialManager().getMaterial("textures/exporttest/renderBump1");
+    auto unchangedMaterial = GlobalMaterialManager().getMaterial("textures/exporttest/renderBump2");
+    auto otherFileMaterial = GlobalMaterialManager().getMaterial("textures/numbers/1");
+
+    std::size_t changedCount = 0;
+    std::size_t unchangedCount = 0;
+    std::size_t otherFileCount = 0;
+
+    changedMaterial->sig_materialChanged().connect([&]() { ++changedCount; });
+    unchangedMaterial->sig_materialChanged().connect([&]() { ++unchangedCount; });
+    otherFileMaterial->sig_materialChanged().connect([&]() { ++otherFileCount; });
+
+    // Change a single declaration and add a new one
+    std::stringstream contentStream;
+    {
+        std::ifstream input(exportTestFile);
+        contentStream << input.rdbuf();
+    }
+
+    auto contents = string::replace_all_copy(contentStream.str(),
+        "renderBump textures/output.tga models/hipoly", "renderBump textures/changed.tga models/hipoly");
+    {
+        std::ofstream output(exportTestFile);
+        output << contents << std::endl << "textures/exporttest/addedOnRefresh { description \"Added\" }" << std::endl;
+    }
+
+    EXPECT_FALSE(GlobalMaterialManager().materialExists("textures/exporttest/addedOnRefresh"));
+
+    GlobalMaterialManager().refresh();
+
+    // The existing material objects are updated in place
+    EXPECT_EQ(GlobalMaterialManager().getMaterial("textures/exporttest/renderBump1"), changedMaterial);
+    EXPECT_GT(changedCount, 0);
+    expectDefinitionContains(changedMaterial, "textures/changed.tga");
+
+    EXPECT_EQ(unchangedCount, 0);
+    EXPECT_EQ(otherFileCount, 0);
+
+    EXPECT_TRUE(GlobalMaterialManager().materialExists("textures/exporttest/addedOnRefresh"));
+    EXPECT_EQ(GlobalMaterialManager().getMaterial("textures/exporttest/addedOnRefresh")->getDescription(), "Added");
+}
+
+TEST_F(MaterialExportTest, RefreshKeepsFirstDeclarationAcrossFiles)
+{
+    auto firstFile = _context.getTestProjectPath() + "materials/refresh_test_1.mtr";
+    auto secondFile = _context.getTestProjectPath() + "materials/refresh_test_2.mtr";
+
+    auto writeMaterial = [](const std::string& path, const std::string& description)
+    {
+        std::ofstream output(path);
+
+        if (!description.empty())
+        {
+            output << "textures/refreshtest/shared { description \"" << description << "\" }" << std::endl;
+            output << "table refreshTestTable_" << description << " { { 0, 1 } }" << std::endl;
+        }
+    };
+
+    auto getDescription = []()
+    {
+        return GlobalMaterialManager().getMaterial("textures/refreshtest/shared")->getDescription();
+    };
+
+    writeMaterial(firstFile, "first");
+    writeMaterial(secondFile, "second");
+
+    GlobalMaterialManager().refresh();
+
+    // The file order depends on the file system, the first declaration wins
+    auto winner = getDescription();
+    EXPECT_TRUE(winner == "first" || winner == "second");
+
+    auto winningFile = winner == "first" ? firstFile : secondFile;
+    auto losingFile = winner == "first" ? secondFile : firstFile;
+    auto loser = winner == "first" ? "second" : "first";
+
+    // Changing the later declaration doesn't affect the result
+    writeMaterial(losingFile, "changed");
+    GlobalMaterialManager().refresh();
+    EXPECT_EQ(getDescription(), winner);
+
+    // The tables of the changed file are replaced
+    EXPECT_FALSE(GlobalMaterialManager().getTable(std::string("refreshTestTable_") + loser));
+    EXPECT_TRUE(GlobalMaterialManager().getTable("refreshTestTable_changed"));
+
+    // Removing the earlier declaration lets the later one take over
+    writeMaterial(winningFile, "");
+    GlobalMaterialManager().refresh();
+    EXPECT_TRUE(GlobalMaterialManager().materialExists("textures/refreshtest/shared"));
+    EXPECT_EQ(getDescription(), "changed");
+    EXPECT_FALSE(GlobalMaterialManager().getTable(std::string("refreshTestTable_") + winner));
+
+    fs::remove(firstFile);
+    fs::remove(secondFile);
+}
+
 TEST_F(MaterialExportTest, SetShaderFilePath)
 {
     auto newMaterial = GlobalMaterialManager().createEmptyMaterial("textures/exporttest/somePath");
@@ -1,13 +1,23 @@
 #include "RadiantTest.h"
 
 #include "ishaders.h"
+#include "imap.h"
+#include "ipatch.h"
+#include "iselection.h"
+#include "icommandsystem.h"
+#include "iundo.h"
 #include <algorithm>
+#include <future>
 #include "string/split.h"
 #include "string/case_conv.h"
 #include "string/trim.h"
 #include "string/join.h"
 #include "math/MatrixUtils.h"
 #include "materials/FrobStageSetup.h"
+#include "algorithm/Primitives.h"
+#include "scene/ShaderBreakdown.h"
+#include "scenelib.h"
+#include "shaderlib.h"
 
 namespace test
 {
@@ -1501,4 +1511,160 @@ TEST_F(MaterialsTest, MaterialFrobStageRemoval)
     checkFrobStageRemoval("textures/parsertest/frobstage_missing5");
 }
 
+namespace
+{
+
+scene::INodePtr createPatch(const scene::INodePtr& parent, const std::string& material)
+{
+    auto patchNode = GlobalPatchModule().createPatch(patch::PatchDefType::Def3);
+    auto& patch = std::dynamic_pointer_cast<IPatchNode>(patchNode)->getPatch();
+    patch.setDims(3, 3);
+    patch.setShader(material);
+
+    parent->addChildNode(patchNode);
+
+    return patchNode;
+}
+
+}
+
+TEST_F(MaterialsTest, MaterialUsageIndexTracksSurfaces)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto& index = GlobalMapModule().getRoot()->getMaterialUsageIndex();
+
+    EXPECT_EQ(index.getFaceCount("textures/numbers/1"), 0);
+
+    auto brush = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/numbers/1");
+    auto patch = createPatch(worldspawn, "textures/numbers/2");
+
+    EXPECT_EQ(index.getFaceCount("textures/numbers/1"), 6);
+    EXPECT_EQ(index.getPatchCount("textures/numbers/1"), 0);
+    EXPECT_EQ(index.getPatchCount("textures/numbers/2"), 1);
+
+    // Material names are case-insensitive
+    EXPECT_EQ(index.getFaceCount("TEXTURES/numbers/1"), 6);
+
+    // Changing a single face
+    {
+        UndoableCommand cmd("changeMaterial");
+        Node_getIBrush(brush)->getFace(0).setShader("textures/numbers/2");
+    }
+
+    EXPECT_EQ(index.getFaceCount("textures/numbers/1"), 5);
+    EXPECT_EQ(index.getFaceCount("textures/numbers/2"), 1);
+
+    // Undo restores the previous material
+    GlobalUndoSystem().undo();
+
+    EXPECT_EQ(index.getFaceCount("textures/numbers/1"), 6);
+    EXPECT_EQ(index.getFaceCount("textures/numbers/2"), 0);
+
+    // The breakdown is answered by the index
+    scene::ShaderBreakdown breakdown;
+    EXPECT_EQ(breakdown.getMap().at("textures/numbers/1").faceCount, 6);
+    EXPECT_EQ(breakdown.getMap().at("textures/numbers/2").patchCount, 1);
+
+    // Removing the nodes from the scene
+    scene::removeNodeFromParent(brush);
+    scene::removeNodeFromParent(patch);
+
+    EXPECT_EQ(index.getFaceCount("textures/numbers/1"), 0);
+    EXPECT_EQ(index.getPatchCount("textures/numbers/2"), 0);
+
+    std::size_t materialCount = 0;
+    index.foreachMaterial([&](const std::string&, std::size_t, std::size_t) { ++materialCount; });
+    EXPECT_EQ(materialCount, 0);
+}
+
+TEST_F(MaterialsTest, MaterialUsageVisitorCanStopTraversal)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto& index = GlobalMapModule().getRoot()->getMaterialUsageIndex();
+
+    algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/numbers/1");
+    createPatch(worldspawn, "textures/numbers/1");
+
+    std::size_t visited = 0;
+    EXPECT_TRUE(index.foreachUsage("textures/numbers/1", [&](const scene::MaterialUsage&)
+    {
+        ++visited;
+        return true;
+    }));
+    EXPECT_EQ(visited, 7);
+
+    // Returning false stops at the first usage
+    visited = 0;
+    EXPECT_FALSE(index.foreachUsage("textures/numbers/1", [&](const scene::MaterialUsage&)
+    {
+        ++visited;
+        return false;
+    }));
+    EXPECT_EQ(visited, 1);
+
+    // Unknown materials have nothing to visit
+    EXPECT_TRUE(index.foreachUsage("textures/numbers/0", [&](const scene::MaterialUsage&) { return false; }));
+}
+
+TEST_F(MaterialsTest, SelectItemsByShader)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto brush1 = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/numbers/1");
+    auto brush2 = algorithm::createCubicBrush(worldspawn, Vector3(256, 0, 0), "textures/numbers/2");
+    auto patch = createPatch(worldspawn, "textures/numbers/1");
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    GlobalCommandSystem().executeCommand("SelectItemsByShader", cmd::Argument("textures/numbers/1"));
+
+    EXPECT_TRUE(Node_isSelected(brush1));
+    EXPECT_FALSE(Node_isSelected(brush2));
+    EXPECT_TRUE(Node_isSelected(patch));
+
+    GlobalCommandSystem().executeCommand("DeselectItemsByShader", cmd::Argument("textures/numbers/1"));
+
+    EXPECT_FALSE(Node_isSelected(brush1));
+    EXPECT_FALSE(Node_isSelected(patch));
+}
+
+TEST_F(MaterialsTest, FindAndReplaceShader)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto brush = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/numbers/1");
+    auto patch = createPatch(worldspawn, "textures/numbers/1");
+    auto& index = GlobalMapModule().getRoot()->getMaterialUsageIndex();
+
+    auto replaced = scene::findAndReplaceShader("textures/numbers/1", "textures/numbers/3", false);
+
+    EXPECT_EQ(replaced, 7);
+    EXPECT_EQ(index.getFaceCount("textures/numbers/1"), 0);
+    EXPECT_EQ(index.getPatchCount("textures/numbers/1"), 0);
+    EXPECT_EQ(index.getFaceCount("textures/numbers/3"), 6);
+    EXPECT_EQ(index.getPatchCount("textures/numbers/3"), 1);
+    EXPECT_EQ(Node_getIPatch(patch)->getShader(), "textures/numbers/3");
+}
+
+// The editor image data can be loaded in a worker thread without creating the texture
+TEST_F(MaterialsTest, EditorImageLoaderRunsInWorkerThread)
+{
+    auto material = GlobalMaterialManager().getMaterial("textures/numbers/1");
+
+    EXPECT_FALSE(material->isEditorImageRealised());
+
+    auto loader = material->getEditorImageLoader();
+    auto image = std::async(std::launch::async, loader).get();
+
+    ASSERT_TRUE(image);
+    EXPECT_GT(image->getWidth(), 0);
+    EXPECT_GT(image->getHeight(), 0);
+
+    // Nothing has been realised by loading the image
+    EXPECT_FALSE(material->isEditorImageRealised());
+
+    // A material without any image produces no data
+    auto emptyLoader = GlobalMaterialManager().createEmptyMaterial("textures/test/empty")->getEditorImageLoader();
+    EXPECT_FALSE(emptyLoader());
+}
+
 }
@@ -0,0 +1,80 @@
+#include "RadiantTest.h"
+
+#include <map>
+#include "iimage.h"
+
+namespace test
+{
+
+using ModuleRegistryTest = RadiantTest;
+
+TEST_F(ModuleRegistryTest, TimelineContainsEveryModuleOnce)
+{
+    const auto& timeline = module::GlobalModuleRegistry().getInitialisationTimeline();
+
+    EXPECT_FALSE(timeline.empty());
+
+    std::map<std::string, std::size_t> counts;
+
+    for (const auto& record : timeline)
+    {
+        ++counts[record.name];
+        EXPECT_TRUE(module::GlobalModuleRegistry().moduleExists(record.name)) << record.name;
+    }
+
+    for (const auto& pair : counts)
+    {
+        EXPECT_EQ(pair.second, 1) << pair.first << " initialised more than once";
+    }
+
+    EXPECT_EQ(counts.count(MODULE_IMAGELOADER), 1);
+}
+
+TEST_F(ModuleRegistryTest, DependenciesAreInitialisedFirst)
+{
+    const auto& timeline = module::GlobalModuleRegistry().getInitialisationTimeline();
+
+    std::map<std::string, const IModuleRegistry::InitialisationRecord*> records;
+
+    for (const auto& record : timeline)
+    {
+        records[record.name] = &record;
+    }
+
+    for (const auto& record : timeline)
+    {
+        auto module = module::GlobalModuleRegistry().getModule(record.name);
+        ASSERT_TRUE(module);
+
+        for (const auto& dependency : module->getDependencies())
+        {
+            auto found = records.find(dependency);
+
+            // The core module is initialised before the timeline starts
+            if (found == records.end()) continue;
+
+            // Circular dependencies can't be satisfied either way
+            auto dependencyModule = module::GlobalModuleRegistry().getModule(dependency);
+            if (dependencyModule->getDependencies().count(record.name) > 0) continue;
+
+            EXPECT_LE(found->second->beginUsec + found->second->durationUsec, record.beginUsec)
+                << record.name << " started before its dependency " << dependency << " was finished";
+        }
+    }
+}
+
+// The main thread initialises the modules one after another, in timeline order
+TEST_F(ModuleRegistryTest, TimelineRecordsDontOverlap)
+{
+    const auto& timeline = module::GlobalModuleRegistry().getInitialisationTimeline();
+
+    for (std::size_t i = 1; i < timeline.size(); ++i)
+    {
+        const auto& previous = timeline[i - 1];
+
+        EXPECT_LE(previous.beginUsec + previous.durationUsec, timeline[i].beginUsec)
+            << timeline[i].name << " started before " << previous.name << " was finished";
+    }
+}
+
+}
@@ -1,7 +1,9 @@
 #include "RadiantTest.h"
 
 #include "isound.h"
+#include "parser/DefBlockScanner.h"
 #include "parser/DefBlockTokeniser.h"
+#include "parser/DefTokeniser.h"
 
 namespace test
 {
@@ -113,6 +115,38 @@ TEST(DefBlockTokeniser, BlockSeparation)
     });
 }
 
+TEST(DefBlockScanner, FindTopLevelBlocks)
+{
+    std::string testString = R"(// readable/first { in a comment
+readable/first
+{
+    precache
+    "page1_body" : { "text with { braces }" }
+}
+
+/* readable/commented { */ readable/second// comment
+{ nested { } }
+readable/third{"quoted } brace" }
+)";
+
+    auto blocks = parser::findDefBlocks(testString);
+
+    ASSERT_EQ(blocks.size(), 3);
+    EXPECT_EQ(blocks[0].first, "readable/first");
+    EXPECT_EQ(blocks[1].first, "readable/second");
+    EXPECT_EQ(blocks[2].first, "readable/third");
+
+    // A tokeniser started at the offsets is returning the block name and the opening brace
+    for (const auto& block : blocks)
+    {
+        auto remainder = testString.substr(block.second);
+        parser::BasicDefTokeniser<std::string> tokeniser(remainder);
+
+        EXPECT_EQ(tokeniser.nextToken(), block.first);
+        EXPECT_EQ(tokeniser.nextToken(), "{");
+    }
+}
+
 using SoundShaderParsingTests = RadiantTest;
 
 TEST_F(SoundShaderParsingTests, ShaderParsing)
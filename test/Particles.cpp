@@ -0,0 +1,315 @@
+#include "RadiantTest.h"
+
+#include "iparticles.h"
+#include "iparticlestage.h"
+#include "irendersystemfactory.h"
+#include "math/AABB.h"
+#include "math/Matrix4.h"
+#include "math/Vector2.h"
+#include "math/Vector4.h"
+
+namespace test
+{
+
+using ParticlesTest = RadiantTest;
+
+namespace
+{
+
+const unsigned int PARTICLE_SEED = 42;
+
+particles::IStageDef& addStage(const particles::IParticleDefPtr& def)
+{
+    auto& stage = def->getStage(def->addParticleStage());
+    stage.setMaterialName("textures/numbers/1");
+
+    return stage;
+}
+
+// Adds stages covering the various path, distribution and orientation types
+void addMixedStages(const particles::IParticleDefPtr& def)
+{
+    auto& sphere = addStage(def);
+    sphere.setDistributionType(particles::IStageDef::DISTRIBUTION_SPHERE);
+    sphere.setDistributionParm(3, 0.5f);
+    sphere.setDirectionType(particles::IStageDef::DIRECTION_OUTWARD);
+    sphere.setDirectionParm(0, 0.3f);
+    sphere.setFadeIndexFraction(0.5f);
+    sphere.setBunching(0.4f);
+
+    auto& aimed = addStage(def);
+    aimed.setDistributionType(particles::IStageDef::DISTRIBUTION_CYLINDER);
+    aimed.setDistributionParm(3, 1.5f);
+    aimed.setOrientationType(particles::IStageDef::ORIENTATION_AIMED);
+    aimed.setOrientationParm(0, 3);
+    aimed.setOrientationParm(1, 0.2f);
+    aimed.setAnimationFrames(4);
+    aimed.setAnimationRate(8);
+    aimed.setWorldGravityFlag(true);
+    aimed.setGravity(40);
+
+    auto& flies = addStage(def);
+    flies.setCustomPathType(particles::IStageDef::PATH_FLIES);
+    flies.setCustomPathParm(0, 10);
+    flies.setCustomPathParm(1, 20);
+    flies.setCustomPathParm(2, 30);
+    flies.setOrientationType(particles::IStageDef::ORIENTATION_X);
+    flies.setInitialAngle(45);
+    flies.getRotationSpeed().setFrom(10);
+    flies.getRotationSpeed().setTo(90);
+
+    auto& helix = addStage(def);
+    helix.setCustomPathType(particles::IStageDef::PATH_HELIX);
+    helix.setCustomPathParm(0, 16);
+    helix.setCustomPathParm(1, 8);
+    helix.setCustomPathParm(2, 32);
+    helix.setCustomPathParm(3, 2);
+    helix.setCustomPathParm(4, 10);
+    helix.setUseEntityColour(true);
+    helix.setTimeOffset(0.3f);
+    helix.setDeadTime(0.5f);
+    helix.getSize().setTo(12);
+}
+
+// Adds a stage with the given number of particles, all of them located at the origin
+void addPointStage(const particles::IParticleDefPtr& def, int count)
+{
+    auto& stage = addStage(def);
+    stage.setCount(count);
+    stage.setDistributionParm(0, 0);
+    stage.setDistributionParm(1, 0);
+    stage.setDistributionParm(2, 0);
+    stage.getSpeed().setFrom(0);
+    stage.getSpeed().setTo(0);
+    stage.getSize().setFrom(0);
+    stage.getSize().setTo(0);
+    stage.setGravity(0);
+}
+
+AABB getBoundsAtTime(const particles::IRenderableParticlePtr& particle, const RenderSystemPtr& backend,
+                     std::size_t time)
+{
+    backend->setTime(time);
+    particle->update(Matrix4::getRotationAboutZ(math::Degrees(30)));
+
+    return particle->getBounds();
+}
+
+particles::IRenderableParticlePtr createRenderableParticle(const std::string& name, const RenderSystemPtr& backend)
+{
+    auto particle = GlobalParticlesManager().getRenderableParticle(name);
+    particle->setRandomSeed(PARTICLE_SEED);
+    particle->setRenderSystem(backend);
+    particle->setMainDirection(Vector3(0.3, -0.2, 1));
+    particle->setEntityColour(Vector3(0.5, 0.7, 0.2));
+
+    return particle;
+}
+
+struct RecordedVertex
+{
+    Vector3 vertex;
+    Vector2 texcoord;
+    Vector4 colour;
+};
+
+// The vertices generated for the mixed stages with two particles each at 3380 msecs,
+// as recorded before the stages were compiled and updated in parallel
+const std::vector<RecordedVertex> RECORDED_VERTICES
+{
+    // Sphere distribution, outward direction
+    { { -64.0303, -6.83717, 5.78833 }, { 0, 0 }, { 1, 1, 1, 1 } },
+    { { -56.6152, -9.8399, 5.78833 }, { 1, 0 }, { 1, 1, 1, 1 } },
+    { { -59.618, -17.255, 5.78833 }, { 1, 1 }, { 1, 1, 1, 1 } },
+    { { -67.033, -14.2523, 5.78833 }, { 0, 1 }, { 1, 1, 1, 1 } },
+    { { -1.78491, -2.20475, 19.3675 }, { 0, 0 }, { 0.533333, 0.533333, 0.533333, 0.533333 } },
+    { { -9.65765, -0.783504, 19.3675 }, { 1, 0 }, { 0.533333, 0.533333, 0.533333, 0.533333 } },
+    { { -8.2364, 7.08924, 19.3675 }, { 1, 1 }, { 0.533333, 0.533333, 0.533333, 0.533333 } },
+    { { -0.363663, 5.66799, 19.3675 }, { 0, 1 }, { 0.533333, 0.533333, 0.533333, 0.533333 } },
+
+    // Aimed, animated trails
+    { { -20.2629, 17.5067, 49.0389 }, { 0.75, 0 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -16.4402, 24.5343, 49.0389 }, { 1, 0 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -14.233, 23.3337, 42.6823 }, { 1, 0.25 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -18.0557, 16.3061, 42.6823 }, { 0.75, 0.25 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -20.2629, 17.5067, 49.0389 }, { 0, 0 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -16.4402, 24.5343, 49.0389 }, { 0.25, 0 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -14.233, 23.3337, 42.6823 }, { 0.25, 0.25 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -18.0557, 16.3061, 42.6823 }, { 0, 0.25 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -18.0557, 16.3061, 42.6823 }, { 0.75, 0.25 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -14.233, 23.3337, 42.6823 }, { 1, 0.25 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -12.0258, 22.1331, 36.2257 }, { 1, 0.5 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -15.8485, 15.1055, 36.2257 }, { 0.75, 0.5 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -18.0557, 16.3061, 42.6823 }, { 0, 0.25 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -14.233, 23.3337, 42.6823 }, { 0.25, 0.25 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -12.0258, 22.1331, 36.2257 }, { 0.25, 0.5 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -15.8485, 15.1055, 36.2257 }, { 0, 0.5 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -15.8485, 15.1055, 36.2257 }, { 0.75, 0.5 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -12.0258, 22.1331, 36.2257 }, { 1, 0.5 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -9.81865, 20.9325, 29.6691 }, { 1, 0.75 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -13.6413, 13.9049, 29.6691 }, { 0.75, 0.75 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -15.8485, 15.1055, 36.2257 }, { 0, 0.5 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -12.0258, 22.1331, 36.2257 }, { 0.25, 0.5 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -9.81865, 20.9325, 29.6691 }, { 0.25, 0.75 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -13.6413, 13.9049, 29.6691 }, { 0, 0.75 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -13.6413, 13.9049, 29.6691 }, { 0.75, 0.75 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -9.81865, 20.9325, 29.6691 }, { 1, 0.75 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -7.61146, 19.7319, 23.0125 }, { 1, 1 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -11.4341, 12.7043, 23.0125 }, { 0.75, 1 }, { 0.96, 0.96, 0.96, 0.96 } },
+    { { -13.6413, 13.9049, 29.6691 }, { 0, 0.75 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -9.81865, 20.9325, 29.6691 }, { 0.25, 0.75 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -7.61146, 19.7319, 23.0125 }, { 0.25, 1 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -11.4341, 12.7043, 23.0125 }, { 0, 1 }, { 0.0400002, 0.0400002, 0.0400002, 0.0400002 } },
+    { { -31.2524, 65.4541, 122.722 }, { 0.25, 0 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -24.3481, 69.4954, 122.722 }, { 0.5, 0 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -22.8777, 66.9832, 118.02 }, { 0.5, 0.25 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -29.7819, 62.942, 118.02 }, { 0.25, 0.25 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -31.2524, 65.4541, 122.722 }, { 0.5, 0 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -24.3481, 69.4954, 122.722 }, { 0.75, 0 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -22.8777, 66.9832, 118.02 }, { 0.75, 0.25 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -29.7819, 62.942, 118.02 }, { 0.5, 0.25 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -29.7819, 62.942, 118.02 }, { 0.25, 0.25 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -22.8777, 66.9832, 118.02 }, { 0.5, 0.25 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -21.4073, 64.4711, 113.218 }, { 0.5, 0.5 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -28.3115, 60.4299, 113.218 }, { 0.25, 0.5 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -29.7819, 62.942, 118.02 }, { 0.5, 0.25 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -22.8777, 66.9832, 118.02 }, { 0.75, 0.25 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -21.4073, 64.4711, 113.218 }, { 0.75, 0.5 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -28.3115, 60.4299, 113.218 }, { 0.5, 0.5 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -28.3115, 60.4299, 113.218 }, { 0.25, 0.5 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -21.4073, 64.4711, 113.218 }, { 0.5, 0.5 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -19.9369, 61.959, 108.316 }, { 0.5, 0.75 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -26.8411, 57.9177, 108.316 }, { 0.25, 0.75 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -28.3115, 60.4299, 113.218 }, { 0.5, 0.5 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -21.4073, 64.4711, 113.218 }, { 0.75, 0.5 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -19.9369, 61.959, 108.316 }, { 0.75, 0.75 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -26.8411, 57.9177, 108.316 }, { 0.5, 0.75 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -26.8411, 57.9177, 108.316 }, { 0.25, 0.75 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -19.9369, 61.959, 108.316 }, { 0.5, 0.75 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -18.4665, 59.4468, 103.313 }, { 0.5, 1 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -25.3707, 55.4056, 103.313 }, { 0.25, 1 }, { 0.9472, 0.9472, 0.9472, 0.9472 } },
+    { { -26.8411, 57.9177, 108.316 }, { 0.5, 0.75 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -19.9369, 61.959, 108.316 }, { 0.75, 0.75 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -18.4665, 59.4468, 103.313 }, { 0.75, 1 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+    { { -25.3707, 55.4056, 103.313 }, { 0.5, 1 }, { 0.0394666, 0.0394666, 0.0394666, 0.0394666 } },
+
+    // Flies path, x orientation
+    { { -0.479549, -22.7837, -24.2531 }, { 0, 0 }, { 1, 1, 1, 1 } },
+    { { -0.479549, -29.1433, -19.3997 }, { 1, 0 }, { 1, 1, 1, 1 } },
+    { { -0.479549, -24.2899, -13.0401 }, { 1, 1 }, { 1, 1, 1, 1 } },
+    { { -0.479549, -17.9303, -17.8935 }, { 0, 1 }, { 1, 1, 1, 1 } },
+    { { -5.13194, 4.58873, -32.9195 }, { 0, 0 }, { 0.986667, 0.986667, 0.986667, 0.986667 } },
+    { { -5.13194, 4.63769, -24.9196 }, { 1, 0 }, { 0.986667, 0.986667, 0.986667, 0.986667 } },
+    { { -5.13194, 12.6375, -24.9686 }, { 1, 1 }, { 0.986667, 0.986667, 0.986667, 0.986667 } },
+    { { -5.13194, 12.5886, -32.9684 }, { 0, 1 }, { 0.986667, 0.986667, 0.986667, 0.986667 } },
+
+    // Helix path, entity colour
+    { { -1.63535, -20.332, 4.25416 }, { 0, 0 }, { 0.5, 0.7, 0.2, 1 } },
+    { { -19.2184, -11.8545, 4.25416 }, { 1, 0 }, { 0.5, 0.7, 0.2, 1 } },
+    { { -10.7409, 5.72855, 4.25416 }, { 1, 1 }, { 0.5, 0.7, 0.2, 1 } },
+    { { 6.84213, -2.74893, 4.25416 }, { 0, 1 }, { 0.5, 0.7, 0.2, 1 } },
+    { { -17.8022, 3.4915, 1.12926 }, { 0, 0 }, { 0.5, 0.7, 0.2, 1 } },
+    { { -12.8438, 13.8898, 1.12926 }, { 1, 0 }, { 0.5, 0.7, 0.2, 1 } },
+    { { -2.44551, 8.93133, 1.12926 }, { 1, 1 }, { 0.5, 0.7, 0.2, 1 } },
+    { { -7.40396, -1.46695, 1.12926 }, { 0, 1 }, { 0.5, 0.7, 0.2, 1 } },
+};
+
+}
+
+TEST_F(ParticlesTest, UpdateDependsOnTimeOnly)
+{
+    auto def = GlobalParticlesManager().findOrInsertParticleDef("test/mixedStages");
+    addMixedStages(def);
+
+    RenderSystemPtr backend = GlobalRenderSystemFactory().createRenderSystem();
+
+    auto particle = createRenderableParticle(def->getName(), backend);
+    auto bounds = getBoundsAtTime(particle, backend, 2345);
+
+    EXPECT_TRUE(bounds.isValid());
+
+    // Stepping through other frames (and cycles) must not affect the result
+    for (std::size_t time = 0; time < 6000; time += 160)
+    {
+        getBoundsAtTime(particle, backend, time);
+    }
+
+    EXPECT_EQ(getBoundsAtTime(particle, backend, 2345), bounds);
+
+    // A new instance with the same seed is producing the same geometry
+    auto other = createRenderableParticle(def->getName(), backend);
+
+    EXPECT_EQ(getBoundsAtTime(other, backend, 2345), bounds);
+}
+
+TEST_F(ParticlesTest, BatchUpdateMatchesSequentialUpdate)
+{
+    // Both particles share the mixed stages as first stages, these receive the same seeds.
+    // The last stage doesn't extend the bounds beyond the origin, but pushes the number of
+    // particles of the second particle above the threshold of the parallel update.
+    auto sequentialDef = GlobalParticlesManager().findOrInsertParticleDef("test/sequentialUpdate");
+    addMixedStages(sequentialDef);
+    addPointStage(sequentialDef, 1);
+
+    auto batchDef = GlobalParticlesManager().findOrInsertParticleDef("test/batchUpdate");
+    addMixedStages(batchDef);
+    addPointStage(batchDef, 10000);
+
+    RenderSystemPtr backend = GlobalRenderSystemFactory().createRenderSystem();
+
+    auto sequential = createRenderableParticle(sequentialDef->getName(), backend);
+    auto batch = createRenderableParticle(batchDef->getName(), backend);
+
+    for (std::size_t time = 0; time < 6000; time += 250)
+    {
+        auto bounds = getBoundsAtTime(sequential, backend, time);
+
+        EXPECT_EQ(getBoundsAtTime(batch, backend, time), bounds) << "Bounds differ at time " << time;
+    }
+}
+
+TEST_F(ParticlesTest, UpdateMatchesRecordedQuads)
+{
+    auto def = GlobalParticlesManager().findOrInsertParticleDef("test/recordedQuads");
+    addMixedStages(def);
+
+    for (std::size_t i = 0; i < def->getNumStages(); ++i)
+    {
+        def->getStage(i).setCount(2);
+    }
+
+    RenderSystemPtr backend = GlobalRenderSystemFactory().createRenderSystem();
+
+    auto particle = createRenderableParticle(def->getName(), backend);
+    getBoundsAtTime(particle, backend, 3380);
+
+    std::vector<RecordedVertex> vertices;
+    particle->foreachVertex([&](const Vector3& vertex, const Vector2& texcoord, const Vector4& colour)
+    {
+        vertices.push_back(RecordedVertex{ vertex, texcoord, colour });
+    });
+
+    ASSERT_EQ(vertices.size(), RECORDED_VERTICES.size());
+
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+        const auto& expected = RECORDED_VERTICES[i];
+
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+            EXPECT_NEAR(vertices[i].vertex[c], expected.vertex[c], 0.01) << "Vertex " << i << " differs";
+        }
+
+        for (std::size_t c = 0; c < 2; ++c)
+        {
+            EXPECT_NEAR(vertices[i].texcoord[c], expected.texcoord[c], 0.0001) << "Texcoord " << i << " differs";
+        }
+
+        for (std::size_t c = 0; c < 4; ++c)
+        {
+            EXPECT_NEAR(vertices[i].colour[c], expected.colour[c], 0.0001) << "Colour " << i << " differs";
+        }
+    }
+}
+
+}
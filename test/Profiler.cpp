@@ -0,0 +1,129 @@
+#include "RadiantTest.h"
+
+#include <thread>
+#include <sstream>
+#include <fstream>
+#include "iprofiler.h"
+#include "icommandsystem.h"
+#include "os/file.h"
+
+namespace test
+{
+
+using ProfilerTest = RadiantTest;
+
+namespace
+{
+
+std::string getTrace()
+{
+    std::ostringstream stream;
+    GlobalProfiler().writeTrace(stream);
+    return stream.str();
+}
+
+}
+
+TEST_F(ProfilerTest, NotRunningByDefault)
+{
+    EXPECT_FALSE(GlobalProfiler().isRunning());
+
+    {
+        profiling::ScopedZone zone("Zone while stopped");
+    }
+
+    EXPECT_EQ(getTrace().find("Zone while stopped"), std::string::npos);
+}
+
+TEST_F(ProfilerTest, StartStopCommands)
+{
+    GlobalCommandSystem().executeCommand("ProfilerStart");
+    EXPECT_TRUE(GlobalProfiler().isRunning());
+
+    auto tracePath = _context.getTemporaryDataPath() + "profiler_trace.json";
+    GlobalCommandSystem().executeCommand("ProfilerStop", cmd::Argument(tracePath));
+    EXPECT_FALSE(GlobalProfiler().isRunning());
+
+    EXPECT_TRUE(os::fileOrDirExists(tracePath));
+
+    std::ifstream stream(tracePath);
+    std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    EXPECT_NE(contents.find("\"traceEvents\""), std::string::npos);
+}
+
+TEST_F(ProfilerTest, ZonesOfAllThreadsAreRecorded)
+{
+    GlobalProfiler().start();
+
+    {
+        profiling::ScopedZone zone("Main thread zone");
+    }
+
+    std::thread worker([]()
+    {
+        profiling::ScopedZone zone("Worker thread zone");
+    });
+    worker.join();
+
+    GlobalProfiler().setCounter("Test counter", 42);
+    GlobalProfiler().markFrame("Test frame");
+
+    GlobalProfiler().stop();
+
+    // Zones recorded after stopping are discarded
+    {
+        profiling::ScopedZone zone("Zone after stop");
+    }
+
+    auto trace = getTrace();
+
+    EXPECT_NE(trace.find("\"name\":\"Main thread zone\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Worker thread zone\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Test counter\",\"ph\":\"C\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Test frame\",\"ph\":\"i\""), std::string::npos);
+    EXPECT_EQ(trace.find("Zone after stop"), std::string::npos);
+
+    // Restarting discards the previous events
+    GlobalProfiler().start();
+    GlobalProfiler().stop();
+
+    EXPECT_EQ(getTrace().find("Main thread zone"), std::string::npos);
+}
+
+TEST_F(ProfilerTest, BufferOfExitedThreadIsReused)
+{
+    GlobalProfiler().start();
+
+    std::thread first([]()
+    {
+        profiling::ScopedZone zone("First worker zone");
+    });
+    first.join();
+
+    std::thread second([]()
+    {
+        profiling::ScopedZone zone("Second worker zone");
+    });
+    second.join();
+
+    GlobalProfiler().stop();
+
+    auto trace = getTrace();
+
+    // Both workers wrote to the same buffer, the events of the first one are kept
+    EXPECT_NE(trace.find("\"name\":\"First worker zone\",\"ph\":\"X\",\"pid\":1,\"tid\":0"), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Second worker zone\",\"ph\":\"X\",\"pid\":1,\"tid\":0"), std::string::npos);
+    EXPECT_EQ(trace.find("\"Thread 1\""), std::string::npos);
+}
+
+TEST_F(ProfilerTest, MapLoadIsInstrumented)
+{
+    GlobalProfiler().start();
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument("maps/altar.map"));
+    GlobalProfiler().stop();
+
+    EXPECT_NE(getTrace().find("\"name\":\"Map load\""), std::string::npos);
+}
+
+}
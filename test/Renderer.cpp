@@ -3,7 +3,10 @@
 #include "ieclass.h"
 #include "ientity.h"
 #include "ilightnode.h"
+#include "irendersystemfactory.h"
 #include "math/Matrix4.h"
+#include "render/ArbitraryMeshVertex.h"
+#include "render/LightInteractionCache.h"
 
 namespace test
 {
@@ -194,4 +197,218 @@ TEST_F(RendererTest, SimpleProjectedLight)
     EXPECT_EQ(projT.z(), 1);
 }
 
-}
\ No newline at end of file
+// Renderable counting the number of times it has been drawn
+class CountingRenderable :
+    public OpenGLRenderable
+{
+public:
+    mutable int renderCount = 0;
+
+    void render(const RenderInfo& info) const override
+    {
+        ++renderCount;
+    }
+};
+
+TEST_F(RendererTest, FrameStatisticsOfRenderQueue)
+{
+    RenderSystemPtr backend = GlobalRenderSystemFactory().createRenderSystem();
+    backend->realise();
+
+    auto shader = backend->capture("<1 0 0>");
+
+    // Submit the same renderable for two different entities
+    Light first;
+    Light second;
+    CountingRenderable renderable;
+
+    shader->addRenderable(renderable, Matrix4::getIdentity(), nullptr, first.node.get());
+    shader->addRenderable(renderable, Matrix4::getIdentity(), nullptr, second.node.get());
+
+    backend->render(RENDER_DEPTHTEST | RENDER_DEPTHWRITE, Matrix4::getIdentity(),
+        Matrix4::getIdentity(), V3(0, 0, 0));
+
+    const auto& stats = backend->getFrameStatistics();
+
+    // One queue entry per entity, both of them drawn
+    EXPECT_EQ(stats.queueEntries, 2);
+    EXPECT_EQ(stats.drawCalls, 2);
+    EXPECT_EQ(renderable.renderCount, 2);
+
+    // The pass has no stages, so its state needs to be applied only once
+    EXPECT_EQ(stats.stateChanges, 1);
+    EXPECT_EQ(stats.skippedStateChanges, 1);
+
+    // Nothing is left in the queue for the next frame
+    backend->render(RENDER_DEPTHTEST | RENDER_DEPTHWRITE, Matrix4::getIdentity(),
+        Matrix4::getIdentity(), V3(0, 0, 0));
+
+    EXPECT_EQ(backend->getFrameStatistics().queueEntries, 0);
+    EXPECT_EQ(backend->getFrameStatistics().drawCalls, 0);
+    EXPECT_EQ(renderable.renderCount, 2);
+}
+
+// LitObject with fixed bounds, counting the intersection tests
+class TestLitObject :
+    public LitObject
+{
+public:
+    AABB bounds;
+    mutable std::size_t intersectionTests = 0;
+
+    TestLitObject(const AABB& bounds_) :
+        bounds(bounds_)
+    {}
+
+    bool intersectsLight(const RendererLight& light) const override
+    {
+        ++intersectionTests;
+        return light.lightAABB().intersects(bounds);
+    }
+
+    const AABB& litObjectAABB() const override
+    {
+        return bounds;
+    }
+};
+
+std::size_t countLights(const LightSources& lights)
+{
+    std::size_t count = 0;
+    lights.forEachLight([&](const RendererLight&) { ++count; });
+    return count;
+}
+
+// Runs one frame through the cache, returns the number of lights of each object
+std::vector<std::size_t> updateInteractions(render::LightInteractionCache& cache,
+    const std::vector<const RendererLight*>& lights, const std::vector<TestLitObject*>& objects)
+{
+    cache.beginFrame();
+
+    for (auto light : lights)
+    {
+        cache.addLight(*light, light->lightAABB());
+    }
+
+    cache.beginUpdate();
+
+    std::vector<std::size_t> result;
+
+    for (auto object : objects)
+    {
+        result.push_back(countLights(cache.getLights(*object)));
+    }
+
+    cache.endUpdate();
+
+    return result;
+}
+
+TEST_F(RendererTest, LightInteractionsAreReused)
+{
+    Light light = Light::withRadius(V3(64, 64, 64));
+    const auto& rendererLight = light.iLightNode->getRendererLight();
+
+    TestLitObject inside(AABB(V3(32, 0, 0), V3(8, 8, 8)));
+    TestLitObject outside(AABB(V3(512, 0, 0), V3(8, 8, 8)));
+
+    render::LightInteractionCache cache;
+
+    auto lightCounts = updateInteractions(cache, { &rendererLight }, { &inside, &outside });
+
+    EXPECT_EQ(lightCounts, std::vector<std::size_t>({ 1, 0 }));
+    EXPECT_EQ(cache.getStatistics().interactions, 1);
+    EXPECT_EQ(cache.getStatistics().rebuiltObjects, 2);
+
+    // Nothing changed, the second frame must not test any intersections
+    inside.intersectionTests = outside.intersectionTests = 0;
+
+    lightCounts = updateInteractions(cache, { &rendererLight }, { &inside, &outside });
+
+    EXPECT_EQ(lightCounts, std::vector<std::size_t>({ 1, 0 }));
+    EXPECT_EQ(cache.getStatistics().interactions, 1);
+    EXPECT_EQ(cache.getStatistics().rebuiltObjects, 0);
+    EXPECT_EQ(cache.getStatistics().changedLights, 0);
+    EXPECT_EQ(inside.intersectionTests, 0);
+    EXPECT_EQ(outside.intersectionTests, 0);
+
+    // Move the second object into the light, only this one is re-evaluated
+    outside.bounds = AABB(V3(-32, 0, 0), V3(8, 8, 8));
+
+    lightCounts = updateInteractions(cache, { &rendererLight }, { &inside, &outside });
+
+    EXPECT_EQ(lightCounts, std::vector<std::size_t>({ 1, 1 }));
+    EXPECT_EQ(cache.getStatistics().rebuiltObjects, 1);
+    EXPECT_EQ(inside.intersectionTests, 0);
+    EXPECT_EQ(outside.intersectionTests, 1);
+}
+
+TEST_F(RendererTest, LightInteractionsFollowLightChanges)
+{
+    Light light = Light::withRadius(V3(64, 64, 64));
+    const auto& rendererLight = light.iLightNode->getRendererLight();
+
+    TestLitObject object(AABB(V3(48, 0, 0), V3(8, 8, 8)));
+
+    render::LightInteractionCache cache;
+
+    EXPECT_EQ(updateInteractions(cache, { &rendererLight }, { &object }), std::vector<std::size_t>({ 1 }));
+
+    // Shrink the light, the object is no longer lit
+    light.entity->setKeyValue("light_radius", "16 16 16");
+
+    EXPECT_EQ(updateInteractions(cache, { &rendererLight }, { &object }), std::vector<std::size_t>({ 0 }));
+    EXPECT_EQ(cache.getStatistics().changedLights, 2); // removed and added again
+    EXPECT_EQ(cache.getStatistics().rebuiltObjects, 1);
+
+    light.entity->setKeyValue("light_radius", "64 64 64");
+
+    EXPECT_EQ(updateInteractions(cache, { &rendererLight }, { &object }), std::vector<std::size_t>({ 1 }));
+
+    // A light that is no longer submitted must disappear from the lists
+    EXPECT_EQ(updateInteractions(cache, {}, { &object }), std::vector<std::size_t>({ 0 }));
+    EXPECT_EQ(cache.getStatistics().changedLights, 1);
+    EXPECT_EQ(cache.getStatistics().interactions, 0);
+}
+
+TEST_F(RendererTest, GeometryStoreSlotAllocation)
+{
+    RenderSystemPtr backend = GlobalRenderSystemFactory().createRenderSystem();
+    auto& store = backend->getGeometryStore();
+
+    std::vector<ArbitraryMeshVertex> vertices(3);
+    std::vector<unsigned int> indices{ 0, 1, 2 };
+
+    auto first = store.allocateSlot(3, 3);
+    auto second = store.allocateSlot(3, 3);
+    store.updateData(first, vertices, indices);
+    store.updateData(second, vertices, indices);
+
+    // Both slots report their used index range, without overlapping
+    auto firstParams = store.getRenderParameters(first);
+    auto secondParams = store.getRenderParameters(second);
+    EXPECT_EQ(firstParams.indexCount, 3);
+    EXPECT_EQ(secondParams.indexCount, 3);
+    EXPECT_NE(firstParams.firstIndex, secondParams.firstIndex);
+
+    // Uploading more data than allocated is rejected, leaving the slot untouched
+    std::vector<ArbitraryMeshVertex> tooManyVertices(4);
+    std::vector<unsigned int> fewerIndices{ 0, 1 };
+    EXPECT_THROW(store.updateData(first, tooManyVertices, fewerIndices), std::logic_error);
+    EXPECT_EQ(store.getRenderParameters(first).indexCount, 3);
+
+    std::vector<unsigned int> tooManyIndices{ 0, 1, 2, 0, 1, 2 };
+    EXPECT_THROW(store.updateData(first, vertices, tooManyIndices), std::logic_error);
+    EXPECT_EQ(store.getRenderParameters(first).indexCount, 3);
+
+    // A freed slot can be re-used by a new allocation of the same size
+    store.deallocateSlot(first);
+    auto third = store.allocateSlot(3, 3);
+    store.updateData(third, vertices, indices);
+    EXPECT_EQ(store.getRenderParameters(third).firstIndex, firstParams.firstIndex);
+
+    store.deallocateSlot(second);
+    store.deallocateSlot(third);
+}
+
+}
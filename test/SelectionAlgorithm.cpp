@@ -1,8 +1,21 @@
 #include "RadiantTest.h"
 
+#include <set>
+#include <map>
 #include "iselection.h"
+#include "iselectiongroup.h"
 #include "icommandsystem.h"
+#include "ientity.h"
+#include "ieclass.h"
+#include "imap.h"
+#include "ispacepartition.h"
+#include "iscenegraph.h"
+#include "itextstream.h"
 #include "selectionlib.h"
+#include "scenelib.h"
+#include "algorithm/Primitives.h"
+#include "time/StopWatch.h"
+#include "string/convert.h"
 
 namespace test
 {
@@ -33,4 +46,398 @@ TEST_F(RadiantTest, SelectItemsByModel)
     ASSERT_TRUE(GlobalSelectionSystem().getSelectionInfo().totalCount == 0);
 }
 
+namespace
+{
+
+// Fills the worldspawn with a grid of 128x128x128 cubes, 256 units apart
+std::vector<scene::INodePtr> createBrushGrid(std::size_t size)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    std::vector<scene::INodePtr> brushes;
+
+    for (std::size_t x = 0; x < size; ++x)
+    {
+        for (std::size_t y = 0; y < size; ++y)
+        {
+            brushes.push_back(algorithm::createCubicBrush(worldspawn, Vector3(x * 256.0, y * 256.0, 0)));
+        }
+    }
+
+    return brushes;
+}
+
+std::set<scene::INodePtr> getSelectedNodes()
+{
+    std::set<scene::INodePtr> selected;
+
+    GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node)
+    {
+        selected.insert(node);
+    });
+
+    return selected;
+}
+
+void selectByBounds(const std::string& command, const Vector3& min, const Vector3& max)
+{
+    GlobalSelectionSystem().setSelectedAll(false);
+    GlobalCommandSystem().executeCommand(command, { cmd::Argument(min), cmd::Argument(max) });
+}
+
+// Selects the touching nodes by traversing the whole scene, as it has been done before the octree was used
+void selectTouchingByTraversal(const AABB& box)
+{
+    GlobalSceneGraph().root()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (!node->visible()) return true;
+
+        auto entity = Node_getEntity(node);
+        if (entity && entity->isWorldspawn()) return true;
+
+        if (!Node_getSelectable(node) || !node->getParent()) return true;
+
+        const auto& other = node->worldAABB();
+
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            if (std::abs(box.origin[i] - other.origin[i]) > (box.extents[i] + other.extents[i]))
+            {
+                return true;
+            }
+        }
+
+        Node_setSelected(node, true);
+        return true;
+    });
+}
+
+}
+
+TEST_F(RadiantTest, SpacePartitionBoundsQuery)
+{
+    auto brushes = createBrushGrid(4);
+
+    auto countMatches = [](const scene::BoundsQuery& query)
+    {
+        std::size_t count = 0;
+
+        GlobalSceneGraph().foreachNodeInBounds(query, [&](const scene::INodePtr& node)
+        {
+            if (Node_isBrush(node)) ++count;
+            return true;
+        });
+
+        return count;
+    };
+
+    // The first two cubes along the x axis are touched or contained
+    auto box = AABB::createFromMinMax(Vector3(-64, -64, -64), Vector3(320, 64, 64));
+
+    EXPECT_EQ(countMatches(scene::BoundsQuery({ box }, scene::BoundsQueryType::Intersects)), 2);
+    EXPECT_EQ(countMatches(scene::BoundsQuery({ box }, scene::BoundsQueryType::Contained)), 2);
+
+    // Moving the box up by 100 units keeps the intersections, but nothing is contained anymore
+    auto raisedBox = AABB(box.getOrigin() + Vector3(0, 0, 100), box.getExtents());
+
+    EXPECT_EQ(countMatches(scene::BoundsQuery({ raisedBox }, scene::BoundsQueryType::Intersects)), 2);
+    EXPECT_EQ(countMatches(scene::BoundsQuery({ raisedBox }, scene::BoundsQueryType::Contained)), 0);
+
+    // A box high above the grid only finds something when extended along the z axis
+    auto highBox = AABB(Vector3(0, 0, 4096), Vector3(8, 8, 8));
+    scene::BoundsQuery column({ highBox }, scene::BoundsQueryType::ColumnIntersects);
+    column.columnAxis = 2;
+
+    EXPECT_EQ(countMatches(scene::BoundsQuery({ highBox }, scene::BoundsQueryType::Intersects)), 0);
+    EXPECT_EQ(countMatches(column), 1);
+
+    // Multiple query boxes, all four corners of the grid
+    std::vector<AABB> corners;
+    corners.emplace_back(Vector3(0, 0, 0), Vector3(8, 8, 8));
+    corners.emplace_back(Vector3(768, 0, 0), Vector3(8, 8, 8));
+    corners.emplace_back(Vector3(0, 768, 0), Vector3(8, 8, 8));
+    corners.emplace_back(Vector3(768, 768, 0), Vector3(8, 8, 8));
+
+    EXPECT_EQ(countMatches(scene::BoundsQuery(corners, scene::BoundsQueryType::Intersects)), 4);
+}
+
+TEST_F(RadiantTest, SelectByBounds)
+{
+    auto brushes = createBrushGrid(10);
+
+    selectByBounds("SelectTouching", Vector3(-64, -64, -64), Vector3(320, 64, 64));
+    EXPECT_EQ(getSelectedNodes(), std::set<scene::INodePtr>({ brushes[0], brushes[10] }));
+
+    // Flush planes are accepted by SelectInside
+    selectByBounds("SelectInside", Vector3(-64, -64, -64), Vector3(320, 64, 64));
+    EXPECT_EQ(getSelectedNodes(), std::set<scene::INodePtr>({ brushes[0], brushes[10] }));
+
+    // ...but not by SelectFullyInside
+    selectByBounds("SelectFullyInside", Vector3(-64, -64, -64), Vector3(320, 64, 64));
+    EXPECT_EQ(GlobalSelectionSystem().countSelected(), 0);
+
+    selectByBounds("SelectFullyInside", Vector3(-100, -100, -100), Vector3(350, 100, 100));
+    EXPECT_EQ(getSelectedNodes(), std::set<scene::INodePtr>({ brushes[0], brushes[10] }));
+
+    GlobalSelectionSystem().setSelectedAll(false);
+}
+
+TEST_F(RadiantTest, SelectByBoundsSkipsChildrenOfSelectedEntities)
+{
+    auto funcStatic = GlobalEntityModule().createEntity(GlobalEntityClassManager().findOrInsert("func_static", false));
+    GlobalMapModule().getRoot()->addChildNode(funcStatic);
+
+    auto childBrush = algorithm::createCubicBrush(funcStatic, Vector3(1024, 0, 0));
+
+    selectByBounds("SelectTouching", Vector3(960, -64, -64), Vector3(1088, 64, 64));
+
+    // The entity is selected, its child brush is not
+    EXPECT_TRUE(Node_isSelected(funcStatic));
+    EXPECT_FALSE(Node_isSelected(childBrush));
+
+    GlobalSelectionSystem().setSelectedAll(false);
+}
+
+TEST_F(RadiantTest, SelectInsideUsesLightDiamond)
+{
+    auto light = GlobalEntityModule().createEntity(GlobalEntityClassManager().findClass("light"));
+    GlobalMapModule().getRoot()->addChildNode(light);
+
+    light->getEntity().setKeyValue("origin", "512 512 0");
+    light->getEntity().setKeyValue("light_radius", "320 320 320");
+
+    // The light volume is much larger than the box, but the diamond is inside
+    selectByBounds("SelectInside", Vector3(480, 480, -32), Vector3(544, 544, 32));
+    EXPECT_TRUE(Node_isSelected(light));
+
+    selectByBounds("SelectInside", Vector3(600, 600, -32), Vector3(700, 700, 32));
+    EXPECT_FALSE(Node_isSelected(light));
+
+    GlobalSelectionSystem().setSelectedAll(false);
+}
+
+TEST_F(RadiantTest, FloorSelection)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    // The floor below the entity and another one out of reach
+    algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0));
+    algorithm::createCubicBrush(worldspawn, Vector3(1024, 0, 128));
+
+    auto entity = GlobalEntityModule().createEntity(GlobalEntityClassManager().findOrInsert("info_player_start", false));
+    GlobalMapModule().getRoot()->addChildNode(entity);
+    entity->getEntity().setKeyValue("origin", "0 0 256");
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    Node_setSelected(entity, true);
+
+    GlobalCommandSystem().executeCommand("FloorSelection");
+
+    EXPECT_EQ(entity->getEntity().getKeyValue("origin"), "0 0 64");
+
+    GlobalSelectionSystem().setSelectedAll(false);
+}
+
+// Compares the octree-backed SelectTouching against a full scene traversal
+TEST_F(RadiantTest, SelectTouchingBenchmark)
+{
+    createBrushGrid(80);
+
+    // A few boxes spread over the map
+    std::vector<AABB> boxes;
+    for (int i = 0; i < 10; ++i)
+    {
+        boxes.emplace_back(Vector3(i * 2000.0, i * 1000.0, 0), Vector3(300, 300, 64));
+    }
+
+    std::size_t traversalMsecs = 0;
+    std::size_t octreeMsecs = 0;
+
+    for (const auto& box : boxes)
+    {
+        GlobalSelectionSystem().setSelectedAll(false);
+
+        util::StopWatch traversalTimer;
+        selectTouchingByTraversal(box);
+        traversalMsecs += traversalTimer.getMilliSecondsPassed();
+
+        auto expected = getSelectedNodes();
+        GlobalSelectionSystem().setSelectedAll(false);
+
+        util::StopWatch octreeTimer;
+        GlobalCommandSystem().executeCommand("SelectTouching",
+            { cmd::Argument(box.origin - box.extents), cmd::Argument(box.origin + box.extents) });
+        octreeMsecs += octreeTimer.getMilliSecondsPassed();
+
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(getSelectedNodes(), expected);
+    }
+
+    rMessage() << "SelectTouching on " << 80 * 80 << " brushes: scene traversal took " <<
+        traversalMsecs << " msec, octree query took " << octreeMsecs << " msec" << std::endl;
+
+    GlobalSelectionSystem().setSelectedAll(false);
+}
+
+namespace
+{
+
+std::vector<IEntityNodePtr> getEntitiesByClassname(const std::string& classname)
+{
+    std::vector<IEntityNodePtr> entities;
+
+    GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& node)
+    {
+        auto entity = std::dynamic_pointer_cast<IEntityNode>(node);
+
+        if (entity && entity->getEntity().getKeyValue("classname") == classname)
+        {
+            entities.push_back(entity);
+        }
+
+        return true;
+    });
+
+    return entities;
+}
+
+}
+
+TEST_F(RadiantTest, CopyPasteEntityWithChildPrimitives)
+{
+    auto funcStatic = GlobalEntityModule().createEntity(GlobalEntityClassManager().findClass("func_static"));
+    GlobalMapModule().getRoot()->addChildNode(funcStatic);
+    funcStatic->getEntity().setKeyValue("name", "copied_static");
+    funcStatic->getEntity().setKeyValue("origin", "128 0 0");
+
+    auto brush = algorithm::createCubicBrush(funcStatic, Vector3(128, 0, 0));
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    Node_setSelected(funcStatic, true);
+
+    GlobalCommandSystem().executeCommand("Copy");
+    GlobalCommandSystem().executeCommand("Paste");
+
+    auto entities = getEntitiesByClassname("func_static");
+    ASSERT_EQ(entities.size(), 2);
+
+    auto pasted = entities[0] == funcStatic ? entities[1] : entities[0];
+
+    // The pasted entity is selected and got a new name
+    EXPECT_TRUE(Node_isSelected(pasted));
+    EXPECT_FALSE(Node_isSelected(funcStatic));
+    EXPECT_NE(pasted->getEntity().getKeyValue("name"), "copied_static");
+    EXPECT_EQ(pasted->getEntity().getKeyValue("origin"), "128 0 0");
+
+    // The child brush is at the same position as the original one
+    std::vector<scene::INodePtr> children;
+    pasted->foreachNode([&](const scene::INodePtr& child) { children.push_back(child); return true; });
+
+    ASSERT_EQ(children.size(), 1);
+    EXPECT_TRUE(Node_isBrush(children.front()));
+    EXPECT_TRUE(math::isNear(children.front()->worldAABB().getOrigin(), brush->worldAABB().getOrigin(), 0.01));
+
+    // The clipboard contents can be pasted more than once
+    GlobalCommandSystem().executeCommand("Paste");
+
+    std::set<std::string> names;
+    for (const auto& entity : getEntitiesByClassname("func_static"))
+    {
+        names.insert(entity->getEntity().getKeyValue("name"));
+    }
+
+    EXPECT_EQ(names.size(), 3);
+
+    GlobalSelectionSystem().setSelectedAll(false);
+}
+
+TEST_F(RadiantTest, CopyPasteKeepsSelectionGroups)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto first = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0));
+    auto second = algorithm::createCubicBrush(worldspawn, Vector3(256, 0, 0));
+    auto ungrouped = algorithm::createCubicBrush(worldspawn, Vector3(512, 0, 0));
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    Node_setSelected(first, true);
+    Node_setSelected(second, true);
+    GlobalCommandSystem().executeCommand("GroupSelected");
+
+    auto originalGroup = std::dynamic_pointer_cast<IGroupSelectable>(first)->getMostRecentGroupId();
+
+    Node_setSelected(ungrouped, true);
+    GlobalCommandSystem().executeCommand("Copy");
+    GlobalCommandSystem().executeCommand("Paste");
+
+    auto pasted = getSelectedNodes();
+    ASSERT_EQ(pasted.size(), 3);
+
+    // The two grouped brushes share a new group, the third one is still ungrouped
+    std::map<std::size_t, std::size_t> brushesPerGroup;
+    std::size_t ungroupedCount = 0;
+
+    for (const auto& node : pasted)
+    {
+        EXPECT_TRUE(node != first && node != second && node != ungrouped);
+
+        auto groupSelectable = std::dynamic_pointer_cast<IGroupSelectable>(node);
+        ASSERT_TRUE(groupSelectable);
+
+        if (groupSelectable->isGroupMember())
+        {
+            brushesPerGroup[groupSelectable->getMostRecentGroupId()]++;
+        }
+        else
+        {
+            ungroupedCount++;
+        }
+    }
+
+    EXPECT_EQ(ungroupedCount, 1);
+    ASSERT_EQ(brushesPerGroup.size(), 1);
+    EXPECT_EQ(brushesPerGroup.begin()->second, 2);
+    EXPECT_NE(brushesPerGroup.begin()->first, originalGroup);
+
+    GlobalSelectionSystem().setSelectedAll(false);
+}
+
+// Pasting many entities with conflicting names needs to assign unique names to all of them
+TEST_F(RadiantTest, CopyPasteManyNamedEntities)
+{
+    const std::size_t count = 2000;
+
+    GlobalSelectionSystem().setSelectedAll(false);
+
+    for (std::size_t i = 1; i <= count; ++i)
+    {
+        auto entity = GlobalEntityModule().createEntity(GlobalEntityClassManager().findClass("func_static"));
+        GlobalMapModule().getRoot()->addChildNode(entity);
+        entity->getEntity().setKeyValue("name", "func_static_" + string::to_string(i));
+        Node_setSelected(entity, true);
+    }
+
+    util::StopWatch timer;
+
+    GlobalCommandSystem().executeCommand("Copy");
+    GlobalCommandSystem().executeCommand("Paste");
+
+    rMessage() << "Copy and paste of " << count << " entities took " << timer.getMilliSecondsPassed() << " msec" << std::endl;
+
+    auto entities = getEntitiesByClassname("func_static");
+    EXPECT_EQ(entities.size(), count * 2);
+
+    std::set<std::string> names;
+    for (const auto& entity : entities)
+    {
+        names.insert(entity->getEntity().getKeyValue("name"));
+    }
+
+    EXPECT_EQ(names.size(), count * 2);
+
+    // The conflicting names continue where the existing ones stop
+    EXPECT_EQ(names.count("func_static_" + string::to_string(count * 2)), 1);
+    EXPECT_EQ(names.count("func_static_" + string::to_string(count * 2 + 1)), 0);
+
+    GlobalSelectionSystem().setSelectedAll(false);
+}
+
 }
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <limits>
+#include <ostream>
+#include <functional>
+#include "../RadiantTest.h"
+
+namespace benchmark
+{
+
+/**
+ * The measurements collected by all benchmarks of a drbench run,
+ * written out as JSON document when the run is complete.
+ */
+class Results
+{
+public:
+    struct Measurement
+    {
+        std::string name;
+        std::size_t iterations = 0;
+        double totalMs = 0;
+        double minMs = std::numeric_limits<double>::max();
+        double maxMs = 0;
+    };
+
+    // Scale factor applied to the synthetic maps, set by the command line
+    std::size_t scale = 100;
+
+    std::vector<Measurement> measurements;
+
+    static Results& Instance()
+    {
+        static Results _instance;
+        return _instance;
+    }
+
+    void writeJson(std::ostream& stream) const
+    {
+        stream << "{\n  \"scale\": " << scale << ",\n  \"benchmarks\": [";
+
+        for (std::size_t i = 0; i < measurements.size(); ++i)
+        {
+            const auto& m = measurements[i];
+
+            stream << (i > 0 ? ",\n" : "\n") << "    { \"name\": \"" << m.name << "\""
+                << ", \"iterations\": " << m.iterations
+                << ", \"total_ms\": " << m.totalMs
+                << ", \"mean_ms\": " << (m.iterations > 0 ? m.totalMs / m.iterations : 0)
+                << ", \"min_ms\": " << m.minMs
+                << ", \"max_ms\": " << m.maxMs << " }";
+        }
+
+        stream << "\n  ]\n}\n";
+    }
+};
+
+/**
+ * Fixture of all benchmarks, runs the same module startup as the
+ * drtest fixture and works on the same test resources.
+ */
+class BenchmarkTest :
+    public test::RadiantTest
+{
+protected:
+    using Clock = std::chrono::steady_clock;
+
+    std::size_t getScale() const
+    {
+        return Results::Instance().scale;
+    }
+
+    // Runs the given function the given number of times, recording the
+    // time spent in each call under the given name
+    void measure(const std::string& name, const std::function<void()>& func, std::size_t iterations = 1)
+    {
+        Results::Measurement measurement;
+        measurement.name = name;
+
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            auto start = Clock::now();
+            func();
+            auto ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            measurement.iterations++;
+            measurement.totalMs += ms;
+            measurement.minMs = std::min(measurement.minMs, ms);
+            measurement.maxMs = std::max(measurement.maxMs, ms);
+        }
+
+        Results::Instance().measurements.emplace_back(std::move(measurement));
+    }
+};
+
+}
@@ -0,0 +1,56 @@
+#include "Benchmark.h"
+
+#include <fstream>
+#include <iostream>
+#include "string/convert.h"
+#include "string/predicate.h"
+
+/**
+ * Entry point of the drbench executable. Accepts the usual gtest options
+ * (e.g. --gtest_filter to pick the benchmarks to run) and additionally:
+ *
+ * --scale=<N>     Size of the synthetic maps, N * 10 brushes, N * 2 patches
+ *                 and N entities (default: 100)
+ * --output=<path> File to write the JSON results to (default: drbench.json)
+ */
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+
+    std::string outputPath = "drbench.json";
+    auto& results = benchmark::Results::Instance();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+
+        if (string::starts_with(arg, "--scale="))
+        {
+            results.scale = string::convert<std::size_t>(arg.substr(8), results.scale);
+        }
+        else if (string::starts_with(arg, "--output="))
+        {
+            outputPath = arg.substr(9);
+        }
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    auto result = RUN_ALL_TESTS();
+
+    std::ofstream stream(outputPath);
+
+    if (!stream)
+    {
+        std::cerr << "Cannot write to " << outputPath << std::endl;
+        return 1;
+    }
+
+    results.writeJson(stream);
+    std::cout << "Benchmark results written to " << outputPath << std::endl;
+
+    return result;
+}
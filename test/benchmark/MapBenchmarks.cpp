@@ -0,0 +1,262 @@
+#include "Benchmark.h"
+#include "SyntheticMap.h"
+
+#include "imap.h"
+#include "imapresource.h"
+#include "iselection.h"
+#include "iscenegraph.h"
+#include "ifilter.h"
+#include "ishaders.h"
+#include "ieclass.h"
+#include "iparticles.h"
+#include "icommandsystem.h"
+#include "render/View.h"
+#include "selection/SelectionVolume.h"
+#include "Rectangle.h"
+#include "selectionlib.h"
+#include "scene/merge/GraphComparer.h"
+
+namespace benchmark
+{
+
+namespace
+{
+
+constexpr std::size_t DeviceWidth = 640;
+constexpr std::size_t DeviceHeight = 640;
+
+// Sets up a top-down orthographic view centered at the given origin,
+// showing an area of the given size
+void constructOrthoView(render::View& view, const Vector3& origin, double visibleSize)
+{
+    auto scale = DeviceWidth / visibleSize;
+
+    Matrix4 projection = Matrix4::getIdentity();
+    projection[0] = 1.0 / static_cast<double>(DeviceWidth / 2);
+    projection[5] = 1.0 / static_cast<double>(DeviceHeight / 2);
+    projection[10] = 1.0 / (32768 * scale);
+    projection[14] = -1.0;
+
+    Matrix4 modelView = Matrix4::getIdentity();
+    modelView[0] = scale;
+    modelView[5] = scale;
+    modelView[10] = -scale;
+    modelView[12] = -origin.x() * scale;
+    modelView[13] = -origin.y() * scale;
+    modelView[14] = 32768 * scale;
+
+    view.construct(projection, modelView, DeviceWidth, DeviceHeight);
+}
+
+// A selection test of the given device area in a view centered at the given origin
+SelectionVolume createSelectionTest(const Vector3& origin, double visibleSize, const selection::Rectangle& rectangle)
+{
+    render::View view(false);
+    constructOrthoView(view, origin, visibleSize);
+    ConstructSelectionTest(view, rectangle);
+
+    return SelectionVolume(view);
+}
+
+}
+
+class MapBenchmark :
+    public BenchmarkTest
+{
+protected:
+    SyntheticMap _map;
+
+    MapBenchmark() :
+        _map(Results::Instance().scale)
+    {}
+
+    // Creates the synthetic map in the active scene
+    void populateMap()
+    {
+        _map.populate(GlobalMapModule().getRoot(), GlobalMapModule().findOrInsertWorldspawn());
+    }
+
+    // Saves the active map to the temporary data folder and returns the full path
+    std::string saveMap()
+    {
+        auto path = _context.getTemporaryDataPath() + "drbench.map";
+        GlobalCommandSystem().executeCommand("SaveMapCopyAs", cmd::Argument(path));
+
+        return path;
+    }
+};
+
+TEST_F(MapBenchmark, DeclarationLoading)
+{
+    // Loading the decls at startup happens in the background, force a full reload
+    measure("decls.materials", []()
+    {
+        GlobalMaterialManager().refresh();
+        GlobalMaterialManager().materialExists(SyntheticMap::Material);
+    }, 3);
+
+    measure("decls.entity_classes", []()
+    {
+        GlobalEntityClassManager().reloadDefs();
+    }, 3);
+
+    measure("decls.particles", []()
+    {
+        GlobalParticlesManager().reloadParticleDefs();
+    }, 3);
+}
+
+TEST_F(MapBenchmark, SceneInsert)
+{
+    measure("map.populate", [&]() { populateMap(); });
+}
+
+TEST_F(MapBenchmark, SaveAndLoad)
+{
+    populateMap();
+
+    std::string path;
+    measure("map.save", [&]() { path = saveMap(); }, 3);
+
+    measure("map.parse", [&]()
+    {
+        auto resource = GlobalMapResourceManager().createFromPath(path);
+        EXPECT_TRUE(resource->load());
+    }, 3);
+
+    GlobalMapModule().setModified(false);
+
+    measure("map.open", [&]()
+    {
+        GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument(path));
+    });
+}
+
+TEST_F(MapBenchmark, OctreeQueries)
+{
+    populateMap();
+
+    // Query a view-sized area around every 10th object
+    std::vector<render::View> views;
+
+    for (std::size_t i = 0; i < _map.getNumObjects(); i += 10)
+    {
+        views.emplace_back(false);
+        constructOrthoView(views.back(), _map.getCellOrigin(i), DeviceWidth);
+    }
+
+    measure("octree.query", [&]()
+    {
+        std::size_t visited = 0;
+
+        for (const auto& view : views)
+        {
+            GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr&)
+            {
+                ++visited;
+                return true;
+            });
+        }
+
+        EXPECT_GT(visited, 0);
+    }, 10);
+}
+
+TEST_F(MapBenchmark, PointSelection)
+{
+    populateMap();
+
+    auto epsilon = Vector2(2.0 / DeviceWidth, 2.0 / DeviceHeight);
+    auto rectangle = selection::Rectangle::ConstructFromPoint(Vector2(0, 0), epsilon);
+
+    std::vector<SelectionVolume> tests;
+
+    for (std::size_t i = 0; i < _map.getNumObjects(); i += 10)
+    {
+        tests.emplace_back(createSelectionTest(_map.getCellOrigin(i), DeviceWidth, rectangle));
+    }
+
+    measure("selection.point", [&]()
+    {
+        for (auto& test : tests)
+        {
+            GlobalSelectionSystem().selectPoint(test, SelectionSystem::eReplace, false);
+        }
+    }, 3);
+
+    // Face selection, as used by the texture tools
+    measure("selection.point_faces", [&]()
+    {
+        for (auto& test : tests)
+        {
+            GlobalSelectionSystem().selectPoint(test, SelectionSystem::eReplace, true);
+        }
+    }, 3);
+}
+
+TEST_F(MapBenchmark, AreaSelection)
+{
+    populateMap();
+
+    auto bounds = _map.getBounds();
+    auto rectangle = selection::Rectangle::ConstructFromArea(Vector2(-1, -1), Vector2(2, 2));
+    auto test = createSelectionTest(bounds.getOrigin(), bounds.getExtents().x() * 2, rectangle);
+
+    measure("selection.area", [&]()
+    {
+        GlobalSelectionSystem().selectArea(test, SelectionSystem::eReplace, false);
+        EXPECT_GT(GlobalSelectionSystem().countSelected(), 0);
+    }, 3);
+}
+
+TEST_F(MapBenchmark, CSG)
+{
+    populateMap();
+
+    // Hollow every 10th brush
+    std::size_t index = 0;
+
+    GlobalMapModule().findOrInsertWorldspawn()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (Node_isBrush(node) && index++ % 10 == 0)
+        {
+            Node_setSelected(node, true);
+        }
+
+        return true;
+    });
+
+    measure("csg.hollow", []()
+    {
+        GlobalCommandSystem().executeCommand("CSGHollow");
+    });
+}
+
+TEST_F(MapBenchmark, MergeComparison)
+{
+    populateMap();
+
+    auto path = saveMap();
+
+    auto resource = GlobalMapResourceManager().createFromPath(path);
+    EXPECT_TRUE(resource->load());
+
+    measure("merge.compare", [&]()
+    {
+        auto result = scene::merge::GraphComparer::Compare(resource->getRootNode(), GlobalMapModule().getRoot());
+        EXPECT_EQ(result->differingEntities.size(), 0);
+    }, 3);
+}
+
+TEST_F(MapBenchmark, FilterToggles)
+{
+    populateMap();
+
+    measure("filter.toggle", []()
+    {
+        GlobalFilterSystem().setFilterState("Caulk", true);
+        GlobalFilterSystem().setFilterState("Caulk", false);
+    }, 10);
+}
+
+}
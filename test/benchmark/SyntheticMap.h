@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cmath>
+#include "ibrush.h"
+#include "ipatch.h"
+#include "ientity.h"
+#include "ieclass.h"
+#include "scenelib.h"
+#include "string/convert.h"
+#include "../algorithm/Primitives.h"
+
+namespace benchmark
+{
+
+/**
+ * Populates a map with a configurable amount of brushes, patches and
+ * model entities, laid out in a regular grid such that spatial queries
+ * hit a predictable share of the map. Every fourth brush is using the
+ * caulk material to give the filter benchmarks something to hide.
+ */
+class SyntheticMap
+{
+public:
+    // Distance between the grid cells, every primitive fits into one cell
+    static constexpr double CellSize = 256;
+
+    static constexpr const char* const Material = "textures/numbers/1";
+    static constexpr const char* const CaulkMaterial = "textures/common/caulk";
+    static constexpr const char* const Model = "models/ase/testcube.ase";
+
+    std::size_t numBrushes;
+    std::size_t numPatches;
+    std::size_t numEntities;
+
+    // Size of the object counts relative to the given scale (brushes:patches:entities = 10:2:1)
+    SyntheticMap(std::size_t scale) :
+        numBrushes(scale * 10),
+        numPatches(scale * 2),
+        numEntities(scale)
+    {}
+
+    std::size_t getNumObjects() const
+    {
+        return numBrushes + numPatches + numEntities;
+    }
+
+    // Number of cells along the X and Y axis
+    std::size_t getGridSize() const
+    {
+        return static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(getNumObjects()))));
+    }
+
+    // The origin of the n-th grid cell
+    Vector3 getCellOrigin(std::size_t index) const
+    {
+        auto gridSize = getGridSize();
+        return Vector3((index % gridSize) * CellSize, (index / gridSize) * CellSize, 0);
+    }
+
+    // The bounds of the whole grid
+    AABB getBounds() const
+    {
+        auto extent = getGridSize() * CellSize;
+        return AABB::createFromMinMax(Vector3(-CellSize, -CellSize, -CellSize), Vector3(extent, extent, CellSize));
+    }
+
+    // Adds the primitives to the worldspawn and the entities to the root of the given map
+    void populate(const scene::INodePtr& root, const scene::INodePtr& worldspawn) const
+    {
+        std::size_t cell = 0;
+
+        for (std::size_t i = 0; i < numBrushes; ++i, ++cell)
+        {
+            test::algorithm::createCubicBrush(worldspawn, getCellOrigin(cell), i % 4 == 0 ? CaulkMaterial : Material);
+        }
+
+        for (std::size_t i = 0; i < numPatches; ++i, ++cell)
+        {
+            createPatch(worldspawn, getCellOrigin(cell));
+        }
+
+        auto eclass = GlobalEntityClassManager().findClass("func_static");
+
+        for (std::size_t i = 0; i < numEntities; ++i, ++cell)
+        {
+            auto entity = GlobalEntityModule().createEntity(eclass);
+            root->addChildNode(entity);
+
+            auto origin = getCellOrigin(cell);
+            entity->getEntity().setKeyValue("origin", string::to_string(origin));
+            entity->getEntity().setKeyValue("model", Model);
+        }
+    }
+
+private:
+    // A curved 3x3 patch spanning 128x128 units
+    static void createPatch(const scene::INodePtr& parent, const Vector3& origin)
+    {
+        auto node = GlobalPatchModule().createPatch(patch::PatchDefType::Def2);
+        scene::addNodeToContainer(node, parent);
+
+        auto& patch = std::dynamic_pointer_cast<IPatchNode>(node)->getPatch();
+        patch.setDims(3, 3);
+
+        for (std::size_t row = 0; row < 3; ++row)
+        {
+            for (std::size_t col = 0; col < 3; ++col)
+            {
+                auto& control = patch.ctrlAt(row, col);
+                control.vertex = origin + Vector3(col * 64.0 - 64, row * 64.0 - 64, row == 1 ? 32 : 0);
+                control.texcoord = Vector2(col * 0.5, row * 0.5);
+            }
+        }
+
+        patch.controlPointsChanged();
+        patch.setShader(Material);
+    }
+};
+
+}